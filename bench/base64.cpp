@@ -0,0 +1,155 @@
+#include <libutils/bytes.hpp>
+#include <libutils/simd.hpp>
+#include <libutils/strings.hpp>
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::string random_bytes(std::size_t const size)
+{
+    std::mt19937 gen{1};
+    std::uniform_int_distribution<int> dist{0, 255};
+    std::string out(size, '\0');
+    for (auto& ch : out) {
+        ch = static_cast<char>(dist(gen));
+    }
+    return out;
+}
+
+// Every codec is measured in raw (decoded) bytes, so the numbers compare the
+// cost of moving the same payload; the encoded text is 2x for hex, 1.33x for
+// Base64 and 1.6x for Base32.
+void set_bytes(benchmark::State& state)
+{
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_to_hex(benchmark::State& state)
+{
+    auto const bytes = random_bytes(static_cast<std::size_t>(state.range(0)));
+    std::string out;
+    for (auto _ : state) {
+        utils::strings::to_hex_into<char>(out,
+                                          utils::bytes::byte_view(bytes));
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_bytes(state);
+}
+
+void BM_to_base64(benchmark::State& state, utils::simd::level const l)
+{
+    auto const bytes = random_bytes(static_cast<std::size_t>(state.range(0)));
+    utils::simd::set_max_level(l);
+    std::string out;
+    for (auto _ : state) {
+        utils::strings::to_base64_into<char>(out,
+                                             utils::bytes::byte_view(bytes));
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_bytes(state);
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+void BM_to_base32(benchmark::State& state, utils::simd::level const l)
+{
+    auto const bytes = random_bytes(static_cast<std::size_t>(state.range(0)));
+    utils::simd::set_max_level(l);
+    std::string out;
+    for (auto _ : state) {
+        utils::strings::to_base32_into<char>(out,
+                                             utils::bytes::byte_view(bytes));
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_bytes(state);
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+void BM_from_hex(benchmark::State& state)
+{
+    auto const text = utils::strings::to_hex<char>(
+        random_bytes(static_cast<std::size_t>(state.range(0))));
+    std::vector<std::byte> out(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            utils::strings::hex_to_bytes_into<char>(out, text));
+    }
+    set_bytes(state);
+}
+
+void BM_from_base64(benchmark::State& state, utils::simd::level const l)
+{
+    auto const text = utils::strings::to_base64<char>(utils::bytes::byte_view(
+        random_bytes(static_cast<std::size_t>(state.range(0)))));
+    std::vector<std::byte> out(static_cast<std::size_t>(state.range(0)));
+    utils::simd::set_max_level(l);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            utils::strings::base64_to_bytes_into<char>(out, text));
+    }
+    set_bytes(state);
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+void BM_from_base32(benchmark::State& state, utils::simd::level const l)
+{
+    auto const text = utils::strings::to_base32<char>(utils::bytes::byte_view(
+        random_bytes(static_cast<std::size_t>(state.range(0)))));
+    std::vector<std::byte> out(static_cast<std::size_t>(state.range(0)));
+    utils::simd::set_max_level(l);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            utils::strings::base32_to_bytes_into<char>(out, text));
+    }
+    set_bytes(state);
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+} // namespace
+
+// 64 B .. 1 MiB in steps of 16x.
+BENCHMARK(BM_to_hex)
+    ->Name("encode/hex")
+    ->RangeMultiplier(16)
+    ->Range(64, 1 << 20);
+BENCHMARK_CAPTURE(BM_to_base64, scalar, utils::simd::level::scalar)
+    ->Name("encode/base64/scalar")
+    ->RangeMultiplier(16)
+    ->Range(64, 1 << 20);
+BENCHMARK_CAPTURE(BM_to_base64, simd, utils::simd::level::avx2)
+    ->Name("encode/base64/simd")
+    ->RangeMultiplier(16)
+    ->Range(64, 1 << 20);
+BENCHMARK_CAPTURE(BM_to_base32, scalar, utils::simd::level::scalar)
+    ->Name("encode/base32/scalar")
+    ->RangeMultiplier(16)
+    ->Range(64, 1 << 20);
+BENCHMARK_CAPTURE(BM_to_base32, simd, utils::simd::level::avx2)
+    ->Name("encode/base32/simd")
+    ->RangeMultiplier(16)
+    ->Range(64, 1 << 20);
+
+BENCHMARK(BM_from_hex)
+    ->Name("decode/hex")
+    ->RangeMultiplier(16)
+    ->Range(64, 1 << 20);
+BENCHMARK_CAPTURE(BM_from_base64, scalar, utils::simd::level::scalar)
+    ->Name("decode/base64/scalar")
+    ->RangeMultiplier(16)
+    ->Range(64, 1 << 20);
+BENCHMARK_CAPTURE(BM_from_base64, simd, utils::simd::level::avx2)
+    ->Name("decode/base64/simd")
+    ->RangeMultiplier(16)
+    ->Range(64, 1 << 20);
+BENCHMARK_CAPTURE(BM_from_base32, scalar, utils::simd::level::scalar)
+    ->Name("decode/base32/scalar")
+    ->RangeMultiplier(16)
+    ->Range(64, 1 << 20);
+BENCHMARK_CAPTURE(BM_from_base32, simd, utils::simd::level::avx2)
+    ->Name("decode/base32/simd")
+    ->RangeMultiplier(16)
+    ->Range(64, 1 << 20);
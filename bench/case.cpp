@@ -0,0 +1,174 @@
+#include <libutils/simd.hpp>
+#include <libutils/strings.hpp>
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <locale>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+// The pre-table ignore_case comparison, kept verbatim as the baseline: every
+// character goes through std::tolower with a freshly constructed locale.
+char legacy_tolower(char const ch, std::locale const& loc = std::locale())
+{
+    return std::tolower(ch, loc);
+}
+
+bool legacy_equal(std::string_view const a, std::string_view const b)
+{
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(),
+                      [](char const c1, char const c2) {
+                          return legacy_tolower(c1) == legacy_tolower(c2);
+                      });
+}
+
+bool legacy_contains(std::string_view const input,
+                     std::string_view const needle)
+{
+    return std::search(input.begin(), input.end(), needle.begin(),
+                       needle.end(), [](char const c1, char const c2) {
+                           return legacy_tolower(c1) == legacy_tolower(c2);
+                       }) != input.end();
+}
+
+// HTTP-style header names in mixed case, the typical short-key workload.
+std::vector<std::string> const& header_names()
+{
+    static std::vector<std::string> const names = [] {
+        std::vector<std::string> out;
+        for (auto const* const name :
+             {"Content-Type", "content-length", "ACCEPT-ENCODING",
+              "X-Forwarded-For", "User-Agent", "Cache-Control",
+              "If-None-Match", "Transfer-Encoding"}) {
+            out.emplace_back(name);
+        }
+        return out;
+    }();
+    return names;
+}
+
+// ~64 KiB of mixed-case prose with the needle only at the very end.
+std::string const& document()
+{
+    static std::string const text = [] {
+        std::mt19937 gen{7};
+        std::uniform_int_distribution<int> ch{0, 51};
+        std::string out;
+        while (out.size() < (std::size_t{1} << 16U)) {
+            auto const c = ch(gen);
+            out += c == 0 ? ' '
+                          : static_cast<char>(c < 26 ? 'a' + c : 'A' + c - 26);
+        }
+        return out + "Needle-In-Haystack";
+    }();
+    return text;
+}
+
+enum class impl
+{
+    legacy,
+    scalar,
+    simd
+};
+
+void pin(impl const i)
+{
+    utils::simd::set_max_level(i == impl::scalar ? utils::simd::level::scalar
+                                                 : utils::simd::level::avx2);
+}
+
+template <impl Impl>
+void BM_equal_headers(benchmark::State& state)
+{
+    auto const& names = header_names();
+    pin(Impl);
+    for (auto _ : state) {
+        std::size_t hits = 0;
+        for (auto const& a : names) {
+            for (auto const& b : names) {
+                if constexpr (Impl == impl::legacy) {
+                    hits += legacy_equal(a, b) ? 1 : 0;
+                } else {
+                    hits += utils::strings::equal<char>(a, b, true) ? 1 : 0;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(names.size() *
+                                                      names.size()));
+    pin(impl::simd);
+}
+
+template <impl Impl>
+void BM_contains(benchmark::State& state)
+{
+    auto const& text = document();
+    pin(Impl);
+    for (auto _ : state) {
+        if constexpr (Impl == impl::legacy) {
+            benchmark::DoNotOptimize(
+                legacy_contains(text, "needle-in-haystack"));
+        } else {
+            benchmark::DoNotOptimize(utils::strings::contains<char>(
+                text, "needle-in-haystack", true));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+    pin(impl::simd);
+}
+
+template <impl Impl>
+void BM_to_lower(benchmark::State& state)
+{
+    auto const& text = document();
+    pin(Impl);
+    for (auto _ : state) {
+        auto copy = text;
+        if constexpr (Impl == impl::legacy) {
+            std::transform(copy.begin(), copy.end(), copy.begin(),
+                           [](char const ch) { return legacy_tolower(ch); });
+        } else {
+            utils::strings::mutable_version::to_lower<char>(copy);
+        }
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+    pin(impl::simd);
+}
+
+void BM_equal_unicode(benchmark::State& state)
+{
+    std::string const a =
+        "\xC3\x84PFEL, BIRNEN UND \xCE\xA3\xCE\x9F\xCE\xA6\xCE\x99\xCE\x91";
+    std::string const b =
+        "\xC3\xA4pfel, birnen und \xCF\x83\xCE\xBF\xCF\x86\xCE\xB9\xCE\xB1";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utils::strings::equal<char>(
+            a, b, utils::strings::case_folding::unicode));
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(a.size()));
+}
+} // namespace
+
+BENCHMARK(BM_equal_headers<impl::legacy>)->Name("equal_icase/headers/legacy");
+BENCHMARK(BM_equal_headers<impl::scalar>)->Name("equal_icase/headers/scalar");
+BENCHMARK(BM_equal_headers<impl::simd>)->Name("equal_icase/headers/simd");
+BENCHMARK(BM_contains<impl::legacy>)->Name("contains_icase/64k/legacy");
+BENCHMARK(BM_contains<impl::scalar>)->Name("contains_icase/64k/scalar");
+BENCHMARK(BM_contains<impl::simd>)->Name("contains_icase/64k/simd");
+BENCHMARK(BM_to_lower<impl::legacy>)->Name("to_lower/64k/legacy");
+BENCHMARK(BM_to_lower<impl::scalar>)->Name("to_lower/64k/scalar");
+BENCHMARK(BM_to_lower<impl::simd>)->Name("to_lower/64k/simd");
+BENCHMARK(BM_equal_unicode)->Name("equal_icase/unicode");
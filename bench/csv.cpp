@@ -0,0 +1,142 @@
+#include <libutils/csv.hpp>
+#include <libutils/simd.hpp>
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+// A typical hand-written RFC 4180 state machine, one byte at a time, building
+// each field into a std::string: the kind of separate parser the reader
+// replaces.
+std::size_t legacy_parse(std::string_view const text)
+{
+    std::size_t fields = 0;
+    std::vector<std::string> row;
+    std::string field;
+    bool quoted = false;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        auto const ch = text[i];
+        if (quoted) {
+            if (ch == '"') {
+                if (i + 1 < text.size() && text[i + 1] == '"') {
+                    field += '"';
+                    ++i;
+                } else {
+                    quoted = false;
+                }
+            } else {
+                field += ch;
+            }
+        } else if (ch == '"' && field.empty()) {
+            quoted = true;
+        } else if (ch == ',') {
+            row.push_back(std::move(field));
+            field.clear();
+        } else if (ch == '\n') {
+            if (!field.empty() && field.back() == '\r') {
+                field.pop_back();
+            }
+            row.push_back(std::move(field));
+            field.clear();
+            fields += row.size();
+            row.clear();
+        } else {
+            field += ch;
+        }
+    }
+    return fields + row.size();
+}
+
+// ~4 MiB of 8-column records: numbers, short words, and every fourth row a
+// quoted free-text column with commas, escaped quotes or a line break.
+std::string const& corpus()
+{
+    static std::string const text = [] {
+        std::mt19937 gen{42};
+        std::uniform_int_distribution<int> len{1, 16};
+        std::uniform_int_distribution<int> ch{'a', 'z'};
+        std::string out;
+        std::size_t row = 0;
+        while (out.size() < (std::size_t{4} << 20U)) {
+            for (int column = 0; column < 8; ++column) {
+                if (column == 7 && row % 4 == 0) {
+                    out += "\"free, text with \"\"quotes\"\"\nand a break\"";
+                } else if (column % 2 == 0) {
+                    out += std::to_string(gen() % 100000);
+                } else {
+                    out.append(static_cast<std::size_t>(len(gen)),
+                               static_cast<char>(ch(gen)));
+                }
+                out += column == 7 ? "\r\n" : ",";
+            }
+            ++row;
+        }
+        return out;
+    }();
+    return text;
+}
+
+void BM_legacy(benchmark::State& state)
+{
+    auto const& text = corpus();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacy_parse(text));
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+
+template <utils::simd::level Level>
+void BM_reader(benchmark::State& state)
+{
+    auto const& text = corpus();
+    utils::simd::set_max_level(Level);
+    for (auto _ : state) {
+        std::size_t fields = 0;
+        utils::strings::csv::reader rows{text};
+        while (rows.next()) {
+            fields += rows.row().size();
+        }
+        benchmark::DoNotOptimize(fields);
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+void BM_parallel(benchmark::State& state)
+{
+    auto const& text = corpus();
+    auto const threads = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        std::vector<std::size_t> fields(threads);
+        utils::strings::csv::parallel_for_each_row(
+            text, threads,
+            [&](std::size_t const chunk,
+                utils::span<std::string_view const> const row) {
+                fields[chunk] += row.size();
+            });
+        benchmark::DoNotOptimize(fields.data());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+} // namespace
+
+BENCHMARK(BM_legacy)->Name("csv/legacy");
+BENCHMARK(BM_reader<utils::simd::level::scalar>)->Name("csv/reader/scalar");
+BENCHMARK(BM_reader<utils::simd::level::sse4_2>)->Name("csv/reader/sse4_2");
+BENCHMARK(BM_reader<utils::simd::level::avx2>)->Name("csv/reader/avx2");
+BENCHMARK(BM_parallel)
+    ->Name("csv/parallel")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
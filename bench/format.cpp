@@ -0,0 +1,188 @@
+#include <libutils/strings.hpp>
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::vector<std::int64_t> const& ints()
+{
+    static std::vector<std::int64_t> const out = [] {
+        std::mt19937_64 gen{1};
+        std::uniform_int_distribution<std::int64_t> value{-1000000000,
+                                                          1000000000};
+        std::vector<std::int64_t> v(1024);
+        for (auto& n : v) {
+            n = value(gen);
+        }
+        return v;
+    }();
+    return out;
+}
+
+std::vector<double> const& doubles()
+{
+    static std::vector<double> const out = [] {
+        std::mt19937_64 gen{2};
+        std::uniform_real_distribution<double> value{-1e6, 1e6};
+        std::vector<double> v(1024);
+        for (auto& n : v) {
+            n = value(gen);
+        }
+        return v;
+    }();
+    return out;
+}
+
+// A user type printed through operator<<, as to_string() requires.
+struct sample
+{
+    std::int64_t id;
+    double value;
+};
+
+std::ostream& operator<<(std::ostream& os, sample const& s)
+{
+    return os << s.id << ':' << s.value;
+}
+
+// The same type formatted field by field into a caller buffer.
+void append_sample(std::string& out, sample const& s)
+{
+    utils::strings::append_number(out, s.id);
+    out += ':';
+    utils::strings::append_number(out, s.value);
+}
+
+void BM_int_to_string(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (auto const n : ints()) {
+            benchmark::DoNotOptimize(utils::strings::to_string(n));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(ints().size()));
+}
+
+void BM_int_append_number(benchmark::State& state)
+{
+    std::string out;
+    for (auto _ : state) {
+        for (auto const n : ints()) {
+            out.clear();
+            utils::strings::append_number(out, n);
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(ints().size()));
+}
+
+void BM_int_format_to(benchmark::State& state)
+{
+    char buffer[32];
+    for (auto _ : state) {
+        for (auto const n : ints()) {
+            benchmark::DoNotOptimize(
+                utils::strings::format_to<char>(utils::span<char>{buffer}, n));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(ints().size()));
+}
+
+void BM_int_padded(benchmark::State& state)
+{
+    std::string out;
+    for (auto _ : state) {
+        for (auto const n : ints()) {
+            out.clear();
+            utils::strings::append_padded(out, n, 12);
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(ints().size()));
+}
+
+void BM_double_to_string(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (auto const d : doubles()) {
+            benchmark::DoNotOptimize(utils::strings::to_string(d));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(doubles().size()));
+}
+
+void BM_double_append_number(benchmark::State& state)
+{
+    std::string out;
+    for (auto _ : state) {
+        for (auto const d : doubles()) {
+            out.clear();
+            utils::strings::append_number(out, d);
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(doubles().size()));
+}
+
+void BM_double_append_fixed(benchmark::State& state)
+{
+    std::string out;
+    for (auto _ : state) {
+        for (auto const d : doubles()) {
+            out.clear();
+            utils::strings::append_fixed(out, d, 6);
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(doubles().size()));
+}
+
+void BM_user_to_string(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < ints().size(); ++i) {
+            benchmark::DoNotOptimize(
+                utils::strings::to_string(sample{ints()[i], doubles()[i]}));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(ints().size()));
+}
+
+void BM_user_append(benchmark::State& state)
+{
+    std::string out;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < ints().size(); ++i) {
+            out.clear();
+            append_sample(out, sample{ints()[i], doubles()[i]});
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(ints().size()));
+}
+} // namespace
+
+BENCHMARK(BM_int_to_string)->Name("int64/to_string");
+BENCHMARK(BM_int_append_number)->Name("int64/append_number");
+BENCHMARK(BM_int_format_to)->Name("int64/format_to_span");
+BENCHMARK(BM_int_padded)->Name("int64/append_padded");
+BENCHMARK(BM_double_to_string)->Name("double/to_string");
+BENCHMARK(BM_double_append_number)->Name("double/append_number_shortest");
+BENCHMARK(BM_double_append_fixed)->Name("double/append_fixed");
+BENCHMARK(BM_user_to_string)->Name("user_type/to_string");
+BENCHMARK(BM_user_append)->Name("user_type/append_fields");
@@ -0,0 +1,186 @@
+#include <libutils/fuzzy.hpp>
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// The O(nm) dynamic program the bit-parallel version replaces.
+std::size_t naive_distance(std::string_view const a, std::string_view const b)
+{
+    std::vector<std::size_t> row(b.size() + 1);
+    for (std::size_t j = 0; j <= b.size(); ++j) {
+        row[j] = j;
+    }
+    for (std::size_t i = 1; i <= a.size(); ++i) {
+        auto diagonal = row[0];
+        row[0] = i;
+        for (std::size_t j = 1; j <= b.size(); ++j) {
+            auto const above = row[j];
+            row[j] = std::min({above + 1, row[j - 1] + 1,
+                               diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+// A few random substitutions, insertions and deletions, as typos.
+std::string misspell(std::string text, std::mt19937& gen, int const edits)
+{
+    std::uniform_int_distribution<int> ch{'a', 'z'};
+    for (int k = 0; k < edits; ++k) {
+        auto const at = gen() % text.size();
+        switch (gen() % 3) {
+        case 0:
+            text[at] = static_cast<char>(ch(gen));
+            break;
+        case 1:
+            text.insert(at, 1, static_cast<char>(ch(gen)));
+            break;
+        default:
+            text.erase(at, 1);
+        }
+    }
+    return text;
+}
+
+// 10k host names like "db-0042.eu-west.example.com" and 256 lookups of
+// misspelled ones (1..3 edits).
+struct hosts
+{
+    std::vector<std::string> names;
+    std::vector<std::string> lookups;
+
+    hosts()
+    {
+        std::mt19937 gen{23};
+        char const* const roles[] = {"db", "web", "cache", "queue", "auth"};
+        char const* const regions[] = {"eu-west", "us-east", "ap-south"};
+        for (std::size_t i = 0; i < 10000; ++i) {
+            names.push_back(std::string{roles[gen() % 5]} + '-' +
+                            std::to_string(gen() % 10000) + '.' +
+                            regions[gen() % 3] + ".example.com");
+        }
+        for (std::size_t i = 0; i < 256; ++i) {
+            lookups.push_back(misspell(names[gen() % names.size()], gen,
+                                       1 + static_cast<int>(i % 3)));
+        }
+    }
+};
+
+hosts const& data()
+{
+    static hosts const instance;
+    return instance;
+}
+
+// Pairs of strings of `size` characters a few edits apart.
+std::vector<std::pair<std::string, std::string>> pairs(std::size_t const size)
+{
+    std::mt19937 gen{31};
+    std::uniform_int_distribution<int> ch{'a', 'z'};
+    std::vector<std::pair<std::string, std::string>> out(256);
+    for (auto& [a, b] : out) {
+        a.resize(size);
+        for (auto& c : a) {
+            c = static_cast<char>(ch(gen));
+        }
+        b = misspell(a, gen, static_cast<int>(size / 8));
+    }
+    return out;
+}
+
+template <typename Distance>
+void run_pairs(benchmark::State& state, Distance const& distance)
+{
+    auto const input = pairs(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::size_t total = 0;
+        for (auto const& [a, b] : input) {
+            total += distance(a, b);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(input.size()));
+}
+
+void BM_distance_naive(benchmark::State& state)
+{
+    run_pairs(state, naive_distance);
+}
+
+void BM_distance_myers(benchmark::State& state)
+{
+    run_pairs(state, [](std::string_view const a, std::string_view const b) {
+        return utils::strings::edit_distance(a, b);
+    });
+}
+
+// Bounded at 2: every pair here is further apart, so each stops early.
+void BM_distance_bounded(benchmark::State& state)
+{
+    run_pairs(state, [](std::string_view const a, std::string_view const b) {
+        return utils::strings::edit_distance(a, b, 2);
+    });
+}
+
+// Best match over all hosts with the DP on every candidate.
+void BM_find_naive(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (auto const& lookup : data().lookups) {
+            std::size_t best = 0;
+            auto best_distance = static_cast<std::size_t>(-1);
+            for (std::size_t i = 0; i < data().names.size(); ++i) {
+                auto const d = naive_distance(lookup, data().names[i]);
+                if (d < best_distance) {
+                    best = i;
+                    best_distance = d;
+                }
+            }
+            benchmark::DoNotOptimize(best);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(data().lookups.size()));
+}
+
+void BM_find_best(benchmark::State& state)
+{
+    auto const limit = state.range(0) < 0
+                           ? utils::strings::fuzzy_match::npos
+                           : static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        for (auto const& lookup : data().lookups) {
+            benchmark::DoNotOptimize(
+                utils::strings::fuzzy_find_best(lookup, data().names, limit));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(data().lookups.size()));
+}
+} // namespace
+
+BENCHMARK(BM_distance_naive)->Name("distance/naive")->Arg(24)->Arg(200);
+BENCHMARK(BM_distance_myers)->Name("distance/myers")->Arg(24)->Arg(200);
+BENCHMARK(BM_distance_bounded)
+    ->Name("distance/myers_bounded")
+    ->Arg(24)
+    ->Arg(200);
+BENCHMARK(BM_find_naive)
+    ->Name("find_best/naive")
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_find_best)
+    ->Name("find_best/fuzzy_find_best")
+    ->Arg(-1)
+    ->Arg(3)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,185 @@
+#include <libutils/bytes.hpp>
+#include <libutils/simd.hpp>
+#include <libutils/strings.hpp>
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+// The stringstream-based to_hex this library used to ship, as the baseline.
+std::string legacy_to_hex(std::string const& bytes)
+{
+    std::stringstream oss;
+    oss.setf(std::ios_base::uppercase);
+    for (char const ch : bytes) {
+        oss << std::hex << std::setw(2) << std::setfill('0')
+            << static_cast<unsigned>(static_cast<unsigned char>(ch));
+    }
+    return oss.str();
+}
+
+// The throwing, push_back-based hex_to_bytes this library used to ship.
+std::vector<std::byte> legacy_hex_to_bytes(std::string_view const str)
+{
+    auto const hexchar_to_int = [](char const ch) {
+        if (ch >= '0' && ch <= '9') {
+            return ch - '0';
+        }
+        if (ch >= 'A' && ch <= 'F') {
+            return ch - 'A' + 10;
+        }
+        if (ch >= 'a' && ch <= 'f') {
+            return ch - 'a' + 10;
+        }
+        throw std::invalid_argument("Invalid hexadecimal character");
+    };
+
+    std::vector<std::byte> result;
+    for (std::size_t i = 0; i < str.size(); i += 2) {
+        result.push_back(static_cast<std::byte>((hexchar_to_int(str[i]) << 4) |
+                                                hexchar_to_int(str[i + 1])));
+    }
+    return result;
+}
+
+std::string random_bytes(std::size_t const size)
+{
+    std::mt19937 gen{1};
+    std::uniform_int_distribution<int> dist{0, 255};
+    std::string out(size, '\0');
+    for (auto& ch : out) {
+        ch = static_cast<char>(dist(gen));
+    }
+    return out;
+}
+
+void BM_legacy(benchmark::State& state)
+{
+    auto const bytes = random_bytes(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacy_to_hex(bytes));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// to_hex_into a reused string: no allocation after the first iteration.
+void BM_to_hex_into(benchmark::State& state, utils::simd::level const l)
+{
+    auto const bytes = random_bytes(static_cast<std::size_t>(state.range(0)));
+    utils::simd::set_max_level(l);
+    std::string out;
+    for (auto _ : state) {
+        utils::strings::to_hex_into<char>(out,
+                                          utils::bytes::byte_view(bytes));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+void BM_to_hex(benchmark::State& state)
+{
+    auto const bytes = random_bytes(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utils::strings::to_hex<char>(bytes));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_legacy_decode(benchmark::State& state)
+{
+    auto const hex = utils::strings::to_hex<char>(
+        random_bytes(static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacy_hex_to_bytes(hex));
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(hex.size()));
+}
+
+void BM_hex_to_bytes_into(benchmark::State& state, utils::simd::level const l)
+{
+    auto const hex = utils::strings::to_hex<char>(
+        random_bytes(static_cast<std::size_t>(state.range(0))));
+    std::vector<std::byte> out(hex.size() / 2);
+    utils::simd::set_max_level(l);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            utils::strings::hex_to_bytes_into<char>(out, hex));
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(hex.size()));
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+// Untrusted input where every other field is malformed: exceptions vs status.
+void BM_decode_errors(benchmark::State& state, bool const throwing)
+{
+    std::vector<std::string> fields;
+    for (int i = 0; i < 64; ++i) {
+        fields.push_back(i % 2 == 0 ? "deadbeefcafef00d" : "deadbeefcafef0zz");
+    }
+    std::vector<std::byte> out(8);
+    for (auto _ : state) {
+        std::size_t failures = 0;
+        for (auto const& field : fields) {
+            if (throwing) {
+                try {
+                    benchmark::DoNotOptimize(legacy_hex_to_bytes(field));
+                } catch (std::invalid_argument const&) {
+                    ++failures;
+                }
+            } else if (!utils::strings::hex_to_bytes_into<char>(out, field)) {
+                ++failures;
+            }
+        }
+        benchmark::DoNotOptimize(failures);
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(fields.size()));
+}
+} // namespace
+
+// 16 B .. 16 MiB in steps of 16x.
+BENCHMARK(BM_legacy)
+    ->Name("to_hex/legacy")
+    ->RangeMultiplier(16)
+    ->Range(16, 16 << 20);
+BENCHMARK_CAPTURE(BM_to_hex_into, table, utils::simd::level::scalar)
+    ->Name("to_hex_into/table")
+    ->RangeMultiplier(16)
+    ->Range(16, 16 << 20);
+BENCHMARK_CAPTURE(BM_to_hex_into, simd, utils::simd::level::avx2)
+    ->Name("to_hex_into/simd")
+    ->RangeMultiplier(16)
+    ->Range(16, 16 << 20);
+BENCHMARK(BM_to_hex)
+    ->Name("to_hex/simd")
+    ->RangeMultiplier(16)
+    ->Range(16, 16 << 20);
+
+BENCHMARK(BM_legacy_decode)
+    ->Name("hex_to_bytes/legacy")
+    ->RangeMultiplier(16)
+    ->Range(16, 16 << 20);
+BENCHMARK_CAPTURE(BM_hex_to_bytes_into, table, utils::simd::level::scalar)
+    ->Name("hex_to_bytes_into/table")
+    ->RangeMultiplier(16)
+    ->Range(16, 16 << 20);
+BENCHMARK_CAPTURE(BM_hex_to_bytes_into, simd, utils::simd::level::avx2)
+    ->Name("hex_to_bytes_into/simd")
+    ->RangeMultiplier(16)
+    ->Range(16, 16 << 20);
+BENCHMARK_CAPTURE(BM_decode_errors, throwing, true)
+    ->Name("hex_decode_errors/throwing");
+BENCHMARK_CAPTURE(BM_decode_errors, status, false)
+    ->Name("hex_decode_errors/status");
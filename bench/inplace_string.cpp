@@ -0,0 +1,99 @@
+#include <libutils/inplace_string.hpp>
+#include <libutils/strings.hpp>
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+// 4096 (tenant, region, id) records; the keys built from them, e.g.
+// "ACMECORP:eu-west-1:00004242", are 25..36 characters: past the small-string
+// buffer, as cache and metric keys usually are.
+struct record
+{
+    std::string tenant;
+    std::string region;
+    std::uint32_t id;
+};
+
+std::vector<record> const& records()
+{
+    static std::vector<record> const out = [] {
+        std::mt19937 gen{5};
+        std::uniform_int_distribution<int> len{6, 16};
+        std::uniform_int_distribution<int> ch{'a', 'z'};
+        std::uniform_int_distribution<std::uint32_t> id{0, 99999999};
+        char const* const regions[] = {"eu-west-1", "us-east-2", "ap-south-1"};
+        std::vector<record> v(4096);
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            v[i].tenant.assign(static_cast<std::size_t>(len(gen)),
+                               static_cast<char>(ch(gen)));
+            v[i].region = regions[i % 3];
+            v[i].id = id(gen);
+        }
+        return v;
+    }();
+    return out;
+}
+
+void set_items(benchmark::State& state)
+{
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(records().size()));
+}
+
+template <typename String>
+String make_key(record const& r)
+{
+    String key(r.tenant);
+    utils::strings::mutable_version::to_upper(key);
+    key.push_back(':');
+    key.append(r.region);
+    key.push_back(':');
+    utils::strings::append_padded(key, r.id, 8);
+    return key;
+}
+
+using inline_key = utils::strings::inplace_string<47>;
+
+// Building each key and dropping it.
+template <typename String>
+void BM_build(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (auto const& r : records()) {
+            auto const key = make_key<String>(r);
+            benchmark::DoNotOptimize(key.data());
+        }
+    }
+    set_items(state);
+}
+
+// Building the keys into a batch that is then handed on (copied), as when
+// queuing lookups: the inline keys copy as 48-byte blocks, the strings
+// allocate again.
+template <typename String>
+void BM_build_and_copy(benchmark::State& state)
+{
+    std::vector<String> batch;
+    batch.reserve(records().size());
+    for (auto _ : state) {
+        batch.clear();
+        for (auto const& r : records()) {
+            batch.push_back(make_key<String>(r));
+        }
+        auto const queued = batch;
+        benchmark::DoNotOptimize(queued.data());
+    }
+    set_items(state);
+}
+} // namespace
+
+BENCHMARK(BM_build<std::string>)->Name("build/std::string");
+BENCHMARK(BM_build<inline_key>)->Name("build/inplace_string");
+BENCHMARK(BM_build_and_copy<std::string>)->Name("build+copy/std::string");
+BENCHMARK(BM_build_and_copy<inline_key>)->Name("build+copy/inplace_string");
@@ -0,0 +1,138 @@
+#include <libutils/intern_pool.hpp>
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+// 256 Ki occurrences of 4096 distinct host / metric / tag names, skewed so
+// that a few names make up most of the stream, as in a metrics feed.
+struct stream
+{
+    std::vector<std::string> names;
+    std::vector<std::string> occurrences;
+
+    stream()
+    {
+        std::mt19937 gen{42};
+        std::uniform_int_distribution<int> len{6, 24};
+        std::uniform_int_distribution<int> ch{'a', 'z'};
+        char const* const prefixes[] = {"host.", "metric.", "tag."};
+        for (std::size_t i = 0; i < 4096; ++i) {
+            std::string name = prefixes[i % 3];
+            name.append(static_cast<std::size_t>(len(gen)),
+                        static_cast<char>(ch(gen)));
+            names.push_back(name + std::to_string(i));
+        }
+        std::geometric_distribution<std::size_t> pick{0.002};
+        for (std::size_t i = 0; i < (std::size_t{1} << 18U); ++i) {
+            occurrences.push_back(names[pick(gen) % names.size()]);
+        }
+    }
+};
+
+stream const& data()
+{
+    static stream const instance;
+    return instance;
+}
+
+void set_items(benchmark::State& state)
+{
+    auto const count = data().occurrences.size();
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(count));
+}
+
+// Interning the whole stream into an empty container.
+void BM_insert_unordered_set(benchmark::State& state)
+{
+    for (auto _ : state) {
+        std::unordered_set<std::string> set;
+        for (auto const& name : data().occurrences) {
+            benchmark::DoNotOptimize(set.insert(name).first);
+        }
+    }
+    set_items(state);
+}
+
+template <typename Pool>
+void BM_insert_pool(benchmark::State& state)
+{
+    for (auto _ : state) {
+        Pool pool;
+        for (auto const& name : data().occurrences) {
+            benchmark::DoNotOptimize(pool.intern(name));
+        }
+    }
+    set_items(state);
+}
+
+// Looking up names already interned.
+void BM_lookup_unordered_set(benchmark::State& state)
+{
+    std::unordered_set<std::string> const set(data().names.begin(),
+                                              data().names.end());
+    for (auto _ : state) {
+        for (auto const& name : data().occurrences) {
+            benchmark::DoNotOptimize(set.find(name));
+        }
+    }
+    set_items(state);
+}
+
+template <typename Pool>
+void BM_lookup_pool(benchmark::State& state)
+{
+    Pool pool;
+    for (auto const& name : data().names) {
+        pool.intern(name);
+    }
+    for (auto _ : state) {
+        for (auto const& name : data().occurrences) {
+            benchmark::DoNotOptimize(pool.find(name));
+        }
+    }
+    set_items(state);
+    state.counters["area"] = static_cast<double>(pool.area());
+}
+
+// The memory side: what holding the distinct names costs.
+void BM_area_unordered_set(benchmark::State& state)
+{
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        std::unordered_set<std::string> const set(data().names.begin(),
+                                                  data().names.end());
+        // Nodes (string + next pointer + cached hash), buckets, and the
+        // strings too long for the small-string buffer.
+        bytes = sizeof(set) + set.bucket_count() * sizeof(void*) +
+                set.size() * (sizeof(std::string) + 2 * sizeof(void*));
+        for (auto const& name : set) {
+            bytes += name.capacity() > 15 ? name.capacity() + 1 : 0;
+        }
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.counters["area"] = static_cast<double>(bytes);
+}
+} // namespace
+
+BENCHMARK(BM_insert_unordered_set)->Name("insert/unordered_set");
+BENCHMARK(BM_insert_pool<utils::strings::intern_pool>)
+    ->Name("insert/intern_pool");
+BENCHMARK(BM_insert_pool<utils::strings::sharded_intern_pool<>>)
+    ->Name("insert/sharded_intern_pool");
+
+BENCHMARK(BM_lookup_unordered_set)->Name("lookup/unordered_set");
+BENCHMARK(BM_lookup_pool<utils::strings::intern_pool>)
+    ->Name("lookup/intern_pool");
+BENCHMARK(BM_lookup_pool<utils::strings::sharded_intern_pool<>>)
+    ->Name("lookup/sharded_intern_pool");
+
+BENCHMARK(BM_area_unordered_set)->Name("area/unordered_set");
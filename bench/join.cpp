@@ -0,0 +1,129 @@
+#include <libutils/iterators.hpp>
+#include <libutils/strings.hpp>
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+// The pre-fast-path join, kept verbatim as the baseline.
+template <typename C>
+std::string legacy_join(C const& c, char const* const separator)
+{
+    std::stringstream oss;
+    std::copy(std::cbegin(c), std::cend(c),
+              utils::iterators::make_ostream_joiner(oss, separator));
+    return oss.str();
+}
+
+// 2000 header-value-sized fields, the shape of a response being assembled.
+std::vector<std::string> const& fields()
+{
+    static std::vector<std::string> const out = [] {
+        std::mt19937 gen{5};
+        std::uniform_int_distribution<int> len{3, 30};
+        std::vector<std::string> v(2000);
+        for (auto& field : v) {
+            field.assign(static_cast<std::size_t>(len(gen)), 'x');
+        }
+        return v;
+    }();
+    return out;
+}
+
+std::vector<std::string_view> const& views()
+{
+    static std::vector<std::string_view> const out(fields().begin(),
+                                                   fields().end());
+    return out;
+}
+
+std::vector<std::int64_t> const& numbers()
+{
+    static std::vector<std::int64_t> const out = [] {
+        std::mt19937_64 gen{8};
+        std::uniform_int_distribution<std::int64_t> value{-1000000, 1000000};
+        std::vector<std::int64_t> v(2000);
+        for (auto& n : v) {
+            n = value(gen);
+        }
+        return v;
+    }();
+    return out;
+}
+
+void BM_views_legacy(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacy_join(views(), ", "));
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(views().size()));
+}
+
+void BM_views(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utils::strings::join<char>(views(), ", "));
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(views().size()));
+}
+
+// Appending into one reused string: no allocation after the first pass.
+void BM_views_into_reused(benchmark::State& state)
+{
+    std::string out;
+    for (auto _ : state) {
+        out.clear();
+        utils::strings::join_into<char>(out, views(), ", ");
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(views().size()));
+}
+
+void BM_views_into_span(benchmark::State& state)
+{
+    std::vector<char> buffer(utils::strings::joined_size<char>(
+        views().begin(), views().end(), 2));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utils::strings::join_into<char>(
+            utils::span<char>{buffer}, views(), ", "));
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(views().size()));
+}
+
+void BM_numbers_legacy(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacy_join(numbers(), ","));
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(numbers().size()));
+}
+
+void BM_numbers(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utils::strings::join<char>(numbers(), ","));
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(numbers().size()));
+}
+} // namespace
+
+BENCHMARK(BM_views_legacy)->Name("join/views/legacy");
+BENCHMARK(BM_views)->Name("join/views");
+BENCHMARK(BM_views_into_reused)->Name("join/views/into_reused_string");
+BENCHMARK(BM_views_into_span)->Name("join/views/into_span");
+BENCHMARK(BM_numbers_legacy)->Name("join/int64/legacy");
+BENCHMARK(BM_numbers)->Name("join/int64");
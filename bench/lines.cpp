@@ -0,0 +1,192 @@
+#include <libutils/lines.hpp>
+#include <libutils/mapped_file.hpp>
+#include <libutils/simd.hpp>
+#include <libutils/strings.hpp>
+#include <libutils/unused.hpp>
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace
+{
+// ~32 MiB of comma-separated log records, 20..120 bytes per line, written to
+// a temporary file once and removed at exit.
+struct corpus
+{
+    std::string text;
+    std::string path;
+
+    corpus()
+        : path((std::filesystem::temp_directory_path() / "libutils_lines.log")
+                   .string())
+    {
+        std::mt19937 gen{42};
+        std::uniform_int_distribution<int> len{2, 20};
+        std::uniform_int_distribution<int> fields{2, 8};
+        std::uniform_int_distribution<int> ch{'a', 'z'};
+        while (text.size() < (std::size_t{32} << 20U)) {
+            for (auto n = fields(gen); n > 0; --n) {
+                text.append(static_cast<std::size_t>(len(gen)),
+                            static_cast<char>(ch(gen)));
+                text += n == 1 ? '\n' : ',';
+            }
+        }
+        std::ofstream(path, std::ios::binary) << text;
+    }
+
+    ~corpus() { utils::unused(std::remove(path.c_str())); }
+
+    corpus(corpus const&) = delete;
+    corpus& operator=(corpus const&) = delete;
+    corpus(corpus&&) = delete;
+    corpus& operator=(corpus&&) = delete;
+};
+
+corpus const& data()
+{
+    static corpus const instance;
+    return instance;
+}
+
+void set_bytes(benchmark::State& state)
+{
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(data().text.size()));
+}
+
+// The istream path being replaced: getline into a string, then split it.
+void BM_getline_file(benchmark::State& state)
+{
+    auto const& c = data();
+    for (auto _ : state) {
+        std::ifstream in(c.path, std::ios::binary);
+        std::string line;
+        std::size_t fields = 0;
+        while (std::getline(in, line)) {
+            fields += utils::strings::split_view<char>(line, ',').size();
+        }
+        benchmark::DoNotOptimize(fields);
+    }
+    set_bytes(state);
+}
+
+// Map the file and split each line in place; the mapping is redone every
+// iteration so open/mmap/munmap are part of the cost. With `Lazy` the fields
+// are counted through split_lazy, so nothing at all is allocated per line.
+template <bool Lazy>
+void BM_mapped_lines(benchmark::State& state)
+{
+    auto const& c = data();
+    for (auto _ : state) {
+        utils::mapped_file const file(c.path);
+        std::size_t fields = 0;
+        for (auto const line : utils::strings::lines(file.bytes())) {
+            if constexpr (Lazy) {
+                auto const range = utils::strings::split_lazy<char>(line, ',');
+                fields += static_cast<std::size_t>(
+                    std::distance(range.begin(), range.end()));
+            } else {
+                fields += utils::strings::split_view<char>(line, ',').size();
+            }
+        }
+        benchmark::DoNotOptimize(fields);
+    }
+    set_bytes(state);
+}
+
+// Line iteration alone, over a buffer already in memory.
+void BM_getline_memory(benchmark::State& state)
+{
+    auto const& c = data();
+    for (auto _ : state) {
+        std::istringstream in(c.text);
+        std::string line;
+        std::size_t size = 0;
+        while (std::getline(in, line)) {
+            size += line.size();
+        }
+        benchmark::DoNotOptimize(size);
+    }
+    set_bytes(state);
+}
+
+// Fields and bytes per line, summed per thread and merged as chunks finish.
+struct tally
+{
+    std::size_t lines{0};
+    std::size_t fields{0};
+};
+
+// Scaling over the generated corpus, or over the file named by
+// UTILS_BENCH_LINES_FILE (e.g. a multi-GiB log), mapped once up front.
+std::string_view scaling_input()
+{
+    static utils::mapped_file const file = [] {
+        auto const* const path = std::getenv("UTILS_BENCH_LINES_FILE");
+        return path == nullptr ? utils::mapped_file{}
+                               : utils::mapped_file{path};
+    }();
+    return file.empty() ? std::string_view{data().text} : file.text();
+}
+
+void BM_parallel(benchmark::State& state)
+{
+    auto const text = scaling_input();
+    auto const threads = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        auto const total = utils::strings::parallel_for_each_line(
+            text, threads, tally{},
+            [](tally& t, std::string_view const line) {
+                ++t.lines;
+                t.fields += 1 + utils::simd::count(
+                                    line.data(), line.data() + line.size(),
+                                    ',');
+            },
+            [](tally& into, tally const& from) {
+                into.lines += from.lines;
+                into.fields += from.fields;
+            },
+            utils::strings::merge_order::unordered);
+        benchmark::DoNotOptimize(total.fields);
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+
+void BM_lines_memory(benchmark::State& state)
+{
+    auto const& c = data();
+    for (auto _ : state) {
+        std::size_t size = 0;
+        for (auto const line : utils::strings::lines(c.text)) {
+            size += line.size();
+        }
+        benchmark::DoNotOptimize(size);
+    }
+    set_bytes(state);
+}
+} // namespace
+
+BENCHMARK(BM_getline_file)->Name("file/getline+split");
+BENCHMARK(BM_mapped_lines<false>)->Name("file/mapped_lines+split");
+BENCHMARK(BM_mapped_lines<true>)->Name("file/mapped_lines+split_lazy");
+BENCHMARK(BM_getline_memory)->Name("memory/getline");
+BENCHMARK(BM_lines_memory)->Name("memory/lines");
+BENCHMARK(BM_parallel)
+    ->Name("parallel")
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Arg(16)
+    ->UseRealTime();
@@ -0,0 +1,147 @@
+#include <libutils/strings.hpp>
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+// `count` secret-looking patterns such as "apikey_k3x9=".
+std::vector<std::string> make_patterns(std::size_t const count)
+{
+    std::mt19937 gen{17};
+    std::uniform_int_distribution<int> ch{'a', 'z'};
+    std::vector<std::string> patterns;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::string pattern = "key_";
+        for (int j = 0; j < 6; ++j) {
+            pattern += static_cast<char>(ch(gen));
+        }
+        patterns.push_back(pattern + "=");
+    }
+    return patterns;
+}
+
+// 4096 log lines of ~120 bytes; every 16th line leaks one of the patterns.
+std::vector<std::string> make_lines(std::vector<std::string> const& patterns)
+{
+    std::mt19937 gen{23};
+    std::uniform_int_distribution<int> word{2, 10};
+    std::uniform_int_distribution<int> ch{'a', 'z'};
+    std::vector<std::string> lines(4096);
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        auto& line = lines[i];
+        while (line.size() < 120) {
+            for (auto n = word(gen); n > 0; --n) {
+                line += static_cast<char>(ch(gen));
+            }
+            line += ' ';
+        }
+        if (i % 16 == 0) {
+            line += patterns[i % patterns.size()] + "s3cr3t";
+        }
+    }
+    return lines;
+}
+
+std::int64_t total_size(std::vector<std::string> const& lines)
+{
+    std::int64_t bytes = 0;
+    for (auto const& line : lines) {
+        bytes += static_cast<std::int64_t>(line.size());
+    }
+    return bytes;
+}
+
+// One replace_all pass per pattern: the cost this type exists to remove.
+void BM_redact_per_pattern(benchmark::State& state)
+{
+    auto const patterns =
+        make_patterns(static_cast<std::size_t>(state.range(0)));
+    auto const lines = make_lines(patterns);
+    for (auto _ : state) {
+        for (auto const& line : lines) {
+            auto redacted = line;
+            for (auto const& pattern : patterns) {
+                redacted = utils::strings::replace_all<char>(
+                    std::move(redacted), pattern, "<redacted>");
+            }
+            benchmark::DoNotOptimize(redacted.data());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * total_size(lines));
+}
+
+void BM_redact_multi_searcher(benchmark::State& state)
+{
+    auto const patterns =
+        make_patterns(static_cast<std::size_t>(state.range(0)));
+    auto const lines = make_lines(patterns);
+    utils::strings::multi_searcher<char> const matcher{patterns};
+    for (auto _ : state) {
+        for (auto const& line : lines) {
+            auto const redacted = utils::strings::replace_all<char>(
+                line, matcher, std::string_view{"<redacted>"});
+            benchmark::DoNotOptimize(redacted.data());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * total_size(lines));
+}
+
+void BM_contains_any_per_pattern(benchmark::State& state)
+{
+    auto const patterns =
+        make_patterns(static_cast<std::size_t>(state.range(0)));
+    auto const lines = make_lines(patterns);
+    for (auto _ : state) {
+        std::size_t hits = 0;
+        for (auto const& line : lines) {
+            for (auto const& pattern : patterns) {
+                if (utils::strings::contains<char>(line, pattern)) {
+                    ++hits;
+                    break;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetBytesProcessed(state.iterations() * total_size(lines));
+}
+
+void BM_contains_any_multi_searcher(benchmark::State& state)
+{
+    auto const patterns =
+        make_patterns(static_cast<std::size_t>(state.range(0)));
+    auto const lines = make_lines(patterns);
+    utils::strings::multi_searcher<char> const matcher{patterns};
+    for (auto _ : state) {
+        std::size_t hits = 0;
+        for (auto const& line : lines) {
+            hits += utils::strings::contains_any<char>(line, matcher) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetBytesProcessed(state.iterations() * total_size(lines));
+}
+} // namespace
+
+BENCHMARK(BM_redact_per_pattern)
+    ->Name("redact/per_pattern")
+    ->RangeMultiplier(4)
+    ->Range(1, 256);
+BENCHMARK(BM_redact_multi_searcher)
+    ->Name("redact/multi_searcher")
+    ->RangeMultiplier(4)
+    ->Range(1, 256);
+BENCHMARK(BM_contains_any_per_pattern)
+    ->Name("contains_any/per_pattern")
+    ->RangeMultiplier(4)
+    ->Range(1, 256);
+BENCHMARK(BM_contains_any_multi_searcher)
+    ->Name("contains_any/multi_searcher")
+    ->RangeMultiplier(4)
+    ->Range(1, 256);
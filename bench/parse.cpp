@@ -0,0 +1,243 @@
+#include <libutils/strings.hpp>
+
+#include <benchmark/benchmark.h>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+// ~1 MiB of comma-separated decimal integers, `fields` per line, each drawn
+// with `digits` digits or fewer (0 for a mix of 1..19 digits).
+std::string make_column(std::size_t const digits)
+{
+    std::mt19937_64 gen{42};
+    std::uniform_int_distribution<int> width{1, 19};
+    std::string text;
+    std::size_t field = 0;
+    while (text.size() < (std::size_t{1} << 20U)) {
+        auto const n = digits == 0 ? static_cast<std::size_t>(width(gen))
+                                   : digits;
+        auto number = std::to_string(gen() % 10000000000000000000ULL);
+        number.resize(n < number.size() ? n : number.size());
+        text += number;
+        text += (++field % 16 == 0) ? '\n' : ',';
+    }
+    return text;
+}
+
+std::string const& column(std::size_t const digits)
+{
+    static std::string const fixed8 = make_column(8);
+    static std::string const fixed16 = make_column(16);
+    static std::string const mixed = make_column(0);
+    return digits == 8 ? fixed8 : digits == 16 ? fixed16 : mixed;
+}
+
+// The hot path as written today: split_view, then to_integral per token.
+void BM_to_integral(benchmark::State& state)
+{
+    auto const& text = column(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::vector<std::uint64_t> values;
+        for (auto const token :
+             utils::strings::split_view<char>(text, ",\n")) {
+            values.push_back(
+                utils::strings::to_integral<std::uint64_t>(token));
+        }
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+
+void BM_parse_integers(benchmark::State& state)
+{
+    auto const& text = column(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto const tokens = utils::strings::split_view<char>(text, ",\n");
+        std::vector<std::uint64_t> values(tokens.size());
+        auto const result =
+            utils::strings::parse_integers<std::uint64_t>(tokens, values);
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+
+void BM_split_and_parse(benchmark::State& state)
+{
+    auto const& text = column(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::vector<std::uint64_t> values;
+        auto const result =
+            utils::strings::split_and_parse(text, ",\n", values);
+        benchmark::DoNotOptimize(result);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+
+// Fixed-width fields need no delimiter scan at all.
+void BM_fixed_from_chars(benchmark::State& state)
+{
+    auto const& text = column(16);
+    for (auto _ : state) {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i + 16 <= text.size(); i += 17) {
+            std::uint64_t value = 0;
+            std::from_chars(text.data() + i, text.data() + i + 16, value);
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+
+void BM_fixed_swar(benchmark::State& state)
+{
+    auto const& text = column(16);
+    for (auto _ : state) {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i + 16 <= text.size(); i += 17) {
+            sum += utils::simd::parse_sixteen_digits(text.data() + i);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+// Ingest-style fields where a share (range(0) percent) are malformed: missing
+// values, placeholders, units glued to the number.
+std::vector<std::string> const& dirty_fields(std::int64_t const bad_percent)
+{
+    static std::vector<std::vector<std::string>> cache(101);
+    auto& fields = cache[static_cast<std::size_t>(bad_percent)];
+    if (fields.empty()) {
+        std::mt19937_64 gen{7};
+        std::uniform_int_distribution<int> percent{0, 99};
+        char const* const junk[] = {"", "n/a", "-", "12ms", "NULL", "1e3"};
+        for (int i = 0; i < 10000; ++i) {
+            if (percent(gen) < bad_percent) {
+                fields.emplace_back(junk[gen() % 6]);
+            } else {
+                fields.push_back(std::to_string(gen() % 1000000));
+            }
+        }
+    }
+    return fields;
+}
+
+void BM_errors_throwing(benchmark::State& state)
+{
+    auto const& fields = dirty_fields(state.range(0));
+    for (auto _ : state) {
+        std::int64_t sum = 0;
+        for (auto const& field : fields) {
+            try {
+                sum += utils::strings::to_integral<std::int64_t>(field);
+            } catch (std::invalid_argument const&) {
+                --sum;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(fields.size()));
+}
+
+void BM_errors_try(benchmark::State& state)
+{
+    auto const& fields = dirty_fields(state.range(0));
+    for (auto _ : state) {
+        std::int64_t sum = 0;
+        for (auto const& field : fields) {
+            auto const result =
+                utils::strings::try_to_integral<std::int64_t>(field);
+            sum += result ? *result : -1;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(fields.size()));
+}
+
+#if defined(__cpp_lib_to_chars)
+void BM_errors_floating_throwing(benchmark::State& state)
+{
+    auto const& fields = dirty_fields(state.range(0));
+    for (auto _ : state) {
+        double sum = 0;
+        for (auto const& field : fields) {
+            try {
+                sum += utils::strings::to_floating<double>(field);
+            } catch (std::invalid_argument const&) {
+                sum -= 1;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(fields.size()));
+}
+
+void BM_errors_floating_try(benchmark::State& state)
+{
+    auto const& fields = dirty_fields(state.range(0));
+    for (auto _ : state) {
+        double sum = 0;
+        for (auto const& field : fields) {
+            sum +=
+                utils::strings::try_to_floating<double>(field).value_or(-1);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(fields.size()));
+}
+#endif
+} // namespace
+
+BENCHMARK(BM_to_integral)->Name("column/to_integral")->Arg(8)->Arg(16)->Arg(0);
+BENCHMARK(BM_parse_integers)
+    ->Name("column/parse_integers")
+    ->Arg(8)
+    ->Arg(16)
+    ->Arg(0);
+BENCHMARK(BM_split_and_parse)
+    ->Name("column/split_and_parse")
+    ->Arg(8)
+    ->Arg(16)
+    ->Arg(0);
+BENCHMARK(BM_fixed_from_chars)->Name("fixed16/from_chars");
+BENCHMARK(BM_fixed_swar)->Name("fixed16/parse_sixteen_digits");
+BENCHMARK(BM_errors_throwing)
+    ->Name("errors/to_integral_catch")
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(50);
+BENCHMARK(BM_errors_try)
+    ->Name("errors/try_to_integral")
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(50);
+#if defined(__cpp_lib_to_chars)
+BENCHMARK(BM_errors_floating_throwing)
+    ->Name("errors/to_floating_catch")
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(50);
+BENCHMARK(BM_errors_floating_try)
+    ->Name("errors/try_to_floating")
+    ->Arg(0)
+    ->Arg(10)
+    ->Arg(50);
+#endif
@@ -0,0 +1,88 @@
+#include <libutils/strings.hpp>
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__cpp_lib_memory_resource)
+#include <memory_resource>
+
+namespace
+{
+// 1000 query-string-like requests of 8..24 "key=value" fields, values of 8..40
+// characters: enough for the owning split to allocate for most tokens.
+std::vector<std::string> const& requests()
+{
+    static std::vector<std::string> const out = [] {
+        std::mt19937 gen{11};
+        std::uniform_int_distribution<int> fields{8, 24};
+        std::uniform_int_distribution<int> len{8, 40};
+        std::uniform_int_distribution<int> ch{'a', 'z'};
+        std::vector<std::string> v(1000);
+        for (auto& request : v) {
+            for (auto n = fields(gen); n > 0; --n) {
+                request += "k" + std::to_string(n) + '=';
+                request.append(static_cast<std::size_t>(len(gen)),
+                               static_cast<char>(ch(gen)));
+                request += n == 1 ? "" : "&";
+            }
+        }
+        return v;
+    }();
+    return out;
+}
+
+std::int64_t total_size()
+{
+    std::size_t size = 0;
+    for (auto const& request : requests()) {
+        size += request.size();
+    }
+    return static_cast<std::int64_t>(size);
+}
+
+// Per request: split the fields, join them back with another separator and
+// hex-encode the result (e.g. to build a cache key).
+void BM_pipeline_heap(benchmark::State& state)
+{
+    for (auto _ : state) {
+        for (auto const& request : requests()) {
+            auto const fields = utils::strings::split<char>(request, '&');
+            auto const joined = utils::strings::join(fields, ',');
+            auto const key = utils::strings::to_hex<char>(joined);
+            benchmark::DoNotOptimize(key.data());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * total_size());
+}
+
+// The same work on a per-request monotonic arena over a stack buffer: every
+// allocation is a pointer bump and the whole request is freed at once.
+void BM_pipeline_pmr(benchmark::State& state)
+{
+    std::array<std::byte, 32768> buffer{};
+    for (auto _ : state) {
+        for (auto const& request : requests()) {
+            std::pmr::monotonic_buffer_resource arena(buffer.data(),
+                                                      buffer.size());
+            std::pmr::polymorphic_allocator<char> const alloc(&arena);
+            auto const fields =
+                utils::strings::split<char>(request, '&', false, alloc);
+            auto const joined = utils::strings::join(fields, ',', alloc);
+            auto const key =
+                utils::strings::to_hex<char>(joined, true, false, alloc);
+            benchmark::DoNotOptimize(key.data());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * total_size());
+}
+} // namespace
+
+BENCHMARK(BM_pipeline_heap)->Name("split+join+to_hex/heap");
+BENCHMARK(BM_pipeline_pmr)->Name("split+join+to_hex/pmr_arena");
+#endif
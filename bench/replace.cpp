@@ -0,0 +1,116 @@
+#include <libutils/strings.hpp>
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace
+{
+// The pre-rewrite replace_all, kept verbatim as the baseline: each hit
+// shifts the tail of the string.
+std::string legacy_replace_all(std::string text, std::string_view const from,
+                               std::string_view const to)
+{
+    if (from.empty()) {
+        return text;
+    }
+    std::size_t pos = 0;
+    while ((pos = text.find(from, pos)) != std::string::npos) {
+        text.replace(pos, from.size(), to.data(), to.size());
+        pos += to.size();
+    }
+    return text;
+}
+
+// 256 KiB of lowercase text with "{{x}}" every `gap` bytes on average.
+std::string make_payload(std::size_t const gap)
+{
+    std::mt19937 gen{9};
+    std::uniform_int_distribution<int> ch{'a', 'z'};
+    std::uniform_int_distribution<std::size_t> hit{0, gap - 1};
+    std::string payload;
+    while (payload.size() < (std::size_t{1} << 18U)) {
+        if (hit(gen) == 0) {
+            payload += "{{x}}";
+        } else {
+            payload += static_cast<char>(ch(gen));
+        }
+    }
+    return payload;
+}
+
+std::string const& payload(std::int64_t const gap)
+{
+    static std::string const dense = make_payload(16);
+    static std::string const sparse = make_payload(4096);
+    return gap == 16 ? dense : sparse;
+}
+
+// Replacement length relative to the 5-byte needle.
+std::string_view replacement(std::int64_t const growth)
+{
+    return growth < 0 ? "?" : growth == 0 ? "<val>" : "<a longer value>";
+}
+
+enum class impl
+{
+    legacy,
+    by_value,
+    in_place,
+    append,
+};
+
+// Args: {hit gap, replacement growth (-1 shrink, 0 equal, 1 grow)}.
+template <impl Impl>
+void BM_replace_all(benchmark::State& state)
+{
+    auto const& text = payload(state.range(0));
+    auto const to = replacement(state.range(1));
+    std::string out;
+    for (auto _ : state) {
+        if constexpr (Impl == impl::legacy) {
+            benchmark::DoNotOptimize(legacy_replace_all(text, "{{x}}", to));
+        } else if constexpr (Impl == impl::by_value) {
+            benchmark::DoNotOptimize(
+                utils::strings::replace_all<char>(text, "{{x}}", to));
+        } else if constexpr (Impl == impl::in_place) {
+            out = text; // reuses out's capacity after the first iteration
+            utils::strings::mutable_version::replace_all<char>(out, "{{x}}",
+                                                               to);
+            benchmark::DoNotOptimize(out.data());
+        } else {
+            out.clear();
+            utils::strings::append_replaced<char>(out, text, "{{x}}", to);
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+
+void args(benchmark::internal::Benchmark* b)
+{
+    for (std::int64_t const gap : {16, 4096}) {
+        for (std::int64_t const growth : {-1, 0, 1}) {
+            b->Args({gap, growth});
+        }
+    }
+    b->ArgNames({"gap", "growth"});
+}
+} // namespace
+
+BENCHMARK(BM_replace_all<impl::legacy>)
+    ->Name("replace_all/legacy")
+    ->Apply(args);
+BENCHMARK(BM_replace_all<impl::by_value>)
+    ->Name("replace_all/by_value")
+    ->Apply(args);
+BENCHMARK(BM_replace_all<impl::in_place>)
+    ->Name("replace_all/in_place")
+    ->Apply(args);
+BENCHMARK(BM_replace_all<impl::append>)
+    ->Name("replace_all/append")
+    ->Apply(args);
@@ -0,0 +1,173 @@
+#include <libutils/simd.hpp>
+#include <libutils/strings.hpp>
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+// 20k log records of ~100 bytes; one in 64 carries the needle near its end.
+std::vector<std::string> make_records(std::string const& needle)
+{
+    std::mt19937 gen{3};
+    std::uniform_int_distribution<int> len{60, 140};
+    std::uniform_int_distribution<int> ch{'a', 'z'};
+    std::vector<std::string> records(20000);
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        auto& record = records[i];
+        auto const size = static_cast<std::size_t>(len(gen));
+        while (record.size() < size) {
+            record += static_cast<char>(ch(gen));
+        }
+        if (i % 64 == 0) {
+            record += needle;
+        }
+    }
+    return records;
+}
+
+std::string make_needle(std::size_t const size)
+{
+    std::mt19937 gen{11};
+    std::uniform_int_distribution<int> ch{'a', 'z'};
+    std::string needle;
+    while (needle.size() < size) {
+        needle += static_cast<char>(ch(gen));
+    }
+    return needle;
+}
+
+enum class impl
+{
+    per_call,       // contains(record, needle): no reuse
+    std_horspool,   // std::boyer_moore_horspool_searcher built once
+    searcher,       // utils::strings::searcher built once
+    scalar,         // ... with SIMD dispatch disabled (Horspool when long)
+    searcher_icase, // ... ignoring case
+};
+
+template <impl Impl>
+void BM_records(benchmark::State& state)
+{
+    auto const needle = make_needle(static_cast<std::size_t>(state.range(0)));
+    auto const records = make_records(needle);
+    utils::strings::searcher<char> const compiled{needle,
+                                                  Impl == impl::searcher_icase};
+    std::boyer_moore_horspool_searcher const bmh{needle.begin(), needle.end()};
+    std::int64_t bytes = 0;
+    for (auto const& record : records) {
+        bytes += static_cast<std::int64_t>(record.size());
+    }
+
+    for (auto _ : state) {
+        std::size_t hits = 0;
+        for (auto const& record : records) {
+            if constexpr (Impl == impl::per_call) {
+                hits += utils::strings::contains<char>(record, needle) ? 1 : 0;
+            } else if constexpr (Impl == impl::std_horspool) {
+                hits += std::search(record.begin(), record.end(), bmh) !=
+                                record.end()
+                            ? 1
+                            : 0;
+            } else {
+                hits +=
+                    utils::strings::contains<char>(record, compiled) ? 1 : 0;
+            }
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+// One long haystack, where Horspool's skips pay off for long needles.
+template <impl Impl>
+void BM_document(benchmark::State& state)
+{
+    auto const needle = make_needle(static_cast<std::size_t>(state.range(0)));
+    std::string text;
+    for (auto const& record : make_records("")) {
+        text += record;
+    }
+    text += needle;
+    utils::strings::searcher<char> const compiled{needle,
+                                                  Impl == impl::searcher_icase};
+    std::boyer_moore_horspool_searcher const bmh{needle.begin(), needle.end()};
+
+    utils::simd::set_max_level(Impl == impl::scalar
+                                   ? utils::simd::level::scalar
+                                   : utils::simd::level::avx2);
+    for (auto _ : state) {
+        if constexpr (Impl == impl::per_call) {
+            benchmark::DoNotOptimize(
+                utils::strings::contains<char>(text, needle));
+        } else if constexpr (Impl == impl::std_horspool) {
+            benchmark::DoNotOptimize(
+                std::search(text.begin(), text.end(), bmh));
+        } else {
+            benchmark::DoNotOptimize(compiled.find(text));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+} // namespace
+
+BENCHMARK(BM_records<impl::per_call>)
+    ->Name("records/per_call")
+    ->Arg(8)
+    ->Arg(64);
+BENCHMARK(BM_records<impl::std_horspool>)
+    ->Name("records/std_horspool")
+    ->Arg(8)
+    ->Arg(64);
+BENCHMARK(BM_records<impl::searcher>)
+    ->Name("records/searcher")
+    ->Arg(8)
+    ->Arg(64);
+BENCHMARK(BM_records<impl::searcher_icase>)
+    ->Name("records/searcher_icase")
+    ->Arg(8)
+    ->Arg(64);
+BENCHMARK(BM_document<impl::per_call>)
+    ->Name("document/per_call")
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(33)
+    ->Arg(64)
+    ->Arg(256);
+BENCHMARK(BM_document<impl::std_horspool>)
+    ->Name("document/std_horspool")
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(33)
+    ->Arg(64)
+    ->Arg(256);
+BENCHMARK(BM_document<impl::searcher>)
+    ->Name("document/searcher")
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(33)
+    ->Arg(64)
+    ->Arg(256);
+BENCHMARK(BM_document<impl::scalar>)
+    ->Name("document/searcher_scalar")
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(33)
+    ->Arg(64)
+    ->Arg(256);
+BENCHMARK(BM_document<impl::searcher_icase>)
+    ->Name("document/searcher_icase")
+    ->Arg(8)
+    ->Arg(32)
+    ->Arg(33)
+    ->Arg(64)
+    ->Arg(256);
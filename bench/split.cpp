@@ -0,0 +1,125 @@
+#include <libutils/simd.hpp>
+#include <libutils/strings.hpp>
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+// The pre-vectorization split_view, kept verbatim as the baseline.
+std::vector<std::string_view> legacy_split_view(std::string_view const text,
+                                                std::string_view const delims,
+                                                bool const keep_empty)
+{
+    std::vector<std::string_view> tokens;
+    std::size_t pos = 0;
+    std::size_t prev_pos = 0;
+    while ((pos = text.find_first_of(delims, prev_pos)) !=
+           std::string_view::npos) {
+        if (pos > prev_pos || keep_empty) {
+            tokens.push_back(text.substr(prev_pos, pos - prev_pos));
+        }
+        prev_pos = pos + 1;
+    }
+    if (prev_pos < text.size() || keep_empty) {
+        tokens.push_back(text.substr(prev_pos));
+    }
+    return tokens;
+}
+
+// ~1 MiB of log-like records: `fields` columns of 2..24 printable characters
+// separated by `separator`, one record per line.
+std::string make_corpus(char const separator, std::size_t const fields)
+{
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<int> len{2, 24};
+    std::uniform_int_distribution<int> ch{'a', 'z'};
+    std::string corpus;
+    while (corpus.size() < (std::size_t{1} << 20U)) {
+        for (std::size_t f = 0; f < fields; ++f) {
+            corpus.append(static_cast<std::size_t>(len(gen)),
+                          static_cast<char>(ch(gen)));
+            corpus += (f + 1 == fields) ? '\n' : separator;
+        }
+    }
+    return corpus;
+}
+
+std::string const& corpus(char const separator)
+{
+    static std::string const csv = make_corpus(',', 12);
+    static std::string const tsv = make_corpus('\t', 12);
+    static std::string const ws = make_corpus(' ', 12);
+    return separator == ',' ? csv : separator == '\t' ? tsv : ws;
+}
+
+// Record separator plus field separator: the shape of a log ingest split.
+std::string_view delimiters(char const separator)
+{
+    return separator == ',' ? ",\n" : separator == '\t' ? "\t\n" : " \t\r\n";
+}
+
+enum class impl
+{
+    legacy,
+    scalar,
+    simd
+};
+
+template <char Separator, impl Impl>
+void BM_split_view(benchmark::State& state)
+{
+    auto const& text = corpus(Separator);
+    auto const delims = delimiters(Separator);
+    utils::simd::set_max_level(Impl == impl::scalar
+                                   ? utils::simd::level::scalar
+                                   : utils::simd::level::avx2);
+    for (auto _ : state) {
+        if constexpr (Impl == impl::legacy) {
+            benchmark::DoNotOptimize(legacy_split_view(text, delims, true));
+        } else {
+            benchmark::DoNotOptimize(
+                utils::strings::split_view<char>(text, delims, true));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+// Same scan without materializing a token vector.
+template <char Separator>
+void BM_split_lazy(benchmark::State& state)
+{
+    auto const& text = corpus(Separator);
+    auto const delims = delimiters(Separator);
+    for (auto _ : state) {
+        std::size_t bytes = 0;
+        for (auto const token :
+             utils::strings::split_lazy<char>(text, delims, true)) {
+            bytes += token.size();
+        }
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+} // namespace
+
+BENCHMARK(BM_split_view<',', impl::legacy>)->Name("split_view/csv/legacy");
+BENCHMARK(BM_split_view<',', impl::scalar>)->Name("split_view/csv/scalar");
+BENCHMARK(BM_split_view<',', impl::simd>)->Name("split_view/csv/simd");
+BENCHMARK(BM_split_view<'\t', impl::legacy>)->Name("split_view/tsv/legacy");
+BENCHMARK(BM_split_view<'\t', impl::scalar>)->Name("split_view/tsv/scalar");
+BENCHMARK(BM_split_view<'\t', impl::simd>)->Name("split_view/tsv/simd");
+BENCHMARK(BM_split_view<' ', impl::legacy>)->Name("split_view/ws/legacy");
+BENCHMARK(BM_split_view<' ', impl::scalar>)->Name("split_view/ws/scalar");
+BENCHMARK(BM_split_view<' ', impl::simd>)->Name("split_view/ws/simd");
+BENCHMARK(BM_split_lazy<','>)->Name("split_lazy/csv");
+BENCHMARK(BM_split_lazy<'\t'>)->Name("split_lazy/tsv");
+BENCHMARK(BM_split_lazy<' '>)->Name("split_lazy/ws");
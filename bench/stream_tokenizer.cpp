@@ -0,0 +1,108 @@
+#include <libutils/strings.hpp>
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace
+{
+constexpr std::size_t chunk_size = std::size_t{64} << 10U;
+
+// ~16 MiB of newline-delimited records of 20..120 printable characters.
+std::string const& corpus()
+{
+    static std::string const text = [] {
+        std::mt19937 gen{7};
+        std::uniform_int_distribution<int> len{20, 120};
+        std::uniform_int_distribution<int> ch{' ', '~'};
+        std::string out;
+        while (out.size() < (std::size_t{16} << 20U)) {
+            auto const n = len(gen);
+            for (int i = 0; i < n; ++i) {
+                out += static_cast<char>(ch(gen));
+            }
+            out += '\n';
+        }
+        return out;
+    }();
+    return text;
+}
+
+// Upper bound: count newlines with memchr over the same 64 KiB chunks.
+void BM_memchr_lines(benchmark::State& state)
+{
+    std::string_view const text = corpus();
+    for (auto _ : state) {
+        std::size_t lines = 0;
+        for (std::size_t pos = 0; pos < text.size(); pos += chunk_size) {
+            auto const chunk = text.substr(pos, chunk_size);
+            auto const* p = chunk.data();
+            auto const* const last = chunk.data() + chunk.size();
+            while ((p = static_cast<char const*>(std::memchr(
+                        p, '\n', static_cast<std::size_t>(last - p)))) !=
+                   nullptr) {
+                ++lines;
+                ++p;
+            }
+        }
+        benchmark::DoNotOptimize(lines);
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+
+void BM_stream_tokenizer(benchmark::State& state)
+{
+    std::string_view const text = corpus();
+    auto tokenizer = utils::strings::make_stream_tokenizer<char>('\n');
+    for (auto _ : state) {
+        std::size_t bytes = 0;
+        auto const count = [&](std::string_view const line) {
+            bytes += line.size();
+        };
+        for (std::size_t pos = 0; pos < text.size(); pos += chunk_size) {
+            tokenizer.feed(text.substr(pos, chunk_size), count);
+        }
+        tokenizer.finish(count);
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+
+// What callers did before: copy the straddling tail in front of the next read
+// and re-run split_view over the joined buffer.
+void BM_split_view_rescan(benchmark::State& state)
+{
+    std::string_view const text = corpus();
+    for (auto _ : state) {
+        std::size_t bytes = 0;
+        std::string pending;
+        for (std::size_t pos = 0; pos < text.size(); pos += chunk_size) {
+            pending.append(text.substr(pos, chunk_size));
+            auto const last_newline = pending.rfind('\n');
+            if (last_newline == std::string::npos) {
+                continue;
+            }
+            for (auto const line : utils::strings::split_view<char>(
+                     std::string_view{pending}.substr(0, last_newline),
+                     '\n')) {
+                bytes += line.size();
+            }
+            pending.erase(0, last_newline + 1);
+        }
+        bytes += pending.size();
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+} // namespace
+
+BENCHMARK(BM_memchr_lines)->Name("lines/memchr");
+BENCHMARK(BM_stream_tokenizer)->Name("lines/stream_tokenizer");
+BENCHMARK(BM_split_view_rescan)->Name("lines/split_view_rescan");
@@ -0,0 +1,136 @@
+#include <libutils/string_builder.hpp>
+#include <libutils/strings.hpp>
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+// 100k rows of three names and three numbers, written out as CSV: about
+// 6 MiB of output, as in a large report or API response.
+struct row
+{
+    std::array<std::string, 3> names;
+    std::array<std::int64_t, 3> numbers;
+};
+
+std::vector<row> const& rows()
+{
+    static std::vector<row> const out = [] {
+        std::mt19937 gen{17};
+        std::uniform_int_distribution<int> len{4, 16};
+        std::uniform_int_distribution<int> ch{'a', 'z'};
+        std::uniform_int_distribution<std::int64_t> number{-1000000, 1000000};
+        std::vector<row> v(100000);
+        for (auto& r : v) {
+            for (auto& name : r.names) {
+                name.assign(static_cast<std::size_t>(len(gen)),
+                            static_cast<char>(ch(gen)));
+            }
+            for (auto& n : r.numbers) {
+                n = number(gen);
+            }
+        }
+        return v;
+    }();
+    return out;
+}
+
+template <typename Out>
+void write_rows(Out& out)
+{
+    std::string_view const comma{","};
+    for (auto const& r : rows()) {
+        utils::strings::join_into(out, r.names, comma);
+        out += ',';
+        utils::strings::join_into(out, r.numbers, comma);
+        out += '\n';
+    }
+}
+
+void set_bytes(benchmark::State& state, std::size_t const size)
+{
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(size));
+}
+
+// One std::string grown by appending: every doubling copies what was written.
+void BM_string(benchmark::State& state)
+{
+    std::size_t size = 0;
+    for (auto _ : state) {
+        std::string out;
+        write_rows(out);
+        size = out.size();
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_bytes(state, size);
+}
+
+void BM_ostringstream(benchmark::State& state)
+{
+    std::size_t size = 0;
+    for (auto _ : state) {
+        std::ostringstream os;
+        for (auto const& r : rows()) {
+            os << r.names[0] << ',' << r.names[1] << ',' << r.names[2] << ','
+               << r.numbers[0] << ',' << r.numbers[1] << ',' << r.numbers[2]
+               << '\n';
+        }
+        auto const out = os.str();
+        size = out.size();
+        benchmark::DoNotOptimize(out.data());
+    }
+    set_bytes(state, size);
+}
+
+// The builder, finished with one to_string() copy.
+void BM_builder_to_string(benchmark::State& state)
+{
+    std::size_t size = 0;
+    for (auto _ : state) {
+        utils::strings::string_builder out;
+        write_rows(out);
+        auto const text = out.to_string();
+        size = text.size();
+        benchmark::DoNotOptimize(text.data());
+    }
+    set_bytes(state, size);
+}
+
+// The builder drawing from a pool that outlives it, read out chunk by chunk
+// (as writev would): no allocation and no copy after the first iteration.
+void BM_builder_pooled(benchmark::State& state)
+{
+    using utils::strings::chunk_pool;
+    chunk_pool pool(chunk_pool::default_chunk_size, 256);
+    std::size_t size = 0;
+    for (auto _ : state) {
+        utils::strings::string_builder out(pool);
+        write_rows(out);
+        out.for_each_chunk([](std::string_view const chunk) {
+            benchmark::DoNotOptimize(chunk.data());
+        });
+        size = out.size();
+    }
+    set_bytes(state, size);
+}
+} // namespace
+
+BENCHMARK(BM_string)->Name("csv/std::string")->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ostringstream)
+    ->Name("csv/ostringstream")
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_builder_to_string)
+    ->Name("csv/string_builder+to_string")
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_builder_pooled)
+    ->Name("csv/string_builder_pooled")
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,170 @@
+#include <libutils/hash.hpp>
+#include <libutils/strings.hpp>
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+// Command names of a text protocol; each benchmark dispatches over the first
+// N of them.
+constexpr std::array<std::string_view, 64> names = {
+    "get",      "set",       "del",       "incr",      "decr",
+    "expire",   "ttl",       "exists",    "keys",      "append",
+    "strlen",   "mget",      "mset",      "hget",      "hset",
+    "ping",     "hdel",      "hlen",      "hkeys",     "hvals",
+    "hgetall",  "hexists",   "hincrby",   "lpush",     "rpush",
+    "lpop",     "rpop",      "llen",      "lrange",    "lindex",
+    "lset",     "lrem",      "ltrim",     "sadd",      "srem",
+    "smembers", "sismember", "scard",     "spop",      "sunion",
+    "sinter",   "sdiff",     "zadd",      "zrem",      "zrange",
+    "zscore",   "zcard",     "zrank",     "zincrby",   "zcount",
+    "incrby",   "decrby",    "getset",    "setnx",     "setex",
+    "persist",  "pexpire",   "pttl",      "rename",    "type",
+    "select",   "flushdb",   "dbsize",    "echo"};
+
+template <std::size_t N>
+constexpr std::array<std::string_view, N> first_names()
+{
+    std::array<std::string_view, N> out{};
+    for (std::size_t i = 0; i < N; ++i) {
+        out[i] = names[i];
+    }
+    return out;
+}
+
+// 64 Ki commands, uniform over the first N names, with 1 in 16 unknown.
+template <std::size_t N>
+std::vector<std::string> const& stream()
+{
+    static std::vector<std::string> const out = [] {
+        std::mt19937 gen{3};
+        std::uniform_int_distribution<std::size_t> pick{0, N - 1};
+        std::vector<std::string> v(std::size_t{1} << 16U);
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            v[i] = i % 16 == 0 ? "unknown" : std::string{names[pick(gen)]};
+        }
+        return v;
+    }();
+    return out;
+}
+
+// Each benchmark maps every command to its case index (N when unknown).
+template <std::size_t N>
+void set_items(benchmark::State& state)
+{
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(stream<N>().size()));
+}
+
+// An if-chain of equal() calls, one per case in order.
+template <std::size_t N>
+std::size_t dispatch_if_chain(std::string_view const name)
+{
+    for (std::size_t i = 0; i < N; ++i) {
+        if (utils::strings::equal<char>(name, names[i])) {
+            return i;
+        }
+    }
+    return N;
+}
+
+template <std::size_t N>
+void BM_if_chain(benchmark::State& state)
+{
+    for (auto _ : state) {
+        std::size_t acc = 0;
+        for (auto const& name : stream<N>()) {
+            acc += dispatch_if_chain<N>(name);
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    set_items<N>(state);
+}
+
+template <std::size_t N>
+void BM_unordered_map(benchmark::State& state)
+{
+    std::unordered_map<std::string_view, std::size_t> map;
+    for (std::size_t i = 0; i < N; ++i) {
+        map.emplace(names[i], i);
+    }
+    for (auto _ : state) {
+        std::size_t acc = 0;
+        for (auto const& name : stream<N>()) {
+            auto const it = map.find(name);
+            acc += it == map.end() ? N : it->second;
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    set_items<N>(state);
+}
+
+template <std::size_t N>
+void BM_string_switch(benchmark::State& state)
+{
+    static constexpr utils::hash::string_switch<N> commands{first_names<N>()};
+    for (auto _ : state) {
+        std::size_t acc = 0;
+        for (auto const& name : stream<N>()) {
+            acc += commands.find(name);
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    set_items<N>(state);
+}
+
+// The intended use: a switch statement over the case indexes.
+constexpr auto small = utils::hash::make_string_switch("get", "set", "del",
+                                                       "incr", "decr", "ping");
+
+int dispatch_switch(std::string_view const name, int const arg)
+{
+    switch (small.find(name)) {
+    case small.index("get"):
+        return arg + 1;
+    case small.index("set"):
+        return arg * 3;
+    case small.index("del"):
+        return arg - 1;
+    case small.index("incr"):
+        return arg + 2;
+    case small.index("decr"):
+        return arg - 2;
+    case small.index("ping"):
+        return arg ^ 1;
+    default:
+        return -arg;
+    }
+}
+
+void BM_switch_statement(benchmark::State& state)
+{
+    for (auto _ : state) {
+        int acc = 0;
+        for (auto const& name : stream<8>()) {
+            acc = dispatch_switch(name, acc);
+        }
+        benchmark::DoNotOptimize(acc);
+    }
+    set_items<8>(state);
+}
+} // namespace
+
+BENCHMARK(BM_if_chain<8>)->Name("dispatch/if_chain/8");
+BENCHMARK(BM_unordered_map<8>)->Name("dispatch/unordered_map/8");
+BENCHMARK(BM_string_switch<8>)->Name("dispatch/string_switch/8");
+BENCHMARK(BM_if_chain<16>)->Name("dispatch/if_chain/16");
+BENCHMARK(BM_unordered_map<16>)->Name("dispatch/unordered_map/16");
+BENCHMARK(BM_string_switch<16>)->Name("dispatch/string_switch/16");
+BENCHMARK(BM_if_chain<64>)->Name("dispatch/if_chain/64");
+BENCHMARK(BM_unordered_map<64>)->Name("dispatch/unordered_map/64");
+BENCHMARK(BM_string_switch<64>)->Name("dispatch/string_switch/64");
+BENCHMARK(BM_switch_statement)->Name("dispatch/switch_statement");
@@ -0,0 +1,223 @@
+#include <libutils/simd.hpp>
+#include <libutils/strings.hpp>
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+constexpr utils::strings::char_class digits{"0123456789"};
+constexpr utils::strings::char_class separators{" \t,;"};
+
+// The pre-char_class trim: a predicate per character from each end.
+std::string_view legacy_trim(std::string_view const text)
+{
+    auto const first = std::find_if_not(
+        text.begin(), text.end(), utils::strings::detail::is_whitespace<char>);
+    if (first == text.end()) {
+        return {};
+    }
+    auto const last =
+        std::find_if_not(text.rbegin(), text.rend(),
+                         utils::strings::detail::is_whitespace<char>);
+    return {&*first, static_cast<std::size_t>(last.base() - first)};
+}
+
+// Short tokens with 0..3 whitespace characters on either side (the common
+// case of trimming parsed fields) when `padding` is 0, otherwise a few tokens
+// buried in `padding` characters of whitespace on each side.
+std::vector<std::string> make_tokens(std::size_t const padding)
+{
+    std::mt19937 gen{7};
+    std::uniform_int_distribution<int> len{1, 12};
+    std::uniform_int_distribution<int> ch{'a', 'z'};
+    std::uniform_int_distribution<std::size_t> pad{0, 3};
+    std::string_view const whitespace{" \t\r\n"};
+    std::vector<std::string> tokens(padding == 0 ? 4096 : 64);
+    for (auto& token : tokens) {
+        auto const spaces = [&] {
+            return std::string(padding == 0 ? pad(gen) : padding,
+                               whitespace[pad(gen)]);
+        };
+        token = spaces() +
+                std::string(static_cast<std::size_t>(len(gen)),
+                            static_cast<char>(ch(gen))) +
+                spaces();
+    }
+    return tokens;
+}
+
+std::vector<std::string> const& tokens(bool const padded)
+{
+    static std::vector<std::string> const short_tokens = make_tokens(0);
+    static std::vector<std::string> const long_padding = make_tokens(256);
+    return padded ? long_padding : short_tokens;
+}
+
+std::int64_t total_size(std::vector<std::string> const& items)
+{
+    std::size_t size = 0;
+    for (auto const& item : items) {
+        size += item.size();
+    }
+    return static_cast<std::int64_t>(size);
+}
+
+// ~1 MiB of log-like text: words, numbers and separators.
+std::string const& corpus()
+{
+    static std::string const text = [] {
+        std::mt19937 gen{42};
+        std::uniform_int_distribution<int> len{1, 10};
+        std::uniform_int_distribution<int> ch{'a', 'z'};
+        std::uniform_int_distribution<int> odds{0, 3};
+        std::string out;
+        while (out.size() < (std::size_t{1} << 20U)) {
+            if (odds(gen) == 0) {
+                out += std::to_string(gen() % 100000);
+            } else {
+                out.append(static_cast<std::size_t>(len(gen)),
+                           static_cast<char>(ch(gen)));
+            }
+            out += odds(gen) == 0 ? ", " : " ";
+        }
+        return out;
+    }();
+    return text;
+}
+
+void BM_legacy_trim(benchmark::State& state)
+{
+    auto const& items = tokens(state.range(0) != 0);
+    for (auto _ : state) {
+        for (auto const& item : items) {
+            benchmark::DoNotOptimize(legacy_trim(item));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * total_size(items));
+}
+
+template <utils::simd::level Level>
+void BM_trim_view(benchmark::State& state)
+{
+    auto const& items = tokens(state.range(0) != 0);
+    utils::simd::set_max_level(Level);
+    for (auto _ : state) {
+        for (auto const& item : items) {
+            benchmark::DoNotOptimize(utils::strings::trim_view(item));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * total_size(items));
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+void BM_legacy_count(benchmark::State& state)
+{
+    auto const& text = corpus();
+    std::string_view const set{"0123456789"};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            std::count_if(text.begin(), text.end(), [&](char const ch) {
+                return set.find(ch) != std::string_view::npos;
+            }));
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+
+template <utils::simd::level Level>
+void BM_count_in(benchmark::State& state)
+{
+    auto const& text = corpus();
+    utils::simd::set_max_level(Level);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utils::strings::count_in(text, digits));
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+void BM_legacy_remove(benchmark::State& state)
+{
+    auto const& text = corpus();
+    for (auto _ : state) {
+        auto copy = text;
+        copy.erase(std::remove_if(copy.begin(), copy.end(),
+                                  [](char const ch) {
+                                      return ch >= '0' && ch <= '9';
+                                  }),
+                   copy.end());
+        benchmark::DoNotOptimize(copy.data());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+
+template <utils::simd::level Level>
+void BM_remove(benchmark::State& state)
+{
+    auto const& text = corpus();
+    utils::simd::set_max_level(Level);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utils::strings::remove(text, digits).data());
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+// Splitting many short lines on the same set: the string overload builds its
+// byte_set per call, the char_class overload reuses a constant one.
+template <bool Class>
+void BM_split_lines(benchmark::State& state)
+{
+    auto const& text = corpus();
+    std::vector<std::string_view> lines;
+    for (std::size_t pos = 0; pos + 64 <= text.size(); pos += 64) {
+        lines.push_back(std::string_view{text}.substr(pos, 64));
+    }
+    for (auto _ : state) {
+        std::size_t count = 0;
+        for (auto const line : lines) {
+            if constexpr (Class) {
+                count += utils::strings::split_view(line, separators).size();
+            } else {
+                count += utils::strings::split_view<char>(line, " \t,;").size();
+            }
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(lines.size() * 64));
+}
+} // namespace
+
+// Arg 0: short tokens with 0..3 whitespace characters on each side; arg 1: a
+// few tokens with 256 on each side.
+BENCHMARK(BM_legacy_trim)->Name("trim/legacy")->Arg(0)->Arg(1);
+BENCHMARK(BM_trim_view<utils::simd::level::scalar>)
+    ->Name("trim/scalar")
+    ->Arg(0)
+    ->Arg(1);
+BENCHMARK(BM_trim_view<utils::simd::level::avx2>)
+    ->Name("trim/avx2")
+    ->Arg(0)
+    ->Arg(1);
+
+BENCHMARK(BM_legacy_count)->Name("count_in/legacy");
+BENCHMARK(BM_count_in<utils::simd::level::scalar>)->Name("count_in/scalar");
+BENCHMARK(BM_count_in<utils::simd::level::avx2>)->Name("count_in/avx2");
+
+BENCHMARK(BM_legacy_remove)->Name("remove/legacy");
+BENCHMARK(BM_remove<utils::simd::level::scalar>)->Name("remove/scalar");
+BENCHMARK(BM_remove<utils::simd::level::avx2>)->Name("remove/avx2");
+
+BENCHMARK(BM_split_lines<false>)->Name("split_view/string_set");
+BENCHMARK(BM_split_lines<true>)->Name("split_view/char_class");
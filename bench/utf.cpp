@@ -0,0 +1,242 @@
+#include <libutils/simd.hpp>
+#include <libutils/strings.hpp>
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+// The per-code-point converter used at the system boundary, as the baseline:
+// decode and validate one sequence, append its units, repeat.
+std::u16string legacy_utf8_to_utf16(std::string_view const text)
+{
+    std::u16string out;
+    std::size_t i = 0;
+    while (i < text.size()) {
+        auto const lead = static_cast<unsigned char>(text[i]);
+        std::size_t size = 1;
+        char32_t cp = lead;
+        char32_t min = 0;
+        if (lead >= 0xF0) {
+            size = 4, cp = lead & 0x07U, min = 0x10000;
+        } else if (lead >= 0xE0) {
+            size = 3, cp = lead & 0x0FU, min = 0x800;
+        } else if (lead >= 0xC0) {
+            size = 2, cp = lead & 0x1FU, min = 0x80;
+        } else if (lead >= 0x80) {
+            throw std::invalid_argument("invalid UTF-8");
+        }
+        if (i + size > text.size()) {
+            throw std::invalid_argument("invalid UTF-8");
+        }
+        for (std::size_t k = 1; k < size; ++k) {
+            auto const b = static_cast<unsigned char>(text[i + k]);
+            if ((b & 0xC0U) != 0x80U) {
+                throw std::invalid_argument("invalid UTF-8");
+            }
+            cp = (cp << 6U) | (b & 0x3FU);
+        }
+        if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+            throw std::invalid_argument("invalid UTF-8");
+        }
+        if (cp >= 0x10000) {
+            out.push_back(static_cast<char16_t>(0xD7C0 + (cp >> 10U)));
+            out.push_back(static_cast<char16_t>(0xDC00 | (cp & 0x3FFU)));
+        } else {
+            out.push_back(static_cast<char16_t>(cp));
+        }
+        i += size;
+    }
+    return out;
+}
+
+std::string legacy_utf16_to_utf8(std::u16string_view const text)
+{
+    std::string out;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        char32_t cp = text[i];
+        if (cp >= 0xD800 && cp <= 0xDFFF) {
+            if (cp > 0xDBFF || i + 1 == text.size() || text[i + 1] < 0xDC00 ||
+                text[i + 1] > 0xDFFF) {
+                throw std::invalid_argument("invalid UTF-16");
+            }
+            cp = 0x10000 + ((cp - 0xD800) << 10U) + (text[++i] - 0xDC00U);
+        }
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xC0U | (cp >> 6U)));
+            out.push_back(static_cast<char>(0x80U | (cp & 0x3FU)));
+        } else if (cp < 0x10000) {
+            out.push_back(static_cast<char>(0xE0U | (cp >> 12U)));
+            out.push_back(static_cast<char>(0x80U | ((cp >> 6U) & 0x3FU)));
+            out.push_back(static_cast<char>(0x80U | (cp & 0x3FU)));
+        } else {
+            out.push_back(static_cast<char>(0xF0U | (cp >> 18U)));
+            out.push_back(static_cast<char>(0x80U | ((cp >> 12U) & 0x3FU)));
+            out.push_back(static_cast<char>(0x80U | ((cp >> 6U) & 0x3FU)));
+            out.push_back(static_cast<char>(0x80U | (cp & 0x3FU)));
+        }
+    }
+    return out;
+}
+
+// ~1 MiB of UTF-8 text. ASCII-heavy: English-like words with an accented
+// word every ~50. CJK-heavy: ideographs with ASCII punctuation and spaces
+// every few characters.
+std::string const& corpus(bool const cjk)
+{
+    auto const make = [](bool const ideographs) {
+        std::mt19937 gen{ideographs ? 2U : 1U};
+        std::uniform_int_distribution<int> letter{'a', 'z'};
+        std::uniform_int_distribution<std::uint32_t> han{0x4E00, 0x9FFF};
+        std::uniform_int_distribution<int> length{2, 9};
+        std::uniform_int_distribution<int> odds{0, 49};
+        std::string out;
+        while (out.size() < (std::size_t{1} << 20U)) {
+            auto const n = length(gen);
+            for (int i = 0; i < n; ++i) {
+                if (ideographs) {
+                    utils::strings::detail::append_utf8(out, han(gen));
+                } else {
+                    out += static_cast<char>(letter(gen));
+                }
+            }
+            if (!ideographs && odds(gen) == 0) {
+                out += "\xC3\xA9"; // é
+            }
+            out += ideographs && odds(gen) < 40 ? "\xEF\xBC\x8C" : " ";
+        }
+        return out;
+    };
+    static std::string const ascii = make(false);
+    static std::string const ideographs = make(true);
+    return cjk ? ideographs : ascii;
+}
+
+void set_bytes(benchmark::State& state, std::string const& text)
+{
+    state.SetBytesProcessed(state.iterations() *
+                            static_cast<std::int64_t>(text.size()));
+}
+
+void BM_validate(benchmark::State& state, bool const cjk,
+                 utils::simd::level const l)
+{
+    auto const& text = corpus(cjk);
+    utils::simd::set_max_level(l);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utils::strings::is_valid_utf8(text));
+    }
+    set_bytes(state, text);
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+void BM_count(benchmark::State& state, bool const cjk,
+              utils::simd::level const l)
+{
+    auto const& text = corpus(cjk);
+    utils::simd::set_max_level(l);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(utils::strings::utf16_size(text));
+    }
+    set_bytes(state, text);
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+void BM_legacy_to_utf16(benchmark::State& state, bool const cjk)
+{
+    auto const& text = corpus(cjk);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacy_utf8_to_utf16(text));
+    }
+    set_bytes(state, text);
+}
+
+// Validating conversion into a buffer sized once with utf16_size().
+void BM_to_utf16(benchmark::State& state, bool const cjk,
+                 utils::simd::level const l)
+{
+    auto const& text = corpus(cjk);
+    std::vector<char16_t> out(utils::strings::utf16_size(text));
+    utils::simd::set_max_level(l);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            utils::strings::utf8_to_utf16_into(out, text));
+    }
+    set_bytes(state, text);
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+void BM_legacy_from_utf16(benchmark::State& state, bool const cjk)
+{
+    auto const& text = corpus(cjk);
+    auto const utf16 = utils::strings::utf8_to_utf16(text);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacy_utf16_to_utf8(utf16));
+    }
+    set_bytes(state, text);
+}
+
+void BM_from_utf16(benchmark::State& state, bool const cjk,
+                   utils::simd::level const l)
+{
+    auto const& text = corpus(cjk);
+    auto const utf16 = utils::strings::utf8_to_utf16(text);
+    std::vector<char> out(text.size());
+    utils::simd::set_max_level(l);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            utils::strings::utf16_to_utf8_into(out, utf16));
+    }
+    set_bytes(state, text);
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+void BM_to_utf32(benchmark::State& state, bool const cjk,
+                 utils::simd::level const l)
+{
+    auto const& text = corpus(cjk);
+    std::vector<char32_t> out(utils::strings::utf32_size(text));
+    utils::simd::set_max_level(l);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            utils::strings::utf8_to_utf32_into(out, text));
+    }
+    set_bytes(state, text);
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+} // namespace
+
+// Throughput is in UTF-8 bytes for every direction.
+#define UTF_BENCH(fn, name)                                                    \
+    BENCHMARK_CAPTURE(fn, ascii_scalar, false, utils::simd::level::scalar)     \
+        ->Name(name "/ascii/scalar");                                          \
+    BENCHMARK_CAPTURE(fn, ascii_avx2, false, utils::simd::level::avx2)         \
+        ->Name(name "/ascii/avx2");                                            \
+    BENCHMARK_CAPTURE(fn, cjk_scalar, true, utils::simd::level::scalar)        \
+        ->Name(name "/cjk/scalar");                                            \
+    BENCHMARK_CAPTURE(fn, cjk_avx2, true, utils::simd::level::avx2)            \
+        ->Name(name "/cjk/avx2")
+
+UTF_BENCH(BM_validate, "validate");
+UTF_BENCH(BM_count, "utf16_size");
+
+BENCHMARK_CAPTURE(BM_legacy_to_utf16, ascii, false)
+    ->Name("utf8_to_utf16/ascii/legacy");
+BENCHMARK_CAPTURE(BM_legacy_to_utf16, cjk, true)
+    ->Name("utf8_to_utf16/cjk/legacy");
+UTF_BENCH(BM_to_utf16, "utf8_to_utf16");
+UTF_BENCH(BM_to_utf32, "utf8_to_utf32");
+
+BENCHMARK_CAPTURE(BM_legacy_from_utf16, ascii, false)
+    ->Name("utf16_to_utf8/ascii/legacy");
+BENCHMARK_CAPTURE(BM_legacy_from_utf16, cjk, true)
+    ->Name("utf16_to_utf8/cjk/legacy");
+UTF_BENCH(BM_from_utf16, "utf16_to_utf8");
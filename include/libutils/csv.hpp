@@ -0,0 +1,411 @@
+#pragma once
+
+#include <libutils/polyfill.hpp>
+#include <libutils/simd.hpp>
+#include <libutils/threading.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * RFC 4180 CSV over an in-memory buffer (a string, or a memory-mapped file).
+ *
+ * Fields are separated by the dialect's delimiter and rows end at "\n" or
+ * "\r\n". A field that starts with the quote character runs to the matching
+ * closing quote and may contain delimiters, newlines and doubled ("escaped")
+ * quotes. Like split_view(..., keep_empty = true), every field is reported,
+ * empty ones included.
+ *
+ * Parsing is zero-copy: fields are views into the input, except those with
+ * escaped quotes, which are unescaped into a scratch buffer owned by the
+ * reader. Input is classified 64 bytes at a time into quote / delimiter /
+ * newline bitmasks (simd::match_block64), and the parser walks the set bits
+ * rather than the bytes.
+ *
+ * Malformed input is read leniently rather than rejected: characters between a
+ * closing quote and the next separator are appended to the field, and an
+ * unterminated quoted field runs to the end of the input.
+ */
+namespace utils::strings::csv
+{
+struct dialect
+{
+    char delimiter{','};
+    char quote{'"'};
+};
+
+namespace detail
+{
+inline void check_dialect(dialect const d)
+{
+    if (d.delimiter == d.quote || d.delimiter == '\n' || d.delimiter == '\r' ||
+        d.quote == '\n' || d.quote == '\r') {
+        throw std::invalid_argument(
+            "csv: delimiter and quote must differ and not be line breaks");
+    }
+}
+
+// Answers "where is the next quote / separator at or after pos" from the
+// bitmasks of the current 64-byte block, classifying each block once.
+class block_scanner
+{
+public:
+    block_scanner(std::string_view const text, dialect const d) noexcept
+        : text_(text), dialect_(d)
+    {}
+
+    // Next delimiter or '\n' at or after `pos`; text.size() if none.
+    [[nodiscard]] std::size_t next_separator(std::size_t const pos) noexcept
+    {
+        return next(pos, false);
+    }
+
+    // Next quote at or after `pos`; text.size() if none.
+    [[nodiscard]] std::size_t next_quote(std::size_t const pos) noexcept
+    {
+        return next(pos, true);
+    }
+
+private:
+    static constexpr std::size_t block_size = 64;
+
+    [[nodiscard]] std::size_t next(std::size_t pos, bool const quotes) noexcept
+    {
+        while (pos < text_.size()) {
+            auto const block = pos & ~(block_size - 1);
+            if (block != block_) {
+                load(block);
+            }
+            auto const candidates = quotes ? masks_.b : (masks_.a | masks_.c);
+            auto const bits =
+                candidates & (~std::uint64_t{0} << (pos - block));
+            if (bits != 0) {
+                return block +
+                       static_cast<std::size_t>(utils::countr_zero(bits));
+            }
+            pos = block + block_size;
+        }
+        return text_.size();
+    }
+
+    void load(std::size_t const block) noexcept
+    {
+        block_ = block;
+        auto const available = text_.size() - block;
+        if (available >= block_size) {
+            masks_ = simd::match_block64(text_.data() + block,
+                                         dialect_.delimiter, dialect_.quote,
+                                         '\n');
+            return;
+        }
+        // The tail is classified from a padded copy; bits past the end of the
+        // input are cleared so the padding never matches.
+        char padded[block_size] = {};
+        std::memcpy(padded, text_.data() + block, available);
+        masks_ = simd::match_block64(padded, dialect_.delimiter,
+                                     dialect_.quote, '\n');
+        auto const valid = (std::uint64_t{1} << available) - 1;
+        masks_.a &= valid;
+        masks_.b &= valid;
+        masks_.c &= valid;
+    }
+
+    std::string_view text_;
+    dialect dialect_;
+    std::size_t block_{static_cast<std::size_t>(-1)};
+    simd::block_masks masks_;
+};
+} // namespace detail
+
+/**
+ * Reads rows one at a time into a reused buffer of field views.
+ *
+ *     csv::reader rows{text};
+ *     while (rows.next()) {
+ *         for (std::string_view const field : rows.row()) { ... }
+ *     }
+ *
+ * The input must outlive the reader. row() is valid until the next call to
+ * next(); fields that needed unescaping point into the reader itself.
+ */
+class reader
+{
+public:
+    explicit reader(std::string_view const text, dialect const d = {})
+        : text_(text), dialect_(d), scanner_(text, d)
+    {
+        detail::check_dialect(d);
+    }
+
+    // Parse the next row; false once the input is exhausted. An empty input
+    // has no rows, and a final line break does not start another one.
+    [[nodiscard]] bool next()
+    {
+        if (pos_ >= text_.size()) {
+            return false;
+        }
+        fields_.clear();
+        scratch_.clear();
+        escaped_.clear();
+
+        auto const size = text_.size();
+        for (;;) {
+            auto const quoted = pos_ < size && text_[pos_] == dialect_.quote;
+            auto const separator = quoted ? quoted_field() : plain_field();
+            if (separator == size || text_[separator] == '\n') {
+                pos_ = separator == size ? size : separator + 1;
+                break;
+            }
+            pos_ = separator + 1;
+        }
+
+        // Scratch may have been reallocated while the row was read, so the
+        // unescaped fields are only pointed into it now.
+        for (auto const& field : escaped_) {
+            fields_[field.index] =
+                std::string_view(scratch_.data() + field.offset, field.size);
+        }
+        ++rows_;
+        return true;
+    }
+
+    // The fields of the current row.
+    [[nodiscard]] utils::span<std::string_view const> row() const noexcept
+    {
+        return {fields_.data(), fields_.size()};
+    }
+
+    // Rows read so far.
+    [[nodiscard]] std::size_t rows() const noexcept { return rows_; }
+
+    // Offset of the first byte of the input not yet read.
+    [[nodiscard]] std::size_t offset() const noexcept { return pos_; }
+
+private:
+    struct escaped_field
+    {
+        std::size_t index;
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    // An unquoted field runs to the next separator; a '\r' right before a
+    // line break belongs to the line break. Returns the separator position.
+    std::size_t plain_field()
+    {
+        auto const separator = scanner_.next_separator(pos_);
+        auto end = separator;
+        if ((separator == text_.size() || text_[separator] == '\n') &&
+            end > pos_ && text_[end - 1] == '\r') {
+            --end;
+        }
+        fields_.push_back(text_.substr(pos_, end - pos_));
+        return separator;
+    }
+
+    // A quoted field: its content, then anything up to the next separator
+    // (nothing, or a lone '\r', in well-formed input).
+    std::size_t quoted_field()
+    {
+        auto const size = text_.size();
+        auto const content = pos_ + 1;
+        auto close = content;
+        bool escaped = false;
+        for (;;) {
+            close = scanner_.next_quote(close);
+            if (close + 1 < size && text_[close + 1] == dialect_.quote) {
+                escaped = true;
+                close += 2;
+                continue;
+            }
+            break;
+        }
+
+        auto const after = close == size ? size : close + 1;
+        auto const separator = scanner_.next_separator(after);
+        auto tail_end = separator;
+        if ((separator == size || text_[separator] == '\n') &&
+            tail_end > after && text_[tail_end - 1] == '\r') {
+            --tail_end;
+        }
+
+        if (!escaped && tail_end == after) {
+            fields_.push_back(text_.substr(content, close - content));
+            return separator;
+        }
+
+        auto const offset = scratch_.size();
+        unescape(text_.substr(content, close - content));
+        scratch_.append(text_.data() + after, tail_end - after);
+        escaped_.push_back({fields_.size(), offset, scratch_.size() - offset});
+        fields_.emplace_back();
+        return separator;
+    }
+
+    // Append `content` to the scratch buffer with each doubled quote halved.
+    void unescape(std::string_view content)
+    {
+        for (;;) {
+            auto const quote = content.find(dialect_.quote);
+            if (quote == std::string_view::npos) {
+                scratch_.append(content.data(), content.size());
+                return;
+            }
+            scratch_.append(content.data(), quote + 1);
+            content.remove_prefix(std::min(quote + 2, content.size()));
+        }
+    }
+
+    std::string_view text_;
+    dialect dialect_;
+    detail::block_scanner scanner_;
+    std::size_t pos_{0};
+    std::size_t rows_{0};
+    std::vector<std::string_view> fields_;
+    std::string scratch_;
+    std::vector<escaped_field> escaped_;
+};
+
+// Call fn(row) for every row of `text`, where row is a
+// utils::span<std::string_view const> valid for the duration of the call.
+template <typename Fn>
+void for_each_row(std::string_view const text, Fn&& fn, dialect const d = {})
+{
+    reader rows{text, d};
+    while (rows.next()) {
+        fn(rows.row());
+    }
+}
+
+namespace detail
+{
+// The first row boundary at or after `pos`, knowing whether `pos` is inside a
+// quoted field. Returns text.size() if there is none.
+[[nodiscard]] inline std::size_t row_start_after(std::string_view const text,
+                                                 std::size_t const pos,
+                                                 bool in_quotes,
+                                                 dialect const d) noexcept
+{
+    char const structural[] = {d.quote, '\n'};
+    simd::byte_set const set(std::string_view(structural, 2));
+    auto const* p = text.data() + pos;
+    auto const* const last = text.data() + text.size();
+    for (;;) {
+        p = simd::find_first_of(p, last, set);
+        if (p == last) {
+            return text.size();
+        }
+        if (*p == d.quote) {
+            in_quotes = !in_quotes;
+        } else if (!in_quotes) {
+            return static_cast<std::size_t>(p + 1 - text.data());
+        }
+        ++p;
+    }
+}
+
+// Split at row boundaries near `parts` equally spaced cut points, given the
+// number of quotes in each of the `parts` equal segments of `text`. Quotes
+// toggle the quoted state (a doubled quote toggles twice), so the parity of
+// the quotes before a cut point says whether it falls inside a quoted field.
+[[nodiscard]] inline std::vector<std::string_view>
+split_rows(std::string_view const text,
+           std::vector<std::size_t> const& quote_counts, dialect const d)
+{
+    auto const parts = quote_counts.size();
+    std::vector<std::string_view> chunks;
+    std::size_t start = 0;
+    std::size_t quotes = 0;
+    for (std::size_t k = 1; k < parts && start < text.size(); ++k) {
+        quotes += quote_counts[k - 1];
+        auto const cut = text.size() / parts * k;
+        if (cut < start) {
+            continue;
+        }
+        auto const boundary = row_start_after(text, cut, quotes % 2 != 0, d);
+        if (boundary > start) {
+            chunks.push_back(text.substr(start, boundary - start));
+            start = boundary;
+        }
+    }
+    if (start < text.size()) {
+        chunks.push_back(text.substr(start));
+    }
+    return chunks;
+}
+
+// Bounds of segment `k` of `parts` equal segments of a `size`-byte input; the
+// last one takes the remainder.
+[[nodiscard]] inline std::pair<std::size_t, std::size_t>
+segment(std::size_t const size, std::size_t const parts,
+        std::size_t const k) noexcept
+{
+    auto const step = size / parts;
+    return {step * k, k + 1 == parts ? size : step * (k + 1)};
+}
+} // namespace detail
+
+// Split `text` into at most `parts` consecutive chunks that each start at the
+// beginning of a row, so that each can be parsed independently. For RFC 4180
+// input, reading the chunks one after the other yields exactly the rows of
+// reading `text`; a stray quote inside an unquoted field can shift a boundary.
+[[nodiscard]] inline std::vector<std::string_view>
+split_rows(std::string_view const text, std::size_t const parts,
+           dialect const d = {})
+{
+    detail::check_dialect(d);
+    auto const n = std::max<std::size_t>(parts, 1);
+    std::vector<std::size_t> quote_counts(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        auto const [first, last] = detail::segment(text.size(), n, k);
+        quote_counts[k] =
+            simd::count(text.data() + first, text.data() + last, d.quote);
+    }
+    return detail::split_rows(text, quote_counts, d);
+}
+
+// Parse `text` on up to `n_threads` threads. The input is cut into chunks at
+// row boundaries (see split_rows(); the quote counting runs in parallel too)
+// and each chunk is read by its own thread, which calls
+// fn(chunk, row) for each of its rows in order, with `chunk` < n_threads
+// identifying the chunk (and so the thread): chunks are consecutive, so
+// per-chunk accumulators merged in chunk order give the sequential result.
+// `fn` must be safe to call concurrently for different chunks. The first
+// exception thrown by `fn` is rethrown once every thread has finished.
+template <typename Fn>
+void parallel_for_each_row(std::string_view const text,
+                           std::size_t const n_threads, Fn&& fn,
+                           dialect const d = {})
+{
+    detail::check_dialect(d);
+    auto const parts =
+        utils::threading::parallel_chunks(text.size(), n_threads);
+
+    std::vector<std::size_t> quote_counts(parts);
+    std::vector<std::string_view> chunks;
+    if (parts == 1) {
+        chunks.push_back(text);
+    } else {
+        utils::threading::run_chunks(parts, [&](std::size_t const k) {
+            auto const [first, last] = detail::segment(text.size(), parts, k);
+            quote_counts[k] =
+                simd::count(text.data() + first, text.data() + last, d.quote);
+        });
+        chunks = detail::split_rows(text, quote_counts, d);
+    }
+
+    utils::threading::run_chunks(chunks.size(), [&](std::size_t const k) {
+        reader rows{chunks[k], d};
+        while (rows.next()) {
+            fn(k, rows.row());
+        }
+    });
+}
+} // namespace utils::strings::csv
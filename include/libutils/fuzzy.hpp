@@ -0,0 +1,359 @@
+#pragma once
+
+#include <libutils/strings.hpp>
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Levenshtein distance (insertions, deletions and substitutions, each costing
+ * one) with Myers' bit-parallel algorithm, in Hyyrö's formulation: a column of
+ * the dynamic-programming matrix is kept as bit vectors of +1/-1 vertical
+ * differences and advanced by one text character with a handful of word
+ * operations, so strings of up to 64 characters take O(n) time instead of
+ * O(nm). Longer ones are split into 64-row blocks that pass the horizontal
+ * difference at their last row down to the next block.
+ *
+ * The bounded form stops as soon as the distance must exceed a limit: the
+ * last row of the matrix can drop by at most one per remaining column.
+ *
+ * fuzzy_find_best() picks the closest of many candidates. The needle's bit
+ * vectors are built once, and candidates are first filtered by length and by
+ * the q-gram lemma (strings within distance k share at least
+ * max(m, n) - q + 1 - kq of their q-grams), with the bound tightening as
+ * better matches are found.
+ *
+ * Example usage:
+ * utils::strings::edit_distance("kitten", "sitting"); // 3
+ * auto const match = utils::strings::fuzzy_find_best("db-01.exmaple.com",
+ *                                                    hosts, 3);
+ * if (match) { use(hosts[match.index]); }
+ */
+namespace utils::strings
+{
+namespace detail
+{
+// The match bit vectors (Peq) of a pattern: bit i of masks(c)[b] is set when
+// pattern[64b + i] == c.
+template <typename CharT>
+class edit_pattern
+{
+public:
+    using unit = std::make_unsigned_t<CharT>;
+
+    explicit edit_pattern(tstringview<CharT> const pattern)
+        : size_(pattern.size()), blocks_((pattern.size() + 63) / 64)
+    {
+        if constexpr (sizeof(CharT) == 1) {
+            masks_.assign((std::size_t{UCHAR_MAX} + 1) * blocks_, 0);
+            for (std::size_t i = 0; i < size_; ++i) {
+                auto const c = static_cast<unit>(pattern[i]);
+                masks_[c * blocks_ + i / 64] |= std::uint64_t{1} << (i % 64);
+            }
+        } else {
+            // The pattern's alphabet, sorted for lookup, plus a zero row for
+            // everything else.
+            alphabet_.assign(pattern.begin(), pattern.end());
+            std::sort(alphabet_.begin(), alphabet_.end());
+            alphabet_.erase(std::unique(alphabet_.begin(), alphabet_.end()),
+                            alphabet_.end());
+            masks_.assign((alphabet_.size() + 1) * blocks_, 0);
+            for (std::size_t i = 0; i < size_; ++i) {
+                auto const c = row(pattern[i]);
+                masks_[c * blocks_ + i / 64] |= std::uint64_t{1} << (i % 64);
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+    [[nodiscard]] std::uint64_t const* masks(CharT const c) const noexcept
+    {
+        return masks_.data() + row(c) * blocks_;
+    }
+
+    // The distance to `text`, or limit + 1 if it is larger than `limit`.
+    [[nodiscard]] std::size_t distance(tstringview<CharT> const text,
+                                       std::size_t limit) const
+    {
+        auto const m = size_;
+        auto const n = text.size();
+        limit = std::min(limit, std::max(m, n));
+        if ((m > n ? m - n : n - m) > limit) {
+            return limit + 1;
+        }
+        if (m == 0 || n == 0) {
+            return std::max(m, n);
+        }
+        return blocks_ == 1 ? distance_word(text, limit)
+                            : distance_blocks(text, limit);
+    }
+
+private:
+    [[nodiscard]] std::size_t row(CharT const c) const noexcept
+    {
+        if constexpr (sizeof(CharT) == 1) {
+            return static_cast<unit>(c);
+        } else {
+            auto const it =
+                std::lower_bound(alphabet_.begin(), alphabet_.end(), c);
+            return it != alphabet_.end() && *it == c
+                       ? static_cast<std::size_t>(it - alphabet_.begin())
+                       : alphabet_.size();
+        }
+    }
+
+    std::size_t distance_word(tstringview<CharT> const text,
+                              std::size_t const limit) const noexcept
+    {
+        auto const n = text.size();
+        auto const last = std::uint64_t{1} << (size_ - 1);
+        std::uint64_t pv = ~std::uint64_t{0};
+        std::uint64_t mv = 0;
+        auto score = size_;
+        for (std::size_t j = 0; j < n; ++j) {
+            auto const eq = *masks(text[j]);
+            auto const xv = eq | mv;
+            auto const xh = (((eq & pv) + pv) ^ pv) | eq;
+            auto ph = mv | ~(xh | pv);
+            auto mh = pv & xh;
+            score += (ph & last) != 0 ? 1 : 0;
+            score -= (mh & last) != 0 ? 1 : 0;
+            // The first row of the matrix grows by one per column.
+            ph = (ph << 1U) | 1U;
+            mh <<= 1U;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+            // The remaining n - j - 1 columns can lower the score by at most
+            // one each.
+            if (score > limit + (n - j - 1)) {
+                return limit + 1;
+            }
+        }
+        return score;
+    }
+
+    std::size_t distance_blocks(tstringview<CharT> const text,
+                                std::size_t const limit) const
+    {
+        auto const n = text.size();
+        auto const high = std::uint64_t{1} << 63U;
+        auto const last = std::uint64_t{1} << ((size_ - 1) % 64);
+        std::vector<std::uint64_t> pv(blocks_, ~std::uint64_t{0});
+        std::vector<std::uint64_t> mv(blocks_, 0);
+        auto score = size_;
+        for (std::size_t j = 0; j < n; ++j) {
+            auto const* const eqs = masks(text[j]);
+            // The horizontal difference entering the block from above: +1
+            // along the first row.
+            int carry = 1;
+            for (std::size_t b = 0; b < blocks_; ++b) {
+                auto eq = eqs[b];
+                auto const xv = eq | mv[b];
+                if (carry < 0) {
+                    eq |= 1U;
+                }
+                auto const xh = (((eq & pv[b]) + pv[b]) ^ pv[b]) | eq;
+                auto ph = mv[b] | ~(xh | pv[b]);
+                auto mh = pv[b] & xh;
+                auto const out = b + 1 == blocks_ ? last : high;
+                auto const next_carry =
+                    (ph & out) != 0 ? 1 : ((mh & out) != 0 ? -1 : 0);
+                ph <<= 1U;
+                mh <<= 1U;
+                if (carry < 0) {
+                    mh |= 1U;
+                } else if (carry > 0) {
+                    ph |= 1U;
+                }
+                pv[b] = mh | ~(xv | ph);
+                mv[b] = ph & xv;
+                carry = next_carry;
+            }
+            score += carry > 0 ? 1 : 0;
+            score -= carry < 0 ? 1 : 0;
+            if (score > limit + (n - j - 1)) {
+                return limit + 1;
+            }
+        }
+        return score;
+    }
+
+    std::size_t size_;
+    std::size_t blocks_;
+    std::vector<CharT> alphabet_;
+    std::vector<std::uint64_t> masks_;
+};
+
+// Bigram counts hashed into 256 buckets. Collisions can only add to the
+// counted common bigrams, so the q-gram filter stays a safe lower bound.
+template <typename CharT>
+class bigram_profile
+{
+public:
+    using counts_type = std::array<std::uint16_t, 256>;
+
+    explicit bigram_profile(tstringview<CharT> const text) noexcept
+    {
+        for (std::size_t i = 1; i < text.size(); ++i) {
+            auto& count = counts_[bucket(text[i - 1], text[i])];
+            count = static_cast<std::uint16_t>(
+                count < UINT16_MAX ? count + 1 : count);
+        }
+    }
+
+    // Bigrams of `text` matched by distinct bigrams of the profile.
+    [[nodiscard]] std::size_t
+    common(tstringview<CharT> const text) const noexcept
+    {
+        auto left = counts_;
+        std::size_t shared = 0;
+        for (std::size_t i = 1; i < text.size(); ++i) {
+            auto& count = left[bucket(text[i - 1], text[i])];
+            if (count != 0) {
+                --count;
+                ++shared;
+            }
+        }
+        return shared;
+    }
+
+private:
+    static std::size_t bucket(CharT const a, CharT const b) noexcept
+    {
+        using unit = std::make_unsigned_t<CharT>;
+        auto const h = static_cast<std::uint32_t>(static_cast<unit>(a)) * 31U +
+                       static_cast<std::uint32_t>(static_cast<unit>(b));
+        return (h ^ (h >> 8U)) & 255U;
+    }
+
+    counts_type counts_{};
+};
+} // namespace detail
+
+// ----------
+// Edit distance
+// ----------
+
+// The Levenshtein distance between `a` and `b` if it is at most `limit`,
+// limit + 1 otherwise; the scan stops as soon as the limit is exceeded.
+template <typename CharT>
+[[nodiscard]] inline std::size_t edit_distance(tstringview<CharT> a,
+                                               tstringview<CharT> b,
+                                               std::size_t const limit)
+{
+    // A common prefix and suffix never change the distance.
+    auto const prefix = static_cast<std::size_t>(
+        std::mismatch(a.begin(), a.end(), b.begin(), b.end()).first -
+        a.begin());
+    a.remove_prefix(prefix);
+    b.remove_prefix(prefix);
+    auto const suffix = static_cast<std::size_t>(
+        std::mismatch(a.rbegin(), a.rend(), b.rbegin(), b.rend()).first -
+        a.rbegin());
+    a.remove_suffix(suffix);
+    b.remove_suffix(suffix);
+    // The shorter string is the pattern: fewer 64-row blocks.
+    if (a.size() > b.size()) {
+        std::swap(a, b);
+    }
+    return detail::edit_pattern<CharT>(a).distance(b, limit);
+}
+
+// The Levenshtein distance between `a` and `b`.
+template <typename CharT>
+[[nodiscard]] inline std::size_t edit_distance(tstringview<CharT> const a,
+                                               tstringview<CharT> const b)
+{
+    return edit_distance(a, b, std::max(a.size(), b.size()));
+}
+
+[[nodiscard]] inline std::size_t edit_distance(std::string_view const a,
+                                               std::string_view const b,
+                                               std::size_t const limit)
+{
+    return edit_distance<char>(a, b, limit);
+}
+
+[[nodiscard]] inline std::size_t edit_distance(std::string_view const a,
+                                               std::string_view const b)
+{
+    return edit_distance<char>(a, b);
+}
+
+// ----------
+// Fuzzy matching
+// ----------
+
+// The closest candidate found by fuzzy_find_best(): its position in the
+// candidates and its distance. Converts to false when no candidate was within
+// the limit.
+struct fuzzy_match
+{
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    std::size_t index{npos};
+    std::size_t distance{npos};
+
+    [[nodiscard]] constexpr explicit operator bool() const noexcept
+    {
+        return index != npos;
+    }
+};
+
+// The candidate closest to `needle` by edit distance, if any is within
+// `max_distance`; ties go to the earliest candidate. `candidates` is a range
+// of anything convertible to tstringview<CharT>. Candidates are ruled out by
+// length and shared bigrams before being scored, and scoring stops early
+// once a candidate cannot beat the best so far.
+template <typename CharT, typename C>
+[[nodiscard]] fuzzy_match
+fuzzy_find_best(tstringview<CharT> const needle, C const& candidates,
+                std::size_t const max_distance = fuzzy_match::npos)
+{
+    detail::edit_pattern<CharT> const pattern(needle);
+    detail::bigram_profile<CharT> const profile(needle);
+    auto const m = needle.size();
+
+    fuzzy_match best;
+    auto limit = max_distance;
+    std::size_t index = 0;
+    for (auto const& element : candidates) {
+        tstringview<CharT> const candidate(element);
+        auto const n = candidate.size();
+        auto const current = index++;
+        if ((m > n ? m - n : n - m) > limit) {
+            continue;
+        }
+        // q-gram lemma with q = 2.
+        auto const longest = std::max(m, n);
+        if (limit < longest && longest - 1 > 2 * limit &&
+            profile.common(candidate) < longest - 1 - 2 * limit) {
+            continue;
+        }
+        auto const distance = pattern.distance(candidate, limit);
+        if (distance <= limit) {
+            best = {current, distance};
+            if (distance == 0) {
+                break;
+            }
+            limit = distance - 1;
+        }
+    }
+    return best;
+}
+
+template <typename C>
+[[nodiscard]] fuzzy_match
+fuzzy_find_best(std::string_view const needle, C const& candidates,
+                std::size_t const max_distance = fuzzy_match::npos)
+{
+    return fuzzy_find_best<char>(needle, candidates, max_distance);
+}
+} // namespace utils::strings
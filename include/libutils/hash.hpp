@@ -1,9 +1,13 @@
 #pragma once
 
+#include <array>
 #include <climits>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
 
 /**
  * hash_combine taken from boost. Example implementation for a Point type:
@@ -25,6 +29,18 @@
  *         }
  *     };
  *     }
+ *
+ * hash_string is a constexpr string hash that gives the same value at compile
+ * time and at run time, and string_switch builds on it to dispatch on a fixed
+ * set of strings (command names, keywords) with one hash, one table lookup and
+ * one final comparison instead of a chain of comparisons:
+ *
+ *     constexpr auto commands = utils::hash::make_string_switch("get", "set");
+ *     switch (commands.find(name)) {
+ *     case commands.index("get"): ...
+ *     case commands.index("set"): ...
+ *     default: // not a command
+ *     }
  */
 
 namespace utils::hash
@@ -85,7 +101,7 @@ struct hash_mix_impl;
 template <>
 struct hash_mix_impl<64>
 {
-    static std::uint64_t fn(std::uint64_t x)
+    static constexpr std::uint64_t fn(std::uint64_t x)
     {
         std::uint64_t const m = 0xe9846af9b1a615d;
         x ^= x >> 32U;
@@ -105,7 +121,7 @@ struct hash_mix_impl<64>
 template <>
 struct hash_mix_impl<32>
 {
-    static std::uint32_t fn(std::uint32_t x)
+    static constexpr std::uint32_t fn(std::uint32_t x)
     {
         std::uint32_t const m1 = 0x21f0aaad;
         std::uint32_t const m2 = 0x735a2d97;
@@ -118,7 +134,7 @@ struct hash_mix_impl<32>
     }
 };
 
-inline std::size_t hash_mix(std::size_t v)
+constexpr std::size_t hash_mix(std::size_t v)
 {
     return hash_mix_impl<sizeof(std::size_t) * CHAR_BIT>::fn(v);
 }
@@ -133,4 +149,240 @@ inline void combine(std::size_t& seed, T const& v)
             : static_cast<std::size_t>(0x9e3779b9U);
     seed = detail::hash_mix(seed + magic + std::hash<T>()(v));
 }
+
+// ----------
+// String hashing
+// ----------
+
+namespace detail
+{
+// `count` code units from `pos`, packed little-endian into a 64 bit word.
+template <typename CharT>
+constexpr std::uint64_t pack_units(std::basic_string_view<CharT> const text,
+                                   std::size_t const pos,
+                                   std::size_t const count) noexcept
+{
+    using unit = std::make_unsigned_t<CharT>;
+    std::uint64_t word = 0;
+    for (std::size_t k = 0; k < count; ++k) {
+        word |= std::uint64_t{static_cast<unit>(text[pos + k])}
+                << (k * sizeof(CharT) * CHAR_BIT);
+    }
+    return word;
+}
+
+// The code units packed into 64 bit words (eight chars, four char16_t...),
+// each folded in with a multiply, then the 64 bit mixer. A partial last word
+// is read as two overlapping halves, or for one to three units as its first,
+// middle and last unit, as short-input hashes such as wyhash do: that covers
+// every unit with fixed-size reads, and the length, mixed in at the end,
+// tells the overlaps apart. The words are assembled with shifts so that the
+// hash stays constexpr; compilers turn the fixed-size ones into single loads.
+template <typename CharT>
+constexpr std::uint64_t hash_string64(
+    std::basic_string_view<CharT> const text) noexcept
+{
+    constexpr std::size_t per_word = sizeof(std::uint64_t) / sizeof(CharT);
+    constexpr std::size_t half = per_word / 2;
+    constexpr std::uint64_t m = 0x9e3779b97f4a7c15ULL;
+
+    auto const fold = [](std::uint64_t h, std::uint64_t const word) {
+        h = (h ^ word) * m;
+        return h ^ (h >> 32U);
+    };
+    std::uint64_t h = 0;
+    std::size_t i = 0;
+    for (; i + per_word <= text.size(); i += per_word) {
+        h = fold(h, pack_units(text, i, per_word));
+    }
+    auto const rest = text.size() - i;
+    if (rest >= half && rest != 0) {
+        h = fold(h, pack_units(text, i, half) |
+                        pack_units(text, i + rest - half, half) << 32U);
+    } else if (rest != 0) {
+        // Only reached by units of at most 2 bytes, so three fit a word.
+        if constexpr (half > 1) {
+            constexpr auto bits = sizeof(CharT) * CHAR_BIT;
+            h = fold(h, pack_units(text, i, 1) |
+                            pack_units(text, i + rest / 2, 1) << bits |
+                            pack_units(text, i + rest - 1, 1) << (2 * bits));
+        }
+    }
+    return hash_mix_impl<64>::fn(h ^ text.size());
+}
+
+constexpr unsigned ceil_log2(std::size_t const n) noexcept
+{
+    unsigned bits = 0;
+    while ((std::size_t{1} << bits) < n) {
+        ++bits;
+    }
+    return bits;
+}
+} // namespace detail
+
+// A hash of `text` usable in constant expressions, equal to the value computed
+// at run time for the same code units.
+template <typename CharT>
+[[nodiscard]] constexpr std::size_t
+hash_string(std::basic_string_view<CharT> const text) noexcept
+{
+    return static_cast<std::size_t>(detail::hash_string64(text));
+}
+
+[[nodiscard]] constexpr std::size_t
+hash_string(std::string_view const text) noexcept
+{
+    return hash_string<char>(text);
+}
+
+// ----------
+// String dispatch
+// ----------
+
+// A perfect hash table over N distinct strings, built at compile time by
+// hash and displace: the cases are spread over about N buckets, and each
+// bucket, largest first, gets the smallest displacement that moves all of its
+// cases to free slots of a table of 2N or more. find() hashes its argument
+// once, reads the bucket's displacement and one slot, and confirms the match
+// with one hash and one string comparison.
+template <std::size_t N, typename CharT = char>
+class string_switch
+{
+    static_assert(N > 0 && N < 0xffff,
+                  "string_switch: the number of cases must be 1..65534");
+
+public:
+    using view_type = std::basic_string_view<CharT>;
+
+    // Throws std::invalid_argument (a compile error when constexpr) if two
+    // cases are equal.
+    constexpr explicit string_switch(std::array<view_type, N> const& cases)
+        : cases_(cases)
+    {
+        // Cases by bucket, as linked lists through `next`.
+        std::array<slot_type, buckets> head{};
+        std::array<slot_type, buckets> count{};
+        std::array<slot_type, N> next{};
+        for (auto& h : head) {
+            h = static_cast<slot_type>(N);
+        }
+        for (auto& slot : table_) {
+            slot = static_cast<slot_type>(N);
+        }
+        std::size_t largest = 0;
+        for (std::size_t i = 0; i < N; ++i) {
+            hashes_[i] = detail::hash_string64(cases_[i]);
+            auto const b = hashes_[i] & (buckets - 1);
+            for (auto j = head[b]; j != N; j = next[j]) {
+                if (hashes_[j] == hashes_[i]) {
+                    throw std::invalid_argument(
+                        "string_switch: duplicate case");
+                }
+            }
+            next[i] = head[b];
+            head[b] = static_cast<slot_type>(i);
+            ++count[b];
+            largest = count[b] > largest ? count[b] : largest;
+        }
+        for (auto size = largest; size > 0; --size) {
+            for (std::size_t b = 0; b < buckets; ++b) {
+                if (count[b] == size) {
+                    place(head[b], next, b);
+                }
+            }
+        }
+    }
+
+    // The index of `text` among the cases, or size() if it is none of them.
+    [[nodiscard]] constexpr std::size_t
+    find(view_type const text) const noexcept
+    {
+        auto const h = detail::hash_string64(text);
+        std::size_t const i = table_[slot(h, disp_[h & (buckets - 1)])];
+        return i != N && hashes_[i] == h && cases_[i] == text ? i : N;
+    }
+
+    // The index of case `label`, for case labels; throws std::invalid_argument
+    // (a compile error when constexpr) if it is not a case.
+    [[nodiscard]] constexpr std::size_t index(view_type const label) const
+    {
+        auto const i = find(label);
+        if (i == N) {
+            throw std::invalid_argument("string_switch: unknown case");
+        }
+        return i;
+    }
+
+    [[nodiscard]] static constexpr std::size_t size() noexcept { return N; }
+
+    [[nodiscard]] constexpr view_type operator[](std::size_t const i) const
+    {
+        return cases_[i];
+    }
+
+private:
+    using slot_type =
+        std::conditional_t<(N < 0xff), std::uint8_t, std::uint16_t>;
+
+    static constexpr std::size_t buckets = std::size_t{1}
+                                           << detail::ceil_log2(N);
+    static constexpr std::size_t slots = 2 * buckets;
+
+    // The slot of a hash for a displacement: the high half of the hash plus
+    // `d` odd steps taken from the middle bits, so each bucket sees a
+    // different sequence.
+    static constexpr std::size_t slot(std::uint64_t const h,
+                                      std::uint16_t const d) noexcept
+    {
+        return static_cast<std::size_t>(((h >> 32U) + d * ((h >> 16U) | 1U)) &
+                                        (slots - 1));
+    }
+
+    constexpr void place(slot_type const first,
+                         std::array<slot_type, N> const& next,
+                         std::size_t const bucket)
+    {
+        for (std::uint32_t d = 0; d <= 0xffff; ++d) {
+            auto const disp = static_cast<std::uint16_t>(d);
+            auto fits = true;
+            for (auto i = first; i != N; i = next[i]) {
+                auto& slot_index = table_[slot(hashes_[i], disp)];
+                if (slot_index != N) {
+                    fits = false;
+                    break;
+                }
+                slot_index = i;
+            }
+            if (fits) {
+                disp_[bucket] = disp;
+                return;
+            }
+            // Undo the cases placed before the collision.
+            for (auto i = first; i != N; i = next[i]) {
+                auto& slot_index = table_[slot(hashes_[i], disp)];
+                if (slot_index != i) {
+                    break;
+                }
+                slot_index = static_cast<slot_type>(N);
+            }
+        }
+        throw std::invalid_argument("string_switch: no collision-free table");
+    }
+
+    std::array<view_type, N> cases_{};
+    std::array<std::uint64_t, N> hashes_{};
+    std::array<std::uint16_t, buckets> disp_{};
+    std::array<slot_type, slots> table_{};
+};
+
+// A string_switch over the given string literals (or other string views).
+template <typename... Cases>
+[[nodiscard]] constexpr string_switch<sizeof...(Cases)>
+make_string_switch(Cases const&... cases)
+{
+    return string_switch<sizeof...(Cases)>(
+        std::array<std::string_view, sizeof...(Cases)>{
+            std::string_view(cases)...});
+}
 } // namespace utils::hash
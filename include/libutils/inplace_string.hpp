@@ -0,0 +1,325 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * A string of at most N characters stored inline: no allocation, and copies
+ * are a memcpy of the object (it is trivially copyable), so it suits keys and
+ * labels built on a hot path and passed around by value.
+ *
+ * It has the subset of the std::basic_string interface the library uses, and
+ * the mutating algorithms of strings.hpp (to_upper, trim, pad_left, the
+ * character replace_all...) accept it. Growing past N is an error: the
+ * checked operations (append, push_back, resize, insert...) throw
+ * std::out_of_range and leave the string unchanged, like the library's other
+ * functions writing to a fixed buffer. append_truncated() and truncated()
+ * keep what fits instead.
+ *
+ * The characters are always followed by a null terminator, so c_str() is
+ * valid. Positions past size() are not initialized.
+ *
+ * Example usage:
+ * utils::strings::inplace_string<32> key("user:");
+ * key.append(name).push_back(':');
+ * utils::strings::append_padded(key, id, 8); // "user:alice:00000042"
+ */
+namespace utils::strings
+{
+template <std::size_t N, typename CharT = char>
+class inplace_string
+{
+public:
+    using traits_type = std::char_traits<CharT>;
+    using value_type = CharT;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = CharT&;
+    using const_reference = CharT const&;
+    using pointer = CharT*;
+    using const_pointer = CharT const*;
+    using iterator = CharT*;
+    using const_iterator = CharT const*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using view_type = std::basic_string_view<CharT>;
+
+    static constexpr size_type npos = view_type::npos;
+
+    inplace_string() noexcept { set_size(0); }
+
+    // Throws std::out_of_range if `text` is longer than N.
+    explicit inplace_string(view_type const text) { assign(text); }
+
+    // Throws std::out_of_range if `count` is larger than N.
+    inplace_string(size_type const count, CharT const ch)
+    {
+        set_size(0);
+        append(count, ch);
+    }
+
+    // The first N characters of `text`.
+    [[nodiscard]] static inplace_string truncated(view_type const text) noexcept
+    {
+        inplace_string out;
+        out.append_truncated(text);
+        return out;
+    }
+
+    // ----------
+    // Access
+    // ----------
+
+    [[nodiscard]] CharT* data() noexcept { return data_; }
+    [[nodiscard]] CharT const* data() const noexcept { return data_; }
+    [[nodiscard]] CharT const* c_str() const noexcept { return data_; }
+
+    [[nodiscard]] size_type size() const noexcept { return size_; }
+    [[nodiscard]] size_type length() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] static constexpr size_type capacity() noexcept { return N; }
+    [[nodiscard]] static constexpr size_type max_size() noexcept { return N; }
+
+    // Characters that can still be appended.
+    [[nodiscard]] size_type available() const noexcept { return N - size_; }
+
+    [[nodiscard]] CharT& operator[](size_type const pos) noexcept
+    {
+        return data_[pos];
+    }
+    [[nodiscard]] CharT const& operator[](size_type const pos) const noexcept
+    {
+        return data_[pos];
+    }
+
+    [[nodiscard]] CharT& front() noexcept { return data_[0]; }
+    [[nodiscard]] CharT const& front() const noexcept { return data_[0]; }
+    [[nodiscard]] CharT& back() noexcept { return data_[size_ - 1]; }
+    [[nodiscard]] CharT const& back() const noexcept
+    {
+        return data_[size_ - 1];
+    }
+
+    [[nodiscard]] iterator begin() noexcept { return data_; }
+    [[nodiscard]] iterator end() noexcept { return data_ + size_; }
+    [[nodiscard]] const_iterator begin() const noexcept { return data_; }
+    [[nodiscard]] const_iterator end() const noexcept { return data_ + size_; }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+    [[nodiscard]] const_iterator cend() const noexcept { return end(); }
+    [[nodiscard]] reverse_iterator rbegin() noexcept
+    {
+        return reverse_iterator{end()};
+    }
+    [[nodiscard]] reverse_iterator rend() noexcept
+    {
+        return reverse_iterator{begin()};
+    }
+    [[nodiscard]] const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator{end()};
+    }
+    [[nodiscard]] const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator{begin()};
+    }
+
+    [[nodiscard]] view_type view() const noexcept { return {data_, size_}; }
+    operator view_type() const noexcept { return view(); }
+
+    // ----------
+    // Checked modifiers
+    // ----------
+
+    void clear() noexcept { set_size(0); }
+
+    inplace_string& assign(view_type const text)
+    {
+        check(text.size());
+        // `text` may be a view of this string.
+        traits_type::move(data_, text.data(), text.size());
+        set_size(text.size());
+        return *this;
+    }
+
+    inplace_string& append(CharT const* const text, size_type const count)
+    {
+        check_append(count);
+        traits_type::copy(data_ + size_, text, count);
+        set_size(size_ + count);
+        return *this;
+    }
+
+    inplace_string& append(view_type const text)
+    {
+        return append(text.data(), text.size());
+    }
+
+    inplace_string& append(size_type const count, CharT const ch)
+    {
+        check_append(count);
+        traits_type::assign(data_ + size_, count, ch);
+        set_size(size_ + count);
+        return *this;
+    }
+
+    inplace_string& operator+=(view_type const text) { return append(text); }
+
+    inplace_string& operator+=(CharT const ch)
+    {
+        push_back(ch);
+        return *this;
+    }
+
+    void push_back(CharT const ch)
+    {
+        check_append(1);
+        data_[size_] = ch;
+        set_size(size_ + 1);
+    }
+
+    void pop_back() noexcept { set_size(size_ - 1); }
+
+    void resize(size_type const count, CharT const ch = CharT{})
+    {
+        check(count);
+        if (count > size_) {
+            traits_type::assign(data_ + size_, count - size_, ch);
+        }
+        set_size(count);
+    }
+
+    // Insert `count` copies of `ch` before position `pos` (<= size()).
+    inplace_string& insert(size_type const pos, size_type const count,
+                           CharT const ch)
+    {
+        check_append(count);
+        traits_type::move(data_ + pos + count, data_ + pos, size_ - pos);
+        traits_type::assign(data_ + pos, count, ch);
+        set_size(size_ + count);
+        return *this;
+    }
+
+    // Remove up to `count` characters from position `pos` (<= size()).
+    inplace_string& erase(size_type const pos = 0, size_type count = npos)
+    {
+        count = count < size_ - pos ? count : size_ - pos;
+        traits_type::move(data_ + pos, data_ + pos + count,
+                          size_ - pos - count);
+        set_size(size_ - count);
+        return *this;
+    }
+
+    iterator erase(const_iterator const first, const_iterator const last)
+    {
+        auto const pos = static_cast<size_type>(first - data_);
+        erase(pos, static_cast<size_type>(last - first));
+        return data_ + pos;
+    }
+
+    // ----------
+    // Truncating modifiers
+    // ----------
+
+    // Append as much of `text` as fits; returns whether all of it did.
+    bool append_truncated(view_type const text) noexcept
+    {
+        auto const count =
+            text.size() < available() ? text.size() : available();
+        traits_type::copy(data_ + size_, text.data(), count);
+        set_size(size_ + count);
+        return count == text.size();
+    }
+
+    bool append_truncated(size_type count, CharT const ch) noexcept
+    {
+        auto const fits = count <= available();
+        count = fits ? count : available();
+        traits_type::assign(data_ + size_, count, ch);
+        set_size(size_ + count);
+        return fits;
+    }
+
+    // ----------
+    // Comparison
+    // ----------
+
+    [[nodiscard]] friend bool operator==(inplace_string const& lhs,
+                                         inplace_string const& rhs) noexcept
+    {
+        return lhs.view() == rhs.view();
+    }
+    [[nodiscard]] friend bool operator==(inplace_string const& lhs,
+                                         view_type const rhs) noexcept
+    {
+        return lhs.view() == rhs;
+    }
+    [[nodiscard]] friend bool operator==(view_type const lhs,
+                                         inplace_string const& rhs) noexcept
+    {
+        return lhs == rhs.view();
+    }
+    [[nodiscard]] friend bool operator!=(inplace_string const& lhs,
+                                         inplace_string const& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+    [[nodiscard]] friend bool operator!=(inplace_string const& lhs,
+                                         view_type const rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+    [[nodiscard]] friend bool operator!=(view_type const lhs,
+                                         inplace_string const& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+    [[nodiscard]] friend bool operator<(inplace_string const& lhs,
+                                        inplace_string const& rhs) noexcept
+    {
+        return lhs.view() < rhs.view();
+    }
+
+    friend std::basic_ostream<CharT>& operator<<(std::basic_ostream<CharT>& os,
+                                                 inplace_string const& text)
+    {
+        return os << text.view();
+    }
+
+private:
+    // The smallest unsigned type that holds N.
+    using size_storage = std::conditional_t<
+        N <= UINT8_MAX, std::uint8_t,
+        std::conditional_t<N <= UINT16_MAX, std::uint16_t,
+                           std::conditional_t<N <= UINT32_MAX, std::uint32_t,
+                                              std::size_t>>>;
+
+    static void check(size_type const size)
+    {
+        if (size > N) {
+            throw std::out_of_range("inplace_string: capacity exceeded");
+        }
+    }
+
+    void check_append(size_type const count) const
+    {
+        if (count > available()) {
+            throw std::out_of_range("inplace_string: capacity exceeded");
+        }
+    }
+
+    void set_size(size_type const size) noexcept
+    {
+        size_ = static_cast<size_storage>(size);
+        data_[size] = CharT{};
+    }
+
+    size_storage size_;
+    CharT data_[N + 1];
+};
+} // namespace utils::strings
@@ -0,0 +1,456 @@
+#pragma once
+
+#include <libutils/collections.hpp>
+#include <libutils/hash.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * String interning: each distinct string is stored once and named by a 32-bit
+ * symbol id, so records that repeat the same few thousand host, metric or tag
+ * names hold 4-byte ids instead of std::string copies, and compare them with
+ * an integer comparison.
+ *
+ * Strings are copied back to back into an arena of fixed-size chunks (a string
+ * longer than half a chunk gets one of its own) that is never moved, so the
+ * views handed out stay valid until the pool is cleared or destroyed. Ids are
+ * dense, starting at 0 in insertion order, and view(id) is an index into a
+ * vector.
+ * The index is an open-addressing table of (id, hash tag) slots with linear
+ * probing; hashes are std::hash of the view run through utils::hash's mixer,
+ * and are kept per symbol so growing the table does not rehash any string.
+ *
+ * intern_pool is not thread-safe; sharded_intern_pool splits the strings over
+ * independently locked pools by hash.
+ *
+ * Example usage:
+ * utils::strings::intern_pool pool;
+ * auto const host = pool.intern("db-01.example.com");
+ * assert(pool.intern("db-01.example.com") == host);
+ * assert(pool.view(host) == "db-01.example.com");
+ */
+namespace utils::strings
+{
+namespace detail
+{
+[[nodiscard]] inline std::size_t intern_hash(std::string_view const text)
+{
+    return utils::hash::detail::hash_mix(std::hash<std::string_view>{}(text));
+}
+} // namespace detail
+
+template <std::size_t Shards>
+class sharded_intern_pool;
+
+class intern_pool
+{
+public:
+    using id_type = std::uint32_t;
+
+    static constexpr std::size_t default_chunk_size = std::size_t{64} << 10U;
+
+    // A pool whose arena grows by `chunk_size` bytes at a time.
+    explicit intern_pool(std::size_t const chunk_size = default_chunk_size)
+        : chunk_size_(std::max<std::size_t>(chunk_size, 1))
+    {}
+
+    // The id of `text`, copying it into the pool first if it is new. Throws
+    // std::length_error if the pool already holds max_size() strings.
+    id_type intern(std::string_view const text)
+    {
+        return intern(text, detail::intern_hash(text));
+    }
+
+    // The id of `text` if it has been interned.
+    [[nodiscard]] std::optional<id_type>
+    find(std::string_view const text) const noexcept
+    {
+        return find(text, detail::intern_hash(text));
+    }
+
+    // The string named by `id`, which must come from this pool.
+    [[nodiscard]] std::string_view view(id_type const id) const noexcept
+    {
+        return views_[id];
+    }
+
+    // As view(), but throws std::out_of_range for an unknown id.
+    [[nodiscard]] std::string_view at(id_type const id) const
+    {
+        if (id >= views_.size()) {
+            throw std::out_of_range("intern_pool: unknown id");
+        }
+        return views_[id];
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return views_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return views_.empty(); }
+
+    [[nodiscard]] static constexpr std::size_t max_size() noexcept
+    {
+        return std::numeric_limits<id_type>::max();
+    }
+
+    // Total length of the interned strings.
+    [[nodiscard]] std::size_t string_bytes() const noexcept
+    {
+        return string_bytes_;
+    }
+
+    // Bytes allocated by the pool, counted like collections::areaof(): the
+    // capacity of every buffer it owns plus the object itself.
+    [[nodiscard]] std::size_t area() const noexcept
+    {
+        return sizeof(*this) + arena_bytes_ +
+               collections::areaof(chunks_) - sizeof(chunks_) +
+               collections::areaof(views_) - sizeof(views_) +
+               collections::areaof(hashes_) - sizeof(hashes_) +
+               collections::areaof(slots_) - sizeof(slots_);
+    }
+
+    // Make room for `count` strings without growing the index.
+    void reserve(std::size_t const count)
+    {
+        views_.reserve(count);
+        hashes_.reserve(count);
+        if (count > capacity_limit()) {
+            rehash(table_size_for(count));
+        }
+    }
+
+    // Forget every string, releasing the arena. Ids and views handed out
+    // before are invalidated.
+    void clear() noexcept
+    {
+        chunks_.clear();
+        views_.clear();
+        hashes_.clear();
+        slots_.clear();
+        cursor_ = nullptr;
+        remaining_ = 0;
+        arena_bytes_ = 0;
+        string_bytes_ = 0;
+    }
+
+private:
+    template <std::size_t Shards>
+    friend class sharded_intern_pool;
+
+    // id + 1, so that a zeroed slot is empty, and a tag from the hash to
+    // skip most mismatches without touching the string.
+    struct slot
+    {
+        std::uint32_t id_plus_one;
+        std::uint32_t tag;
+    };
+
+    // Bits 24..55 of the hash. The slot index comes from the low bits, so
+    // entries in one probe run share those, and sharded_intern_pool picks the
+    // shard from the top 8, which entries of one shard share.
+    [[nodiscard]] static std::uint32_t tag_of(std::size_t const hash) noexcept
+    {
+        return static_cast<std::uint32_t>(hash >> 24U);
+    }
+
+    // Where `text` is or would go in slots_, which must not be empty.
+    [[nodiscard]] std::size_t probe(std::string_view const text,
+                                    std::size_t const hash) const noexcept
+    {
+        auto const mask = slots_.size() - 1;
+        auto const tag = tag_of(hash);
+        for (auto i = hash & mask;; i = (i + 1) & mask) {
+            auto const& s = slots_[i];
+            if (s.id_plus_one == 0 ||
+                (s.tag == tag && views_[s.id_plus_one - 1] == text)) {
+                return i;
+            }
+        }
+    }
+
+    [[nodiscard]] std::optional<id_type>
+    find(std::string_view const text, std::size_t const hash) const noexcept
+    {
+        if (slots_.empty()) {
+            return std::nullopt;
+        }
+        auto const& s = slots_[probe(text, hash)];
+        if (s.id_plus_one == 0) {
+            return std::nullopt;
+        }
+        return s.id_plus_one - 1;
+    }
+
+    id_type intern(std::string_view const text, std::size_t const hash,
+                   std::size_t const limit = max_size())
+    {
+        if (size() + 1 > capacity_limit()) {
+            rehash(table_size_for(size() + 1));
+        }
+        auto& s = slots_[probe(text, hash)];
+        if (s.id_plus_one != 0) {
+            return s.id_plus_one - 1;
+        }
+        if (size() >= limit) {
+            throw std::length_error("intern_pool: too many strings");
+        }
+        auto const id = static_cast<id_type>(views_.size());
+        views_.push_back(store(text));
+        try {
+            hashes_.push_back(hash);
+        } catch (...) {
+            views_.pop_back();
+            throw;
+        }
+        s = slot{id + 1, tag_of(hash)};
+        return id;
+    }
+
+    // Copy `text` into the arena.
+    std::string_view store(std::string_view const text)
+    {
+        if (text.empty()) {
+            return {};
+        }
+        if (text.size() > remaining_) {
+            // A string that would waste most of a fresh chunk gets a chunk of
+            // its own, leaving the current one to be filled.
+            if (text.size() > chunk_size_ / 2) {
+                auto* const data = allocate(text.size());
+                std::memcpy(data, text.data(), text.size());
+                string_bytes_ += text.size();
+                return {data, text.size()};
+            }
+            cursor_ = allocate(chunk_size_);
+            remaining_ = chunk_size_;
+        }
+        auto* const data = cursor_;
+        std::memcpy(data, text.data(), text.size());
+        cursor_ += text.size();
+        remaining_ -= text.size();
+        string_bytes_ += text.size();
+        return {data, text.size()};
+    }
+
+    [[nodiscard]] char* allocate(std::size_t const size)
+    {
+        // Owned before emplace_back(), which may throw while growing chunks_.
+        std::unique_ptr<char[]> chunk(new char[size]);
+        chunks_.emplace_back(std::move(chunk));
+        arena_bytes_ += size;
+        return chunks_.back().get();
+    }
+
+    // The index is kept at most 3/4 full.
+    [[nodiscard]] std::size_t capacity_limit() const noexcept
+    {
+        return slots_.size() / 4 * 3;
+    }
+
+    [[nodiscard]] static std::size_t table_size_for(std::size_t const count)
+    {
+        std::size_t size = 16;
+        while (size / 4 * 3 < count) {
+            size *= 2;
+        }
+        return size;
+    }
+
+    void rehash(std::size_t const size)
+    {
+        std::vector<slot> slots(size, slot{0, 0});
+        auto const mask = size - 1;
+        for (std::size_t id = 0; id < hashes_.size(); ++id) {
+            auto i = hashes_[id] & mask;
+            while (slots[i].id_plus_one != 0) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = slot{static_cast<std::uint32_t>(id + 1),
+                            tag_of(hashes_[id])};
+        }
+        slots_.swap(slots);
+    }
+
+    std::size_t chunk_size_;
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    char* cursor_{nullptr};
+    std::size_t remaining_{0};
+    std::size_t arena_bytes_{0};
+    std::size_t string_bytes_{0};
+    std::vector<std::string_view> views_;
+    std::vector<std::size_t> hashes_;
+    std::vector<slot> slots_;
+};
+
+/**
+ * A thread-safe intern_pool: strings are spread by hash over `Shards` pools,
+ * each behind its own reader/writer lock, so threads interning different
+ * strings rarely contend. Ids stay 32-bit and O(1) to resolve: the low bits
+ * name the shard and the rest the id within it. Ids are unique but, unlike
+ * intern_pool's, not dense.
+ */
+template <std::size_t Shards = 16>
+class sharded_intern_pool
+{
+    static_assert(Shards != 0 && (Shards & (Shards - 1)) == 0 && Shards <= 256,
+                  "sharded_intern_pool: Shards must be a power of two, at "
+                  "most 256");
+
+public:
+    using id_type = intern_pool::id_type;
+
+    explicit sharded_intern_pool(
+        std::size_t const chunk_size = intern_pool::default_chunk_size)
+    {
+        for (auto& s : shards_) {
+            s.pool = intern_pool{chunk_size};
+        }
+    }
+
+    // The id of `text`, interning it first if it is new. Throws
+    // std::length_error if its shard is full.
+    id_type intern(std::string_view const text)
+    {
+        auto const hash = detail::intern_hash(text);
+        auto const k = shard_of(hash);
+        auto& s = shards_[k];
+        {
+            std::shared_lock<std::shared_mutex> const lock{s.mutex};
+            if (auto const id = s.pool.find(text, hash)) {
+                return make_id(k, *id);
+            }
+        }
+        std::unique_lock<std::shared_mutex> const lock{s.mutex};
+        return make_id(k, s.pool.intern(text, hash, max_shard_size));
+    }
+
+    [[nodiscard]] std::optional<id_type>
+    find(std::string_view const text) const
+    {
+        auto const hash = detail::intern_hash(text);
+        auto const k = shard_of(hash);
+        auto const& s = shards_[k];
+        std::shared_lock<std::shared_mutex> const lock{s.mutex};
+        if (auto const id = s.pool.find(text, hash)) {
+            return make_id(k, *id);
+        }
+        return std::nullopt;
+    }
+
+    // The string named by `id`, which must come from this pool. The view
+    // stays valid while other threads intern.
+    [[nodiscard]] std::string_view view(id_type const id) const
+    {
+        auto const& s = shards_[id % Shards];
+        std::shared_lock<std::shared_mutex> const lock{s.mutex};
+        return s.pool.view(id / Shards);
+    }
+
+    // As view(), but throws std::out_of_range for an unknown id.
+    [[nodiscard]] std::string_view at(id_type const id) const
+    {
+        auto const& s = shards_[id % Shards];
+        std::shared_lock<std::shared_mutex> const lock{s.mutex};
+        return s.pool.at(id / Shards);
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        return accumulate([](intern_pool const& p) { return p.size(); });
+    }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    [[nodiscard]] std::size_t string_bytes() const
+    {
+        return accumulate(
+            [](intern_pool const& p) { return p.string_bytes(); });
+    }
+
+    // Bytes allocated by every shard, plus this object.
+    [[nodiscard]] std::size_t area() const
+    {
+        return sizeof(*this) +
+               accumulate([](intern_pool const& p) {
+                   return p.area() - sizeof(intern_pool);
+               });
+    }
+
+    // Forget every string; ids and views handed out before are invalidated.
+    void clear()
+    {
+        for (auto& s : shards_) {
+            std::unique_lock<std::shared_mutex> const lock{s.mutex};
+            s.pool.clear();
+        }
+    }
+
+private:
+    static constexpr std::size_t max_shard_size =
+        intern_pool::max_size() / Shards;
+
+    // Each on its own cache lines, so that locking one shard does not slow
+    // down threads working on its neighbours.
+    struct alignas(64) shard
+    {
+        mutable std::shared_mutex mutex;
+        intern_pool pool;
+    };
+
+    // The shard comes from the high bits, which the slot index in the shard
+    // (the low bits) does not use.
+    [[nodiscard]] static std::size_t shard_of(std::size_t const hash) noexcept
+    {
+        return (hash >> (sizeof(std::size_t) * 8 - 8)) & (Shards - 1);
+    }
+
+    [[nodiscard]] static id_type make_id(std::size_t const k,
+                                         id_type const local) noexcept
+    {
+        return static_cast<id_type>(local * Shards + k);
+    }
+
+    template <typename Get>
+    [[nodiscard]] std::size_t accumulate(Get const& get) const
+    {
+        std::size_t total = 0;
+        for (auto const& s : shards_) {
+            std::shared_lock<std::shared_mutex> const lock{s.mutex};
+            total += get(s.pool);
+        }
+        return total;
+    }
+
+    std::array<shard, Shards> shards_;
+};
+} // namespace utils::strings
+
+namespace utils::collections
+{
+// Bytes allocated by an intern pool; see intern_pool::area().
+[[nodiscard]] inline std::size_t areaof(strings::intern_pool const& x) noexcept
+{
+    return x.area();
+}
+
+// Ratio of interned string bytes to everything the pool allocated.
+[[nodiscard]] inline double
+memory_utilization(strings::intern_pool const& x) noexcept
+{
+    return static_cast<double>(x.string_bytes()) /
+           static_cast<double>(x.area());
+}
+} // namespace utils::collections
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <libutils/polyfill.hpp>
+#include <libutils/simd.hpp>
+#include <libutils/threading.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Zero-copy iteration over the lines of an in-memory buffer (a string, or a
+ * memory-mapped file, see mapped_file.hpp).
+ *
+ * Lines end at "\n" or "\r\n" and are yielded without the line break, as views
+ * into the buffer. Like std::getline, a final line break does not start an
+ * extra empty line, while empty lines in between are reported. A "\r" right
+ * before the end of an unterminated last line is stripped as well.
+ *
+ * The buffer is classified 64 bytes at a time into a newline bitmask
+ * (simd::match_block64) and each step takes the next set bit, so short lines
+ * cost a few instructions rather than a search call each. Breaking out of the
+ * loop early skips the rest of the buffer.
+ *
+ * parallel_for_each_line() cuts a large buffer at line boundaries into one
+ * chunk per thread and runs the same loop over each chunk concurrently.
+ */
+namespace utils::strings
+{
+// Forward range over the lines of `text`, which must outlive it and its
+// iterators. Create one with lines().
+class line_range
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type const*;
+        using reference = value_type const&;
+
+        iterator() = default;
+
+        [[nodiscard]] reference operator*() const noexcept { return line_; }
+        [[nodiscard]] pointer operator->() const noexcept { return &line_; }
+
+        iterator& operator++() noexcept
+        {
+            advance();
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            auto const previous = *this;
+            advance();
+            return previous;
+        }
+
+        [[nodiscard]] friend bool operator==(iterator const& lhs,
+                                             iterator const& rhs) noexcept
+        {
+            return lhs.next_ == rhs.next_;
+        }
+
+        [[nodiscard]] friend bool operator!=(iterator const& lhs,
+                                             iterator const& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        friend class line_range;
+
+        static constexpr std::size_t block_size = 64;
+
+        explicit iterator(std::string_view const text) noexcept
+            : text_(text), next_(0)
+        {
+            advance();
+        }
+
+        // Bits of the newlines in the 64 bytes at `block`; the last, partial
+        // block is classified byte by byte.
+        [[nodiscard]] std::uint64_t
+        newlines(std::size_t const block) const noexcept
+        {
+            if (block + block_size <= text_.size()) {
+                return simd::match_block64(text_.data() + block, '\n');
+            }
+            std::uint64_t mask = 0;
+            for (auto i = block; i < text_.size(); ++i) {
+                mask |= text_[i] == '\n' ? std::uint64_t{1} << (i - block) : 0;
+            }
+            return mask;
+        }
+
+        // next_ is where the following line starts, and npos at the end.
+        void advance() noexcept
+        {
+            if (next_ >= text_.size()) {
+                next_ = std::string_view::npos;
+                return;
+            }
+            auto const start = next_;
+            while (mask_ == 0) {
+                if (block_ >= text_.size()) {
+                    next_ = text_.size();
+                    set_line(start, text_.size());
+                    return;
+                }
+                mask_ = newlines(block_);
+                block_ += block_size;
+            }
+            auto const newline = block_ - block_size +
+                                 static_cast<std::size_t>(
+                                     utils::countr_zero(mask_));
+            mask_ &= mask_ - 1;
+            next_ = newline + 1;
+            set_line(start, newline);
+        }
+
+        void set_line(std::size_t const start, std::size_t end) noexcept
+        {
+            if (end != start && text_[end - 1] == '\r') {
+                --end;
+            }
+            line_ = text_.substr(start, end - start);
+        }
+
+        std::string_view text_;
+        std::size_t next_{std::string_view::npos};
+        // The next block to classify, and the unconsumed newlines of the one
+        // before it.
+        std::size_t block_{0};
+        std::uint64_t mask_{0};
+        std::string_view line_;
+    };
+
+    explicit line_range(std::string_view const text) noexcept : text_(text) {}
+
+    [[nodiscard]] iterator begin() const noexcept { return iterator{text_}; }
+    [[nodiscard]] iterator end() const noexcept { return iterator{}; }
+
+private:
+    std::string_view text_;
+};
+
+// The lines of `text`; see line_range.
+[[nodiscard]] inline line_range lines(std::string_view const text) noexcept
+{
+    return line_range{text};
+}
+
+// The lines of a span of characters or raw bytes, e.g. mapped_file::bytes().
+template <typename T>
+[[nodiscard]] line_range lines(utils::span<T> const text) noexcept
+{
+    using element = std::remove_const_t<T>;
+    static_assert(std::is_same_v<element, char> ||
+                      std::is_same_v<element, std::byte>,
+                  "lines() takes a span of char or std::byte");
+    return line_range{std::string_view(
+        reinterpret_cast<char const*>(text.data()), text.size())};
+}
+
+// Split `text` into at most `parts` consecutive chunks of about equal size,
+// each cut right after a '\n', so that reading the chunks one after the other
+// yields exactly the lines of `text`.
+[[nodiscard]] inline std::vector<std::string_view>
+split_lines(std::string_view const text, std::size_t const parts)
+{
+    auto const n = std::max<std::size_t>(parts, 1);
+    std::vector<std::string_view> chunks;
+    std::size_t start = 0;
+    for (std::size_t k = 1; k < n && start < text.size(); ++k) {
+        auto const cut = std::max(start, text.size() / n * k);
+        auto const* const newline = static_cast<char const*>(std::memchr(
+            text.data() + cut, '\n', text.size() - cut));
+        if (newline == nullptr) {
+            break;
+        }
+        auto const boundary =
+            static_cast<std::size_t>(newline + 1 - text.data());
+        chunks.push_back(text.substr(start, boundary - start));
+        start = boundary;
+    }
+    if (start < text.size()) {
+        chunks.push_back(text.substr(start));
+    }
+    return chunks;
+}
+
+// How parallel_for_each_line() combines the per-chunk accumulators.
+enum class merge_order
+{
+    // In chunk order once every chunk is done: for merges that are not
+    // commutative (appending to a vector, keeping the first match...).
+    ordered,
+    // As each chunk finishes, under a lock, in completion order: merging
+    // overlaps the slower chunks, for commutative merges (sums, counts...).
+    unordered
+};
+
+namespace detail
+{
+// The chunks of `text` for up to `n_threads` threads.
+[[nodiscard]] inline std::vector<std::string_view>
+line_chunks(std::string_view const text, std::size_t const n_threads)
+{
+    return split_lines(
+        text, utils::threading::parallel_chunks(text.size(), n_threads));
+}
+} // namespace detail
+
+// Process the lines of `text` on up to `n_threads` threads: `text` is cut into
+// chunks at line boundaries (see split_lines()) and each thread calls
+// fn(chunk, line) for each line of its chunk in order, with `chunk` <
+// n_threads identifying the chunk (and so the thread). Chunks are
+// consecutive, so per-chunk state merged in chunk order gives the sequential
+// result. `fn` must be safe to call concurrently for different chunks. The
+// first exception thrown by `fn` is rethrown once every thread has finished.
+template <typename Fn>
+void parallel_for_each_line(std::string_view const text,
+                            std::size_t const n_threads, Fn&& fn)
+{
+    auto const chunks = detail::line_chunks(text, n_threads);
+    utils::threading::run_chunks(chunks.size(), [&](std::size_t const k) {
+        for (auto const line : lines(chunks[k])) {
+            fn(k, line);
+        }
+    });
+}
+
+// Reduce the lines of `text` on up to `n_threads` threads. Each chunk starts
+// from its own copy of `init`, kept on its thread's stack, and calls
+// fn(accumulator, line) for each of its lines; the accumulators are then
+// combined with merge(into, std::move(from)) in `order`. Returns `init` for
+// an empty input. Exceptions are handled as by the overload above.
+template <typename T, typename Fn, typename Merge>
+[[nodiscard]] T
+parallel_for_each_line(std::string_view const text,
+                       std::size_t const n_threads, T init, Fn&& fn,
+                       Merge&& merge,
+                       merge_order const order = merge_order::ordered)
+{
+    auto const chunks = detail::line_chunks(text, n_threads);
+    std::vector<std::optional<T>> partials(chunks.size());
+    std::optional<T> result;
+    std::mutex result_mutex;
+    utils::threading::run_chunks(chunks.size(), [&](std::size_t const k) {
+        T accumulator = init;
+        for (auto const line : lines(chunks[k])) {
+            fn(accumulator, line);
+        }
+        if (order == merge_order::ordered) {
+            partials[k].emplace(std::move(accumulator));
+            return;
+        }
+        std::lock_guard<std::mutex> const lock{result_mutex};
+        if (result) {
+            merge(*result, std::move(accumulator));
+        } else {
+            result.emplace(std::move(accumulator));
+        }
+    });
+    if (order == merge_order::ordered) {
+        for (auto& partial : partials) {
+            if (result) {
+                merge(*result, std::move(*partial));
+            } else {
+                result = std::move(partial);
+            }
+        }
+    }
+    return result ? std::move(*result) : std::move(init);
+}
+} // namespace utils::strings
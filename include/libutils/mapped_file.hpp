@@ -0,0 +1,151 @@
+#pragma once
+
+#include <libutils/polyfill.hpp>
+#include <libutils/unique_handler.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * A read-only memory mapping of a whole file (POSIX only).
+ *
+ * The mapping is advised MADV_SEQUENTIAL, so the kernel reads ahead
+ * aggressively and drops pages behind the scan: the shape of a pass over a
+ * large log or CSV file with lines() or csv::reader. Data is paged in on
+ * first touch; no copy of the file is made in user space.
+ *
+ * Example usage:
+ * utils::mapped_file const file("events.log");
+ * for (auto const line : utils::strings::lines(file.bytes())) {
+ *     // `line` points into the mapping
+ * }
+ */
+namespace utils
+{
+namespace detail
+{
+struct file_descriptor_traits
+{
+    using handle = int;
+    static handle invalid() noexcept { return -1; }
+    static void destroy(handle const fd) noexcept
+    {
+        if (fd != invalid()) {
+            ::close(fd);
+        }
+    }
+};
+
+struct mapping
+{
+    void* address{nullptr};
+    std::size_t size{0};
+
+    [[nodiscard]] friend bool operator==(mapping const& lhs,
+                                         mapping const& rhs) noexcept
+    {
+        return lhs.address == rhs.address && lhs.size == rhs.size;
+    }
+
+    [[nodiscard]] friend bool operator!=(mapping const& lhs,
+                                         mapping const& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+};
+
+struct mapping_traits
+{
+    using handle = mapping;
+    static handle invalid() noexcept { return {}; }
+    static void destroy(handle const m) noexcept
+    {
+        if (m.address != nullptr) {
+            ::munmap(m.address, m.size);
+        }
+    }
+};
+
+[[noreturn]] inline void throw_file_error(char const* const what,
+                                          char const* const path)
+{
+    throw std::system_error(errno, std::generic_category(),
+                            std::string("mapped_file: ") + what + " " + path);
+}
+} // namespace detail
+
+class mapped_file
+{
+public:
+    // An empty mapping.
+    mapped_file() noexcept = default;
+
+    // Map the file at `path`. Throws std::system_error if it cannot be opened,
+    // inspected or mapped. An empty file gives an empty mapping.
+    explicit mapped_file(char const* const path)
+    {
+        UniqueHandle<detail::file_descriptor_traits> const fd(
+            ::open(path, O_RDONLY | O_CLOEXEC));
+        if (!fd) {
+            detail::throw_file_error("cannot open", path);
+        }
+        struct ::stat info{};
+        if (::fstat(fd.get(), &info) != 0) {
+            detail::throw_file_error("cannot stat", path);
+        }
+        auto const size = static_cast<std::size_t>(info.st_size);
+        if (size == 0) {
+            return;
+        }
+        auto* const address =
+            ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+        if (address == MAP_FAILED) {
+            detail::throw_file_error("cannot map", path);
+        }
+        mapping_.reset({address, size});
+        // Only a hint: the mapping is usable whether or not it is honored.
+        ::madvise(address, size, MADV_SEQUENTIAL);
+    }
+
+    explicit mapped_file(std::string const& path) : mapped_file(path.c_str())
+    {}
+
+    [[nodiscard]] std::byte const* data() const noexcept
+    {
+        return static_cast<std::byte const*>(mapping_.get().address);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return mapping_.get().size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    [[nodiscard]] utils::span<std::byte const> bytes() const noexcept
+    {
+        return {data(), size()};
+    }
+
+    // The contents as characters, e.g. for csv::reader or split_view().
+    [[nodiscard]] std::string_view text() const noexcept
+    {
+        return {reinterpret_cast<char const*>(data()), size()};
+    }
+
+private:
+    UniqueHandle<detail::mapping_traits> mapping_;
+};
+} // namespace utils
+
+#endif
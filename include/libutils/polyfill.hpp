@@ -285,6 +285,21 @@ constexpr T byteswap(T value) noexcept
                   "byteswap requires an integral type");
     using U = typename std::make_unsigned<T>::type;
     U const in = static_cast<U>(value);
+#if defined(__GNUC__) || defined(__clang__)
+    // Single instruction; the loop below is not always recognized at -O2.
+    if (sizeof(T) == 8) {
+        return static_cast<T>(
+            __builtin_bswap64(static_cast<std::uint64_t>(in)));
+    }
+    if (sizeof(T) == 4) {
+        return static_cast<T>(
+            __builtin_bswap32(static_cast<std::uint32_t>(in)));
+    }
+    if (sizeof(T) == 2) {
+        return static_cast<T>(
+            __builtin_bswap16(static_cast<std::uint16_t>(in)));
+    }
+#endif
     U out = 0;
     for (std::size_t i = 0; i < sizeof(T); ++i) {
         out = static_cast<U>(
@@ -326,6 +341,12 @@ constexpr int popcount(T x) noexcept
 {
     static_assert(std::is_unsigned<T>::value,
                   "bit operations require an unsigned integer type");
+#if defined(__GNUC__) || defined(__clang__)
+    // Single instruction where available; these sit in hot scanning loops.
+    if (sizeof(T) <= sizeof(unsigned long long)) {
+        return __builtin_popcountll(static_cast<unsigned long long>(x));
+    }
+#endif
     int count = 0;
     while (x != 0) {
         x = static_cast<T>(x & static_cast<T>(x - 1));
@@ -340,6 +361,12 @@ constexpr int countr_zero(T x) noexcept
     static_assert(std::is_unsigned<T>::value,
                   "bit operations require an unsigned integer type");
     constexpr int digits = std::numeric_limits<T>::digits;
+#if defined(__GNUC__) || defined(__clang__)
+    if (sizeof(T) <= sizeof(unsigned long long)) {
+        return x == 0 ? digits
+                      : __builtin_ctzll(static_cast<unsigned long long>(x));
+    }
+#endif
     for (int i = 0; i < digits; ++i) {
         if (((x >> i) & T{1}) != 0) {
             return i;
@@ -0,0 +1,3143 @@
+#pragma once
+
+#include <libutils/unused.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * Runtime-dispatched byte scanning kernels shared by the string utilities.
+ *
+ * Every kernel has a portable scalar version plus SSE4.2 and AVX2 versions on
+ * x86 with GCC/Clang. The vector versions are compiled with per-function
+ * target attributes, so no -m flags are needed and the headers stay usable on
+ * any baseline; the best level the CPU supports is picked once at runtime.
+ *
+ * Define UTILS_NO_SIMD to compile the scalar versions only.
+ */
+#if !defined(UTILS_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) &&   \
+    (defined(__x86_64__) || defined(__i386__))
+#define UTILS_SIMD_X86 1
+#include <immintrin.h>
+#define UTILS_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define UTILS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace utils::simd
+{
+// Instruction set tiers, in increasing order.
+enum class level : std::uint8_t
+{
+    scalar,
+    sse4_2,
+    avx2
+};
+
+namespace detail
+{
+[[nodiscard]] inline level detect_level() noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return level::avx2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return level::sse4_2;
+    }
+#endif
+    return level::scalar;
+}
+
+inline std::atomic<level> max_level{level::avx2};
+} // namespace detail
+
+// Highest tier the running CPU supports (detected once).
+[[nodiscard]] inline level supported_level() noexcept
+{
+    static level const supported = detail::detect_level();
+    return supported;
+}
+
+// Cap dispatch at `l`, e.g. to test or benchmark the scalar fallback. Levels
+// above what the CPU supports are ignored.
+inline void set_max_level(level const l) noexcept
+{
+    detail::max_level.store(l, std::memory_order_relaxed);
+}
+
+// The tier kernels actually dispatch to.
+[[nodiscard]] inline level active_level() noexcept
+{
+    auto const cap = detail::max_level.load(std::memory_order_relaxed);
+    auto const supported = supported_level();
+    return cap < supported ? cap : supported;
+}
+
+// ----------
+// Byte sets
+// ----------
+
+/**
+ * A set of byte values, stored twice: as a 256-bit bitmap for the scalar path
+ * and as nibble lookup tables for the vector path.
+ *
+ * The vector path classifies a byte b as
+ *     lo_[(b >> 7) * 16 + (b & 0xF)] & (1 << ((b >> 4) & 7))
+ * i.e. one bucket bit per high nibble, with a separate low-nibble table for
+ * each half of the byte range. That is exact for any set of bytes (no
+ * verification pass), at the cost of one extra shuffle and a blend.
+ */
+class byte_set
+{
+public:
+    constexpr byte_set() noexcept = default;
+
+    constexpr explicit byte_set(std::string_view const chars) noexcept
+    {
+        for (char const ch : chars) {
+            insert(static_cast<unsigned char>(ch));
+        }
+    }
+
+    constexpr void insert(unsigned char const b) noexcept
+    {
+        bits_[b >> 6U] |= std::uint64_t{1} << (b & 63U);
+        lo_[((b >> 7U) * 16U) + (b & 0xFU)] |=
+            static_cast<std::uint8_t>(1U << ((b >> 4U) & 7U));
+    }
+
+    [[nodiscard]] constexpr bool contains(unsigned char const b) const noexcept
+    {
+        return ((bits_[b >> 6U] >> (b & 63U)) & 1U) != 0;
+    }
+
+    [[nodiscard]] constexpr std::uint8_t const* nibble_table() const noexcept
+    {
+        return lo_;
+    }
+
+private:
+    std::uint64_t bits_[4]{};
+    std::uint8_t lo_[32]{};
+};
+
+namespace detail
+{
+// The byte_set kernels take `in` to search for members (true) or for
+// non-members (false) of the set; the vector paths flip the match mask.
+[[nodiscard]] inline char const* find_set_scalar(char const* first,
+                                                 char const* const last,
+                                                 byte_set const& set,
+                                                 bool const in) noexcept
+{
+    for (; first != last; ++first) {
+        if (set.contains(static_cast<unsigned char>(*first)) == in) {
+            return first;
+        }
+    }
+    return last;
+}
+
+[[nodiscard]] inline char const* find_last_set_scalar(char const* const first,
+                                                      char const* const last,
+                                                      byte_set const& set,
+                                                      bool const in) noexcept
+{
+    for (auto const* p = last; p != first;) {
+        --p;
+        if (set.contains(static_cast<unsigned char>(*p)) == in) {
+            return p;
+        }
+    }
+    return last;
+}
+
+[[nodiscard]] inline std::size_t count_set_scalar(char const* first,
+                                                  char const* const last,
+                                                  byte_set const& set) noexcept
+{
+    std::size_t count = 0;
+    for (; first != last; ++first) {
+        count += set.contains(static_cast<unsigned char>(*first)) ? 1 : 0;
+    }
+    return count;
+}
+
+// Copies the bytes of [first, last) that are not in `set` to `out`, which may
+// be `first` (it never runs ahead of the read position). Returns the end of
+// the output.
+[[nodiscard]] inline char* remove_set_scalar(char const* first,
+                                             char const* const last, char* out,
+                                             byte_set const& set) noexcept
+{
+    for (; first != last; ++first) {
+        auto const ch = *first;
+        *out = ch;
+        out += set.contains(static_cast<unsigned char>(ch)) ? 0 : 1;
+    }
+    return out;
+}
+
+// pshufb controls that move the bytes of an 8-byte group whose bit is clear in
+// the index to the front, in order. The remaining lanes are don't-care.
+struct pack_shuffles
+{
+    std::uint64_t control[256]{};
+
+    constexpr pack_shuffles() noexcept
+    {
+        for (unsigned mask = 0; mask < 256; ++mask) {
+            unsigned kept = 0;
+            for (unsigned i = 0; i < 8; ++i) {
+                if (((mask >> i) & 1U) == 0) {
+                    control[mask] |= std::uint64_t{i} << (8 * kept++);
+                }
+            }
+        }
+    }
+};
+
+inline constexpr pack_shuffles pack_table{};
+
+[[nodiscard]] inline char const* find_scalar(char const* const first,
+                                             char const* const last,
+                                             char const* const needle,
+                                             std::size_t const size) noexcept
+{
+    auto const haystack =
+        std::string_view(first, static_cast<std::size_t>(last - first));
+    auto const pos = haystack.find(std::string_view(needle, size));
+    return pos == std::string_view::npos ? last : first + pos;
+}
+
+#if defined(UTILS_SIMD_X86)
+// The nibble tables of a byte_set, loaded once per call.
+struct byte_set_sse42
+{
+    __m128i lo_low;
+    __m128i lo_high;
+    __m128i hi_bits;
+};
+
+UTILS_TARGET_SSE42 inline byte_set_sse42
+load_sse42(byte_set const& set) noexcept
+{
+    auto const* table = set.nibble_table();
+    return {_mm_loadu_si128(reinterpret_cast<__m128i const*>(table)),
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(table + 16)),
+            _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32,
+                          64, -128)};
+}
+
+// 0xFF where the byte of `v` is in the set.
+UTILS_TARGET_SSE42 inline __m128i
+members_sse42(__m128i const v, byte_set_sse42 const& t) noexcept
+{
+    auto const nibble = _mm_set1_epi8(0x0F);
+    auto const lo = _mm_and_si128(v, nibble);
+    auto const hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble);
+    auto const buckets = _mm_blendv_epi8(_mm_shuffle_epi8(t.lo_low, lo),
+                                         _mm_shuffle_epi8(t.lo_high, lo), v);
+    auto const hits = _mm_and_si128(buckets, _mm_shuffle_epi8(t.hi_bits, hi));
+    return _mm_xor_si128(_mm_cmpeq_epi8(hits, _mm_setzero_si128()),
+                         _mm_set1_epi8(-1));
+}
+
+UTILS_TARGET_SSE42 inline unsigned
+member_mask_sse42(char const* const p, byte_set_sse42 const& t) noexcept
+{
+    return static_cast<unsigned>(_mm_movemask_epi8(members_sse42(
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(p)), t)));
+}
+
+UTILS_TARGET_SSE42 inline char const* find_set_sse42(char const* first,
+                                                     char const* const last,
+                                                     byte_set const& set,
+                                                     bool const in) noexcept
+{
+    if (last - first < 16) {
+        return find_set_scalar(first, last, set, in);
+    }
+    auto const t = load_sse42(set);
+    auto const flip = in ? 0U : 0xFFFFU;
+    for (; last - first >= 16; first += 16) {
+        auto const mask = member_mask_sse42(first, t) ^ flip;
+        if (mask != 0) {
+            return first + __builtin_ctz(mask);
+        }
+    }
+    return find_set_scalar(first, last, set, in);
+}
+
+UTILS_TARGET_SSE42 inline char const*
+find_last_set_sse42(char const* const first, char const* const last,
+                    byte_set const& set, bool const in) noexcept
+{
+    if (last - first < 16) {
+        return find_last_set_scalar(first, last, set, in);
+    }
+    auto const t = load_sse42(set);
+    auto const flip = in ? 0U : 0xFFFFU;
+    auto const* end = last;
+    for (; end - first >= 16; end -= 16) {
+        auto const mask = member_mask_sse42(end - 16, t) ^ flip;
+        if (mask != 0) {
+            return end - 16 + (31 - __builtin_clz(mask));
+        }
+    }
+    auto const* const hit = find_last_set_scalar(first, end, set, in);
+    return hit == end ? last : hit;
+}
+
+// Same lane counting as count_sse42().
+UTILS_TARGET_SSE42 inline std::size_t
+count_set_sse42(char const* first, char const* const last,
+                byte_set const& set) noexcept
+{
+    auto const t = load_sse42(set);
+    auto totals = _mm_setzero_si128();
+    while (last - first >= 16) {
+        auto lanes = _mm_setzero_si128();
+        for (unsigned n = 0; n < 255 && last - first >= 16; ++n, first += 16) {
+            auto const v =
+                _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+            lanes = _mm_sub_epi8(lanes, members_sse42(v, t));
+        }
+        totals = _mm_add_epi64(totals,
+                               _mm_sad_epu8(lanes, _mm_setzero_si128()));
+    }
+    std::uint64_t sums[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), totals);
+    return static_cast<std::size_t>(sums[0] + sums[1]) +
+           count_set_scalar(first, last, set);
+}
+
+struct byte_set_avx2
+{
+    __m256i lo_low;
+    __m256i lo_high;
+    __m256i hi_bits;
+};
+
+UTILS_TARGET_AVX2 inline byte_set_avx2 load_avx2(byte_set const& set) noexcept
+{
+    auto const* table = set.nibble_table();
+    return {_mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<__m128i const*>(table))),
+            _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<__m128i const*>(table + 16))),
+            _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32,
+                             64, -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4,
+                             8, 16, 32, 64, -128)};
+}
+
+UTILS_TARGET_AVX2 inline __m256i members_avx2(__m256i const v,
+                                              byte_set_avx2 const& t) noexcept
+{
+    auto const nibble = _mm256_set1_epi8(0x0F);
+    auto const lo = _mm256_and_si256(v, nibble);
+    auto const hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble);
+    auto const buckets =
+        _mm256_blendv_epi8(_mm256_shuffle_epi8(t.lo_low, lo),
+                           _mm256_shuffle_epi8(t.lo_high, lo), v);
+    auto const hits =
+        _mm256_and_si256(buckets, _mm256_shuffle_epi8(t.hi_bits, hi));
+    return _mm256_xor_si256(_mm256_cmpeq_epi8(hits, _mm256_setzero_si256()),
+                            _mm256_set1_epi8(-1));
+}
+
+UTILS_TARGET_AVX2 inline unsigned
+member_mask_avx2(char const* const p, byte_set_avx2 const& t) noexcept
+{
+    return static_cast<unsigned>(_mm256_movemask_epi8(members_avx2(
+        _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p)), t)));
+}
+
+UTILS_TARGET_AVX2 inline char const* find_set_avx2(char const* first,
+                                                   char const* const last,
+                                                   byte_set const& set,
+                                                   bool const in) noexcept
+{
+    if (last - first < 32) {
+        return find_set_sse42(first, last, set, in);
+    }
+    auto const t = load_avx2(set);
+    auto const flip = in ? 0U : ~0U;
+    for (; last - first >= 32; first += 32) {
+        auto const mask = member_mask_avx2(first, t) ^ flip;
+        if (mask != 0) {
+            return first + __builtin_ctz(mask);
+        }
+    }
+    return find_set_sse42(first, last, set, in);
+}
+
+UTILS_TARGET_AVX2 inline char const*
+find_last_set_avx2(char const* const first, char const* const last,
+                   byte_set const& set, bool const in) noexcept
+{
+    if (last - first < 32) {
+        return find_last_set_sse42(first, last, set, in);
+    }
+    auto const t = load_avx2(set);
+    auto const flip = in ? 0U : ~0U;
+    auto const* end = last;
+    for (; end - first >= 32; end -= 32) {
+        auto const mask = member_mask_avx2(end - 32, t) ^ flip;
+        if (mask != 0) {
+            return end - 32 + (31 - __builtin_clz(mask));
+        }
+    }
+    auto const* const hit = find_last_set_sse42(first, end, set, in);
+    return hit == end ? last : hit;
+}
+
+UTILS_TARGET_AVX2 inline std::size_t
+count_set_avx2(char const* first, char const* const last,
+               byte_set const& set) noexcept
+{
+    auto const t = load_avx2(set);
+    auto totals = _mm256_setzero_si256();
+    while (last - first >= 32) {
+        auto lanes = _mm256_setzero_si256();
+        for (unsigned n = 0; n < 255 && last - first >= 32; ++n, first += 32) {
+            auto const v =
+                _mm256_loadu_si256(reinterpret_cast<__m256i const*>(first));
+            lanes = _mm256_sub_epi8(lanes, members_avx2(v, t));
+        }
+        totals = _mm256_add_epi64(
+            totals, _mm256_sad_epu8(lanes, _mm256_setzero_si256()));
+    }
+    std::uint64_t sums[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums),
+                     _mm_add_epi64(_mm256_castsi256_si128(totals),
+                                   _mm256_extracti128_si256(totals, 1)));
+    return static_cast<std::size_t>(sums[0] + sums[1]) +
+           count_set_sse42(first, last, set);
+}
+
+// Left-packs the kept bytes of `v`, 8 at a time: each 8-byte store lands at or
+// before the bytes it packs, so the output can overwrite the input in place.
+UTILS_TARGET_SSE42 inline char* pack_sse42(__m128i const v,
+                                           unsigned const drop,
+                                           char* out) noexcept
+{
+    for (unsigned group = 0; group < 2; ++group) {
+        auto const bits = (drop >> (8 * group)) & 0xFFU;
+        auto const control = _mm_cvtsi64_si128(static_cast<long long>(
+            pack_table.control[bits] + (group * 0x0808080808080808ULL)));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out),
+                         _mm_shuffle_epi8(v, control));
+        out += 8 - __builtin_popcount(bits);
+    }
+    return out;
+}
+
+UTILS_TARGET_SSE42 inline char* remove_set_sse42(char const* first,
+                                                 char const* const last,
+                                                 char* out,
+                                                 byte_set const& set) noexcept
+{
+    auto const t = load_sse42(set);
+    for (; last - first >= 16; first += 16) {
+        auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+        auto const drop =
+            static_cast<unsigned>(_mm_movemask_epi8(members_sse42(v, t)));
+        if (drop == 0) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), v);
+            out += 16;
+        } else {
+            out = pack_sse42(v, drop, out);
+        }
+    }
+    return remove_set_scalar(first, last, out, set);
+}
+
+UTILS_TARGET_AVX2 inline char* remove_set_avx2(char const* first,
+                                               char const* const last,
+                                               char* out,
+                                               byte_set const& set) noexcept
+{
+    auto const t = load_avx2(set);
+    for (; last - first >= 32; first += 32) {
+        auto const v =
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(first));
+        auto const drop =
+            static_cast<unsigned>(_mm256_movemask_epi8(members_avx2(v, t)));
+        if (drop == 0) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v);
+            out += 32;
+        } else {
+            out = pack_sse42(_mm256_castsi256_si128(v), drop & 0xFFFFU, out);
+            out = pack_sse42(_mm256_extracti128_si256(v, 1), drop >> 16U, out);
+        }
+    }
+    return remove_set_sse42(first, last, out, set);
+}
+
+// The substring search kernels filter candidate positions by comparing the
+// needle's first AND last byte against two shifted loads, which rejects almost
+// every position without touching the middle of the needle.
+UTILS_TARGET_SSE42 inline char const*
+find_sse42(char const* first, char const* const last, char const* const needle,
+           std::size_t const size) noexcept
+{
+    auto const head = _mm_set1_epi8(needle[0]);
+    auto const tail = _mm_set1_epi8(needle[size - 1]);
+    for (; static_cast<std::size_t>(last - first) >= size - 1 + 16;
+         first += 16) {
+        auto const a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+        auto const b = _mm_loadu_si128(
+            reinterpret_cast<__m128i const*>(first + size - 1));
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(a, head), _mm_cmpeq_epi8(b, tail))));
+        while (mask != 0) {
+            auto const* const candidate = first + __builtin_ctz(mask);
+            if (size <= 2 ||
+                std::memcmp(candidate + 1, needle + 1, size - 2) == 0) {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return find_scalar(first, last, needle, size);
+}
+
+UTILS_TARGET_AVX2 inline char const* find_avx2(char const* first,
+                                               char const* const last,
+                                               char const* const needle,
+                                               std::size_t const size) noexcept
+{
+    auto const head = _mm256_set1_epi8(needle[0]);
+    auto const tail = _mm256_set1_epi8(needle[size - 1]);
+    for (; static_cast<std::size_t>(last - first) >= size - 1 + 32;
+         first += 32) {
+        auto const a =
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(first));
+        auto const b = _mm256_loadu_si256(
+            reinterpret_cast<__m256i const*>(first + size - 1));
+        auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(a, head), _mm256_cmpeq_epi8(b, tail))));
+        while (mask != 0) {
+            auto const* const candidate = first + __builtin_ctz(mask);
+            if (size <= 2 ||
+                std::memcmp(candidate + 1, needle + 1, size - 2) == 0) {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return find_sse42(first, last, needle, size);
+}
+#endif
+} // namespace detail
+
+// First byte in [first, last) that is in `set`, or `last` if there is none.
+// Ranges shorter than a vector block are scanned inline, which keeps short
+// tokens (trim, split fields) off the out-of-line kernels.
+[[nodiscard]] inline char const* find_first_of(char const* const first,
+                                               char const* const last,
+                                               byte_set const& set) noexcept
+{
+    if (last - first < 16) {
+        return detail::find_set_scalar(first, last, set, true);
+    }
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::find_set_avx2(first, last, set, true);
+    case level::sse4_2:
+        return detail::find_set_sse42(first, last, set, true);
+    case level::scalar:
+        break;
+    }
+#endif
+    return detail::find_set_scalar(first, last, set, true);
+}
+
+// First byte in [first, last) that is not in `set`, or `last` if there is
+// none.
+[[nodiscard]] inline char const* find_first_not_of(char const* const first,
+                                                   char const* const last,
+                                                   byte_set const& set) noexcept
+{
+    if (last - first < 16) {
+        return detail::find_set_scalar(first, last, set, false);
+    }
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::find_set_avx2(first, last, set, false);
+    case level::sse4_2:
+        return detail::find_set_sse42(first, last, set, false);
+    case level::scalar:
+        break;
+    }
+#endif
+    return detail::find_set_scalar(first, last, set, false);
+}
+
+// Last byte in [first, last) that is not in `set`, or `last` if there is
+// none. Scans backwards, a block at a time.
+[[nodiscard]] inline char const* find_last_not_of(char const* const first,
+                                                  char const* const last,
+                                                  byte_set const& set) noexcept
+{
+    if (last - first < 16) {
+        return detail::find_last_set_scalar(first, last, set, false);
+    }
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::find_last_set_avx2(first, last, set, false);
+    case level::sse4_2:
+        return detail::find_last_set_sse42(first, last, set, false);
+    case level::scalar:
+        break;
+    }
+#endif
+    return detail::find_last_set_scalar(first, last, set, false);
+}
+
+// Number of bytes in [first, last) that are in `set`.
+[[nodiscard]] inline std::size_t count(char const* const first,
+                                       char const* const last,
+                                       byte_set const& set) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::count_set_avx2(first, last, set);
+    case level::sse4_2:
+        return detail::count_set_sse42(first, last, set);
+    case level::scalar:
+        break;
+    }
+#endif
+    return detail::count_set_scalar(first, last, set);
+}
+
+// Removes the bytes of [first, last) that are in `set`, like std::remove:
+// the kept bytes move to the front in order and the new end is returned.
+[[nodiscard]] inline char* remove(char* const first, char* const last,
+                                  byte_set const& set) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::remove_set_avx2(first, last, first, set);
+    case level::sse4_2:
+        return detail::remove_set_sse42(first, last, first, set);
+    case level::scalar:
+        break;
+    }
+#endif
+    return detail::remove_set_scalar(first, last, first, set);
+}
+
+// First occurrence of the `size`-byte `needle` in [first, last), or `last` if
+// there is none. An empty needle matches at `first`.
+[[nodiscard]] inline char const* find(char const* const first,
+                                      char const* const last,
+                                      char const* const needle,
+                                      std::size_t const size) noexcept
+{
+    if (size == 0) {
+        return first;
+    }
+    if (first == last) {
+        return last;
+    }
+    if (size == 1) {
+        auto const* const hit = static_cast<char const*>(std::memchr(
+            first, needle[0], static_cast<std::size_t>(last - first)));
+        return hit == nullptr ? last : hit;
+    }
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::find_avx2(first, last, needle, size);
+    case level::sse4_2:
+        return detail::find_sse42(first, last, needle, size);
+    case level::scalar:
+        break;
+    }
+#endif
+    return detail::find_scalar(first, last, needle, size);
+}
+
+// ----------
+// Hex encoding
+// ----------
+
+namespace detail
+{
+#if defined(UTILS_SIMD_X86)
+// Split each byte into nibbles, map both through the 16-entry alphabet with a
+// shuffle and interleave high/low digits back into byte order.
+UTILS_TARGET_SSE42 inline std::size_t
+encode_hex_sse42(unsigned char const* const in, std::size_t const size,
+                 char* const out, char const* const alphabet) noexcept
+{
+    auto const lut =
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(alphabet));
+    auto const nibble = _mm_set1_epi8(0x0F);
+    std::size_t i = 0;
+    for (; size - i >= 16; i += 16) {
+        auto const v =
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i));
+        auto const hi = _mm_shuffle_epi8(
+            lut, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+        auto const lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, nibble));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (2 * i)),
+                         _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (2 * i) + 16),
+                         _mm_unpackhi_epi8(hi, lo));
+    }
+    return i;
+}
+
+UTILS_TARGET_AVX2 inline std::size_t
+encode_hex_avx2(unsigned char const* const in, std::size_t const size,
+                char* const out, char const* const alphabet) noexcept
+{
+    auto const lut = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(alphabet)));
+    auto const nibble = _mm256_set1_epi8(0x0F);
+    std::size_t i = 0;
+    for (; size - i >= 32; i += 32) {
+        auto const v =
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + i));
+        auto const hi = _mm256_shuffle_epi8(
+            lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+        auto const lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, nibble));
+        // unpack works per 128-bit lane: reorder the lanes back into sequence.
+        auto const a = _mm256_unpacklo_epi8(hi, lo);
+        auto const b = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + (2 * i)),
+                            _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + (2 * i) + 32),
+                            _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    return i + encode_hex_sse42(in + i, size - i, out + (2 * i), alphabet);
+}
+#endif
+} // namespace detail
+
+// Hex-encode a prefix of `in` into `out` (two characters per byte) using the
+// 16-character `alphabet`, in whole vector blocks. Returns the number of input
+// bytes consumed, which is 0 at level::scalar; the caller encodes the rest.
+[[nodiscard]] inline std::size_t encode_hex(unsigned char const* const in,
+                                            std::size_t const size,
+                                            char* const out,
+                                            char const* const alphabet) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::encode_hex_avx2(in, size, out, alphabet);
+    case level::sse4_2:
+        return detail::encode_hex_sse42(in, size, out, alphabet);
+    case level::scalar:
+        break;
+    }
+#endif
+    utils::unused(in, size, out, alphabet);
+    return 0;
+}
+
+// ----------
+// Hex decoding
+// ----------
+
+namespace detail
+{
+#if defined(UTILS_SIMD_X86)
+// Map each character to its nibble value and flag the ones that are not hex
+// digits: '0'-'9' map through c - '0', letters through (c | 0x20) - 'a' + 10.
+UTILS_TARGET_SSE42 inline __m128i hex_nibbles_sse42(__m128i const v,
+                                                    bool& invalid) noexcept
+{
+    auto const digit = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+    auto const letter =
+        _mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    auto const is_digit =
+        _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    auto const is_letter =
+        _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+    invalid = _mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xFFFF;
+    return _mm_blendv_epi8(_mm_add_epi8(letter, _mm_set1_epi8(10)), digit,
+                           is_digit);
+}
+
+UTILS_TARGET_SSE42 inline std::size_t
+decode_hex_sse42(char const* const in, std::size_t const size,
+                 unsigned char* const out) noexcept
+{
+    // (high, low) nibble pairs -> high * 16 + low, as 16-bit lanes.
+    auto const weights = _mm_set1_epi16(0x0110);
+    std::size_t i = 0;
+    for (; size - i >= 16; i += 16) {
+        bool invalid = false;
+        auto const nibbles = hex_nibbles_sse42(
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i)),
+            invalid);
+        if (invalid) {
+            break;
+        }
+        auto const pairs = _mm_maddubs_epi16(nibbles, weights);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + (i / 2)),
+                         _mm_packus_epi16(pairs, pairs));
+    }
+    return i;
+}
+
+UTILS_TARGET_AVX2 inline __m256i hex_nibbles_avx2(__m256i const v,
+                                                  bool& invalid) noexcept
+{
+    auto const digit = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+    auto const letter = _mm256_sub_epi8(
+        _mm256_or_si256(v, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    auto const is_digit =
+        _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+    auto const is_letter = _mm256_cmpeq_epi8(
+        _mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+    invalid =
+        ~_mm256_movemask_epi8(_mm256_or_si256(is_digit, is_letter)) != 0;
+    return _mm256_blendv_epi8(_mm256_add_epi8(letter, _mm256_set1_epi8(10)),
+                              digit, is_digit);
+}
+
+UTILS_TARGET_AVX2 inline std::size_t
+decode_hex_avx2(char const* const in, std::size_t const size,
+                unsigned char* const out) noexcept
+{
+    auto const weights = _mm256_set1_epi16(0x0110);
+    std::size_t i = 0;
+    for (; size - i >= 32; i += 32) {
+        bool invalid = false;
+        auto const nibbles = hex_nibbles_avx2(
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + i)),
+            invalid);
+        if (invalid) {
+            break;
+        }
+        // packus works per 128-bit lane, so pack the two halves explicitly.
+        auto const pairs = _mm256_maddubs_epi16(nibbles, weights);
+        auto const bytes =
+            _mm_packus_epi16(_mm256_castsi256_si128(pairs),
+                             _mm256_extracti128_si256(pairs, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (i / 2)), bytes);
+    }
+    return i + decode_hex_sse42(in + i, size - i, out + (i / 2));
+}
+#endif
+} // namespace detail
+
+// Decode a prefix of the even-length hex string `in` into `out` (one byte per
+// two characters), in whole vector blocks, stopping at the first block that
+// holds a non-hex character. Returns the number of characters consumed, which
+// is 0 at level::scalar; the caller decodes (and validates) the rest.
+[[nodiscard]] inline std::size_t decode_hex(char const* const in,
+                                            std::size_t const size,
+                                            unsigned char* const out) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::decode_hex_avx2(in, size, out);
+    case level::sse4_2:
+        return detail::decode_hex_sse42(in, size, out);
+    case level::scalar:
+        break;
+    }
+#endif
+    utils::unused(in, size, out);
+    return 0;
+}
+
+// ----------
+// Base64
+// ----------
+
+// The Base64 alphabets share their first 62 characters (A-Z, a-z, 0-9) and
+// differ in the last two ('+' '/' standard, '-' '_' URL-safe), so the kernels
+// take those two symbols as parameters.
+
+namespace detail
+{
+#if defined(UTILS_SIMD_X86)
+// Spread each 3-byte group over a 32-bit lane and move its four 6-bit fields
+// into separate bytes with two 16-bit multiplies (Mula's method).
+UTILS_TARGET_SSE42 inline __m128i base64_indices_sse42(__m128i const v) noexcept
+{
+    auto const in = _mm_shuffle_epi8(
+        v, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+    auto const ac =
+        _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)),
+                        _mm_set1_epi32(0x04000040));
+    auto const bd =
+        _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)),
+                        _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(ac, bd);
+}
+
+// Offset to add to each 6-bit index, looked up by its range: 0 for 26-51,
+// 1-10 for the digits, 11 and 12 for the two symbols, 13 for 0-25.
+UTILS_TARGET_SSE42 inline __m128i base64_lut(char const symbol62,
+                                             char const symbol63) noexcept
+{
+    auto const digit = static_cast<char>('0' - 52);
+    return _mm_setr_epi8(static_cast<char>('a' - 26), digit, digit, digit,
+                         digit, digit, digit, digit, digit, digit, digit,
+                         static_cast<char>(symbol62 - 62),
+                         static_cast<char>(symbol63 - 63), 'A', 0, 0);
+}
+
+UTILS_TARGET_SSE42 inline __m128i base64_chars_sse42(__m128i const indices,
+                                                     __m128i const lut) noexcept
+{
+    auto range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    auto const upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+    return _mm_add_epi8(indices, _mm_shuffle_epi8(lut, range));
+}
+
+UTILS_TARGET_SSE42 inline std::size_t
+encode_base64_sse42(unsigned char const* const in, std::size_t const size,
+                    char* const out, char const symbol62,
+                    char const symbol63) noexcept
+{
+    auto const lut = base64_lut(symbol62, symbol63);
+    std::size_t i = 0;
+    // 12 bytes per 16-byte load.
+    for (; size - i >= 16; i += 12) {
+        auto const v =
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (i / 3 * 4)),
+                         base64_chars_sse42(base64_indices_sse42(v), lut));
+    }
+    return i;
+}
+
+UTILS_TARGET_AVX2 inline std::size_t
+encode_base64_avx2(unsigned char const* const in, std::size_t const size,
+                   char* const out, char const symbol62,
+                   char const symbol63) noexcept
+{
+    auto const lut =
+        _mm256_broadcastsi128_si256(base64_lut(symbol62, symbol63));
+    auto const mask_ac = _mm256_set1_epi32(0x0FC0FC00);
+    auto const mask_bd = _mm256_set1_epi32(0x003F03F0);
+    auto const shuffle = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5,
+        4, 7, 6, 8, 7, 10, 9, 11, 10);
+    std::size_t i = 0;
+    // 24 bytes per iteration, 12 in each 128-bit lane.
+    for (; size - i >= 28; i += 24) {
+        auto const v = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i))),
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i + 12)), 1);
+        auto const spread = _mm256_shuffle_epi8(v, shuffle);
+        auto const indices = _mm256_or_si256(
+            _mm256_mulhi_epu16(_mm256_and_si256(spread, mask_ac),
+                               _mm256_set1_epi32(0x04000040)),
+            _mm256_mullo_epi16(_mm256_and_si256(spread, mask_bd),
+                               _mm256_set1_epi32(0x01000010)));
+        auto range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        auto const upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        range = _mm256_or_si256(range,
+                                _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out + (i / 3 * 4)),
+            _mm256_add_epi8(indices, _mm256_shuffle_epi8(lut, range)));
+    }
+    return i + encode_base64_sse42(in + i, size - i, out + (i / 3 * 4),
+                                   symbol62, symbol63);
+}
+
+// Map each character to its 6-bit value and flag the ones outside the
+// alphabet. Every character falls in at most one range, so the masked values
+// can simply be OR-ed together.
+UTILS_TARGET_SSE42 inline __m128i
+base64_values_sse42(__m128i const v, __m128i const symbol62,
+                    __m128i const symbol63, bool& invalid) noexcept
+{
+    auto const upper = _mm_sub_epi8(v, _mm_set1_epi8('A'));
+    auto const lower = _mm_sub_epi8(v, _mm_set1_epi8('a'));
+    auto const digit = _mm_sub_epi8(v, _mm_set1_epi8('0'));
+    auto const is_upper =
+        _mm_cmpeq_epi8(_mm_min_epu8(upper, _mm_set1_epi8(25)), upper);
+    auto const is_lower =
+        _mm_cmpeq_epi8(_mm_min_epu8(lower, _mm_set1_epi8(25)), lower);
+    auto const is_digit =
+        _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    auto const is_62 = _mm_cmpeq_epi8(v, symbol62);
+    auto const is_63 = _mm_cmpeq_epi8(v, symbol63);
+    auto const valid = _mm_or_si128(_mm_or_si128(is_upper, is_lower),
+                                    _mm_or_si128(is_digit,
+                                                 _mm_or_si128(is_62, is_63)));
+    invalid = _mm_movemask_epi8(valid) != 0xFFFF;
+    auto values = _mm_and_si128(is_upper, upper);
+    values = _mm_or_si128(
+        values,
+        _mm_and_si128(is_lower, _mm_add_epi8(lower, _mm_set1_epi8(26))));
+    values = _mm_or_si128(
+        values,
+        _mm_and_si128(is_digit, _mm_add_epi8(digit, _mm_set1_epi8(52))));
+    values = _mm_or_si128(values, _mm_and_si128(is_62, _mm_set1_epi8(62)));
+    return _mm_or_si128(values, _mm_and_si128(is_63, _mm_set1_epi8(63)));
+}
+
+// Four 6-bit values per 32-bit lane -> one 24-bit value, big-endian bytes
+// first in each lane.
+UTILS_TARGET_SSE42 inline __m128i
+base64_pack_sse42(__m128i const values) noexcept
+{
+    auto const pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    auto const groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(groups, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8,
+                                                  14, 13, 12, -1, -1, -1, -1));
+}
+
+// Every block stores a whole vector, of which only 3/4 is output: the loops
+// keep enough input in reserve that the output always has room for it.
+UTILS_TARGET_SSE42 inline std::size_t
+decode_base64_sse42(char const* const in, std::size_t const size,
+                    unsigned char* const out, char const symbol62,
+                    char const symbol63) noexcept
+{
+    auto const s62 = _mm_set1_epi8(symbol62);
+    auto const s63 = _mm_set1_epi8(symbol63);
+    std::size_t i = 0;
+    for (; size - i >= 24; i += 16) {
+        bool invalid = false;
+        auto const values = base64_values_sse42(
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i)), s62, s63,
+            invalid);
+        if (invalid) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (i / 4 * 3)),
+                         base64_pack_sse42(values));
+    }
+    return i;
+}
+
+UTILS_TARGET_AVX2 inline std::size_t
+decode_base64_avx2(char const* const in, std::size_t const size,
+                   unsigned char* const out, char const symbol62,
+                   char const symbol63) noexcept
+{
+    auto const s62 = _mm256_set1_epi8(symbol62);
+    auto const s63 = _mm256_set1_epi8(symbol63);
+    std::size_t i = 0;
+    for (; size - i >= 48; i += 32) {
+        auto const v =
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + i));
+        auto const upper = _mm256_sub_epi8(v, _mm256_set1_epi8('A'));
+        auto const lower = _mm256_sub_epi8(v, _mm256_set1_epi8('a'));
+        auto const digit = _mm256_sub_epi8(v, _mm256_set1_epi8('0'));
+        auto const is_upper = _mm256_cmpeq_epi8(
+            _mm256_min_epu8(upper, _mm256_set1_epi8(25)), upper);
+        auto const is_lower = _mm256_cmpeq_epi8(
+            _mm256_min_epu8(lower, _mm256_set1_epi8(25)), lower);
+        auto const is_digit = _mm256_cmpeq_epi8(
+            _mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+        auto const is_62 = _mm256_cmpeq_epi8(v, s62);
+        auto const is_63 = _mm256_cmpeq_epi8(v, s63);
+        auto const valid = _mm256_or_si256(
+            _mm256_or_si256(is_upper, is_lower),
+            _mm256_or_si256(is_digit, _mm256_or_si256(is_62, is_63)));
+        if (~_mm256_movemask_epi8(valid) != 0) {
+            break;
+        }
+        auto values = _mm256_and_si256(is_upper, upper);
+        auto const from_lower = _mm256_add_epi8(lower, _mm256_set1_epi8(26));
+        auto const from_digit = _mm256_add_epi8(digit, _mm256_set1_epi8(52));
+        values = _mm256_or_si256(values,
+                                 _mm256_and_si256(is_lower, from_lower));
+        values = _mm256_or_si256(values,
+                                 _mm256_and_si256(is_digit, from_digit));
+        values = _mm256_or_si256(
+            values, _mm256_and_si256(is_62, _mm256_set1_epi8(62)));
+        values = _mm256_or_si256(
+            values, _mm256_and_si256(is_63, _mm256_set1_epi8(63)));
+        auto const pairs =
+            _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        auto const groups =
+            _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        // 12 bytes at the start of each lane, then the lanes joined.
+        auto const lanes = _mm256_shuffle_epi8(
+            groups,
+            _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1,
+                             -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                             -1, -1, -1, -1));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out + (i / 4 * 3)),
+            _mm256_permutevar8x32_epi32(
+                lanes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7)));
+    }
+    return i + decode_base64_sse42(in + i, size - i, out + (i / 4 * 3),
+                                   symbol62, symbol63);
+}
+#endif
+} // namespace detail
+
+// Base64-encode a prefix of `in` into `out` (four characters per three bytes)
+// in whole vector blocks, using the alphabet ending in `symbol62`, `symbol63`.
+// Returns the number of input bytes consumed, a multiple of 3, which is 0 at
+// level::scalar; the caller encodes the rest.
+[[nodiscard]] inline std::size_t
+encode_base64(unsigned char const* const in, std::size_t const size,
+              char* const out, char const symbol62,
+              char const symbol63) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::encode_base64_avx2(in, size, out, symbol62, symbol63);
+    case level::sse4_2:
+        return detail::encode_base64_sse42(in, size, out, symbol62, symbol63);
+    case level::scalar:
+        break;
+    }
+#endif
+    utils::unused(in, size, out, symbol62, symbol63);
+    return 0;
+}
+
+// Decode a prefix of the unpadded Base64 string `in` into `out`, which must
+// hold its size * 3 / 4 bytes, in whole vector blocks, stopping at the first
+// block holding a character outside the alphabet. Returns the number of
+// characters consumed, a multiple of 4, which is 0 at level::scalar; the
+// caller decodes (and validates) the rest.
+[[nodiscard]] inline std::size_t
+decode_base64(char const* const in, std::size_t const size,
+              unsigned char* const out, char const symbol62,
+              char const symbol63) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::decode_base64_avx2(in, size, out, symbol62, symbol63);
+    case level::sse4_2:
+        return detail::decode_base64_sse42(in, size, out, symbol62, symbol63);
+    case level::scalar:
+        break;
+    }
+#endif
+    utils::unused(in, size, out, symbol62, symbol63);
+    return 0;
+}
+
+// ----------
+// Base32
+// ----------
+
+namespace detail
+{
+#if defined(UTILS_SIMD_X86)
+// Each 5-byte group becomes eight 16-bit lanes, lane k holding the two bytes
+// its 5-bit field k spans (first byte high). Shifting lane k left by the
+// field's offset in its first byte puts the field in the top 5 bits.
+UTILS_TARGET_SSE42 inline __m128i base32_fields_sse42(__m128i const v,
+                                                      __m128i const shuffle)
+    noexcept
+{
+    auto const shifted =
+        _mm_mullo_epi16(_mm_shuffle_epi8(v, shuffle),
+                        _mm_setr_epi16(1, 32, 4, 128, 16, 2, 64, 8));
+    return _mm_srli_epi16(shifted, 11);
+}
+
+// 0-25 -> 'A'-'Z', 26-31 -> '2'-'7'.
+UTILS_TARGET_SSE42 inline __m128i base32_chars_sse42(__m128i const indices)
+    noexcept
+{
+    auto const digit = _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(25)),
+                                     _mm_set1_epi8('2' - 26 - 'A'));
+    return _mm_add_epi8(_mm_add_epi8(indices, _mm_set1_epi8('A')), digit);
+}
+
+UTILS_TARGET_SSE42 inline std::size_t
+encode_base32_sse42(unsigned char const* const in, std::size_t const size,
+                    char* const out) noexcept
+{
+    auto const first = _mm_setr_epi8(1, 0, 1, 0, 2, 1, 2, 1, 3, 2, 4, 3, 4, 3,
+                                     5, 4);
+    auto const second = _mm_setr_epi8(6, 5, 6, 5, 7, 6, 7, 6, 8, 7, 9, 8, 9,
+                                      8, 10, 9);
+    std::size_t i = 0;
+    // Two groups (10 bytes) per 16-byte load.
+    for (; size - i >= 16; i += 10) {
+        auto const v =
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i));
+        auto const indices = _mm_packus_epi16(base32_fields_sse42(v, first),
+                                              base32_fields_sse42(v, second));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (i / 5 * 8)),
+                         base32_chars_sse42(indices));
+    }
+    return i;
+}
+
+UTILS_TARGET_AVX2 inline std::size_t
+encode_base32_avx2(unsigned char const* const in, std::size_t const size,
+                   char* const out) noexcept
+{
+    auto const first = _mm256_setr_epi8(
+        1, 0, 1, 0, 2, 1, 2, 1, 3, 2, 4, 3, 4, 3, 5, 4, 1, 0, 1, 0, 2, 1, 2, 1,
+        3, 2, 4, 3, 4, 3, 5, 4);
+    auto const second = _mm256_setr_epi8(
+        6, 5, 6, 5, 7, 6, 7, 6, 8, 7, 9, 8, 9, 8, 10, 9, 6, 5, 6, 5, 7, 6, 7, 6,
+        8, 7, 9, 8, 9, 8, 10, 9);
+    auto const shifts = _mm256_setr_epi16(1, 32, 4, 128, 16, 2, 64, 8, 1, 32,
+                                          4, 128, 16, 2, 64, 8);
+    std::size_t i = 0;
+    // Four groups (20 bytes) per iteration, two in each 128-bit lane.
+    for (; size - i >= 26; i += 20) {
+        auto const v = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i))),
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i + 10)), 1);
+        auto const a = _mm256_srli_epi16(
+            _mm256_mullo_epi16(_mm256_shuffle_epi8(v, first), shifts), 11);
+        auto const b = _mm256_srli_epi16(
+            _mm256_mullo_epi16(_mm256_shuffle_epi8(v, second), shifts), 11);
+        auto const indices = _mm256_packus_epi16(a, b);
+        auto const digit = _mm256_and_si256(
+            _mm256_cmpgt_epi8(indices, _mm256_set1_epi8(25)),
+            _mm256_set1_epi8('2' - 26 - 'A'));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out + (i / 5 * 8)),
+            _mm256_add_epi8(_mm256_add_epi8(indices, _mm256_set1_epi8('A')),
+                            digit));
+    }
+    return i + encode_base32_sse42(in + i, size - i, out + (i / 5 * 8));
+}
+
+// Map each character to its 5-bit value and flag the ones outside the
+// alphabet (which is upper case only).
+UTILS_TARGET_SSE42 inline __m128i base32_values_sse42(__m128i const v,
+                                                      bool& invalid) noexcept
+{
+    auto const upper = _mm_sub_epi8(v, _mm_set1_epi8('A'));
+    auto const digit = _mm_sub_epi8(v, _mm_set1_epi8('2'));
+    auto const is_upper =
+        _mm_cmpeq_epi8(_mm_min_epu8(upper, _mm_set1_epi8(25)), upper);
+    auto const is_digit =
+        _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(5)), digit);
+    invalid = _mm_movemask_epi8(_mm_or_si128(is_upper, is_digit)) != 0xFFFF;
+    return _mm_or_si128(
+        _mm_and_si128(is_upper, upper),
+        _mm_and_si128(is_digit, _mm_add_epi8(digit, _mm_set1_epi8(26))));
+}
+
+// Eight 5-bit values per 64-bit lane -> one 40-bit value, big-endian bytes
+// first in each lane: pairs to 10 bits, quads to 20, then the two halves.
+UTILS_TARGET_SSE42 inline __m128i
+base32_pack_sse42(__m128i const values) noexcept
+{
+    auto const pairs = _mm_maddubs_epi16(values, _mm_set1_epi16(0x0120));
+    auto const quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00010400));
+    auto const groups = _mm_add_epi64(
+        _mm_mul_epu32(quads, _mm_set1_epi64x(1 << 20)),
+        _mm_srli_epi64(quads, 32));
+    return _mm_shuffle_epi8(groups, _mm_setr_epi8(4, 3, 2, 1, 0, 12, 11, 10, 9,
+                                                  8, -1, -1, -1, -1, -1, -1));
+}
+
+// As for Base64, each block stores more than it decodes; the reserve of input
+// guarantees the room.
+UTILS_TARGET_SSE42 inline std::size_t
+decode_base32_sse42(char const* const in, std::size_t const size,
+                    unsigned char* const out) noexcept
+{
+    std::size_t i = 0;
+    for (; size - i >= 32; i += 16) {
+        bool invalid = false;
+        auto const values = base32_values_sse42(
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i)), invalid);
+        if (invalid) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + (i / 8 * 5)),
+                         base32_pack_sse42(values));
+    }
+    return i;
+}
+
+UTILS_TARGET_AVX2 inline std::size_t
+decode_base32_avx2(char const* const in, std::size_t const size,
+                   unsigned char* const out) noexcept
+{
+    std::size_t i = 0;
+    for (; size - i >= 48; i += 32) {
+        auto const v =
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + i));
+        auto const upper = _mm256_sub_epi8(v, _mm256_set1_epi8('A'));
+        auto const digit = _mm256_sub_epi8(v, _mm256_set1_epi8('2'));
+        auto const is_upper = _mm256_cmpeq_epi8(
+            _mm256_min_epu8(upper, _mm256_set1_epi8(25)), upper);
+        auto const is_digit = _mm256_cmpeq_epi8(
+            _mm256_min_epu8(digit, _mm256_set1_epi8(5)), digit);
+        if (~_mm256_movemask_epi8(_mm256_or_si256(is_upper, is_digit)) != 0) {
+            break;
+        }
+        auto const values = _mm256_or_si256(
+            _mm256_and_si256(is_upper, upper),
+            _mm256_and_si256(is_digit,
+                             _mm256_add_epi8(digit, _mm256_set1_epi8(26))));
+        auto const pairs =
+            _mm256_maddubs_epi16(values, _mm256_set1_epi16(0x0120));
+        auto const quads =
+            _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00010400));
+        auto const groups = _mm256_add_epi64(
+            _mm256_mul_epu32(quads, _mm256_set1_epi64x(1 << 20)),
+            _mm256_srli_epi64(quads, 32));
+        // 10 bytes at the start of each lane, stored lane by lane.
+        auto const bytes = _mm256_shuffle_epi8(
+            groups,
+            _mm256_setr_epi8(4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1, -1, -1,
+                             -1, -1, 4, 3, 2, 1, 0, 12, 11, 10, 9, 8, -1, -1,
+                             -1, -1, -1, -1));
+        auto* const dest = out + (i / 8 * 5);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                         _mm256_castsi256_si128(bytes));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 10),
+                         _mm256_extracti128_si256(bytes, 1));
+    }
+    return i + decode_base32_sse42(in + i, size - i, out + (i / 8 * 5));
+}
+#endif
+} // namespace detail
+
+// Base32-encode (RFC 4648 alphabet) a prefix of `in` into `out` (eight
+// characters per five bytes) in whole vector blocks. Returns the number of
+// input bytes consumed, a multiple of 5, which is 0 at level::scalar; the
+// caller encodes the rest.
+[[nodiscard]] inline std::size_t encode_base32(unsigned char const* const in,
+                                               std::size_t const size,
+                                               char* const out) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::encode_base32_avx2(in, size, out);
+    case level::sse4_2:
+        return detail::encode_base32_sse42(in, size, out);
+    case level::scalar:
+        break;
+    }
+#endif
+    utils::unused(in, size, out);
+    return 0;
+}
+
+// Decode a prefix of the unpadded Base32 string `in` into `out`, which must
+// hold its size * 5 / 8 bytes, in whole vector blocks, stopping at the first
+// block holding a character outside the alphabet. Returns the number of
+// characters consumed, a multiple of 8, which is 0 at level::scalar; the
+// caller decodes (and validates) the rest.
+[[nodiscard]] inline std::size_t
+decode_base32(char const* const in, std::size_t const size,
+              unsigned char* const out) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::decode_base32_avx2(in, size, out);
+    case level::sse4_2:
+        return detail::decode_base32_sse42(in, size, out);
+    case level::scalar:
+        break;
+    }
+#endif
+    utils::unused(in, size, out);
+    return 0;
+}
+
+// ----------
+// ASCII case folding
+// ----------
+
+namespace detail
+{
+// Branch-free ASCII folding: 'A'-'Z' gain the 0x20 case bit, all other bytes
+// (including non-ASCII) are unchanged.
+[[nodiscard]] constexpr unsigned char
+ascii_fold(unsigned char const c) noexcept
+{
+    return static_cast<unsigned char>(
+        c | (static_cast<unsigned>(static_cast<unsigned char>(c - 'A') < 26U)
+             << 5U));
+}
+
+[[nodiscard]] inline bool equal_icase_scalar(char const* const a,
+                                             char const* const b,
+                                             std::size_t const size) noexcept
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        if (ascii_fold(static_cast<unsigned char>(a[i])) !=
+            ascii_fold(static_cast<unsigned char>(b[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+[[nodiscard]] inline char const*
+find_icase_scalar(char const* first, char const* const last,
+                  char const* const needle, std::size_t const size) noexcept
+{
+    auto const head = ascii_fold(static_cast<unsigned char>(needle[0]));
+    for (; static_cast<std::size_t>(last - first) >= size; ++first) {
+        if (ascii_fold(static_cast<unsigned char>(*first)) == head &&
+            equal_icase_scalar(first + 1, needle + 1, size - 1)) {
+            return first;
+        }
+    }
+    return last;
+}
+
+// Flip the case bit of every byte in [lo, lo + 25].
+inline void convert_case_scalar(char* const data, std::size_t const size,
+                                char const lo) noexcept
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        auto const c = static_cast<unsigned char>(data[i]);
+        auto const in_range =
+            static_cast<unsigned char>(c - static_cast<unsigned char>(lo)) <
+            26U;
+        data[i] =
+            static_cast<char>(c ^ (static_cast<unsigned>(in_range) << 5U));
+    }
+}
+
+#if defined(UTILS_SIMD_X86)
+// Mask of the bytes in [lo, lo + 25].
+UTILS_TARGET_SSE42 inline __m128i in_letter_range_sse42(__m128i const v,
+                                                        char const lo) noexcept
+{
+    auto const shifted = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(25)), shifted);
+}
+
+UTILS_TARGET_SSE42 inline __m128i fold_sse42(__m128i const v) noexcept
+{
+    return _mm_or_si128(v, _mm_and_si128(in_letter_range_sse42(v, 'A'),
+                                         _mm_set1_epi8(0x20)));
+}
+
+UTILS_TARGET_AVX2 inline __m256i in_letter_range_avx2(__m256i const v,
+                                                      char const lo) noexcept
+{
+    auto const shifted = _mm256_sub_epi8(v, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(25)),
+                             shifted);
+}
+
+UTILS_TARGET_AVX2 inline __m256i fold_avx2(__m256i const v) noexcept
+{
+    return _mm256_or_si256(v, _mm256_and_si256(in_letter_range_avx2(v, 'A'),
+                                               _mm256_set1_epi8(0x20)));
+}
+
+UTILS_TARGET_SSE42 inline bool
+equal_icase_sse42(char const* const a, char const* const b,
+                  std::size_t const size) noexcept
+{
+    std::size_t i = 0;
+    for (; size - i >= 16; i += 16) {
+        auto const va =
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(a + i));
+        auto const vb =
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(b + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(fold_sse42(va), fold_sse42(vb))) !=
+            0xFFFF) {
+            return false;
+        }
+    }
+    return equal_icase_scalar(a + i, b + i, size - i);
+}
+
+UTILS_TARGET_AVX2 inline bool equal_icase_avx2(char const* const a,
+                                               char const* const b,
+                                               std::size_t const size) noexcept
+{
+    std::size_t i = 0;
+    for (; size - i >= 32; i += 32) {
+        auto const va =
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a + i));
+        auto const vb =
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + i));
+        if (~_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(fold_avx2(va), fold_avx2(vb))) != 0) {
+            return false;
+        }
+    }
+    return equal_icase_sse42(a + i, b + i, size - i);
+}
+
+UTILS_TARGET_SSE42 inline char const*
+find_icase_sse42(char const* first, char const* const last,
+                 char const* const needle, std::size_t const size) noexcept
+{
+    auto const head =
+        _mm_set1_epi8(static_cast<char>(ascii_fold(
+            static_cast<unsigned char>(needle[0]))));
+    auto const tail =
+        _mm_set1_epi8(static_cast<char>(ascii_fold(
+            static_cast<unsigned char>(needle[size - 1]))));
+    for (; static_cast<std::size_t>(last - first) >= size - 1 + 16;
+         first += 16) {
+        auto const a = fold_sse42(
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(first)));
+        auto const b = fold_sse42(_mm_loadu_si128(
+            reinterpret_cast<__m128i const*>(first + size - 1)));
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(a, head), _mm_cmpeq_epi8(b, tail))));
+        while (mask != 0) {
+            auto const* const candidate = first + __builtin_ctz(mask);
+            if (equal_icase_sse42(candidate + 1, needle + 1, size - 1)) {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return find_icase_scalar(first, last, needle, size);
+}
+
+UTILS_TARGET_AVX2 inline char const*
+find_icase_avx2(char const* first, char const* const last,
+                char const* const needle, std::size_t const size) noexcept
+{
+    auto const head =
+        _mm256_set1_epi8(static_cast<char>(ascii_fold(
+            static_cast<unsigned char>(needle[0]))));
+    auto const tail =
+        _mm256_set1_epi8(static_cast<char>(ascii_fold(
+            static_cast<unsigned char>(needle[size - 1]))));
+    for (; static_cast<std::size_t>(last - first) >= size - 1 + 32;
+         first += 32) {
+        auto const a = fold_avx2(
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(first)));
+        auto const b = fold_avx2(_mm256_loadu_si256(
+            reinterpret_cast<__m256i const*>(first + size - 1)));
+        auto mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(a, head), _mm256_cmpeq_epi8(b, tail))));
+        while (mask != 0) {
+            auto const* const candidate = first + __builtin_ctz(mask);
+            if (equal_icase_avx2(candidate + 1, needle + 1, size - 1)) {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return find_icase_sse42(first, last, needle, size);
+}
+
+UTILS_TARGET_SSE42 inline void convert_case_sse42(char* const data,
+                                                  std::size_t const size,
+                                                  char const lo) noexcept
+{
+    std::size_t i = 0;
+    for (; size - i >= 16; i += 16) {
+        auto* const p = reinterpret_cast<__m128i*>(data + i);
+        auto const v = _mm_loadu_si128(p);
+        _mm_storeu_si128(
+            p, _mm_xor_si128(v, _mm_and_si128(in_letter_range_sse42(v, lo),
+                                              _mm_set1_epi8(0x20))));
+    }
+    convert_case_scalar(data + i, size - i, lo);
+}
+
+UTILS_TARGET_AVX2 inline void convert_case_avx2(char* const data,
+                                                std::size_t const size,
+                                                char const lo) noexcept
+{
+    std::size_t i = 0;
+    for (; size - i >= 32; i += 32) {
+        auto* const p = reinterpret_cast<__m256i*>(data + i);
+        auto const v = _mm256_loadu_si256(p);
+        _mm256_storeu_si256(
+            p, _mm256_xor_si256(v, _mm256_and_si256(in_letter_range_avx2(v, lo),
+                                                    _mm256_set1_epi8(0x20))));
+    }
+    convert_case_sse42(data + i, size - i, lo);
+}
+#endif
+
+inline void convert_case(char* const data, std::size_t const size,
+                         char const lo) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return convert_case_avx2(data, size, lo);
+    case level::sse4_2:
+        return convert_case_sse42(data, size, lo);
+    case level::scalar:
+        break;
+    }
+#endif
+    convert_case_scalar(data, size, lo);
+}
+} // namespace detail
+
+// Whether the `size` bytes at `a` and `b` are equal ignoring ASCII case.
+[[nodiscard]] inline bool equal_icase(char const* const a, char const* const b,
+                                      std::size_t const size) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::equal_icase_avx2(a, b, size);
+    case level::sse4_2:
+        return detail::equal_icase_sse42(a, b, size);
+    case level::scalar:
+        break;
+    }
+#endif
+    return detail::equal_icase_scalar(a, b, size);
+}
+
+// find() ignoring ASCII case.
+[[nodiscard]] inline char const* find_icase(char const* const first,
+                                            char const* const last,
+                                            char const* const needle,
+                                            std::size_t const size) noexcept
+{
+    if (size == 0) {
+        return first;
+    }
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::find_icase_avx2(first, last, needle, size);
+    case level::sse4_2:
+        return detail::find_icase_sse42(first, last, needle, size);
+    case level::scalar:
+        break;
+    }
+#endif
+    return detail::find_icase_scalar(first, last, needle, size);
+}
+
+// In-place ASCII case conversion; non-ASCII bytes are left alone.
+inline void to_lower_ascii(char* const data, std::size_t const size) noexcept
+{
+    detail::convert_case(data, size, 'A');
+}
+
+inline void to_upper_ascii(char* const data, std::size_t const size) noexcept
+{
+    detail::convert_case(data, size, 'a');
+}
+
+// ----------
+// Block bitmasks
+// ----------
+
+// Positions of three byte values in a 64-byte block: bit i of `a` is set when
+// block[i] == a, and likewise for `b` and `c`. Structural scanners (CSV, line
+// splitting) classify a block once and then walk the bits, instead of
+// restarting a search for every field.
+struct block_masks
+{
+    std::uint64_t a{0};
+    std::uint64_t b{0};
+    std::uint64_t c{0};
+};
+
+namespace detail
+{
+[[nodiscard]] inline block_masks match_block64_scalar(char const* const block,
+                                                      char const a,
+                                                      char const b,
+                                                      char const c) noexcept
+{
+    block_masks masks;
+    for (unsigned i = 0; i < 64; ++i) {
+        auto const bit = std::uint64_t{1} << i;
+        masks.a |= block[i] == a ? bit : 0;
+        masks.b |= block[i] == b ? bit : 0;
+        masks.c |= block[i] == c ? bit : 0;
+    }
+    return masks;
+}
+
+[[nodiscard]] inline std::uint64_t match_block64_scalar(char const* const block,
+                                                        char const ch) noexcept
+{
+    std::uint64_t mask = 0;
+    for (unsigned i = 0; i < 64; ++i) {
+        mask |= block[i] == ch ? std::uint64_t{1} << i : 0;
+    }
+    return mask;
+}
+
+[[nodiscard]] inline std::size_t count_scalar(char const* first,
+                                              char const* const last,
+                                              char const ch) noexcept
+{
+    std::size_t count = 0;
+    for (; first != last; ++first) {
+        count += *first == ch ? 1 : 0;
+    }
+    return count;
+}
+
+#if defined(UTILS_SIMD_X86)
+UTILS_TARGET_SSE42 inline std::uint64_t
+match_mask64_sse42(__m128i const (&v)[4], char const ch) noexcept
+{
+    auto const needle = _mm_set1_epi8(ch);
+    std::uint64_t mask = 0;
+    for (unsigned i = 0; i < 4; ++i) {
+        auto const bits = static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(v[i], needle)));
+        mask |= std::uint64_t{bits} << (i * 16);
+    }
+    return mask;
+}
+
+UTILS_TARGET_SSE42 inline block_masks
+match_block64_sse42(char const* const block, char const a, char const b,
+                    char const c) noexcept
+{
+    __m128i const v[4] = {
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(block)),
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 16)),
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 32)),
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 48))};
+    return {match_mask64_sse42(v, a), match_mask64_sse42(v, b),
+            match_mask64_sse42(v, c)};
+}
+
+UTILS_TARGET_SSE42 inline std::uint64_t
+match_block64_sse42(char const* const block, char const ch) noexcept
+{
+    __m128i const v[4] = {
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(block)),
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 16)),
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 32)),
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 48))};
+    return match_mask64_sse42(v, ch);
+}
+
+UTILS_TARGET_AVX2 inline std::uint64_t
+match_mask64_avx2(__m256i const lo, __m256i const hi, char const ch) noexcept
+{
+    auto const needle = _mm256_set1_epi8(ch);
+    auto const lo_bits = static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+    auto const hi_bits = static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+    return std::uint64_t{lo_bits} | (std::uint64_t{hi_bits} << 32U);
+}
+
+UTILS_TARGET_AVX2 inline block_masks
+match_block64_avx2(char const* const block, char const a, char const b,
+                   char const c) noexcept
+{
+    auto const lo = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block));
+    auto const hi =
+        _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block + 32));
+    return {match_mask64_avx2(lo, hi, a), match_mask64_avx2(lo, hi, b),
+            match_mask64_avx2(lo, hi, c)};
+}
+
+UTILS_TARGET_AVX2 inline std::uint64_t
+match_block64_avx2(char const* const block, char const ch) noexcept
+{
+    auto const lo = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block));
+    auto const hi =
+        _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block + 32));
+    return match_mask64_avx2(lo, hi, ch);
+}
+
+// cmpeq yields -1 per match, so subtracting it counts matches in byte lanes;
+// the lanes are folded into 64-bit sums with sad before they can overflow.
+UTILS_TARGET_SSE42 inline std::size_t count_sse42(char const* first,
+                                                  char const* const last,
+                                                  char const ch) noexcept
+{
+    auto const needle = _mm_set1_epi8(ch);
+    auto totals = _mm_setzero_si128();
+    while (last - first >= 16) {
+        auto lanes = _mm_setzero_si128();
+        for (unsigned n = 0; n < 255 && last - first >= 16; ++n, first += 16) {
+            auto const v =
+                _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+            lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(v, needle));
+        }
+        totals = _mm_add_epi64(totals,
+                               _mm_sad_epu8(lanes, _mm_setzero_si128()));
+    }
+    std::uint64_t sums[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), totals);
+    return static_cast<std::size_t>(sums[0] + sums[1]) +
+           count_scalar(first, last, ch);
+}
+
+UTILS_TARGET_AVX2 inline std::size_t count_avx2(char const* first,
+                                                char const* const last,
+                                                char const ch) noexcept
+{
+    auto const needle = _mm256_set1_epi8(ch);
+    auto totals = _mm256_setzero_si256();
+    while (last - first >= 32) {
+        auto lanes = _mm256_setzero_si256();
+        for (unsigned n = 0; n < 255 && last - first >= 32; ++n, first += 32) {
+            auto const v =
+                _mm256_loadu_si256(reinterpret_cast<__m256i const*>(first));
+            lanes = _mm256_sub_epi8(lanes, _mm256_cmpeq_epi8(v, needle));
+        }
+        totals = _mm256_add_epi64(
+            totals, _mm256_sad_epu8(lanes, _mm256_setzero_si256()));
+    }
+    std::uint64_t sums[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums),
+                     _mm_add_epi64(_mm256_castsi256_si128(totals),
+                                   _mm256_extracti128_si256(totals, 1)));
+    return static_cast<std::size_t>(sums[0] + sums[1]) +
+           count_sse42(first, last, ch);
+}
+#endif
+} // namespace detail
+
+// Classify the 64 bytes at `block` (all of which must be readable).
+[[nodiscard]] inline block_masks match_block64(char const* const block,
+                                               char const a, char const b,
+                                               char const c) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::match_block64_avx2(block, a, b, c);
+    case level::sse4_2:
+        return detail::match_block64_sse42(block, a, b, c);
+    case level::scalar:
+        break;
+    }
+#endif
+    return detail::match_block64_scalar(block, a, b, c);
+}
+
+// Positions of one byte value in the 64 bytes at `block`: bit i is set when
+// block[i] == ch.
+[[nodiscard]] inline std::uint64_t match_block64(char const* const block,
+                                                 char const ch) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::match_block64_avx2(block, ch);
+    case level::sse4_2:
+        return detail::match_block64_sse42(block, ch);
+    case level::scalar:
+        break;
+    }
+#endif
+    return detail::match_block64_scalar(block, ch);
+}
+
+// Number of bytes equal to `ch` in [first, last).
+[[nodiscard]] inline std::size_t count(char const* const first,
+                                       char const* const last,
+                                       char const ch) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::count_avx2(first, last, ch);
+    case level::sse4_2:
+        return detail::count_sse42(first, last, ch);
+    case level::scalar:
+        break;
+    }
+#endif
+    return detail::count_scalar(first, last, ch);
+}
+
+// ----------
+// Decimal digits
+// ----------
+
+// SWAR (eight digits per 64-bit word) decimal parsing. Portable and branch-free
+// within a word, so there is nothing to dispatch: a field of up to 19 digits
+// costs at most three word loads and multiplies instead of one multiply-add
+// per character.
+
+namespace detail
+{
+inline constexpr std::uint64_t ones = 0x0101010101010101ULL;
+
+// Little-endian view of up to 8 bytes at `p`; missing bytes read as zero, which
+// is not a digit. Never reads past p + size.
+[[nodiscard]] inline std::uint64_t load_word(char const* const p,
+                                             std::size_t const size) noexcept
+{
+    std::uint64_t word = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (std::size_t i = 0; i < size && i < 8; ++i) {
+        word |= std::uint64_t{static_cast<unsigned char>(p[i])} << (i * 8);
+    }
+#else
+    // Short reads use two overlapping fixed-size loads rather than a
+    // variable-length memcpy (an out-of-line call); the shared bytes are
+    // equal, so OR-ing them is harmless.
+    if (size >= 8) {
+        std::memcpy(&word, p, 8);
+    } else if (size >= 4) {
+        std::uint32_t lo = 0;
+        std::uint32_t hi = 0;
+        std::memcpy(&lo, p, 4);
+        std::memcpy(&hi, p + size - 4, 4);
+        word = lo | (std::uint64_t{hi} << ((size - 4) * 8));
+    } else if (size >= 2) {
+        std::uint16_t lo = 0;
+        std::uint16_t hi = 0;
+        std::memcpy(&lo, p, 2);
+        std::memcpy(&hi, p + size - 2, 2);
+        word = lo | (std::uint64_t{hi} << ((size - 2) * 8));
+    } else if (size == 1) {
+        word = static_cast<unsigned char>(*p);
+    }
+#endif
+    return word;
+}
+
+// High bit set in every byte of `word` that is not an ASCII digit.
+[[nodiscard]] constexpr std::uint64_t
+non_digits(std::uint64_t const word) noexcept
+{
+    // Digits become 0..9 per byte; flag the bytes above 9. Masking to 7 bits
+    // first keeps the add from carrying into the next byte.
+    auto const x = word ^ (ones * '0');
+    return (((x & (ones * 0x7F)) + (ones * (0x7F - 9))) | x) & (ones * 0x80);
+}
+
+// Number of leading ASCII digits (0..8) in `word`.
+[[nodiscard]] inline std::size_t
+leading_digits(std::uint64_t const word) noexcept
+{
+    auto const over = non_digits(word);
+    if (over == 0) {
+        return 8;
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctzll(over)) / 8;
+#else
+    std::size_t count = 0;
+    while (((over >> (count * 8)) & 0x80U) == 0) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+// Value of the eight digit values (0..9 per byte) in `word`, first byte most
+// significant.
+[[nodiscard]] constexpr std::uint32_t digits_value(std::uint64_t word) noexcept
+{
+    word = (word * 10) + (word >> 8U);
+    word = (((word & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32U))) +
+            (((word >> 16U) & 0x000000FF000000FFULL) *
+             (1 + (10000ULL << 32U)))) >>
+           32U;
+    return static_cast<std::uint32_t>(word);
+}
+
+// Value of the first `count` (1..8) digits of `word`: '0' is subtracted, then
+// the digits are shifted to the top so the zero bytes below act as leading
+// zeros. Any borrow from non-digits after them only reaches bytes that are
+// shifted out.
+[[nodiscard]] constexpr std::uint32_t
+prefix_value(std::uint64_t const word, std::size_t const count) noexcept
+{
+    return digits_value((word - (ones * '0')) << ((8 - count) * 8));
+}
+
+inline constexpr std::uint64_t powers_of_ten[9] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+} // namespace detail
+
+// Value of the 8 ASCII digits at `p`, which must all be digits.
+[[nodiscard]] inline std::uint32_t
+parse_eight_digits(char const* const p) noexcept
+{
+    return detail::digits_value(detail::load_word(p, 8) -
+                                (detail::ones * '0'));
+}
+
+// Value of the 16 ASCII digits at `p`, which must all be digits.
+[[nodiscard]] inline std::uint64_t
+parse_sixteen_digits(char const* const p) noexcept
+{
+    return (std::uint64_t{parse_eight_digits(p)} * 100000000ULL) +
+           parse_eight_digits(p + 8);
+}
+
+// Parse the leading run of decimal digits in [first, last), up to 19 of them
+// (the most that always fit in 64 bits), into `value`. Returns one past the
+// last digit consumed: the first non-digit, `last`, or the 20th digit of a
+// longer run, which the caller must handle.
+[[nodiscard]] inline char const* parse_digits(char const* first,
+                                              char const* const last,
+                                              std::uint64_t& value) noexcept
+{
+    std::uint64_t result = 0;
+    std::size_t budget = 19;
+    while (first != last && budget != 0) {
+        auto const available = static_cast<std::size_t>(last - first);
+        auto const word = detail::load_word(first, available);
+        auto count = detail::leading_digits(word);
+        if (count > budget) {
+            count = budget;
+        }
+        if (count == 0) {
+            break;
+        }
+        result = (result * detail::powers_of_ten[count]) +
+                 detail::prefix_value(word, count);
+        first += count;
+        budget -= count;
+        if (count != 8) {
+            break;
+        }
+    }
+    value = result;
+    return first;
+}
+
+// Parse exactly `size` (1..19) ASCII digits at `p` into `value`. Returns false,
+// leaving `value` alone, if `size` is out of range or any byte is not a digit.
+// Knowing the length up front lets every word be loaded independently: longer
+// inputs take their last eight digits from a load ending at p + size that
+// overlaps the words before it.
+[[nodiscard]] inline bool parse_digits_exact(char const* const p,
+                                             std::size_t const size,
+                                             std::uint64_t& value) noexcept
+{
+    if (size <= 8) {
+        if (size == 0) {
+            return false;
+        }
+        auto const word = detail::load_word(p, size);
+        if (detail::leading_digits(word) < size) {
+            return false;
+        }
+        value = detail::prefix_value(word, size);
+        return true;
+    }
+    if (size > 19) {
+        return false;
+    }
+
+    auto const head = detail::load_word(p, 8);
+    auto const tail = detail::load_word(p + size - 8, 8);
+    if (size <= 16) {
+        if ((detail::non_digits(head) | detail::non_digits(tail)) != 0) {
+            return false;
+        }
+        value = (std::uint64_t{detail::prefix_value(head, size - 8)} *
+                 100000000ULL) +
+                detail::prefix_value(tail, 8);
+        return true;
+    }
+    auto const middle = detail::load_word(p + 8, 8);
+    if ((detail::non_digits(head) | detail::non_digits(middle) |
+         detail::non_digits(tail)) != 0) {
+        return false;
+    }
+    auto const upper =
+        (std::uint64_t{detail::prefix_value(head, 8)} *
+         detail::powers_of_ten[size - 16]) +
+        detail::prefix_value(middle, size - 16);
+    value = (upper * 100000000ULL) + detail::prefix_value(tail, 8);
+    return true;
+}
+
+// ----------
+// Unicode
+// ----------
+
+// UTF-8 validation and counting, and transcoding between UTF-8 and
+// UTF-16/UTF-32. The transcoders stop at the first malformed sequence.
+
+// Input units consumed (the offset of the malformed sequence, if any) and
+// output units produced by a conversion.
+struct utf_conversion
+{
+    std::size_t read{0};
+    std::size_t written{0};
+};
+
+namespace detail
+{
+[[nodiscard]] constexpr bool is_continuation(unsigned char const b) noexcept
+{
+    return (b & 0xC0U) == 0x80U;
+}
+
+[[nodiscard]] inline bool is_ascii_word(unsigned char const* const p) noexcept
+{
+    std::uint64_t word = 0;
+    std::memcpy(&word, p, 8);
+    return (word & 0x8080808080808080ULL) == 0;
+}
+
+// A character boundary at most four bytes before `p`, given that [first, p)
+// is well-formed except for a possibly incomplete final sequence.
+[[nodiscard]] inline char const* utf8_boundary(char const* const first,
+                                               char const* p) noexcept
+{
+    for (int i = 0; i < 3 && p != first &&
+                    is_continuation(static_cast<unsigned char>(p[-1]));
+         ++i) {
+        --p;
+    }
+    if (p != first && static_cast<unsigned char>(p[-1]) >= 0xC0U) {
+        --p;
+    }
+    return p;
+}
+
+// Length of the well-formed sequence starting with the non-ASCII byte at `p`,
+// or 0 if it is malformed. The second byte's range rules out overlong forms,
+// surrogates and code points above U+10FFFF.
+[[nodiscard]] inline std::size_t
+utf8_sequence_size(unsigned char const* const p,
+                   unsigned char const* const end) noexcept
+{
+    auto const lead = *p;
+    std::size_t size = 0;
+    unsigned lo = 0x80;
+    unsigned hi = 0xBF;
+    if (lead >= 0xC2U && lead <= 0xDFU) {
+        size = 2;
+    } else if (lead >= 0xE0U && lead <= 0xEFU) {
+        size = 3;
+        lo = lead == 0xE0U ? 0xA0 : lo;
+        hi = lead == 0xEDU ? 0x9F : hi;
+    } else if (lead >= 0xF0U && lead <= 0xF4U) {
+        size = 4;
+        lo = lead == 0xF0U ? 0x90 : lo;
+        hi = lead == 0xF4U ? 0x8F : hi;
+    } else {
+        return 0;
+    }
+    if (static_cast<std::size_t>(end - p) < size || p[1] < lo || p[1] > hi ||
+        (size > 2 && !is_continuation(p[2])) ||
+        (size > 3 && !is_continuation(p[3]))) {
+        return 0;
+    }
+    return size;
+}
+
+[[nodiscard]] inline char const*
+validate_utf8_scalar(char const* const first, char const* const last) noexcept
+{
+    auto const* p = reinterpret_cast<unsigned char const*>(first);
+    auto const* const end = reinterpret_cast<unsigned char const*>(last);
+    while (p != end) {
+        if (*p < 0x80U) {
+            p += end - p >= 8 && is_ascii_word(p) ? 8 : 1;
+            continue;
+        }
+        auto const size = utf8_sequence_size(p, end);
+        if (size == 0) {
+            break;
+        }
+        p += size;
+    }
+    return reinterpret_cast<char const*>(p);
+}
+
+// Text without surrogates is valid UTF-16, so it is checked in fixed-size
+// blocks with a branch-free test that compilers vectorize.
+[[nodiscard]] inline char16_t const*
+validate_utf16_scalar(char16_t const* p, char16_t const* const last) noexcept
+{
+    constexpr std::ptrdiff_t block = 16;
+    while (p != last) {
+        if (last - p >= block) {
+            unsigned surrogates = 0;
+            for (std::ptrdiff_t k = 0; k < block; ++k) {
+                surrogates |= (p[k] & 0xF800U) == 0xD800U ? 1U : 0U;
+            }
+            if (surrogates == 0) {
+                p += block;
+                continue;
+            }
+        }
+        auto const unit = *p;
+        if ((unit & 0xF800U) != 0xD800U) {
+            ++p;
+        } else if (unit <= 0xDBFFU && last - p >= 2 &&
+                   (p[1] & 0xFC00U) == 0xDC00U) {
+            p += 2;
+        } else {
+            break;
+        }
+    }
+    return p;
+}
+
+[[nodiscard]] inline char32_t const*
+validate_utf32_scalar(char32_t const* p, char32_t const* const last) noexcept
+{
+    for (; p != last; ++p) {
+        if (*p > 0x10FFFFU || (*p & 0xFFFFF800U) == 0xD800U) {
+            break;
+        }
+    }
+    return p;
+}
+
+// Characters in [first, last), plus the four-byte ones again when counting
+// UTF-16 code units (they take a surrogate pair). Eight bytes at a time: the
+// high bit of each byte is moved down and the flags summed by a multiply.
+[[nodiscard]] inline std::size_t utf8_units_scalar(char const* first,
+                                                   char const* const last,
+                                                   bool const utf16) noexcept
+{
+    constexpr std::uint64_t high = 0x8080808080808080ULL;
+    std::size_t count = 0;
+    for (; last - first >= 8; first += 8) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, first, 8);
+        // Continuation bytes are 10xxxxxx; four-byte leads are 11110xxx.
+        auto const continuation = word & ~(word << 1U) & high;
+        count += 8 - (((continuation >> 7U) * 0x0101010101010101ULL) >> 56U);
+        if (utf16) {
+            auto const four =
+                word & (word << 1U) & (word << 2U) & (word << 3U) & high;
+            count += ((four >> 7U) * 0x0101010101010101ULL) >> 56U;
+        }
+    }
+    for (; first != last; ++first) {
+        auto const b = static_cast<unsigned char>(*first);
+        count += is_continuation(b) ? 0 : 1;
+        count += utf16 && b >= 0xF0U ? 1 : 0;
+    }
+    return count;
+}
+
+// Decode the well-formed sequence at `p`; returns its length.
+[[nodiscard]] inline std::size_t decode_utf8(unsigned char const* const p,
+                                             char32_t& cp) noexcept
+{
+    auto const lead = static_cast<char32_t>(p[0]);
+    if (lead < 0x80U) {
+        cp = lead;
+        return 1;
+    }
+    if (lead < 0xE0U) {
+        cp = ((lead & 0x1FU) << 6U) | (p[1] & 0x3FU);
+        return 2;
+    }
+    if (lead < 0xF0U) {
+        cp = ((lead & 0x0FU) << 12U) | ((p[1] & 0x3FU) << 6U) | (p[2] & 0x3FU);
+        return 3;
+    }
+    cp = ((lead & 0x07U) << 18U) | ((p[1] & 0x3FU) << 12U) |
+         ((p[2] & 0x3FU) << 6U) | (p[3] & 0x3FU);
+    return 4;
+}
+
+// Store `cp` as one UTF-32 unit, or as one or two UTF-16 units.
+template <typename Out>
+[[nodiscard]] inline Out* put_code_point(Out* const out,
+                                         char32_t const cp) noexcept
+{
+    if constexpr (std::is_same_v<Out, char16_t>) {
+        if (cp >= 0x10000U) {
+            out[0] = static_cast<char16_t>(0xD7C0U + (cp >> 10U));
+            out[1] = static_cast<char16_t>(0xDC00U | (cp & 0x3FFU));
+            return out + 2;
+        }
+    }
+    *out = static_cast<Out>(cp);
+    return out + 1;
+}
+
+[[nodiscard]] inline char* put_utf8(char* const out, char32_t const cp) noexcept
+{
+    if (cp < 0x80U) {
+        out[0] = static_cast<char>(cp);
+        return out + 1;
+    }
+    if (cp < 0x800U) {
+        out[0] = static_cast<char>(0xC0U | (cp >> 6U));
+        out[1] = static_cast<char>(0x80U | (cp & 0x3FU));
+        return out + 2;
+    }
+    if (cp < 0x10000U) {
+        out[0] = static_cast<char>(0xE0U | (cp >> 12U));
+        out[1] = static_cast<char>(0x80U | ((cp >> 6U) & 0x3FU));
+        out[2] = static_cast<char>(0x80U | (cp & 0x3FU));
+        return out + 3;
+    }
+    out[0] = static_cast<char>(0xF0U | (cp >> 18U));
+    out[1] = static_cast<char>(0x80U | ((cp >> 12U) & 0x3FU));
+    out[2] = static_cast<char>(0x80U | ((cp >> 6U) & 0x3FU));
+    out[3] = static_cast<char>(0x80U | (cp & 0x3FU));
+    return out + 4;
+}
+
+// Next code point of well-formed UTF-16 at in[i], advancing `i` past it.
+[[nodiscard]] inline char32_t next_utf16(char16_t const* const in,
+                                         std::size_t& i) noexcept
+{
+    char32_t const unit = in[i++];
+    if ((unit & 0xFC00U) != 0xD800U) {
+        return unit;
+    }
+    return 0x10000U + ((unit - 0xD800U) << 10U) + (in[i++] - 0xDC00U);
+}
+
+// Convert the well-formed prefix of the UTF-8 at `in`, checking each sequence
+// as it is decoded.
+template <typename Out>
+[[nodiscard]] inline utf_conversion utf8_to_utf_scalar(char const* const in,
+                                                       std::size_t const size,
+                                                       Out* const out) noexcept
+{
+    auto const* const p = reinterpret_cast<unsigned char const*>(in);
+    auto* o = out;
+    std::size_t i = 0;
+    while (i < size) {
+        if (p[i] < 0x80U) {
+            if (size - i >= 8 && is_ascii_word(p + i)) {
+                for (std::size_t k = 0; k < 8; ++k) {
+                    o[k] = static_cast<Out>(p[i + k]);
+                }
+                i += 8;
+                o += 8;
+            } else {
+                *o++ = static_cast<Out>(p[i++]);
+            }
+            continue;
+        }
+        if (utf8_sequence_size(p + i, p + size) == 0) {
+            break;
+        }
+        char32_t cp = 0;
+        i += decode_utf8(p + i, cp);
+        o = put_code_point(o, cp);
+    }
+    return {i, static_cast<std::size_t>(o - out)};
+}
+
+template <typename In>
+[[nodiscard]] inline std::size_t utf_to_utf8_scalar(In const* const in,
+                                                    std::size_t const size,
+                                                    char* const out) noexcept
+{
+    auto* o = out;
+    for (std::size_t i = 0; i < size;) {
+        if constexpr (std::is_same_v<In, char16_t>) {
+            o = put_utf8(o, next_utf16(in, i));
+        } else {
+            o = put_utf8(o, in[i++]);
+        }
+    }
+    return static_cast<std::size_t>(o - out);
+}
+
+#if defined(UTILS_SIMD_X86)
+// Validation after Keiser and Lemire, "Validating UTF-8 In Less Than One
+// Instruction Per Byte": three nibble lookups on each byte and its predecessor
+// flag every malformed two-byte pattern; a byte two or three after a three- or
+// four-byte lead must be a continuation, which is checked separately.
+inline constexpr std::uint8_t utf8_too_short = 1U << 0U;
+inline constexpr std::uint8_t utf8_too_long = 1U << 1U;
+inline constexpr std::uint8_t utf8_overlong_3 = 1U << 2U;
+inline constexpr std::uint8_t utf8_too_large = 1U << 3U;
+inline constexpr std::uint8_t utf8_surrogate = 1U << 4U;
+inline constexpr std::uint8_t utf8_overlong_2 = 1U << 5U;
+inline constexpr std::uint8_t utf8_too_large_1000 = 1U << 6U;
+inline constexpr std::uint8_t utf8_overlong_4 = 1U << 6U;
+inline constexpr std::uint8_t utf8_two_conts = 1U << 7U;
+inline constexpr std::uint8_t utf8_carry =
+    utf8_too_short | utf8_too_long | utf8_two_conts;
+
+// Indexed by the high nibble of the previous byte.
+alignas(16) inline constexpr std::uint8_t utf8_byte_1_high[16] = {
+    utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long,
+    utf8_too_long, utf8_too_long, utf8_too_long, utf8_too_long,
+    utf8_two_conts, utf8_two_conts, utf8_two_conts, utf8_two_conts,
+    utf8_too_short | utf8_overlong_2,
+    utf8_too_short,
+    utf8_too_short | utf8_overlong_3 | utf8_surrogate,
+    utf8_too_short | utf8_too_large | utf8_too_large_1000 | utf8_overlong_4};
+
+// Indexed by the low nibble of the previous byte.
+alignas(16) inline constexpr std::uint8_t utf8_byte_1_low[16] = {
+    utf8_carry | utf8_overlong_3 | utf8_overlong_2 | utf8_overlong_4,
+    utf8_carry | utf8_overlong_2,
+    utf8_carry,
+    utf8_carry,
+    utf8_carry | utf8_too_large,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000 | utf8_surrogate,
+    utf8_carry | utf8_too_large | utf8_too_large_1000,
+    utf8_carry | utf8_too_large | utf8_too_large_1000};
+
+// Indexed by the high nibble of the current byte.
+alignas(16) inline constexpr std::uint8_t utf8_byte_2_high[16] = {
+    utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short,
+    utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short,
+    utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_overlong_3 |
+        utf8_too_large_1000 | utf8_overlong_4,
+    utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_overlong_3 |
+        utf8_too_large,
+    utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_surrogate |
+        utf8_too_large,
+    utf8_too_long | utf8_overlong_2 | utf8_two_conts | utf8_surrogate |
+        utf8_too_large,
+    utf8_too_short, utf8_too_short, utf8_too_short, utf8_too_short};
+
+// A block ends inside a sequence when one of its last three bytes is a lead
+// needing more bytes than remain: compare against these per-position maxima.
+alignas(32) inline constexpr std::uint8_t utf8_incomplete_max[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF};
+
+UTILS_TARGET_SSE42 inline __m128i utf8_errors_sse42(__m128i const input,
+                                                    __m128i const prev) noexcept
+{
+    auto const byte_1_high =
+        _mm_load_si128(reinterpret_cast<__m128i const*>(utf8_byte_1_high));
+    auto const byte_1_low =
+        _mm_load_si128(reinterpret_cast<__m128i const*>(utf8_byte_1_low));
+    auto const byte_2_high =
+        _mm_load_si128(reinterpret_cast<__m128i const*>(utf8_byte_2_high));
+    auto const nibble = _mm_set1_epi8(0x0F);
+    auto const prev1 = _mm_alignr_epi8(input, prev, 15);
+    auto const special = _mm_and_si128(
+        _mm_and_si128(
+            _mm_shuffle_epi8(byte_1_high,
+                             _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+            _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, nibble))),
+        _mm_shuffle_epi8(byte_2_high,
+                         _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+    // Only bytes >= 0xE0 (resp. 0xF0) keep the high bit after the subtraction.
+    auto const third = _mm_subs_epu8(_mm_alignr_epi8(input, prev, 14),
+                                     _mm_set1_epi8(0xE0 - 0x80));
+    auto const fourth = _mm_subs_epu8(_mm_alignr_epi8(input, prev, 13),
+                                      _mm_set1_epi8(0xF0 - 0x80));
+    auto const must_continue = _mm_and_si128(
+        _mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+    return _mm_xor_si128(must_continue, special);
+}
+
+// Both vector validators check whole blocks and stop at the first block with
+// an error; the scalar validator then resumes from the last character
+// boundary before it to find the exact offset (and to check the tail).
+UTILS_TARGET_SSE42 inline char const*
+validate_utf8_sse42(char const* const first, char const* const last) noexcept
+{
+    auto const max = _mm_load_si128(
+        reinterpret_cast<__m128i const*>(utf8_incomplete_max + 16));
+    auto prev = _mm_setzero_si128();
+    auto incomplete = _mm_setzero_si128();
+    auto const* p = first;
+    for (; last - p >= 16; p += 16) {
+        auto const input = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+        auto const errors = _mm_movemask_epi8(input) == 0
+                                ? incomplete
+                                : utf8_errors_sse42(input, prev);
+        if (_mm_testz_si128(errors, errors) == 0) {
+            break;
+        }
+        incomplete = _mm_subs_epu8(input, max);
+        prev = input;
+    }
+    return validate_utf8_scalar(utf8_boundary(first, p), last);
+}
+
+UTILS_TARGET_AVX2 inline __m256i utf8_errors_avx2(__m256i const input,
+                                                  __m256i const prev) noexcept
+{
+    auto const byte_1_high = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<__m128i const*>(utf8_byte_1_high)));
+    auto const byte_1_low = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<__m128i const*>(utf8_byte_1_low)));
+    auto const byte_2_high = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<__m128i const*>(utf8_byte_2_high)));
+    auto const nibble = _mm256_set1_epi8(0x0F);
+    // alignr works per 128-bit lane: pair each lane with the one before it.
+    auto const shifted = _mm256_permute2x128_si256(prev, input, 0x21);
+    auto const prev1 = _mm256_alignr_epi8(input, shifted, 15);
+    auto const special = _mm256_and_si256(
+        _mm256_and_si256(
+            _mm256_shuffle_epi8(
+                byte_1_high,
+                _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+            _mm256_shuffle_epi8(byte_1_low, _mm256_and_si256(prev1, nibble))),
+        _mm256_shuffle_epi8(
+            byte_2_high,
+            _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+    auto const third = _mm256_subs_epu8(_mm256_alignr_epi8(input, shifted, 14),
+                                        _mm256_set1_epi8(0xE0 - 0x80));
+    auto const fourth = _mm256_subs_epu8(
+        _mm256_alignr_epi8(input, shifted, 13), _mm256_set1_epi8(0xF0 - 0x80));
+    auto const must_continue =
+        _mm256_and_si256(_mm256_or_si256(third, fourth),
+                         _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_xor_si256(must_continue, special);
+}
+
+UTILS_TARGET_AVX2 inline char const*
+validate_utf8_avx2(char const* const first, char const* const last) noexcept
+{
+    auto const max = _mm256_load_si256(
+        reinterpret_cast<__m256i const*>(utf8_incomplete_max));
+    auto prev = _mm256_setzero_si256();
+    auto incomplete = _mm256_setzero_si256();
+    auto const* p = first;
+    for (; last - p >= 32; p += 32) {
+        auto const input =
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+        auto const errors = _mm256_movemask_epi8(input) == 0
+                                ? incomplete
+                                : utf8_errors_avx2(input, prev);
+        if (_mm256_testz_si256(errors, errors) == 0) {
+            break;
+        }
+        incomplete = _mm256_subs_epu8(input, max);
+        prev = input;
+    }
+    return validate_utf8_scalar(utf8_boundary(first, p), last);
+}
+
+// Same lane counting as count_sse42(): a character starts at every byte that
+// is not a continuation (signed > -65), and for UTF-16 a byte >= 0xF0 adds
+// the second unit of a surrogate pair.
+UTILS_TARGET_SSE42 inline std::size_t
+utf8_units_sse42(char const* first, char const* const last,
+                 bool const utf16) noexcept
+{
+    auto const continuation = _mm_set1_epi8(-65);
+    auto const four = _mm_set1_epi8(static_cast<char>(0xF0));
+    auto totals = _mm_setzero_si128();
+    while (last - first >= 16) {
+        auto lanes = _mm_setzero_si128();
+        for (unsigned n = 0; n < 127 && last - first >= 16; ++n, first += 16) {
+            auto const v =
+                _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+            lanes = _mm_sub_epi8(lanes, _mm_cmpgt_epi8(v, continuation));
+            if (utf16) {
+                lanes = _mm_sub_epi8(
+                    lanes, _mm_cmpeq_epi8(_mm_max_epu8(v, four), v));
+            }
+        }
+        totals = _mm_add_epi64(totals,
+                               _mm_sad_epu8(lanes, _mm_setzero_si128()));
+    }
+    std::uint64_t sums[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), totals);
+    return static_cast<std::size_t>(sums[0] + sums[1]) +
+           utf8_units_scalar(first, last, utf16);
+}
+
+UTILS_TARGET_AVX2 inline std::size_t utf8_units_avx2(char const* first,
+                                                     char const* const last,
+                                                     bool const utf16) noexcept
+{
+    auto const continuation = _mm256_set1_epi8(-65);
+    auto const four = _mm256_set1_epi8(static_cast<char>(0xF0));
+    auto totals = _mm256_setzero_si256();
+    while (last - first >= 32) {
+        auto lanes = _mm256_setzero_si256();
+        for (unsigned n = 0; n < 127 && last - first >= 32; ++n, first += 32) {
+            auto const v =
+                _mm256_loadu_si256(reinterpret_cast<__m256i const*>(first));
+            lanes = _mm256_sub_epi8(lanes, _mm256_cmpgt_epi8(v, continuation));
+            if (utf16) {
+                lanes = _mm256_sub_epi8(
+                    lanes, _mm256_cmpeq_epi8(_mm256_max_epu8(v, four), v));
+            }
+        }
+        totals = _mm256_add_epi64(
+            totals, _mm256_sad_epu8(lanes, _mm256_setzero_si256()));
+    }
+    std::uint64_t sums[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums),
+                     _mm_add_epi64(_mm256_castsi256_si128(totals),
+                                   _mm256_extracti128_si256(totals, 1)));
+    return static_cast<std::size_t>(sums[0] + sums[1]) +
+           utf8_units_sse42(first, last, utf16);
+}
+
+// The UTF-8 decoders take whole vector blocks where they can: all-ASCII
+// blocks are widened, four three-byte characters (most CJK text) or eight
+// two-byte ones (Latin, Greek, Cyrillic, ...) are decoded with one shuffle.
+// Anything else advances one character through the scalar decoder.
+
+// Store the eight 16-bit code points in `units`.
+template <typename Out>
+UTILS_TARGET_SSE42 inline void store_units16_sse42(Out* const out,
+                                                   __m128i const units) noexcept
+{
+    if constexpr (std::is_same_v<Out, char16_t>) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), units);
+    } else {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                         _mm_cvtepu16_epi32(units));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4),
+                         _mm_cvtepu16_epi32(_mm_srli_si128(units, 8)));
+    }
+}
+
+// Store the four BMP code points in the 32-bit lanes of `units`.
+template <typename Out>
+UTILS_TARGET_SSE42 inline void store_units32_sse42(Out* const out,
+                                                   __m128i const units) noexcept
+{
+    if constexpr (std::is_same_v<Out, char16_t>) {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out),
+                         _mm_packus_epi32(units, units));
+    } else {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), units);
+    }
+}
+
+// Decode four three-byte sequences from the first 12 bytes of `v` into
+// 32-bit lanes. Returns false if the bytes are not laid out that way.
+UTILS_TARGET_SSE42 inline bool utf8_three_byte_sse42(__m128i const v,
+                                                     __m128i& units) noexcept
+{
+    // lane = lead << 16 | second << 8 | third
+    auto const lanes = _mm_shuffle_epi8(
+        v, _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1));
+    auto const tags = _mm_and_si128(lanes, _mm_set1_epi32(0x00F0C0C0));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(tags, _mm_set1_epi32(0x00E08080))) !=
+        0xFFFF) {
+        return false;
+    }
+    units = _mm_or_si128(
+        _mm_or_si128(
+            _mm_srli_epi32(_mm_and_si128(lanes, _mm_set1_epi32(0x000F0000)), 4),
+            _mm_srli_epi32(_mm_and_si128(lanes, _mm_set1_epi32(0x3F00)), 2)),
+        _mm_and_si128(lanes, _mm_set1_epi32(0x3F)));
+    return true;
+}
+
+// Decode eight two-byte sequences from `v` into 16-bit lanes.
+UTILS_TARGET_SSE42 inline bool utf8_two_byte_sse42(__m128i const v,
+                                                   __m128i& units) noexcept
+{
+    // lane = lead << 8 | second
+    auto const lanes = _mm_shuffle_epi8(
+        v, _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+    auto const tags =
+        _mm_and_si128(lanes, _mm_set1_epi16(static_cast<short>(0xE0C0)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(
+            tags, _mm_set1_epi16(static_cast<short>(0xC080)))) != 0xFFFF) {
+        return false;
+    }
+    units = _mm_or_si128(
+        _mm_srli_epi16(_mm_and_si128(lanes, _mm_set1_epi16(0x1F00)), 2),
+        _mm_and_si128(lanes, _mm_set1_epi16(0x3F)));
+    return true;
+}
+
+// One step of the decoder for the non-ASCII block `v` at in[i]: its ASCII
+// prefix, a vector-decoded run, or a single character.
+template <typename Out>
+UTILS_TARGET_SSE42 inline void
+utf8_step_sse42(unsigned char const* const in, __m128i const v,
+                unsigned const ascii_mask, std::size_t& i, Out*& out) noexcept
+{
+    auto const ascii = static_cast<std::size_t>(__builtin_ctz(ascii_mask));
+    if (ascii != 0) {
+        for (std::size_t k = 0; k < ascii; ++k) {
+            out[k] = static_cast<Out>(in[i + k]);
+        }
+        i += ascii;
+        out += ascii;
+        return;
+    }
+    __m128i units;
+    if (utf8_three_byte_sse42(v, units)) {
+        store_units32_sse42(out, units);
+        i += 12;
+        out += 4;
+    } else if (utf8_two_byte_sse42(v, units)) {
+        store_units16_sse42(out, units);
+        i += 16;
+        out += 8;
+    } else {
+        char32_t cp = 0;
+        i += decode_utf8(in + i, cp);
+        out = put_code_point(out, cp);
+    }
+}
+
+template <typename Out>
+UTILS_TARGET_SSE42 inline std::size_t utf8_to_utf_sse42(char const* const in,
+                                                        std::size_t const size,
+                                                        Out* const out) noexcept
+{
+    auto const* const p = reinterpret_cast<unsigned char const*>(in);
+    auto* o = out;
+    std::size_t i = 0;
+    while (size - i >= 16) {
+        auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p + i));
+        auto const mask = static_cast<unsigned>(_mm_movemask_epi8(v));
+        if (mask != 0) {
+            utf8_step_sse42(p, v, mask, i, o);
+            continue;
+        }
+        store_units16_sse42(o, _mm_cvtepu8_epi16(v));
+        store_units16_sse42(o + 8, _mm_cvtepu8_epi16(_mm_srli_si128(v, 8)));
+        i += 16;
+        o += 16;
+    }
+    return static_cast<std::size_t>(o - out) +
+           utf8_to_utf_scalar(in + i, size - i, o).written;
+}
+
+// Eight three-byte characters: the two 12-byte halves of the 24 bytes at `in`
+// go to the two 128-bit lanes and are decoded as in utf8_three_byte_sse42().
+template <typename Out>
+UTILS_TARGET_AVX2 inline bool
+utf8_three_byte8_avx2(unsigned char const* const in, __m256i const v,
+                      Out* const out) noexcept
+{
+    auto const pair = _mm256_inserti128_si256(
+        v, _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + 12)), 1);
+    auto const lanes = _mm256_shuffle_epi8(
+        pair, _mm256_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10,
+                               9, -1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1,
+                               11, 10, 9, -1));
+    auto const tags = _mm256_and_si256(lanes, _mm256_set1_epi32(0x00F0C0C0));
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(
+            tags, _mm256_set1_epi32(0x00E08080))) != -1) {
+        return false;
+    }
+    auto const units = _mm256_or_si256(
+        _mm256_or_si256(
+            _mm256_srli_epi32(
+                _mm256_and_si256(lanes, _mm256_set1_epi32(0x000F0000)), 4),
+            _mm256_srli_epi32(
+                _mm256_and_si256(lanes, _mm256_set1_epi32(0x3F00)), 2)),
+        _mm256_and_si256(lanes, _mm256_set1_epi32(0x3F)));
+    if constexpr (std::is_same_v<Out, char16_t>) {
+        // packus works per lane: gather the two packed halves.
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                         _mm256_castsi256_si128(_mm256_permute4x64_epi64(
+                             _mm256_packus_epi32(units, units), 0x08)));
+    } else {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), units);
+    }
+    return true;
+}
+
+template <typename Out>
+UTILS_TARGET_AVX2 inline std::size_t utf8_to_utf_avx2(char const* const in,
+                                                      std::size_t const size,
+                                                      Out* const out) noexcept
+{
+    auto const* const p = reinterpret_cast<unsigned char const*>(in);
+    auto* o = out;
+    std::size_t i = 0;
+    while (size - i >= 32) {
+        auto const v =
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p + i));
+        auto const mask = static_cast<unsigned>(_mm256_movemask_epi8(v));
+        if (mask != 0) {
+            if ((mask & 1U) == 0 || !utf8_three_byte8_avx2(p + i, v, o)) {
+                utf8_step_sse42(p, _mm256_castsi256_si128(v), mask, i, o);
+                continue;
+            }
+            i += 24;
+            o += 8;
+            continue;
+        }
+        if constexpr (std::is_same_v<Out, char16_t>) {
+            _mm256_storeu_si256(
+                reinterpret_cast<__m256i*>(o),
+                _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+            _mm256_storeu_si256(
+                reinterpret_cast<__m256i*>(o + 16),
+                _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+        } else {
+            for (unsigned k = 0; k < 4; ++k) {
+                _mm256_storeu_si256(
+                    reinterpret_cast<__m256i*>(o + (8 * k)),
+                    _mm256_cvtepu8_epi32(_mm_loadl_epi64(
+                        reinterpret_cast<__m128i const*>(p + i + (8 * k)))));
+            }
+        }
+        i += 32;
+        o += 32;
+    }
+    return static_cast<std::size_t>(o - out) +
+           utf8_to_utf_sse42(in + i, size - i, o);
+}
+// The encoders likewise narrow all-ASCII blocks and encode runs of BMP code
+// points that take three bytes (U+0800 and up, no surrogates) together.
+
+// Encode the four code points in the 32-bit lanes of `units` as three bytes
+// each (12 bytes).
+UTILS_TARGET_SSE42 inline void
+put_three_byte_sse42(char* const out, __m128i const units) noexcept
+{
+    // lane = 0x80 | low six bits << 16 | 0x80 | middle six bits << 8 | lead
+    auto const lanes = _mm_or_si128(
+        _mm_or_si128(_mm_set1_epi32(0x008080E0), _mm_srli_epi32(units, 12)),
+        _mm_or_si128(
+            _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(units, 6),
+                                         _mm_set1_epi32(0x3F)),
+                           8),
+            _mm_slli_epi32(_mm_and_si128(units, _mm_set1_epi32(0x3F)), 16)));
+    auto const bytes = _mm_shuffle_epi8(
+        lanes, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1,
+                             -1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), bytes);
+    auto const tail = _mm_cvtsi128_si32(_mm_srli_si128(bytes, 8));
+    std::memcpy(out + 8, &tail, 4);
+}
+
+// One step of the UTF-16 encoder for the eight units `v` at in[i], which are
+// not all ASCII.
+UTILS_TARGET_SSE42 inline void utf16_step_sse42(char16_t const* const in,
+                                                __m128i const v, std::size_t& i,
+                                                char*& out) noexcept
+{
+    auto const zero = _mm_setzero_si128();
+    auto const ascii = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(
+        _mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xFF80))), zero)));
+    auto const prefix = static_cast<std::size_t>(__builtin_ctz(~ascii)) / 2;
+    if (prefix != 0) {
+        for (std::size_t k = 0; k < prefix; ++k) {
+            out[k] = static_cast<char>(in[i + k]);
+        }
+        i += prefix;
+        out += prefix;
+        return;
+    }
+    auto const top =
+        _mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xF800)));
+    auto const other = _mm_or_si128(
+        _mm_cmpeq_epi16(top, zero),
+        _mm_cmpeq_epi16(top, _mm_set1_epi16(static_cast<short>(0xD800))));
+    if (_mm_testz_si128(other, other) != 0) {
+        put_three_byte_sse42(out, _mm_cvtepu16_epi32(v));
+        put_three_byte_sse42(out + 12,
+                             _mm_cvtepu16_epi32(_mm_srli_si128(v, 8)));
+        i += 8;
+        out += 24;
+        return;
+    }
+    out = put_utf8(out, next_utf16(in, i));
+}
+
+UTILS_TARGET_SSE42 inline std::size_t
+utf16_to_utf8_sse42(char16_t const* const in, std::size_t const size,
+                    char* const out) noexcept
+{
+    auto const high = _mm_set1_epi16(static_cast<short>(0xFF80));
+    auto* o = out;
+    std::size_t i = 0;
+    while (size - i >= 8) {
+        auto const v =
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i));
+        if (_mm_testz_si128(v, high) == 0) {
+            utf16_step_sse42(in, v, i, o);
+            continue;
+        }
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(o), _mm_packus_epi16(v, v));
+        i += 8;
+        o += 8;
+    }
+    return static_cast<std::size_t>(o - out) +
+           utf_to_utf8_scalar(in + i, size - i, o);
+}
+
+UTILS_TARGET_AVX2 inline std::size_t
+utf16_to_utf8_avx2(char16_t const* const in, std::size_t const size,
+                   char* const out) noexcept
+{
+    auto const high = _mm256_set1_epi16(static_cast<short>(0xFF80));
+    auto* o = out;
+    std::size_t i = 0;
+    while (size - i >= 16) {
+        auto const v =
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + i));
+        if (_mm256_testz_si256(v, high) == 0) {
+            utf16_step_sse42(in, _mm256_castsi256_si128(v), i, o);
+            continue;
+        }
+        // packus works per lane: gather the two packed halves.
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(o),
+                         _mm256_castsi256_si128(_mm256_permute4x64_epi64(
+                             _mm256_packus_epi16(v, v), 0x08)));
+        i += 16;
+        o += 16;
+    }
+    return static_cast<std::size_t>(o - out) +
+           utf16_to_utf8_sse42(in + i, size - i, o);
+}
+
+// One step of the UTF-32 encoder for the four code points `v` at in[i],
+// which are not all ASCII.
+UTILS_TARGET_SSE42 inline void utf32_step_sse42(char32_t const* const in,
+                                                __m128i const v, std::size_t& i,
+                                                char*& out) noexcept
+{
+    auto const zero = _mm_setzero_si128();
+    auto const ascii = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi32(
+        _mm_and_si128(v, _mm_set1_epi32(static_cast<int>(0xFFFFFF80))),
+        zero)));
+    auto const prefix = static_cast<std::size_t>(__builtin_ctz(~ascii)) / 4;
+    if (prefix != 0) {
+        for (std::size_t k = 0; k < prefix; ++k) {
+            out[k] = static_cast<char>(in[i + k]);
+        }
+        i += prefix;
+        out += prefix;
+        return;
+    }
+    auto const above =
+        _mm_and_si128(v, _mm_set1_epi32(static_cast<int>(0xFFFF0000)));
+    auto const below = _mm_cmpeq_epi32(
+        _mm_and_si128(v, _mm_set1_epi32(0xF800)), zero);
+    auto const other = _mm_or_si128(above, below);
+    if (_mm_testz_si128(other, other) != 0) {
+        put_three_byte_sse42(out, v);
+        i += 4;
+        out += 12;
+        return;
+    }
+    out = put_utf8(out, in[i++]);
+}
+
+UTILS_TARGET_SSE42 inline std::size_t
+utf32_to_utf8_sse42(char32_t const* const in, std::size_t const size,
+                    char* const out) noexcept
+{
+    auto const high = _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+    auto* o = out;
+    std::size_t i = 0;
+    while (size - i >= 4) {
+        auto const v =
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i));
+        if (_mm_testz_si128(v, high) == 0) {
+            utf32_step_sse42(in, v, i, o);
+            continue;
+        }
+        auto const packed = _mm_packus_epi16(_mm_packus_epi32(v, v), v);
+        auto const bytes = _mm_cvtsi128_si32(packed);
+        std::memcpy(o, &bytes, 4);
+        i += 4;
+        o += 4;
+    }
+    return static_cast<std::size_t>(o - out) +
+           utf_to_utf8_scalar(in + i, size - i, o);
+}
+
+UTILS_TARGET_AVX2 inline std::size_t
+utf32_to_utf8_avx2(char32_t const* const in, std::size_t const size,
+                   char* const out) noexcept
+{
+    auto const high = _mm256_set1_epi32(static_cast<int>(0xFFFFFF80));
+    auto* o = out;
+    std::size_t i = 0;
+    while (size - i >= 8) {
+        auto const v =
+            _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + i));
+        if (_mm256_testz_si256(v, high) == 0) {
+            utf32_step_sse42(in, _mm256_castsi256_si128(v), i, o);
+            continue;
+        }
+        // Each lane packs its four code points into its first four bytes.
+        auto const packed = _mm256_packus_epi16(_mm256_packus_epi32(v, v), v);
+        auto const low = _mm256_permutevar8x32_epi32(
+            packed, _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(o),
+                         _mm256_castsi256_si128(low));
+        i += 8;
+        o += 8;
+    }
+    return static_cast<std::size_t>(o - out) +
+           utf32_to_utf8_sse42(in + i, size - i, o);
+}
+#endif
+} // namespace detail
+
+// First byte of the first malformed sequence in the UTF-8 text [first, last),
+// or `last` if it is well-formed. Overlong forms, surrogates, code points above
+// U+10FFFF and truncated sequences are malformed.
+[[nodiscard]] inline char const* validate_utf8(char const* const first,
+                                               char const* const last) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::validate_utf8_avx2(first, last);
+    case level::sse4_2:
+        return detail::validate_utf8_sse42(first, last);
+    case level::scalar:
+        break;
+    }
+#endif
+    return detail::validate_utf8_scalar(first, last);
+}
+
+// Number of characters in the UTF-8 text [first, last), i.e. of bytes that
+// are not continuation bytes.
+[[nodiscard]] inline std::size_t count_utf8(char const* const first,
+                                            char const* const last) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::utf8_units_avx2(first, last, false);
+    case level::sse4_2:
+        return detail::utf8_units_sse42(first, last, false);
+    case level::scalar:
+        break;
+    }
+#endif
+    return detail::utf8_units_scalar(first, last, false);
+}
+
+// Number of UTF-16 code units the well-formed UTF-8 text [first, last)
+// converts to.
+[[nodiscard]] inline std::size_t utf16_length(char const* const first,
+                                              char const* const last) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return detail::utf8_units_avx2(first, last, true);
+    case level::sse4_2:
+        return detail::utf8_units_sse42(first, last, true);
+    case level::scalar:
+        break;
+    }
+#endif
+    return detail::utf8_units_scalar(first, last, true);
+}
+
+// Well-formed prefixes of UTF-16 (unpaired surrogates are malformed) and
+// UTF-32 (surrogates and values above U+10FFFF are) text. Portable loops.
+[[nodiscard]] inline char16_t const*
+validate_utf16(char16_t const* const first, char16_t const* const last) noexcept
+{
+    return detail::validate_utf16_scalar(first, last);
+}
+
+[[nodiscard]] inline char32_t const*
+validate_utf32(char32_t const* const first, char32_t const* const last) noexcept
+{
+    return detail::validate_utf32_scalar(first, last);
+}
+
+namespace detail
+{
+// The vector decoders take well-formed input, so they run after the vector
+// validator; the scalar decoder checks as it goes, in a single pass.
+template <typename Out>
+[[nodiscard]] inline utf_conversion
+utf8_to_utf(char const* const in, std::size_t const size,
+            Out* const out) noexcept
+{
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2: {
+        auto const read =
+            static_cast<std::size_t>(validate_utf8_avx2(in, in + size) - in);
+        return {read, utf8_to_utf_avx2(in, read, out)};
+    }
+    case level::sse4_2: {
+        auto const read =
+            static_cast<std::size_t>(validate_utf8_sse42(in, in + size) - in);
+        return {read, utf8_to_utf_sse42(in, read, out)};
+    }
+    case level::scalar:
+        break;
+    }
+#endif
+    return utf8_to_utf_scalar(in, size, out);
+}
+} // namespace detail
+
+// Convert the `size` bytes of UTF-8 at `in` to UTF-16 or UTF-32 in `out`,
+// which must hold utf16_length() (resp. count_utf8()) units. Stops at the
+// first malformed sequence.
+[[nodiscard]] inline utf_conversion utf8_to_utf16(char const* const in,
+                                                  std::size_t const size,
+                                                  char16_t* const out) noexcept
+{
+    return detail::utf8_to_utf(in, size, out);
+}
+
+[[nodiscard]] inline utf_conversion utf8_to_utf32(char const* const in,
+                                                  std::size_t const size,
+                                                  char32_t* const out) noexcept
+{
+    return detail::utf8_to_utf(in, size, out);
+}
+
+// Convert `size` units of UTF-16 or UTF-32 at `in` to UTF-8 in `out`, which
+// must hold the converted text. Stops at the first malformed unit.
+[[nodiscard]] inline utf_conversion utf16_to_utf8(char16_t const* const in,
+                                                  std::size_t const size,
+                                                  char* const out) noexcept
+{
+    auto const read =
+        static_cast<std::size_t>(validate_utf16(in, in + size) - in);
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return {read, detail::utf16_to_utf8_avx2(in, read, out)};
+    case level::sse4_2:
+        return {read, detail::utf16_to_utf8_sse42(in, read, out)};
+    case level::scalar:
+        break;
+    }
+#endif
+    return {read, detail::utf_to_utf8_scalar(in, read, out)};
+}
+
+[[nodiscard]] inline utf_conversion utf32_to_utf8(char32_t const* const in,
+                                                  std::size_t const size,
+                                                  char* const out) noexcept
+{
+    auto const read =
+        static_cast<std::size_t>(validate_utf32(in, in + size) - in);
+#if defined(UTILS_SIMD_X86)
+    switch (active_level()) {
+    case level::avx2:
+        return {read, detail::utf32_to_utf8_avx2(in, read, out)};
+    case level::sse4_2:
+        return {read, detail::utf32_to_utf8_sse42(in, read, out)};
+    case level::scalar:
+        break;
+    }
+#endif
+    return {read, detail::utf_to_utf8_scalar(in, read, out)};
+}
+} // namespace utils::simd
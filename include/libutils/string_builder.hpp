@@ -0,0 +1,413 @@
+#pragma once
+
+#include <libutils/strings.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h>
+#endif
+
+/**
+ * A builder for large outputs (multi-megabyte responses, reports, dumps) that
+ * appends into a list of fixed-size chunks instead of one growing string, so
+ * nothing written is ever reallocated or copied again. Every chunk but the
+ * last is full: an append that does not fit the current chunk fills it and
+ * carries on into the next one.
+ *
+ * The result is taken once at the end: to_string() copies it into a single
+ * string, iovecs() describes the chunks for writev(2), and for_each_chunk()
+ * visits them in order for zero-copy output.
+ *
+ * Chunks come from a chunk_pool when one is given, and go back to it when
+ * the builder is cleared or destroyed, so builders created per request reuse
+ * the same few chunks instead of allocating. Without a pool they are plain
+ * heap allocations.
+ *
+ * Example usage:
+ * utils::strings::chunk_pool pool;
+ * utils::strings::string_builder out(pool);
+ * for (auto const& row : rows) {
+ *     utils::strings::join_into(out, row, ",");
+ *     out.push_back('\n');
+ * }
+ * ::writev(fd, out.iovecs().data(), ...);
+ */
+namespace utils::strings
+{
+// A thread-safe free list of equally sized chunks shared by string_builders.
+// At most `max_free` released chunks are kept; the rest are freed.
+class chunk_pool
+{
+public:
+    static constexpr std::size_t default_chunk_size = std::size_t{64} << 10U;
+
+    explicit chunk_pool(std::size_t const chunk_size = default_chunk_size,
+                        std::size_t const max_free = 64)
+        : chunk_size_(std::max<std::size_t>(chunk_size, 1)), max_free_(max_free)
+    {
+        free_.reserve(max_free_);
+    }
+
+    chunk_pool(chunk_pool const&) = delete;
+    chunk_pool& operator=(chunk_pool const&) = delete;
+
+    [[nodiscard]] std::size_t chunk_size() const noexcept
+    {
+        return chunk_size_;
+    }
+
+    // Chunks released and not yet handed out again.
+    [[nodiscard]] std::size_t free_chunks() const
+    {
+        std::lock_guard<std::mutex> const lock(mutex_);
+        return free_.size();
+    }
+
+    // A chunk of chunk_size() bytes (uninitialized), reused if one is free.
+    [[nodiscard]] std::unique_ptr<char[]> acquire()
+    {
+        {
+            std::lock_guard<std::mutex> const lock(mutex_);
+            if (!free_.empty()) {
+                auto chunk = std::move(free_.back());
+                free_.pop_back();
+                return chunk;
+            }
+        }
+        return std::unique_ptr<char[]>(new char[chunk_size_]);
+    }
+
+    // Give back a chunk obtained from acquire().
+    void release(std::unique_ptr<char[]> chunk) noexcept
+    {
+        std::lock_guard<std::mutex> const lock(mutex_);
+        if (free_.size() < max_free_) {
+            free_.push_back(std::move(chunk));
+        }
+    }
+
+private:
+    std::size_t chunk_size_;
+    std::size_t max_free_;
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<char[]>> free_;
+};
+
+class string_builder
+{
+public:
+    // A builder allocating its own chunks of `chunk_size` bytes.
+    explicit string_builder(
+        std::size_t const chunk_size = chunk_pool::default_chunk_size)
+        : chunk_size_(std::max<std::size_t>(chunk_size, 1))
+    {}
+
+    // A builder taking its chunks from `pool`, which must outlive it.
+    explicit string_builder(chunk_pool& pool)
+        : pool_(&pool), chunk_size_(pool.chunk_size())
+    {}
+
+    string_builder(string_builder const&) = delete;
+    string_builder& operator=(string_builder const&) = delete;
+
+    string_builder(string_builder&& other) noexcept
+        : chunks_(std::move(other.chunks_)),
+          pool_(other.pool_),
+          chunk_size_(other.chunk_size_),
+          cursor_(std::exchange(other.cursor_, nullptr)),
+          limit_(std::exchange(other.limit_, nullptr))
+    {
+        other.chunks_.clear();
+    }
+
+    string_builder& operator=(string_builder&& other) noexcept
+    {
+        if (this != &other) {
+            release_all();
+            chunks_ = std::move(other.chunks_);
+            other.chunks_.clear();
+            pool_ = other.pool_;
+            chunk_size_ = other.chunk_size_;
+            cursor_ = std::exchange(other.cursor_, nullptr);
+            limit_ = std::exchange(other.limit_, nullptr);
+        }
+        return *this;
+    }
+
+    ~string_builder() { release_all(); }
+
+    // ----------
+    // Appending
+    // ----------
+
+    string_builder& append(char const* data, std::size_t size)
+    {
+        auto room = static_cast<std::size_t>(limit_ - cursor_);
+        while (size > room) {
+            if (room != 0) {
+                std::memcpy(cursor_, data, room);
+                data += room;
+                size -= room;
+            }
+            grow();
+            room = chunk_size_;
+        }
+        if (size != 0) {
+            std::memcpy(cursor_, data, size);
+            cursor_ += size;
+        }
+        return *this;
+    }
+
+    string_builder& append(std::string_view const text)
+    {
+        return append(text.data(), text.size());
+    }
+
+    string_builder& append(std::size_t count, char const ch)
+    {
+        auto room = static_cast<std::size_t>(limit_ - cursor_);
+        while (count > room) {
+            if (room != 0) {
+                std::memset(cursor_, ch, room);
+                count -= room;
+            }
+            grow();
+            room = chunk_size_;
+        }
+        if (count != 0) {
+            std::memset(cursor_, ch, count);
+            cursor_ += count;
+        }
+        return *this;
+    }
+
+    void push_back(char const ch)
+    {
+        if (cursor_ == limit_) {
+            grow();
+        }
+        *cursor_++ = ch;
+    }
+
+    string_builder& operator+=(std::string_view const text)
+    {
+        return append(text);
+    }
+
+    string_builder& operator+=(char const ch)
+    {
+        push_back(ch);
+        return *this;
+    }
+
+    // Drop the contents, keeping the first chunk for the next use.
+    void clear() noexcept
+    {
+        while (chunks_.size() > 1) {
+            release(std::move(chunks_.back()));
+            chunks_.pop_back();
+        }
+        if (!chunks_.empty()) {
+            cursor_ = chunks_.front().get();
+            limit_ = cursor_ + chunk_size_;
+        }
+    }
+
+    // ----------
+    // Size
+    // ----------
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return chunks_.empty() ? 0
+                               : (chunks_.size() - 1) * chunk_size_ +
+                                     static_cast<std::size_t>(
+                                         cursor_ - chunks_.back().get());
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    [[nodiscard]] std::size_t chunk_size() const noexcept
+    {
+        return chunk_size_;
+    }
+
+    // Chunks in use, including a partly filled last one.
+    [[nodiscard]] std::size_t chunk_count() const noexcept
+    {
+        return chunks_.size();
+    }
+
+    // ----------
+    // Output
+    // ----------
+
+    // Call fn(std::string_view) for each non-empty chunk, in order.
+    template <typename Fn>
+    void for_each_chunk(Fn&& fn) const
+    {
+        for (std::size_t i = 0; i < chunks_.size(); ++i) {
+            auto const data = chunks_[i].get();
+            auto const size = i + 1 < chunks_.size()
+                                  ? chunk_size_
+                                  : static_cast<std::size_t>(cursor_ - data);
+            if (size != 0) {
+                fn(std::string_view{data, size});
+            }
+        }
+    }
+
+    // The contents as one string, allocated once.
+    [[nodiscard]] std::string to_string() const
+    {
+        return to_string(std::allocator<char>{});
+    }
+
+    // The overload taking an allocator builds the result with it.
+    template <typename Allocator>
+    [[nodiscard]] detail::string_for<char, Allocator>
+    to_string(Allocator const& alloc) const
+    {
+        detail::string_for<char, Allocator> out(
+            detail::rebind_alloc_t<Allocator, char>{alloc});
+        out.reserve(size());
+        for_each_chunk([&out](std::string_view const chunk) {
+            out.append(chunk.data(), chunk.size());
+        });
+        return out;
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    // The chunks as iovecs for writev(2). writev takes at most IOV_MAX of
+    // them per call (1024 on Linux): write longer lists in batches.
+    [[nodiscard]] std::vector<iovec> iovecs() const
+    {
+        std::vector<iovec> out;
+        out.reserve(chunks_.size());
+        for_each_chunk([&out](std::string_view const chunk) {
+            out.push_back(iovec{const_cast<char*>(chunk.data()), chunk.size()});
+        });
+        return out;
+    }
+#endif
+
+    friend std::ostream& operator<<(std::ostream& os,
+                                    string_builder const& builder)
+    {
+        builder.for_each_chunk([&os](std::string_view const chunk) {
+            os.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        });
+        return os;
+    }
+
+private:
+    void grow()
+    {
+        if (pool_ != nullptr) {
+            chunks_.push_back(pool_->acquire());
+        } else {
+            std::unique_ptr<char[]> chunk(new char[chunk_size_]);
+            chunks_.emplace_back(std::move(chunk));
+        }
+        cursor_ = chunks_.back().get();
+        limit_ = cursor_ + chunk_size_;
+    }
+
+    void release(std::unique_ptr<char[]> chunk) noexcept
+    {
+        if (pool_ != nullptr) {
+            pool_->release(std::move(chunk));
+        }
+    }
+
+    void release_all() noexcept
+    {
+        for (auto& chunk : chunks_) {
+            release(std::move(chunk));
+        }
+        chunks_.clear();
+        cursor_ = limit_ = nullptr;
+    }
+
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    chunk_pool* pool_{nullptr};
+    std::size_t chunk_size_;
+    char* cursor_{nullptr};
+    char* limit_{nullptr};
+};
+
+// ----------
+// Formatting into a builder
+// ----------
+
+// Append `value` (see format_number) to `out`.
+template <typename T>
+inline void append_number(string_builder& out, T const value)
+{
+    out.append(format_number(value).view());
+}
+
+// Append `text` left-padded with `fill` up to `width` to `out`.
+inline void pad_left_into(string_builder& out, std::string_view const text,
+                          std::size_t const width, char const fill = ' ')
+{
+    if (text.size() < width) {
+        out.append(width - text.size(), fill);
+    }
+    out.append(text);
+}
+
+// Append `text` right-padded with `fill` up to `width` to `out`.
+inline void pad_right_into(string_builder& out, std::string_view const text,
+                           std::size_t const width, char const fill = ' ')
+{
+    out.append(text);
+    if (text.size() < width) {
+        out.append(width - text.size(), fill);
+    }
+}
+
+// Append the string-like or numeric elements of [begin, end), separated by
+// `separator`, to `out`.
+template <typename Iter>
+inline void join_into(string_builder& out, Iter begin, Iter const end,
+                      std::string_view const separator)
+{
+    using value_type = std::remove_cv_t<
+        std::remove_reference_t<decltype(*std::declval<Iter&>())>>;
+    static_assert(detail::is_string_like_v<value_type, char> ||
+                      detail::is_chars_number_v<value_type>,
+                  "join_into(string_builder): elements must be string-like "
+                  "or numeric");
+    for (auto first = true; begin != end; ++begin, first = false) {
+        if (!first) {
+            out.append(separator);
+        }
+        if constexpr (detail::is_string_like_v<value_type, char>) {
+            out.append(std::string_view(*begin));
+        } else {
+            append_number(out, *begin);
+        }
+    }
+}
+
+template <typename C>
+inline void join_into(string_builder& out, C const& c,
+                      std::string_view const separator)
+{
+    join_into(out, std::cbegin(c), std::cend(c), separator);
+}
+} // namespace utils::strings
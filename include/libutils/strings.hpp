@@ -1,19 +1,34 @@
 #pragma once
 
+#include <libutils/bytes.hpp>
+#include <libutils/inplace_string.hpp>
 #include <libutils/iterators.hpp>
+#include <libutils/polyfill.hpp>
+#include <libutils/simd.hpp>
 
 #include <algorithm>
+#include <array>
 #include <charconv>
 #include <cstddef>
-#include <iomanip>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
 #include <locale>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
 namespace utils::strings
 {
 
@@ -39,13 +54,79 @@ template <typename T>
 }
 } // namespace detail
 
-template <typename CharT>
-using tstring =
-    std::basic_string<CharT, std::char_traits<CharT>, std::allocator<CharT>>;
+// The allocator is a defaulted parameter, so tstring<CharT> is still
+// std::basic_string<CharT>. Functions that modify or append to a string take
+// any allocator and transforms of a string keep its allocator; functions that
+// build a string from views have an overload taking the allocator last, after
+// every option. The std::allocator overloads stay alongside: a deduced
+// allocator would stop calls like to_upper<char>("text") from compiling.
+template <typename CharT, typename Allocator = std::allocator<CharT>>
+using tstring = std::basic_string<CharT, std::char_traits<CharT>, Allocator>;
 
 template <typename CharT>
 using tstringview = std::basic_string_view<CharT, std::char_traits<CharT>>;
 
+namespace detail
+{
+template <typename A, typename = void>
+struct is_allocator : std::false_type
+{};
+template <typename A>
+struct is_allocator<A,
+                    std::void_t<typename A::value_type,
+                                decltype(std::declval<A&>().allocate(
+                                    std::size_t{}))>> : std::true_type
+{};
+
+// Only defined for allocators, so that the allocator overloads, which all
+// return one of the types below, drop out for arguments that are not (their
+// last argument may otherwise be a pointer, an iterator or a flag).
+template <typename Allocator, typename T, typename = void>
+struct rebind_alloc
+{};
+template <typename Allocator, typename T>
+struct rebind_alloc<Allocator, T,
+                    std::enable_if_t<is_allocator<Allocator>::value>>
+{
+    using type =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+};
+
+template <typename Allocator, typename T>
+using rebind_alloc_t = typename rebind_alloc<Allocator, T>::type;
+
+// What the allocator overloads return, for an allocator of any value type.
+template <typename CharT, typename Allocator>
+using string_for = tstring<CharT, rebind_alloc_t<Allocator, CharT>>;
+
+template <typename CharT, typename Allocator>
+using strings_for =
+    std::vector<string_for<CharT, Allocator>,
+                rebind_alloc_t<Allocator, string_for<CharT, Allocator>>>;
+
+template <typename CharT, typename Allocator>
+using views_for = std::vector<tstringview<CharT>,
+                              rebind_alloc_t<Allocator, tstringview<CharT>>>;
+
+template <typename Allocator>
+using bytes_for = std::vector<std::byte, rebind_alloc_t<Allocator, std::byte>>;
+} // namespace detail
+
+#if defined(__cpp_lib_memory_resource)
+// Strings on a std::pmr::memory_resource, e.g. a monotonic_buffer_resource
+// per request that is released at once. Pass a polymorphic_allocator to the
+// allocator overloads; copies of a pmr string use the default resource, so
+// hand strings to the by-value transforms with std::move.
+namespace pmr
+{
+template <typename CharT>
+using tstring = strings::tstring<CharT, std::pmr::polymorphic_allocator<CharT>>;
+
+using string = tstring<char>;
+using wstring = tstring<wchar_t>;
+} // namespace pmr
+#endif
+
 template <typename CharT>
 using tstringstream = std::basic_stringstream<CharT, std::char_traits<CharT>,
                                               std::allocator<CharT>>;
@@ -70,536 +151,4588 @@ to_string(Val const& val)
 
 // ----------
 
-template <typename CharT>
-inline CharT my_tolower(CharT const ch, std::locale const& loc = std::locale())
+namespace detail
 {
-    return std::tolower(ch, loc);
-}
-
-template <typename CharT>
-inline CharT my_toupper(CharT const ch, std::locale const& loc = std::locale())
+template <bool Upper>
+constexpr std::array<unsigned char, 256> make_ascii_case_table() noexcept
 {
-    return std::toupper(ch, loc);
+    std::array<unsigned char, 256> table{};
+    for (unsigned c = 0; c < 256; ++c) {
+        auto const from = Upper ? 'a' : 'A';
+        table[c] = static_cast<unsigned char>(
+            c >= static_cast<unsigned>(from) &&
+                    c <= static_cast<unsigned>(from + 25)
+                ? c ^ 0x20U
+                : c);
+    }
+    return table;
 }
 
-// ----------
+inline constexpr auto ascii_lower = make_ascii_case_table<false>();
+inline constexpr auto ascii_upper = make_ascii_case_table<true>();
 
-namespace mutable_version
-{
 template <typename CharT>
-inline void to_upper(tstring<CharT>& text)
+[[nodiscard]] inline CharT map_case(CharT const ch,
+                                    std::array<unsigned char, 256> const& table,
+                                    CharT (*fallback)(CharT))
 {
-    std::transform(std::begin(text), std::end(text), std::begin(text),
-                   [](CharT const& ch) {
-                       return my_toupper(ch);
-                   });
+    auto const code = static_cast<std::make_unsigned_t<CharT>>(ch);
+    if constexpr (sizeof(CharT) == 1) {
+        return static_cast<CharT>(table[code]);
+    } else {
+        return code < 0x80 ? static_cast<CharT>(table[code]) : fallback(ch);
+    }
 }
+} // namespace detail
 
+// Locale-free case mapping. ASCII goes through a lookup table; narrow
+// characters outside ASCII are returned unchanged (the "C" locale behaviour)
+// and wider ones fall back to the global locale. Pass a locale explicitly to
+// get locale-specific mappings for every character.
 template <typename CharT>
-inline void to_lower(tstring<CharT>& text)
+[[nodiscard]] inline CharT my_tolower(CharT const ch)
 {
-    std::transform(std::begin(text), std::end(text), std::begin(text),
-                   [](CharT const& ch) {
-                       return my_tolower(ch);
-                   });
+    return detail::map_case<CharT>(ch, detail::ascii_lower, [](CharT const c) {
+        return std::tolower(c, std::locale());
+    });
 }
 
 template <typename CharT>
-inline void reverse(tstring<CharT>& text)
+[[nodiscard]] inline CharT my_toupper(CharT const ch)
 {
-    std::reverse(std::begin(text), std::end(text));
+    return detail::map_case<CharT>(ch, detail::ascii_upper, [](CharT const c) {
+        return std::toupper(c, std::locale());
+    });
 }
 
 template <typename CharT>
-inline void trim(tstring<CharT>& text)
+[[nodiscard]] inline CharT my_tolower(CharT const ch, std::locale const& loc)
 {
-    text.erase(text.begin(), std::find_if_not(text.begin(), text.end(),
-                                              detail::is_whitespace<CharT>));
-    text.erase(std::find_if_not(text.rbegin(), text.rend(),
-                                detail::is_whitespace<CharT>)
-                   .base(),
-               text.end());
+    return std::tolower(ch, loc);
 }
 
 template <typename CharT>
-inline void trimleft(tstring<CharT>& text)
+[[nodiscard]] inline CharT my_toupper(CharT const ch, std::locale const& loc)
 {
-    text.erase(text.begin(), std::find_if_not(text.begin(), text.end(),
-                                              detail::is_whitespace<CharT>));
+    return std::toupper(ch, loc);
 }
 
-template <typename CharT>
-inline void trimright(tstring<CharT>& text)
+// ----------
+// Unicode simple case folding
+// ----------
+
+namespace detail
 {
-    text.erase(std::find_if_not(text.rbegin(), text.rend(),
-                                detail::is_whitespace<CharT>)
-                   .base(),
-               text.end());
-}
-} // namespace mutable_version
+// Code points in [first, last] fold to cp + delta. When `alternating` is set
+// only every other code point (starting at `first`) folds, which covers the
+// upper/lower pairs that make up most of the Latin, Greek and Cyrillic blocks.
+struct fold_range
+{
+    char32_t first;
+    char32_t last;
+    std::int32_t delta;
+    bool alternating;
+};
 
-template <typename CharT>
-[[nodiscard]]
-inline bool starts_with(tstringview<CharT> const str,
-                        tstringview<CharT> const prefix,
-                        bool const ignore_case = false)
+// A compact subset of CaseFolding.txt (statuses C and S) covering Latin,
+// Greek, Cyrillic, Armenian, Georgian, Glagolitic, Coptic, letterlike and
+// fullwidth forms, Deseret, Osage, Old Hungarian, Warang Citi and Adlam.
+// Sorted by `first`, non-overlapping.
+inline constexpr fold_range fold_ranges[] = {
+    {0x00B5, 0x00B5, 775, false},    {0x00C0, 0x00D6, 32, false},
+    {0x00D8, 0x00DE, 32, false},     {0x0100, 0x012F, 1, true},
+    {0x0132, 0x0137, 1, true},       {0x0139, 0x0148, 1, true},
+    {0x014A, 0x0177, 1, true},       {0x0178, 0x0178, -121, false},
+    {0x0179, 0x017E, 1, true},       {0x017F, 0x017F, -268, false},
+    {0x0181, 0x0181, 210, false},    {0x0182, 0x0185, 1, true},
+    {0x0186, 0x0186, 206, false},    {0x0187, 0x0187, 1, false},
+    {0x0189, 0x018A, 205, false},    {0x018B, 0x018B, 1, false},
+    {0x018E, 0x018E, 79, false},     {0x018F, 0x018F, 202, false},
+    {0x0190, 0x0190, 203, false},    {0x0191, 0x0191, 1, false},
+    {0x0193, 0x0193, 205, false},    {0x0194, 0x0194, 207, false},
+    {0x0196, 0x0196, 211, false},    {0x0197, 0x0197, 209, false},
+    {0x0198, 0x0198, 1, false},      {0x019C, 0x019C, 211, false},
+    {0x019D, 0x019D, 213, false},    {0x019F, 0x019F, 214, false},
+    {0x01A0, 0x01A5, 1, true},       {0x01A7, 0x01A7, 1, false},
+    {0x01A9, 0x01A9, 218, false},    {0x01AC, 0x01AC, 1, false},
+    {0x01AE, 0x01AE, 218, false},    {0x01AF, 0x01AF, 1, false},
+    {0x01B1, 0x01B2, 217, false},    {0x01B3, 0x01B5, 1, true},
+    {0x01B7, 0x01B7, 219, false},    {0x01B8, 0x01B8, 1, false},
+    {0x01BC, 0x01BC, 1, false},      {0x01C4, 0x01C4, 2, false},
+    {0x01C5, 0x01C5, 1, false},      {0x01C7, 0x01C7, 2, false},
+    {0x01C8, 0x01C8, 1, false},      {0x01CA, 0x01CA, 2, false},
+    {0x01CB, 0x01DC, 1, true},       {0x01DE, 0x01EF, 1, true},
+    {0x01F1, 0x01F1, 2, false},      {0x01F2, 0x01F4, 1, true},
+    {0x01F6, 0x01F6, -97, false},    {0x01F7, 0x01F7, -56, false},
+    {0x01F8, 0x021F, 1, true},       {0x0220, 0x0220, -130, false},
+    {0x0222, 0x0233, 1, true},       {0x023A, 0x023A, 10795, false},
+    {0x023B, 0x023B, 1, false},      {0x023D, 0x023D, -163, false},
+    {0x023E, 0x023E, 10792, false},  {0x0241, 0x0241, 1, false},
+    {0x0243, 0x0243, -195, false},   {0x0244, 0x0244, 69, false},
+    {0x0245, 0x0245, 71, false},     {0x0246, 0x024F, 1, true},
+    {0x0345, 0x0345, 116, false},    {0x0370, 0x0373, 1, true},
+    {0x0376, 0x0376, 1, false},      {0x037F, 0x037F, 116, false},
+    {0x0386, 0x0386, 38, false},     {0x0388, 0x038A, 37, false},
+    {0x038C, 0x038C, 64, false},     {0x038E, 0x038F, 63, false},
+    {0x0391, 0x03A1, 32, false},     {0x03A3, 0x03AB, 32, false},
+    {0x03C2, 0x03C2, 1, false},      {0x03CF, 0x03CF, 8, false},
+    {0x03D0, 0x03D0, -30, false},    {0x03D1, 0x03D1, -25, false},
+    {0x03D5, 0x03D5, -15, false},    {0x03D6, 0x03D6, -22, false},
+    {0x03D8, 0x03EF, 1, true},       {0x03F0, 0x03F0, -54, false},
+    {0x03F1, 0x03F1, -48, false},    {0x03F4, 0x03F4, -60, false},
+    {0x03F5, 0x03F5, -64, false},    {0x03F7, 0x03F7, 1, false},
+    {0x03F9, 0x03F9, -7, false},     {0x03FA, 0x03FA, 1, false},
+    {0x03FD, 0x03FF, -130, false},   {0x0400, 0x040F, 80, false},
+    {0x0410, 0x042F, 32, false},     {0x0460, 0x0481, 1, true},
+    {0x048A, 0x04BF, 1, true},       {0x04C0, 0x04C0, 15, false},
+    {0x04C1, 0x04CE, 1, true},       {0x04D0, 0x052F, 1, true},
+    {0x0531, 0x0556, 48, false},     {0x10A0, 0x10C5, 7264, false},
+    {0x10C7, 0x10C7, 7264, false},   {0x10CD, 0x10CD, 7264, false},
+    {0x1E00, 0x1E95, 1, true},       {0x1E9B, 0x1E9B, -58, false},
+    {0x1E9E, 0x1E9E, -7615, false},  {0x1EA0, 0x1EFF, 1, true},
+    {0x1F08, 0x1F0F, -8, false},     {0x1F18, 0x1F1D, -8, false},
+    {0x1F28, 0x1F2F, -8, false},     {0x1F38, 0x1F3F, -8, false},
+    {0x1F48, 0x1F4D, -8, false},     {0x1F59, 0x1F5F, -8, true},
+    {0x1F68, 0x1F6F, -8, false},     {0x1F88, 0x1F8F, -8, false},
+    {0x1F98, 0x1F9F, -8, false},     {0x1FA8, 0x1FAF, -8, false},
+    {0x1FB8, 0x1FB9, -8, false},     {0x1FBA, 0x1FBB, -74, false},
+    {0x1FBC, 0x1FBC, -9, false},     {0x1FBE, 0x1FBE, -7173, false},
+    {0x1FC8, 0x1FCB, -86, false},    {0x1FCC, 0x1FCC, -9, false},
+    {0x1FD8, 0x1FD9, -8, false},     {0x1FDA, 0x1FDB, -100, false},
+    {0x1FE8, 0x1FE9, -8, false},     {0x1FEA, 0x1FEB, -112, false},
+    {0x1FEC, 0x1FEC, -7, false},     {0x1FF8, 0x1FF9, -128, false},
+    {0x1FFA, 0x1FFB, -126, false},   {0x1FFC, 0x1FFC, -9, false},
+    {0x2126, 0x2126, -7517, false},  {0x212A, 0x212A, -8383, false},
+    {0x212B, 0x212B, -8262, false},  {0x2132, 0x2132, 28, false},
+    {0x2160, 0x216F, 16, false},     {0x2183, 0x2183, 1, false},
+    {0x24B6, 0x24CF, 26, false},     {0x2C00, 0x2C2F, 48, false},
+    {0x2C60, 0x2C60, 1, false},      {0x2C62, 0x2C62, -10743, false},
+    {0x2C63, 0x2C63, -3814, false},  {0x2C64, 0x2C64, -10727, false},
+    {0x2C67, 0x2C6B, 1, true},       {0x2C80, 0x2CE3, 1, true},
+    {0xA640, 0xA66D, 1, true},       {0xA680, 0xA69B, 1, true},
+    {0xA722, 0xA72F, 1, true},       {0xA732, 0xA76F, 1, true},
+    {0xA779, 0xA77C, 1, true},       {0xA77E, 0xA787, 1, true},
+    {0xA78B, 0xA78B, 1, false},      {0xA790, 0xA793, 1, true},
+    {0xA796, 0xA7A9, 1, true},       {0xFF21, 0xFF3A, 32, false},
+    {0x10400, 0x10427, 40, false},   {0x104B0, 0x104D3, 40, false},
+    {0x10C80, 0x10CB2, 64, false},   {0x118A0, 0x118BF, 32, false},
+    {0x1E900, 0x1E921, 34, false},
+};
+
+// Decode one UTF-8 sequence from the front of `text` (non-empty). Malformed
+// input yields a single byte tagged with `raw_byte` so it can only ever match
+// the same raw byte, never a real code point.
+inline constexpr char32_t raw_byte = 0x80000000;
+
+struct utf8_unit
 {
-    if (str.size() < prefix.size()) {
-        return false;
+    char32_t value;
+    std::size_t size;
+};
+
+[[nodiscard]] constexpr utf8_unit
+decode_utf8_unit(std::string_view const text) noexcept
+{
+    auto const byte = [&](std::size_t const i) {
+        return static_cast<char32_t>(static_cast<unsigned char>(text[i]));
+    };
+    auto const lead = byte(0);
+    if (lead < 0x80) {
+        return {lead, 1};
     }
-    if (!ignore_case) {
-        return str.substr(0, prefix.size()) == prefix;
+    std::size_t size = 0;
+    char32_t cp = 0;
+    char32_t min = 0;
+    if ((lead & 0xE0U) == 0xC0U) {
+        size = 2, cp = lead & 0x1FU, min = 0x80;
+    } else if ((lead & 0xF0U) == 0xE0U) {
+        size = 3, cp = lead & 0x0FU, min = 0x800;
+    } else if ((lead & 0xF8U) == 0xF0U) {
+        size = 4, cp = lead & 0x07U, min = 0x10000;
+    } else {
+        return {raw_byte | lead, 1};
+    }
+    if (text.size() < size) {
+        return {raw_byte | lead, 1};
+    }
+    for (std::size_t i = 1; i < size; ++i) {
+        if ((byte(i) & 0xC0U) != 0x80U) {
+            return {raw_byte | lead, 1};
+        }
+        cp = (cp << 6U) | (byte(i) & 0x3FU);
+    }
+    if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+        return {raw_byte | lead, 1};
     }
-    return std::equal(prefix.begin(), prefix.end(), str.begin(),
-                      [](CharT const c1, CharT const c2) {
-                          return my_tolower(c1) == my_tolower(c2);
-                      });
+    return {cp, size};
 }
 
-template <typename CharT>
-[[nodiscard]]
-inline bool ends_with(tstringview<CharT> const input,
-                      tstringview<CharT> const suffix,
-                      bool const ignore_case = false)
+template <typename String>
+inline void append_utf8(String& out, char32_t const cp)
 {
-    if (input.size() < suffix.size()) {
-        return false;
-    }
-    auto const tail = input.substr(input.size() - suffix.size());
-    if (!ignore_case) {
-        return tail == suffix;
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0U | (cp >> 6U));
+        out += static_cast<char>(0x80U | (cp & 0x3FU));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0U | (cp >> 12U));
+        out += static_cast<char>(0x80U | ((cp >> 6U) & 0x3FU));
+        out += static_cast<char>(0x80U | (cp & 0x3FU));
+    } else {
+        out += static_cast<char>(0xF0U | (cp >> 18U));
+        out += static_cast<char>(0x80U | ((cp >> 12U) & 0x3FU));
+        out += static_cast<char>(0x80U | ((cp >> 6U) & 0x3FU));
+        out += static_cast<char>(0x80U | (cp & 0x3FU));
     }
-    return std::equal(suffix.begin(), suffix.end(), tail.begin(),
-                      [](CharT const c1, CharT const c2) {
-                          return my_tolower(c1) == my_tolower(c2);
-                      });
 }
+} // namespace detail
 
-template <typename CharT>
-[[nodiscard]]
-bool contains(tstringview<CharT> const input, tstringview<CharT> const needle,
-              bool const ignore_case = false)
+// Unicode simple case folding of a single code point (CaseFolding.txt
+// statuses C and S, for the scripts listed on detail::fold_ranges). Code
+// points outside those ranges fold to themselves.
+[[nodiscard]] constexpr char32_t fold_case(char32_t const cp) noexcept
 {
-    if (input.size() >= needle.size()) {
-        return std::search(std::begin(input), std::end(input),
-                           std::begin(needle), std::end(needle),
-                           [&](CharT const c1, CharT const c2) {
-                               return ignore_case
-                                          ? my_tolower(c1) == my_tolower(c2)
-                                          : c1 == c2;
-                           }) != std::end(input);
+    if (cp < 0x80) {
+        return detail::ascii_lower[cp];
     }
-
-    return false;
+    auto const* first = std::begin(detail::fold_ranges);
+    auto count = std::end(detail::fold_ranges) - first;
+    while (count > 0) {
+        auto const half = count / 2;
+        if (first[half].last < cp) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    if (first == std::end(detail::fold_ranges) || cp < first->first ||
+        (first->alternating && ((cp - first->first) & 1U) != 0)) {
+        return cp;
+    }
+    return static_cast<char32_t>(static_cast<std::int32_t>(cp) + first->delta);
 }
 
-template <typename CharT>
-[[nodiscard]] bool equal(tstringview<CharT> const str1,
-                         tstringview<CharT> const str2,
-                         bool const ignore_case = false)
+// Case-fold UTF-8 text. Malformed sequences are copied through unchanged.
+template <typename Allocator>
+[[nodiscard]] inline detail::string_for<char, Allocator>
+fold_case_utf8(std::string_view text, Allocator const& alloc)
 {
-    if (str1.size() == str2.size()) {
-        return std::equal(str1.begin(), str1.end(), str2.begin(),
-                          [=](CharT const c1, CharT const c2) {
-                              return ignore_case
-                                         ? my_tolower(c1) == my_tolower(c2)
-                                         : c1 == c2;
-                          });
+    detail::string_for<char, Allocator> out(
+        detail::rebind_alloc_t<Allocator, char>{alloc});
+    out.reserve(text.size());
+    while (!text.empty()) {
+        auto const unit = detail::decode_utf8_unit(text);
+        if ((unit.value & detail::raw_byte) != 0) {
+            out += text.front();
+        } else {
+            detail::append_utf8(out, fold_case(unit.value));
+        }
+        text.remove_prefix(unit.size);
     }
-
-    return false;
+    return out;
 }
 
-template <typename CharT>
-[[nodiscard]] inline tstring<CharT> to_upper(tstring<CharT> text)
+[[nodiscard]] inline std::string fold_case_utf8(std::string_view const text)
 {
-    mutable_version::to_upper(text);
-    return text;
+    return fold_case_utf8(text, std::allocator<char>{});
 }
 
+// How the ignore-case overloads compare characters. `ascii` is what
+// `ignore_case = true` selects: ASCII letters fold through a table (SIMD for
+// char), other characters go through my_tolower. `unicode` applies simple
+// case folding to UTF-8 text for char and to each code unit for wider
+// character types. Simple folding maps one code point to one code point, so
+// expansions such as "ß" -> "ss" are not applied.
+enum class case_folding : std::uint8_t
+{
+    none,
+    ascii,
+    unicode,
+};
+
+namespace detail
+{
+// Next case-folded comparison unit of `text`; `size` is how much it consumed.
 template <typename CharT>
-[[nodiscard]] inline tstring<CharT> to_lower(tstring<CharT> text)
+[[nodiscard]] constexpr utf8_unit
+next_folded_unit(tstringview<CharT> const text) noexcept
 {
-    mutable_version::to_lower(text);
-    return text;
+    if constexpr (std::is_same_v<CharT, char>) {
+        auto const unit = decode_utf8_unit(text);
+        if ((unit.value & raw_byte) != 0) {
+            return unit;
+        }
+        return {fold_case(unit.value), unit.size};
+    } else {
+        auto const code = static_cast<std::make_unsigned_t<CharT>>(text[0]);
+        return {fold_case(static_cast<char32_t>(code)), 1};
+    }
 }
 
+// Compare `a` against `b` unit by unit under Unicode folding. Returns whether
+// the compared units matched and sets `rest_a` to the unconsumed tail of `a`.
 template <typename CharT>
-[[nodiscard]] inline tstring<CharT> reverse(tstring<CharT> text)
+[[nodiscard]] constexpr bool
+unicode_prefix_equal(tstringview<CharT> a, tstringview<CharT> b,
+                     tstringview<CharT>& rest_a) noexcept
 {
-    mutable_version::reverse(text);
-    return text;
+    while (!a.empty() && !b.empty()) {
+        auto const ua = next_folded_unit<CharT>(a);
+        auto const ub = next_folded_unit<CharT>(b);
+        if (ua.value != ub.value) {
+            return false;
+        }
+        a.remove_prefix(ua.size);
+        b.remove_prefix(ub.size);
+    }
+    rest_a = a;
+    return b.empty();
 }
 
 template <typename CharT>
-[[nodiscard]] inline tstring<CharT> trim(tstring<CharT> const& text)
+[[nodiscard]] inline tstring<CharT> fold_case_units(tstringview<CharT> text)
 {
-    auto const first = std::find_if_not(text.begin(), text.end(),
-                                        detail::is_whitespace<CharT>);
-    if (first == text.end()) {
-        return {};
+    if constexpr (std::is_same_v<CharT, char>) {
+        return fold_case_utf8(text);
+    } else {
+        tstring<CharT> out(text);
+        for (auto& ch : out) {
+            ch = static_cast<CharT>(fold_case(static_cast<char32_t>(
+                static_cast<std::make_unsigned_t<CharT>>(ch))));
+        }
+        return out;
     }
-    auto const last = std::find_if_not(text.rbegin(), text.rend(),
-                                       detail::is_whitespace<CharT>);
-    return tstring<CharT>(first, last.base());
 }
 
 template <typename CharT>
-[[nodiscard]] inline tstring<CharT> trimleft(tstring<CharT> const& text)
+[[nodiscard]] inline bool equal_ascii_icase(CharT const* const a,
+                                            CharT const* const b,
+                                            std::size_t const size)
 {
-    return tstring<CharT>(std::find_if_not(text.begin(), text.end(),
-                                           detail::is_whitespace<CharT>),
-                          text.end());
+    if constexpr (std::is_same_v<CharT, char>) {
+        return simd::equal_icase(a, b, size);
+    } else {
+        return std::equal(a, a + size, b, [](CharT const c1, CharT const c2) {
+            return my_tolower(c1) == my_tolower(c2);
+        });
+    }
 }
 
-template <typename CharT>
-[[nodiscard]] inline tstring<CharT> trimright(tstring<CharT> const& text)
+[[nodiscard]] constexpr case_folding to_case_folding(bool const ignore_case)
 {
-    return tstring<CharT>(text.begin(),
-                          std::find_if_not(text.rbegin(), text.rend(),
-                                           detail::is_whitespace<CharT>)
-                              .base());
+    return ignore_case ? case_folding::ascii : case_folding::none;
 }
+} // namespace detail
 
-template <typename CharT>
-[[nodiscard]] inline tstring<CharT> trim(tstring<CharT> const& text,
-                                         tstring<CharT> const& chars)
+// ----------
+// Character classes
+// ----------
+
+// A set of characters kept as a 256-bit bitmap, plus the nibble tables the
+// vectorized scans classify 16 or 32 bytes at a time with. Build one once,
+// at compile time where the set is fixed:
+//     inline constexpr utils::strings::char_class digits{"0123456789"};
+// and the scans below cost a few instructions per block instead of a search
+// of the set per character (std::string_view::find_first_of).
+using char_class = simd::byte_set;
+
+// The characters trim() removes by default.
+inline constexpr char_class whitespace_class{" \t\n\r\v\f"};
+
+// Position of the first character at or after `pos` that is in `cls`, or npos.
+[[nodiscard]] inline std::size_t
+find_first_in(std::string_view const text, char_class const& cls,
+              std::size_t const pos = 0) noexcept
 {
-    auto const first{text.find_first_not_of(chars)};
-    if (first == std::string::npos) {
-        return {};
+    if (pos >= text.size()) {
+        return std::string_view::npos;
     }
-
-    auto const last{text.find_last_not_of(chars)};
-    return text.substr(first, (last - first + 1));
+    auto const* const last = text.data() + text.size();
+    auto const* const hit = simd::find_first_of(text.data() + pos, last, cls);
+    return hit == last ? std::string_view::npos
+                       : static_cast<std::size_t>(hit - text.data());
 }
 
-template <typename CharT>
-[[nodiscard]] inline tstring<CharT> trimleft(tstring<CharT> const& text,
-                                             tstring<CharT> const& chars)
+// Position of the first character at or after `pos` that is not in `cls`, or
+// npos.
+[[nodiscard]] inline std::size_t
+find_first_not_in(std::string_view const text, char_class const& cls,
+                  std::size_t const pos = 0) noexcept
 {
-    auto const first{text.find_first_not_of(chars)};
-    if (first == std::string::npos) {
-        return {};
+    if (pos >= text.size()) {
+        return std::string_view::npos;
     }
-
-    return text.substr(first, text.size() - first);
+    auto const* const last = text.data() + text.size();
+    auto const* const hit =
+        simd::find_first_not_of(text.data() + pos, last, cls);
+    return hit == last ? std::string_view::npos
+                       : static_cast<std::size_t>(hit - text.data());
 }
 
-template <typename CharT>
-[[nodiscard]] inline tstring<CharT> trimright(tstring<CharT> const& text,
-                                              tstring<CharT> const& chars)
+// Position of the last character that is not in `cls`, or npos.
+[[nodiscard]] inline std::size_t
+find_last_not_in(std::string_view const text, char_class const& cls) noexcept
 {
-    auto const last{text.find_last_not_of(chars)};
-    return text.substr(0, last + 1);
+    auto const* const last = text.data() + text.size();
+    auto const* const hit = simd::find_last_not_of(text.data(), last, cls);
+    return hit == last ? std::string_view::npos
+                       : static_cast<std::size_t>(hit - text.data());
 }
 
-template <typename CharT>
-[[nodiscard]] inline tstring<CharT> remove(tstring<CharT> text, CharT const ch)
+// Number of characters of `text` that are in `cls`.
+[[nodiscard]] inline std::size_t count_in(std::string_view const text,
+                                          char_class const& cls) noexcept
 {
-    auto const start =
-        std::remove_if(std::begin(text), std::end(text), [=](CharT const c) {
-            return c == ch;
-        });
-    text.erase(start, std::end(text));
-    return text;
+    return simd::count(text.data(), text.data() + text.size(), cls);
 }
 
-// Replace every non-overlapping occurrence of `from` with `to`. An empty `from`
-// is a no-op (returns the input unchanged) rather than looping forever.
-template <typename CharT>
-[[nodiscard]] inline tstring<CharT> replace_all(tstring<CharT> text,
-                                                tstringview<CharT> const from,
-                                                tstringview<CharT> const to)
+// `text` without its leading characters in `cls`. A token that does not start
+// with one is returned after a single bitmap test, so short, already clean
+// tokens never reach the block scan.
+[[nodiscard]] inline std::string_view
+trimleft_view(std::string_view const text,
+              char_class const& cls = whitespace_class) noexcept
 {
-    if (from.empty()) {
+    if (text.empty() ||
+        !cls.contains(static_cast<unsigned char>(text.front()))) {
         return text;
     }
+    auto const first = find_first_not_in(text, cls, 1);
+    return text.substr(first == std::string_view::npos ? text.size() : first);
+}
 
-    std::size_t pos = 0;
-    while ((pos = text.find(from, pos)) != tstring<CharT>::npos) {
-        text.replace(pos, from.size(), to.data(), to.size());
-        pos += to.size(); // skip the replacement so `to` is not re-scanned
+// `text` without its trailing characters in `cls`; see trimleft_view().
+[[nodiscard]] inline std::string_view
+trimright_view(std::string_view const text,
+               char_class const& cls = whitespace_class) noexcept
+{
+    if (text.empty() ||
+        !cls.contains(static_cast<unsigned char>(text.back()))) {
+        return text;
     }
-    return text;
+    auto const last = find_last_not_in(text.substr(0, text.size() - 1), cls);
+    return text.substr(0, last == std::string_view::npos ? 0 : last + 1);
 }
 
-// Single-character replace convenience overload.
-template <typename CharT>
-[[nodiscard]] inline tstring<CharT>
-replace_all(tstring<CharT> text, CharT const from, CharT const to)
+// `text` without its leading and trailing characters in `cls`. The result
+// always points into `text`, empty or not.
+[[nodiscard]] inline std::string_view
+trim_view(std::string_view const text,
+          char_class const& cls = whitespace_class) noexcept
 {
-    std::replace(std::begin(text), std::end(text), from, to);
+    return trimright_view(trimleft_view(text, cls), cls);
+}
+
+// `text` without any character in `cls`, compacted in place a block at a time.
+[[nodiscard]] inline std::string remove(std::string text, char_class const& cls)
+{
+    auto* const first = text.data();
+    text.resize(static_cast<std::size_t>(
+        simd::remove(first, first + text.size(), cls) - first));
     return text;
 }
 
-// Replace only the first occurrence of `from` with `to`.
-template <typename CharT>
-[[nodiscard]] inline tstring<CharT> replace_first(tstring<CharT> text,
-                                                  tstringview<CharT> const from,
-                                                  tstringview<CharT> const to)
+// ----------
+
+namespace detail
 {
-    if (from.empty()) {
-        return text;
+// The in-place transforms, over anything with the std::basic_string members
+// they use: tstring and inplace_string.
+template <typename String>
+inline void to_upper_in_place(String& text)
+{
+    using CharT = typename String::value_type;
+    if constexpr (std::is_same_v<CharT, char>) {
+        simd::to_upper_ascii(text.data(), text.size());
+    } else {
+        std::transform(std::begin(text), std::end(text), std::begin(text),
+                       [](CharT const& ch) {
+                           return my_toupper(ch);
+                       });
     }
+}
 
-    auto const pos = text.find(from);
-    if (pos != tstring<CharT>::npos) {
-        text.replace(pos, from.size(), to.data(), to.size());
+template <typename String>
+inline void to_lower_in_place(String& text)
+{
+    using CharT = typename String::value_type;
+    if constexpr (std::is_same_v<CharT, char>) {
+        simd::to_lower_ascii(text.data(), text.size());
+    } else {
+        std::transform(std::begin(text), std::end(text), std::begin(text),
+                       [](CharT const& ch) {
+                           return my_tolower(ch);
+                       });
     }
-    return text;
 }
 
-template <typename CharT, typename Iter>
-[[nodiscard]] inline tstring<CharT> join(Iter begin, Iter end,
-                                         CharT const* const separator)
+template <typename String>
+inline void trimleft_in_place(String& text)
 {
-    tstringstream<CharT> oss;
-    std::copy(begin, end,
-              utils::iterators::make_ostream_joiner(oss, separator));
-    return oss.str();
+    using CharT = typename String::value_type;
+    if constexpr (std::is_same_v<CharT, char>) {
+        text.erase(0, text.size() - trimleft_view(text).size());
+    } else {
+        text.erase(text.begin(),
+                   std::find_if_not(text.begin(), text.end(),
+                                    is_whitespace<CharT>));
+    }
 }
 
-template <typename CharT, typename C>
-[[nodiscard]] inline tstring<CharT> join(C const& c,
-                                         CharT const* const separator)
+template <typename String>
+inline void trimright_in_place(String& text)
 {
-    return join(std::cbegin(c), std::cend(c), separator);
+    using CharT = typename String::value_type;
+    if constexpr (std::is_same_v<CharT, char>) {
+        text.erase(trimright_view(text).size());
+    } else {
+        text.erase(std::find_if_not(text.rbegin(), text.rend(),
+                                    is_whitespace<CharT>)
+                       .base(),
+                   text.end());
+    }
 }
 
-// Single-character separator convenience overload.
-template <typename CharT, typename C>
-[[nodiscard]] inline tstring<CharT> join(C const& c, CharT const separator)
+template <typename String>
+inline void trim_in_place(String& text)
 {
-    tstring<CharT> const sep(1, separator);
-    return join<CharT>(std::cbegin(c), std::cend(c), sep.c_str());
+    using CharT = typename String::value_type;
+    if constexpr (std::is_same_v<CharT, char>) {
+        auto const kept = trim_view(text);
+        auto const first = static_cast<std::size_t>(kept.data() - text.data());
+        text.erase(first + kept.size());
+        text.erase(0, first);
+    } else {
+        trimright_in_place(text);
+        trimleft_in_place(text);
+    }
 }
+} // namespace detail
 
-// String separator convenience overload.
-template <typename CharT, typename C>
-[[nodiscard]] inline tstring<CharT> join(C const& c,
-                                         tstring<CharT> const& separator)
+namespace mutable_version
 {
-    return join<CharT>(std::cbegin(c), std::cend(c), separator.c_str());
+template <typename CharT, typename Allocator>
+inline void to_upper(tstring<CharT, Allocator>& text)
+{
+    detail::to_upper_in_place(text);
 }
 
-// Non-owning split on a SET of single-character delimiters: returns views into
-// `text`, which must outlive the result. Allocates only the token vector, not
-// the tokens themselves. With keep_empty == false (the default) empty tokens
-// between adjacent/leading/trailing delimiters are skipped; with keep_empty ==
-// true they are preserved (e.g. for CSV fields).
-template <typename CharT>
-[[nodiscard]] inline std::vector<tstringview<CharT>>
-split_view(tstringview<CharT> const text, tstringview<CharT> const delimiters,
-           bool const keep_empty = false)
+template <typename CharT, typename Allocator>
+inline void to_lower(tstring<CharT, Allocator>& text)
 {
-    std::vector<tstringview<CharT>> tokens;
-    std::size_t pos = 0;
-    std::size_t prev_pos = 0;
-    while ((pos = text.find_first_of(delimiters, prev_pos)) !=
-           tstringview<CharT>::npos) {
-        if (pos > prev_pos || keep_empty) {
-            tokens.push_back(text.substr(prev_pos, pos - prev_pos));
-        }
+    detail::to_lower_in_place(text);
+}
 
-        prev_pos = pos + 1;
-    }
+template <typename CharT, typename Allocator>
+inline void reverse(tstring<CharT, Allocator>& text)
+{
+    std::reverse(std::begin(text), std::end(text));
+}
 
-    if (prev_pos < text.size() || keep_empty) {
-        tokens.push_back(text.substr(prev_pos));
-    }
+template <typename CharT, typename Allocator>
+inline void trim(tstring<CharT, Allocator>& text)
+{
+    detail::trim_in_place(text);
+}
 
-    return tokens;
+template <typename CharT, typename Allocator>
+inline void trimleft(tstring<CharT, Allocator>& text)
+{
+    detail::trimleft_in_place(text);
 }
 
-// Single-character delimiter convenience overload.
-template <typename CharT>
-[[nodiscard]] inline std::vector<tstringview<CharT>>
-split_view(tstringview<CharT> const text, CharT const delimiter,
-           bool const keep_empty = false)
+template <typename CharT, typename Allocator>
+inline void trimright(tstring<CharT, Allocator>& text)
 {
-    return split_view<CharT>(text, tstringview<CharT>(&delimiter, 1),
-                             keep_empty);
+    detail::trimright_in_place(text);
 }
+} // namespace mutable_version
 
-// Non-owning split on a WHOLE multi-character delimiter (the entire `delimiter`
-// sequence is matched), as opposed to split_view() which treats its argument as
-// a set of single-character delimiters. An empty delimiter yields the whole
-// input as a single token.
+// ----------
+// Searching
+// ----------
+
+// A needle preprocessed once for repeated searches (e.g. the same key over
+// millions of records). Short needles use the SIMD first/last-byte filter for
+// `char` (basic_string_view::find otherwise); longer ones use Horspool's
+// bad-character skip table, which lets a mismatch jump up to the needle
+// length. While SIMD dispatch is available the filter is kept for long `char`
+// needles over long windows too: on natural-language alphabets Horspool's
+// skips stay near the alphabet size and the vector filter outruns them (see
+// bench/searcher.cpp).
+// With `ignore_case` ASCII letters (and, for wider characters, whatever
+// my_tolower folds) compare equal regardless of case.
+//
+// The searcher owns a copy of the needle. Pass it to contains(),
+// replace_all(), replace_first() and the split_on family instead of the raw
+// needle to reuse the preprocessing.
 template <typename CharT>
-[[nodiscard]] inline std::vector<tstringview<CharT>>
-split_on_view(tstringview<CharT> const text, tstringview<CharT> const delimiter,
-              bool const keep_empty = false)
+class searcher
 {
-    std::vector<tstringview<CharT>> tokens;
-    if (delimiter.empty()) {
-        tokens.push_back(text);
-        return tokens;
-    }
+public:
+    static constexpr std::size_t npos = tstringview<CharT>::npos;
 
-    std::size_t pos = 0;
-    std::size_t prev_pos = 0;
-    while ((pos = text.find(delimiter, prev_pos)) != tstringview<CharT>::npos) {
-        if (pos > prev_pos || keep_empty) {
-            tokens.push_back(text.substr(prev_pos, pos - prev_pos));
+    // Needles longer than this switch from the SIMD filter to Horspool.
+    static constexpr std::size_t short_needle_max = 32;
+
+    explicit searcher(tstringview<CharT> const needle,
+                      bool const ignore_case = false)
+        : needle_(needle), ignore_case_(ignore_case)
+    {
+        if (ignore_case_) {
+            for (auto& ch : needle_) {
+                ch = my_tolower(ch);
+            }
+        }
+        horspool_ = needle_.size() > short_needle_max ||
+                    (ignore_case_ && !std::is_same_v<CharT, char>);
+        if (horspool_) {
+            shift_.fill(needle_.size());
+            for (std::size_t i = 0; i + 1 < needle_.size(); ++i) {
+                shift_[bucket(needle_[i])] = needle_.size() - 1 - i;
+            }
         }
+    }
 
-        prev_pos = pos + delimiter.size();
+    // Position of the first match at or after `pos`, or npos. An empty needle
+    // matches at `pos` (as basic_string_view::find does).
+    [[nodiscard]] std::size_t find(tstringview<CharT> const text,
+                                   std::size_t const pos = 0) const noexcept
+    {
+        if (pos > text.size()) {
+            return npos;
+        }
+        if (needle_.empty()) {
+            return pos;
+        }
+        if (text.size() - pos < needle_.size()) {
+            return npos;
+        }
+        if constexpr (std::is_same_v<CharT, char>) {
+            // Horspool still wins when the window holds only a few needle
+            // lengths: a couple of skips beat setting up vector blocks.
+            if (horspool_ && (text.size() - pos < 4 * needle_.size() ||
+                              simd::active_level() == simd::level::scalar)) {
+                return find_horspool(text, pos);
+            }
+            auto const* const last = text.data() + text.size();
+            auto const* const hit =
+                ignore_case_ ? simd::find_icase(text.data() + pos, last,
+                                                needle_.data(), needle_.size())
+                             : simd::find(text.data() + pos, last,
+                                          needle_.data(), needle_.size());
+            return hit == last ? npos
+                               : static_cast<std::size_t>(hit - text.data());
+        } else {
+            if (horspool_) {
+                return find_horspool(text, pos);
+            }
+            return text.find(tstringview<CharT>{needle_}, pos);
+        }
     }
 
-    if (prev_pos < text.size() || keep_empty) {
-        tokens.push_back(text.substr(prev_pos));
+    // The needle as searched for: lower-cased when ignoring case.
+    [[nodiscard]] tstringview<CharT> needle() const noexcept
+    {
+        return needle_;
     }
 
-    return tokens;
-}
+    [[nodiscard]] std::size_t size() const noexcept { return needle_.size(); }
 
-// Owning splits: materialize the views from the *_view functions into strings.
-template <typename CharT>
+    [[nodiscard]] bool ignore_case() const noexcept { return ignore_case_; }
+
+private:
+    // Skip-table slot: the low byte of the character, so wide characters
+    // sharing a slot keep the smallest (always safe) shift.
+    [[nodiscard]] static std::size_t bucket(CharT const ch) noexcept
+    {
+        return detail::to_byte_value(ch) & 0xFFU;
+    }
+
+    [[nodiscard]] CharT fold(CharT const ch) const noexcept
+    {
+        return ignore_case_ ? my_tolower(ch) : ch;
+    }
+
+    [[nodiscard]] bool matches_head(CharT const* const at) const noexcept
+    {
+        auto const head = needle_.size() - 1;
+        if (!ignore_case_) {
+            return std::char_traits<CharT>::compare(at, needle_.data(), head) ==
+                   0;
+        }
+        if constexpr (std::is_same_v<CharT, char>) {
+            return simd::equal_icase(at, needle_.data(), head);
+        } else {
+            for (std::size_t i = 0; i < head; ++i) {
+                if (my_tolower(at[i]) != needle_[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    [[nodiscard]] std::size_t find_horspool(tstringview<CharT> const text,
+                                            std::size_t pos) const noexcept
+    {
+        auto const last = needle_.size() - 1;
+        while (text.size() - pos >= needle_.size()) {
+            auto const tail = fold(text[pos + last]);
+            if (tail == needle_[last] && matches_head(text.data() + pos)) {
+                return pos;
+            }
+            pos += shift_[bucket(tail)];
+        }
+        return npos;
+    }
+
+    tstring<CharT> needle_;
+    bool ignore_case_;
+    bool horspool_{false};
+    std::array<std::size_t, 256> shift_{};
+};
+
+template <typename CharT>
+[[nodiscard]]
+inline bool starts_with(tstringview<CharT> const str,
+                        tstringview<CharT> const prefix,
+                        case_folding const folding)
+{
+    if (folding == case_folding::unicode) {
+        tstringview<CharT> rest;
+        return detail::unicode_prefix_equal(str, prefix, rest);
+    }
+    if (str.size() < prefix.size()) {
+        return false;
+    }
+    if (folding == case_folding::none) {
+        return str.substr(0, prefix.size()) == prefix;
+    }
+    return detail::equal_ascii_icase(str.data(), prefix.data(), prefix.size());
+}
+
+template <typename CharT>
+[[nodiscard]]
+inline bool starts_with(tstringview<CharT> const str,
+                        tstringview<CharT> const prefix,
+                        bool const ignore_case = false)
+{
+    return starts_with(str, prefix, detail::to_case_folding(ignore_case));
+}
+
+template <typename CharT>
+[[nodiscard]]
+inline bool ends_with(tstringview<CharT> const input,
+                      tstringview<CharT> const suffix,
+                      case_folding const folding)
+{
+    if (folding == case_folding::unicode) {
+        auto const folded = detail::fold_case_units(input);
+        auto const folded_suffix = detail::fold_case_units(suffix);
+        return ends_with(tstringview<CharT>{folded},
+                         tstringview<CharT>{folded_suffix},
+                         case_folding::none);
+    }
+    if (input.size() < suffix.size()) {
+        return false;
+    }
+    auto const tail = input.substr(input.size() - suffix.size());
+    if (folding == case_folding::none) {
+        return tail == suffix;
+    }
+    return detail::equal_ascii_icase(tail.data(), suffix.data(), suffix.size());
+}
+
+template <typename CharT>
+[[nodiscard]]
+inline bool ends_with(tstringview<CharT> const input,
+                      tstringview<CharT> const suffix,
+                      bool const ignore_case = false)
+{
+    return ends_with(input, suffix, detail::to_case_folding(ignore_case));
+}
+
+template <typename CharT>
+[[nodiscard]]
+bool contains(tstringview<CharT> const input, tstringview<CharT> const needle,
+              case_folding const folding)
+{
+    if (folding == case_folding::unicode) {
+        auto const folded = detail::fold_case_units(input);
+        auto const folded_needle = detail::fold_case_units(needle);
+        return contains(tstringview<CharT>{folded},
+                        tstringview<CharT>{folded_needle}, case_folding::none);
+    }
+    if (input.size() < needle.size()) {
+        return false;
+    }
+    if constexpr (std::is_same_v<CharT, char>) {
+        auto const* const last = input.data() + input.size();
+        return (folding == case_folding::none
+                    ? simd::find(input.data(), last, needle.data(),
+                                 needle.size())
+                    : simd::find_icase(input.data(), last, needle.data(),
+                                       needle.size())) != last;
+    } else {
+        return std::search(std::begin(input), std::end(input),
+                           std::begin(needle), std::end(needle),
+                           [&](CharT const c1, CharT const c2) {
+                               return folding == case_folding::ascii
+                                          ? my_tolower(c1) == my_tolower(c2)
+                                          : c1 == c2;
+                           }) != std::end(input);
+    }
+}
+
+template <typename CharT>
+[[nodiscard]]
+bool contains(tstringview<CharT> const input, tstringview<CharT> const needle,
+              bool const ignore_case = false)
+{
+    return contains(input, needle, detail::to_case_folding(ignore_case));
+}
+
+// Search with a precompiled needle (case sensitivity is the searcher's).
+template <typename CharT>
+[[nodiscard]]
+bool contains(tstringview<CharT> const input, searcher<CharT> const& needle)
+{
+    return needle.find(input) != searcher<CharT>::npos;
+}
+
+template <typename CharT>
+[[nodiscard]] bool equal(tstringview<CharT> const str1,
+                         tstringview<CharT> const str2,
+                         case_folding const folding)
+{
+    if (folding == case_folding::unicode) {
+        tstringview<CharT> rest;
+        return detail::unicode_prefix_equal(str1, str2, rest) && rest.empty();
+    }
+    if (str1.size() != str2.size()) {
+        return false;
+    }
+    if (folding == case_folding::none) {
+        return str1 == str2;
+    }
+    return detail::equal_ascii_icase(str1.data(), str2.data(), str1.size());
+}
+
+template <typename CharT>
+[[nodiscard]] bool equal(tstringview<CharT> const str1,
+                         tstringview<CharT> const str2,
+                         bool const ignore_case = false)
+{
+    return equal(str1, str2, detail::to_case_folding(ignore_case));
+}
+
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+to_upper(tstring<CharT, Allocator> text)
+{
+    mutable_version::to_upper(text);
+    return text;
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT> to_upper(tstring<CharT> text)
+{
+    return to_upper<CharT, std::allocator<CharT>>(std::move(text));
+}
+
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+to_lower(tstring<CharT, Allocator> text)
+{
+    mutable_version::to_lower(text);
+    return text;
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT> to_lower(tstring<CharT> text)
+{
+    return to_lower<CharT, std::allocator<CharT>>(std::move(text));
+}
+
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+reverse(tstring<CharT, Allocator> text)
+{
+    mutable_version::reverse(text);
+    return text;
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT> reverse(tstring<CharT> text)
+{
+    return reverse<CharT, std::allocator<CharT>>(std::move(text));
+}
+
+// The trims copy the kept characters into a string on `text`'s allocator.
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+trim(tstring<CharT, Allocator> const& text)
+{
+    using string = tstring<CharT, Allocator>;
+    if constexpr (std::is_same_v<CharT, char>) {
+        return string(trim_view(text), text.get_allocator());
+    } else {
+        auto const first = std::find_if_not(text.begin(), text.end(),
+                                            detail::is_whitespace<CharT>);
+        if (first == text.end()) {
+            return string(text.get_allocator());
+        }
+        auto const last = std::find_if_not(text.rbegin(), text.rend(),
+                                           detail::is_whitespace<CharT>);
+        return string(first, last.base(), text.get_allocator());
+    }
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT> trim(tstring<CharT> const& text)
+{
+    return trim<CharT, std::allocator<CharT>>(text);
+}
+
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+trimleft(tstring<CharT, Allocator> const& text)
+{
+    using string = tstring<CharT, Allocator>;
+    if constexpr (std::is_same_v<CharT, char>) {
+        return string(trimleft_view(text), text.get_allocator());
+    } else {
+        return string(std::find_if_not(text.begin(), text.end(),
+                                       detail::is_whitespace<CharT>),
+                      text.end(), text.get_allocator());
+    }
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT> trimleft(tstring<CharT> const& text)
+{
+    return trimleft<CharT, std::allocator<CharT>>(text);
+}
+
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+trimright(tstring<CharT, Allocator> const& text)
+{
+    using string = tstring<CharT, Allocator>;
+    if constexpr (std::is_same_v<CharT, char>) {
+        return string(trimright_view(text), text.get_allocator());
+    } else {
+        return string(text.begin(),
+                      std::find_if_not(text.rbegin(), text.rend(),
+                                       detail::is_whitespace<CharT>)
+                          .base(),
+                      text.get_allocator());
+    }
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT> trimright(tstring<CharT> const& text)
+{
+    return trimright<CharT, std::allocator<CharT>>(text);
+}
+
+// For `char`, the charset overloads build a char_class from `chars` per call;
+// hold one and use trim_view() where the same set trims many strings.
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+trim(tstring<CharT, Allocator> const& text, tstring<CharT> const& chars)
+{
+    using string = tstring<CharT, Allocator>;
+    if constexpr (std::is_same_v<CharT, char>) {
+        return string(trim_view(text, char_class{chars}), text.get_allocator());
+    } else {
+        auto const first{text.find_first_not_of(chars)};
+        if (first == string::npos) {
+            return string(text.get_allocator());
+        }
+
+        auto const last{text.find_last_not_of(chars)};
+        return string(text, first, (last - first + 1), text.get_allocator());
+    }
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT> trim(tstring<CharT> const& text,
+                                         tstring<CharT> const& chars)
+{
+    return trim<CharT, std::allocator<CharT>>(text, chars);
+}
+
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+trimleft(tstring<CharT, Allocator> const& text, tstring<CharT> const& chars)
+{
+    using string = tstring<CharT, Allocator>;
+    if constexpr (std::is_same_v<CharT, char>) {
+        return string(trimleft_view(text, char_class{chars}),
+                      text.get_allocator());
+    } else {
+        auto const first{text.find_first_not_of(chars)};
+        if (first == string::npos) {
+            return string(text.get_allocator());
+        }
+
+        return string(text, first, text.size() - first, text.get_allocator());
+    }
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT> trimleft(tstring<CharT> const& text,
+                                             tstring<CharT> const& chars)
+{
+    return trimleft<CharT, std::allocator<CharT>>(text, chars);
+}
+
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+trimright(tstring<CharT, Allocator> const& text, tstring<CharT> const& chars)
+{
+    using string = tstring<CharT, Allocator>;
+    if constexpr (std::is_same_v<CharT, char>) {
+        return string(trimright_view(text, char_class{chars}),
+                      text.get_allocator());
+    } else {
+        auto const last{text.find_last_not_of(chars)};
+        return string(text, 0, last + 1, text.get_allocator());
+    }
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT> trimright(tstring<CharT> const& text,
+                                              tstring<CharT> const& chars)
+{
+    return trimright<CharT, std::allocator<CharT>>(text, chars);
+}
+
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+remove(tstring<CharT, Allocator> text, CharT const ch)
+{
+    if constexpr (std::is_same_v<CharT, char>) {
+        auto* const first = text.data();
+        text.resize(static_cast<std::size_t>(
+            simd::remove(first, first + text.size(),
+                         char_class{std::string_view(&ch, 1)}) -
+            first));
+        return text;
+    } else {
+        auto const start = std::remove_if(
+            std::begin(text), std::end(text), [=](CharT const c) {
+                return c == ch;
+            });
+        text.erase(start, std::end(text));
+        return text;
+    }
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT> remove(tstring<CharT> text, CharT const ch)
+{
+    return remove<CharT, std::allocator<CharT>>(std::move(text), ch);
+}
+
+namespace detail
+{
+// Next occurrence of a non-empty `needle` at or after `pos`, or npos.
+template <typename CharT>
+[[nodiscard]] inline std::size_t find_substring(tstringview<CharT> const text,
+                                                tstringview<CharT> const needle,
+                                                std::size_t const pos) noexcept
+{
+    if constexpr (std::is_same_v<CharT, char>) {
+        if (pos >= text.size()) {
+            return std::string_view::npos;
+        }
+        auto const* const last = text.data() + text.size();
+        auto const* const hit =
+            simd::find(text.data() + pos, last, needle.data(), needle.size());
+        return hit == last ? std::string_view::npos
+                           : static_cast<std::size_t>(hit - text.data());
+    } else {
+        return text.find(needle, pos);
+    }
+}
+
+// The replace_all() core. `find(text, pos)` returns the next match of a
+// `from_size`-character needle at or after `pos` (npos when there is none).
+// Matches are non-overlapping and scanned left to right; the output is sized
+// once (counting matches first only when it grows) and built front to back.
+template <typename CharT, typename Find, typename Allocator>
+inline void append_replaced(tstring<CharT, Allocator>& out,
+                            tstringview<CharT> const text, Find const& find,
+                            std::size_t const from_size,
+                            tstringview<CharT> const to)
+{
+    constexpr auto npos = tstringview<CharT>::npos;
+    auto pos = find(text, 0);
+    if (pos == npos) {
+        out.append(text.data(), text.size());
+        return;
+    }
+
+    auto size = text.size();
+    if (to.size() > from_size) {
+        std::size_t count = 0;
+        for (auto p = pos; p != npos; p = find(text, p + from_size)) {
+            ++count;
+        }
+        size += count * (to.size() - from_size);
+    }
+    out.reserve(out.size() + size);
+
+    std::size_t done = 0;
+    for (; pos != npos; pos = find(text, pos + from_size)) {
+        out.append(text.data() + done, pos - done);
+        out.append(to.data(), to.size());
+        done = pos + from_size;
+    }
+    out.append(text.data() + done, text.size() - done);
+}
+
+// In-place core for replacements that do not grow the text: equal lengths
+// overwrite each match, shorter ones compact the string towards the front.
+// Writes never pass the read position, so `find` only sees original text.
+template <typename CharT, typename Find, typename Allocator>
+inline void replace_in_place(tstring<CharT, Allocator>& text, Find const& find,
+                             std::size_t const from_size,
+                             tstringview<CharT> const to)
+{
+    using traits = std::char_traits<CharT>;
+    constexpr auto npos = tstringview<CharT>::npos;
+    tstringview<CharT> const view{text};
+    auto* const data = text.data();
+    auto pos = find(view, 0);
+    if (to.size() == from_size) {
+        for (; pos != npos; pos = find(view, pos + from_size)) {
+            traits::copy(data + pos, to.data(), to.size());
+        }
+        return;
+    }
+    if (pos == npos) {
+        return;
+    }
+
+    auto write = pos;
+    auto done = pos;
+    for (; pos != npos; pos = find(view, pos + from_size)) {
+        traits::move(data + write, data + done, pos - done);
+        write += pos - done;
+        traits::copy(data + write, to.data(), to.size());
+        write += to.size();
+        done = pos + from_size;
+    }
+    traits::move(data + write, data + done, text.size() - done);
+    text.resize(write + text.size() - done);
+}
+
+template <typename CharT, typename Find, typename Allocator>
+inline void replace_all(tstring<CharT, Allocator>& text, Find const& find,
+                        std::size_t const from_size,
+                        tstringview<CharT> const to)
+{
+    if (to.size() <= from_size) {
+        replace_in_place(text, find, from_size, to);
+        return;
+    }
+    tstring<CharT, Allocator> out(text.get_allocator());
+    append_replaced(out, tstringview<CharT>{text}, find, from_size, to);
+    text.swap(out);
+}
+} // namespace detail
+
+namespace mutable_version
+{
+// Replace every non-overlapping occurrence of `from` with `to` in place. When
+// `to` is no longer than `from` the string's buffer is reused and nothing is
+// allocated; otherwise the result is built once in a buffer of the final size.
+// An empty `from` is a no-op.
+template <typename CharT, typename Allocator>
+inline void replace_all(tstring<CharT, Allocator>& text,
+                        tstringview<CharT> const from,
+                        tstringview<CharT> const to)
+{
+    if (from.empty()) {
+        return;
+    }
+    detail::replace_all(
+        text,
+        [from](tstringview<CharT> const t, std::size_t const pos) {
+            return detail::find_substring(t, from, pos);
+        },
+        from.size(), to);
+}
+
+template <typename CharT, typename Allocator>
+inline void replace_all(tstring<CharT, Allocator>& text,
+                        searcher<CharT> const& from,
+                        tstringview<CharT> const to)
+{
+    if (from.size() == 0) {
+        return;
+    }
+    detail::replace_all(
+        text,
+        [&from](tstringview<CharT> const t, std::size_t const pos) {
+            return from.find(t, pos);
+        },
+        from.size(), to);
+}
+} // namespace mutable_version
+
+// Replace every non-overlapping occurrence of `from` with `to`. An empty `from`
+// is a no-op (returns the input unchanged) rather than looping forever.
+// Replacements are not re-scanned, and the work is linear in the text size
+// however many matches there are.
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+replace_all(tstring<CharT, Allocator> text, tstringview<CharT> const from,
+            tstringview<CharT> const to)
+{
+    mutable_version::replace_all(text, from, to);
+    return text;
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT> replace_all(tstring<CharT> text,
+                                                tstringview<CharT> const from,
+                                                tstringview<CharT> const to)
+{
+    return replace_all<CharT, std::allocator<CharT>>(std::move(text), from,
+                                                     to);
+}
+
+// replace_all() with a precompiled `from`; an empty needle is a no-op too.
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+replace_all(tstring<CharT, Allocator> text, searcher<CharT> const& from,
+            tstringview<CharT> const to)
+{
+    mutable_version::replace_all(text, from, to);
+    return text;
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT> replace_all(tstring<CharT> text,
+                                                searcher<CharT> const& from,
+                                                tstringview<CharT> const to)
+{
+    return replace_all<CharT, std::allocator<CharT>>(std::move(text), from,
+                                                     to);
+}
+
+// Append `text` with every occurrence of `from` replaced by `to` to `out`,
+// e.g. to reuse one output buffer across many records. An empty `from`
+// appends `text` unchanged.
+template <typename CharT, typename Allocator>
+inline void append_replaced(tstring<CharT, Allocator>& out,
+                            tstringview<CharT> const text,
+                            tstringview<CharT> const from,
+                            tstringview<CharT> const to)
+{
+    if (from.empty()) {
+        out.append(text.data(), text.size());
+        return;
+    }
+    detail::append_replaced(
+        out, text,
+        [from](tstringview<CharT> const t, std::size_t const pos) {
+            return detail::find_substring(t, from, pos);
+        },
+        from.size(), to);
+}
+
+template <typename CharT, typename Allocator>
+inline void append_replaced(tstring<CharT, Allocator>& out,
+                            tstringview<CharT> const text,
+                            searcher<CharT> const& from,
+                            tstringview<CharT> const to)
+{
+    if (from.size() == 0) {
+        out.append(text.data(), text.size());
+        return;
+    }
+    detail::append_replaced(
+        out, text,
+        [&from](tstringview<CharT> const t, std::size_t const pos) {
+            return from.find(t, pos);
+        },
+        from.size(), to);
+}
+
+// Single-character replace convenience overload.
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+replace_all(tstring<CharT, Allocator> text, CharT const from, CharT const to)
+{
+    std::replace(std::begin(text), std::end(text), from, to);
+    return text;
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT>
+replace_all(tstring<CharT> text, CharT const from, CharT const to)
+{
+    return replace_all<CharT, std::allocator<CharT>>(std::move(text), from,
+                                                     to);
+}
+
+// Replace only the first occurrence of `from` with `to`.
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+replace_first(tstring<CharT, Allocator> text, tstringview<CharT> const from,
+              tstringview<CharT> const to)
+{
+    if (from.empty()) {
+        return text;
+    }
+
+    auto const pos = text.find(from);
+    if (pos != tstring<CharT, Allocator>::npos) {
+        text.replace(pos, from.size(), to.data(), to.size());
+    }
+    return text;
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT> replace_first(tstring<CharT> text,
+                                                  tstringview<CharT> const from,
+                                                  tstringview<CharT> const to)
+{
+    return replace_first<CharT, std::allocator<CharT>>(std::move(text), from,
+                                                       to);
+}
+
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+replace_first(tstring<CharT, Allocator> text, searcher<CharT> const& from,
+              tstringview<CharT> const to)
+{
+    if (from.size() == 0) {
+        return text;
+    }
+
+    auto const pos = from.find(text);
+    if (pos != searcher<CharT>::npos) {
+        text.replace(pos, from.size(), to.data(), to.size());
+    }
+    return text;
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT> replace_first(tstring<CharT> text,
+                                                  searcher<CharT> const& from,
+                                                  tstringview<CharT> const to)
+{
+    return replace_first<CharT, std::allocator<CharT>>(std::move(text), from,
+                                                       to);
+}
+
+// ----------
+// Multi-pattern matching
+// ----------
+
+// Aho-Corasick automaton compiled once from a set of patterns. A scan visits
+// every character of the text once, whatever the number of patterns, instead
+// of the one pass per pattern that repeated find()/replace_all() calls need.
+//
+// States near the root, which most of the scan time is spent in, keep a dense
+// 256-entry transition row (failure links already resolved). Deeper states
+// keep a short sorted edge list and fall back along their failure link. Wide
+// characters are fed through the automaton one byte at a time, so a single
+// byte-level layout serves every CharT. For `char`, runs of text that cannot
+// start a match are skipped with simd::find_first_of while at the root.
+//
+// A pattern's id is its index in the input. Empty patterns never match;
+// duplicate patterns report the lowest id. The object is immutable after
+// construction, so threads can share one instance without synchronization.
+template <typename CharT>
+class multi_searcher
+{
+public:
+    struct match
+    {
+        std::size_t pattern; // index into the pattern list
+        std::size_t offset;  // position of the first character in the text
+    };
+
+    template <typename C>
+    explicit multi_searcher(C const& patterns, bool const ignore_case = false)
+        : ignore_case_(ignore_case)
+    {
+        build(std::cbegin(patterns), std::cend(patterns));
+    }
+
+    explicit multi_searcher(std::initializer_list<tstringview<CharT>> patterns,
+                            bool const ignore_case = false)
+        : ignore_case_(ignore_case)
+    {
+        build(patterns.begin(), patterns.end());
+    }
+
+    [[nodiscard]] std::size_t pattern_count() const noexcept
+    {
+        return sizes_.size();
+    }
+
+    // Length of pattern `id` in characters.
+    [[nodiscard]] std::size_t pattern_size(std::size_t const id) const
+    {
+        return sizes_.at(id);
+    }
+
+    [[nodiscard]] bool ignore_case() const noexcept { return ignore_case_; }
+
+    // Call `fn(match)` for every occurrence of every pattern, overlapping ones
+    // included, ordered by end position (longer patterns first on ties).
+    template <typename F>
+    void for_each_match(tstringview<CharT> const text, F&& fn) const
+    {
+        scan(text, [&](std::size_t const end, std::uint32_t const current) {
+            for (auto s = states_[current].report; s != none;
+                 s = states_[states_[s].fail].report) {
+                auto const id = states_[s].output;
+                fn(match{id, end - sizes_[id]});
+            }
+            return true;
+        });
+    }
+
+    // Call `fn(match)` for the matches replace_all() rewrites, in text order:
+    // scanning left to right, the leftmost match wins and, among those
+    // starting there, the longest. The choice is made during the scan: only
+    // the longest match so far for each start a pattern could still extend
+    // is kept, so memory is bounded by the longest pattern, and a match is
+    // passed on as soon as no later one can start at or before it.
+    template <typename F>
+    void for_each_non_overlapping(tstringview<CharT> const text, F&& fn) const
+    {
+        // Pattern id of the longest match starting at each position in
+        // [cursor, cursor + window), indexed by position % window.
+        auto const window = std::max<std::size_t>(longest_, 1);
+        std::vector<std::uint32_t> longest(window, none);
+        std::size_t cursor = 0; // first start not yet decided
+        std::size_t live = 0;   // entries of `longest` in use
+
+        // No match found from now on starts before `lo`.
+        auto const settle = [&](std::size_t const lo) {
+            while (cursor < lo && live != 0) {
+                auto const id = std::exchange(longest[cursor % window], none);
+                if (id == none) {
+                    ++cursor;
+                    continue;
+                }
+                --live;
+                fn(match{id, cursor});
+                // Drop what the chosen match overlaps.
+                auto const end = cursor + sizes_[id];
+                for (++cursor; cursor < end; ++cursor) {
+                    if (std::exchange(longest[cursor % window], none) !=
+                        none) {
+                        --live;
+                    }
+                }
+            }
+            cursor = std::max(cursor, lo);
+        };
+
+        scan(text, [&](std::size_t const end, std::uint32_t const current) {
+            // The automaton's depth bounds how far back a later match can
+            // start.
+            settle(end - states_[current].depth / sizeof(CharT));
+            // Along the report chain starts increase; at a given start, a
+            // later end is a longer match.
+            for (auto s = states_[current].report; s != none;
+                 s = states_[states_[s].fail].report) {
+                auto const id = states_[s].output;
+                auto const start = end - sizes_[id];
+                if (start < cursor) {
+                    continue;
+                }
+                auto& slot = longest[start % window];
+                live += slot == none ? 1 : 0;
+                slot = id;
+            }
+            return true;
+        });
+        settle(text.size() + 1);
+    }
+
+    [[nodiscard]] bool contains_any(tstringview<CharT> const text) const
+    {
+        auto found = false;
+        scan(text, [&](std::size_t, std::uint32_t) {
+            found = true;
+            return false;
+        });
+        return found;
+    }
+
+    [[nodiscard]] std::vector<match>
+    find_all(tstringview<CharT> const text) const
+    {
+        std::vector<match> matches;
+        for_each_match(text, [&](match const m) {
+            matches.push_back(m);
+        });
+        return matches;
+    }
+
+    // The matches replace_all() rewrites; see for_each_non_overlapping().
+    [[nodiscard]] std::vector<match>
+    find_non_overlapping(tstringview<CharT> const text) const
+    {
+        std::vector<match> matches;
+        for_each_non_overlapping(text, [&](match const m) {
+            matches.push_back(m);
+        });
+        return matches;
+    }
+
+private:
+    static constexpr std::uint32_t none = 0xFFFFFFFFU;
+
+    struct state
+    {
+        std::uint32_t fail{0};
+        std::uint32_t output{none}; // pattern ending here
+        std::uint32_t report{none}; // nearest state on the fail chain
+                                    // (this one included) with an output
+        std::uint32_t row{none};    // dense row index, if any
+        std::uint32_t first_edge{0};
+        std::uint32_t edge_count{0};
+        std::uint32_t depth{0}; // in bytes
+    };
+
+    struct edge
+    {
+        unsigned char byte;
+        std::uint32_t next;
+    };
+
+    // States shallower than this get a dense row.
+    static constexpr std::uint32_t dense_depth = 2;
+
+    [[nodiscard]] CharT fold(CharT const ch) const noexcept
+    {
+        return ignore_case_ ? my_tolower(ch) : ch;
+    }
+
+    // Feed the bytes of one character; wide characters low byte first.
+    template <typename Step>
+    static void for_each_byte(CharT const ch, Step&& step)
+    {
+        auto value = detail::to_byte_value(ch);
+        if constexpr (sizeof(CharT) == 1) {
+            step(static_cast<unsigned char>(value));
+        } else {
+            for (std::size_t i = 0; i < sizeof(CharT); ++i) {
+                step(static_cast<unsigned char>(value & 0xFFU));
+                value >>= 8U;
+            }
+        }
+    }
+
+    template <typename Iter>
+    void build(Iter first, Iter const last)
+    {
+        // 1. Trie with sparse children.
+        std::vector<std::vector<edge>> children(1);
+        states_.emplace_back();
+        for (std::uint32_t id = 0; first != last; ++first, ++id) {
+            tstringview<CharT> const pattern{*first};
+            sizes_.push_back(pattern.size());
+            longest_ = std::max(longest_, pattern.size());
+            if (pattern.empty()) {
+                continue;
+            }
+            std::uint32_t current = 0;
+            for (auto const ch : pattern) {
+                for_each_byte(fold(ch), [&](unsigned char const byte) {
+                    auto& kids = children[current];
+                    auto const it = std::find_if(kids.begin(), kids.end(),
+                                                 [&](edge const& e) {
+                                                     return e.byte == byte;
+                                                 });
+                    if (it != kids.end()) {
+                        current = it->next;
+                        return;
+                    }
+                    auto const next =
+                        static_cast<std::uint32_t>(states_.size());
+                    kids.push_back(edge{byte, next});
+                    states_.emplace_back();
+                    states_.back().depth = states_[current].depth + 1;
+                    children.emplace_back();
+                    current = next;
+                });
+            }
+            if (states_[current].output == none) {
+                states_[current].output = id;
+            }
+        }
+
+        // 2. Failure and report links, breadth first so a state's fail
+        //    target is always finished before the state itself.
+        auto const child = [&](std::uint32_t s, unsigned char const byte) {
+            for (auto const& e : children[s]) {
+                if (e.byte == byte) {
+                    return e.next;
+                }
+            }
+            return none;
+        };
+        std::vector<std::uint32_t> order{0};
+        states_[0].report = states_[0].output;
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            auto const u = order[i];
+            for (auto const& e : children[u]) {
+                auto& v = states_[e.next];
+                if (u != 0) {
+                    auto f = states_[u].fail;
+                    while (f != 0 && child(f, e.byte) == none) {
+                        f = states_[f].fail;
+                    }
+                    auto const target = child(f, e.byte);
+                    v.fail = target == none ? 0 : target;
+                }
+                v.report = v.output != none ? e.next : states_[v.fail].report;
+                order.push_back(e.next);
+            }
+        }
+
+        // 3. Final layout: dense rows for shallow states (in BFS order, so a
+        //    fail target's row exists before it is copied from), sorted edge
+        //    lists for the rest.
+        for (auto const u : order) {
+            auto& s = states_[u];
+            auto& kids = children[u];
+            if (s.depth < dense_depth) {
+                s.row = static_cast<std::uint32_t>(dense_.size() / 256);
+                dense_.resize(dense_.size() + 256);
+                auto* const row = dense_.data() + std::size_t{s.row} * 256;
+                if (u != 0) {
+                    auto const* const fallback =
+                        dense_.data() + std::size_t{states_[s.fail].row} * 256;
+                    std::copy(fallback, fallback + 256, row);
+                }
+                for (auto const& e : kids) {
+                    row[e.byte] = e.next;
+                }
+            } else {
+                std::sort(kids.begin(), kids.end(),
+                          [](edge const& a, edge const& b) {
+                              return a.byte < b.byte;
+                          });
+                s.first_edge = static_cast<std::uint32_t>(edges_.size());
+                s.edge_count = static_cast<std::uint32_t>(kids.size());
+                edges_.insert(edges_.end(), kids.begin(), kids.end());
+            }
+            if (u == 0) {
+                for (auto const& e : kids) {
+                    first_bytes_.insert(e.byte);
+                    if (ignore_case_) {
+                        first_bytes_.insert(detail::ascii_upper[e.byte]);
+                    }
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] std::uint32_t step(std::uint32_t s,
+                                     unsigned char const byte) const noexcept
+    {
+        for (;;) {
+            auto const& st = states_[s];
+            if (st.row != none) {
+                return dense_[std::size_t{st.row} * 256 + byte];
+            }
+            auto const* const first = edges_.data() + st.first_edge;
+            for (auto const* e = first; e != first + st.edge_count; ++e) {
+                if (e->byte == byte) {
+                    return e->next;
+                }
+                if (e->byte > byte) {
+                    break;
+                }
+            }
+            s = st.fail;
+        }
+    }
+
+    // Run the automaton over `text`, calling `on_match(end, state)` after
+    // each character that completes at least one pattern (states_[state]
+    // .report is set); stops early when it returns false.
+    template <typename OnMatch>
+    void scan(tstringview<CharT> const text, OnMatch&& on_match) const
+    {
+        std::uint32_t s = 0;
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            if constexpr (std::is_same_v<CharT, char>) {
+                if (s == 0) {
+                    auto const* const last = text.data() + text.size();
+                    auto const* const hit = simd::find_first_of(
+                        text.data() + i, last, first_bytes_);
+                    if (hit == last) {
+                        return;
+                    }
+                    i = static_cast<std::size_t>(hit - text.data());
+                }
+            }
+            for_each_byte(fold(text[i]), [&](unsigned char const byte) {
+                s = step(s, byte);
+            });
+            if (states_[s].report != none && !on_match(i + 1, s)) {
+                return;
+            }
+        }
+    }
+
+    bool ignore_case_;
+    std::vector<state> states_;
+    std::vector<edge> edges_;
+    std::vector<std::uint32_t> dense_;
+    std::vector<std::size_t> sizes_;
+    std::size_t longest_{0}; // longest pattern, in characters
+    simd::byte_set first_bytes_;
+};
+
+template <typename CharT>
+[[nodiscard]] inline bool contains_any(tstringview<CharT> const text,
+                                       multi_searcher<CharT> const& patterns)
+{
+    return patterns.contains_any(text);
+}
+
+template <typename CharT>
+[[nodiscard]] inline std::vector<typename multi_searcher<CharT>::match>
+find_all(tstringview<CharT> const text, multi_searcher<CharT> const& patterns)
+{
+    return patterns.find_all(text);
+}
+
+namespace detail
+{
+// Build the output of a multi-pattern replace_all, appending each match's
+// replacement as the scan settles it. `replacement(id)` yields the text for
+// pattern `id`.
+template <typename CharT, typename Replacement, typename Allocator>
+[[nodiscard]] inline string_for<CharT, Allocator>
+replace_matches(tstringview<CharT> const text,
+                multi_searcher<CharT> const& patterns,
+                Replacement const& replacement, Allocator const& alloc)
+{
+    using match = typename multi_searcher<CharT>::match;
+    string_for<CharT, Allocator> out(rebind_alloc_t<Allocator, CharT>{alloc});
+    out.reserve(text.size());
+    std::size_t pos = 0;
+    patterns.for_each_non_overlapping(text, [&](match const m) {
+        out.append(text.data() + pos, m.offset - pos);
+        out.append(tstringview<CharT>{replacement(m.pattern)});
+        pos = m.offset + patterns.pattern_size(m.pattern);
+    });
+    out.append(text.data() + pos, text.size() - pos);
+    return out;
+}
+} // namespace detail
+
+// Replace every pattern occurrence with `replacements[id]` of the matching
+// pattern, in one scan of `text` (leftmost-longest, non-overlapping; see
+// multi_searcher::for_each_non_overlapping). `replacements` is any indexable
+// container of string-like values; throws std::invalid_argument unless it
+// holds exactly one replacement per pattern.
+template <typename CharT, typename C, typename Allocator,
+          typename = std::enable_if_t<
+              !std::is_convertible_v<C const&, tstringview<CharT>>>>
+[[nodiscard]] inline detail::string_for<CharT, Allocator>
+replace_all(tstringview<CharT> const text,
+            multi_searcher<CharT> const& patterns, C const& replacements,
+            Allocator const& alloc)
+{
+    if (std::size(replacements) != patterns.pattern_count()) {
+        throw std::invalid_argument(
+            "replace_all: need one replacement per pattern");
+    }
+    return detail::replace_matches(
+        text, patterns,
+        [&](std::size_t const id) {
+            return tstringview<CharT>{replacements[id]};
+        },
+        alloc);
+}
+
+template <typename CharT, typename C,
+          typename = std::enable_if_t<
+              !std::is_convertible_v<C const&, tstringview<CharT>>>>
+[[nodiscard]] inline tstring<CharT>
+replace_all(tstringview<CharT> const text,
+            multi_searcher<CharT> const& patterns, C const& replacements)
+{
+    return replace_all(text, patterns, replacements, std::allocator<CharT>{});
+}
+
+// Replace every occurrence of any pattern with the same `to`.
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline detail::string_for<CharT, Allocator>
+replace_all(tstringview<CharT> const text,
+            multi_searcher<CharT> const& patterns, tstringview<CharT> const to,
+            Allocator const& alloc)
+{
+    return detail::replace_matches(
+        text, patterns,
+        [&](std::size_t) {
+            return to;
+        },
+        alloc);
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT>
+replace_all(tstringview<CharT> const text,
+            multi_searcher<CharT> const& patterns, tstringview<CharT> const to)
+{
+    return replace_all(text, patterns, to, std::allocator<CharT>{});
+}
+
+// ----------
+// Number formatting
+// ----------
+
+namespace detail
+{
+template <typename T>
+inline constexpr bool is_character_v =
+    std::is_same_v<T, char> || std::is_same_v<T, signed char> ||
+    std::is_same_v<T, unsigned char> || std::is_same_v<T, wchar_t> ||
+#if defined(__cpp_char8_t)
+    std::is_same_v<T, char8_t> ||
+#endif
+    std::is_same_v<T, char16_t> || std::is_same_v<T, char32_t>;
+
+// Types formatted with std::to_chars: integers always, floating point where
+// the library provides it. Characters and bool are not numbers here.
+template <typename T>
+inline constexpr bool is_chars_number_v =
+    std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !is_character_v<T>
+#if !defined(__cpp_lib_to_chars)
+    && std::is_integral_v<T>
+#endif
+    ;
+
+// Copy `size` ASCII characters into `out`, widening them for wider CharT.
+template <typename CharT>
+inline void widen_copy(CharT* const out, char const* const in,
+                       std::size_t const size) noexcept
+{
+    if constexpr (std::is_same_v<CharT, char>) {
+        std::char_traits<char>::copy(out, in, size);
+    } else {
+        std::transform(in, in + size, out, [](char const ch) {
+            return static_cast<CharT>(ch);
+        });
+    }
+}
+} // namespace detail
+
+// The characters of one formatted number, stored inline: formatting into it
+// never allocates. Converts to std::string_view, so it can be passed straight
+// to append/pad functions.
+class number_chars
+{
+public:
+    // Fits every integer, the shortest form of every float, and fixed
+    // notation up to this many characters.
+    static constexpr std::size_t capacity = 128;
+
+    [[nodiscard]] char const* data() const noexcept { return data_; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+    [[nodiscard]] std::string_view view() const noexcept
+    {
+        return {data_, size_};
+    }
+
+    operator std::string_view() const noexcept { return view(); } // NOLINT
+
+private:
+    template <typename T>
+    friend number_chars format_number(T value);
+#if defined(__cpp_lib_to_chars)
+    template <typename T>
+    friend number_chars format_fixed(T value, int precision);
+#endif
+
+    char data_[capacity];
+    std::size_t size_{0};
+};
+
+// Format an integer, or a floating-point value in its shortest round-trip
+// form, with std::to_chars (no locale, no allocation).
+template <typename T>
+[[nodiscard]] inline number_chars format_number(T const value)
+{
+    static_assert(detail::is_chars_number_v<T>,
+                  "format_number: T must be an integer or floating-point type");
+    number_chars out;
+    auto const result =
+        std::to_chars(std::begin(out.data_), std::end(out.data_), value);
+    out.size_ = static_cast<std::size_t>(result.ptr - out.data_);
+    return out;
+}
+
+#if defined(__cpp_lib_to_chars)
+// Format a floating-point value in fixed notation with `precision` digits
+// after the point. Throws std::out_of_range if the result would exceed
+// number_chars::capacity (use format_fixed_to with a larger span instead).
+template <typename T>
+[[nodiscard]] inline number_chars format_fixed(T const value,
+                                               int const precision)
+{
+    static_assert(std::is_floating_point_v<T>,
+                  "format_fixed: T must be a floating-point type");
+    number_chars out;
+    auto const result =
+        std::to_chars(std::begin(out.data_), std::end(out.data_), value,
+                      std::chars_format::fixed, precision);
+    if (result.ec != std::errc{}) {
+        throw std::out_of_range("format_fixed: result too long");
+    }
+    out.size_ = static_cast<std::size_t>(result.ptr - out.data_);
+    return out;
+}
+#endif
+
+namespace detail
+{
+template <typename CharT>
+inline std::size_t copy_number(utils::span<CharT> const out,
+                               std::string_view const digits)
+{
+    if (out.size() < digits.size()) {
+        throw std::out_of_range("format_to: output buffer too small");
+    }
+    widen_copy(out.data(), digits.data(), digits.size());
+    return digits.size();
+}
+
+// Write `digits` right-aligned in `width` characters. Zero fill goes after
+// the sign, as printf("%05d") does: -42 -> "-0042".
+template <typename CharT>
+inline void write_padded(CharT* out, std::string_view digits,
+                         std::size_t const width, CharT const fill) noexcept
+{
+    if (digits.size() >= width) {
+        widen_copy(out, digits.data(), digits.size());
+        return;
+    }
+    auto const pad = width - digits.size();
+    if (fill == CharT{'0'} && !digits.empty() && digits.front() == '-') {
+        *out++ = CharT{'-'};
+        digits.remove_prefix(1);
+    }
+    std::char_traits<CharT>::assign(out, pad, fill);
+    widen_copy(out + pad, digits.data(), digits.size());
+}
+} // namespace detail
+
+// Format `value` (see format_number) into a caller-provided buffer. Returns
+// the number of characters written; throws std::out_of_range if `out` is too
+// small.
+template <typename CharT, typename T>
+inline std::size_t format_to(utils::span<CharT> const out, T const value)
+{
+    return detail::copy_number(out, format_number(value).view());
+}
+
+#if defined(__cpp_lib_to_chars)
+// format_fixed() into a caller-provided buffer. Unlike format_fixed, the
+// length is only limited by `out`. Throws std::out_of_range if it is too
+// small.
+template <typename CharT, typename T>
+inline std::size_t format_fixed_to(utils::span<CharT> const out,
+                                   T const value, int const precision)
+{
+    static_assert(std::is_floating_point_v<T>,
+                  "format_fixed_to: T must be a floating-point type");
+    if constexpr (std::is_same_v<CharT, char>) {
+        auto const result =
+            std::to_chars(out.data(), out.data() + out.size(), value,
+                          std::chars_format::fixed, precision);
+        if (result.ec != std::errc{}) {
+            throw std::out_of_range("format_fixed_to: output buffer too small");
+        }
+        return static_cast<std::size_t>(result.ptr - out.data());
+    } else {
+        return detail::copy_number(out,
+                                   format_fixed(value, precision).view());
+    }
+}
+#endif
+
+// Format an integer right-aligned in at least `width` characters (see
+// detail::write_padded for how zero fill treats the sign). Returns the number
+// of characters written; throws std::out_of_range if `out` is too small.
+template <typename CharT, typename T>
+inline std::size_t format_padded_to(utils::span<CharT> const out,
+                                    T const value, std::size_t const width,
+                                    CharT const fill = CharT{'0'})
+{
+    static_assert(std::is_integral_v<T> && detail::is_chars_number_v<T>,
+                  "format_padded_to: T must be an integer type");
+    auto const number = format_number(value);
+    auto const size = std::max(width, number.size());
+    if (out.size() < size) {
+        throw std::out_of_range("format_padded_to: output buffer too small");
+    }
+    detail::write_padded(out.data(), number.view(), width, fill);
+    return size;
+}
+
+namespace detail
+{
+// append_number and append_padded over tstring or inplace_string. Both grow
+// `out` in one step, so an inplace_string that is too small is left as is.
+template <typename String, typename T>
+inline void append_number(String& out, T const value)
+{
+    using CharT = typename String::value_type;
+    auto const number = format_number(value);
+    if constexpr (std::is_same_v<CharT, char>) {
+        out.append(number.data(), number.size());
+    } else {
+        auto const at = out.size();
+        out.resize(at + number.size());
+        widen_copy(out.data() + at, number.data(), number.size());
+    }
+}
+
+template <typename String, typename T>
+inline void append_padded(String& out, T const value, std::size_t const width,
+                          typename String::value_type const fill)
+{
+    static_assert(std::is_integral_v<T> && is_chars_number_v<T>,
+                  "append_padded: T must be an integer type");
+    auto const number = format_number(value);
+    auto const at = out.size();
+    out.resize(at + std::max(width, number.size()));
+    write_padded(out.data() + at, number.view(), width, fill);
+}
+} // namespace detail
+
+// Append `value` (see format_number) to `out`.
+template <typename CharT, typename T, typename Allocator>
+inline void append_number(tstring<CharT, Allocator>& out, T const value)
+{
+    detail::append_number(out, value);
+}
+
+#if defined(__cpp_lib_to_chars)
+// Append `value` in fixed notation with `precision` decimals to `out`.
+template <typename CharT, typename T, typename Allocator>
+inline void append_fixed(tstring<CharT, Allocator>& out, T const value,
+                         int const precision)
+{
+    auto const number = format_fixed(value, precision);
+    auto const at = out.size();
+    out.resize(at + number.size());
+    detail::widen_copy(out.data() + at, number.data(), number.size());
+}
+#endif
+
+// Append an integer right-aligned in at least `width` characters to `out`.
+template <typename CharT, typename T, typename Allocator>
+inline void append_padded(tstring<CharT, Allocator>& out, T const value,
+                          std::size_t const width,
+                          CharT const fill = CharT{'0'})
+{
+    detail::append_padded(out, value, width, fill);
+}
+
+// ----------
+// Joining
+// ----------
+
+namespace detail
+{
+template <typename T, typename CharT>
+inline constexpr bool is_string_like_v =
+    std::is_convertible_v<T const&, tstringview<CharT>>;
+
+template <typename CharT, typename Iter>
+[[nodiscard]] inline std::size_t joined_size(Iter begin, Iter const end,
+                                             std::size_t const separator)
+{
+    std::size_t size = 0;
+    std::size_t count = 0;
+    for (; begin != end; ++begin, ++count) {
+        size += tstringview<CharT>(*begin).size();
+    }
+    return count == 0 ? 0 : size + ((count - 1) * separator);
+}
+} // namespace detail
+
+// Total length of the string-like elements of [begin, end) joined with a
+// separator of `separator_size` characters: the size join_into() needs.
+template <typename CharT, typename Iter>
+[[nodiscard]] inline std::size_t joined_size(Iter const begin, Iter const end,
+                                             std::size_t const separator_size)
+{
+    return detail::joined_size<CharT>(begin, end, separator_size);
+}
+
+// Append the elements of [begin, end), separated by `separator`, to `out`.
+//  - String-like elements are measured first (forward iterators), so `out`
+//    grows once, and then copied in.
+//  - Numbers (other than bool and character types) are written with
+//    std::to_chars, without streams or locales.
+//  - Anything else is formatted with operator<< as before.
+template <typename CharT, typename Iter, typename Allocator>
+inline void join_into(tstring<CharT, Allocator>& out, Iter begin,
+                      Iter const end, tstringview<CharT> const separator)
+{
+    using value_type = std::remove_cv_t<
+        std::remove_reference_t<decltype(*std::declval<Iter&>())>>;
+    if constexpr (detail::is_string_like_v<value_type, CharT>) {
+        using category = typename std::iterator_traits<Iter>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+            // Size once, then copy straight into the buffer.
+            auto const at = out.size();
+            out.resize(at + detail::joined_size<CharT>(begin, end,
+                                                       separator.size()));
+            auto* dest = out.data() + at;
+            for (auto first = true; begin != end; ++begin, first = false) {
+                if (!first) {
+                    std::char_traits<CharT>::copy(dest, separator.data(),
+                                                  separator.size());
+                    dest += separator.size();
+                }
+                tstringview<CharT> const element(*begin);
+                std::char_traits<CharT>::copy(dest, element.data(),
+                                              element.size());
+                dest += element.size();
+            }
+        } else {
+            for (auto first = true; begin != end; ++begin, first = false) {
+                if (!first) {
+                    out.append(separator.data(), separator.size());
+                }
+                tstringview<CharT> const element(*begin);
+                out.append(element.data(), element.size());
+            }
+        }
+    } else if constexpr (detail::is_chars_number_v<value_type>) {
+        for (auto first = true; begin != end; ++begin, first = false) {
+            if (!first) {
+                out.append(separator.data(), separator.size());
+            }
+            append_number(out, *begin);
+        }
+    } else {
+        tstringstream<CharT> oss;
+        std::copy(begin, end,
+                  utils::iterators::make_ostream_joiner(oss, separator));
+        out += oss.str();
+    }
+}
+
+template <typename CharT, typename C, typename Allocator>
+inline void join_into(tstring<CharT, Allocator>& out, C const& c,
+                      tstringview<CharT> const separator)
+{
+    join_into(out, std::cbegin(c), std::cend(c), separator);
+}
+
+// Join string-like or numeric elements into a caller-provided buffer, without
+// allocating. Returns the number of characters written. Throws
+// std::out_of_range if `out` is too small (see joined_size()).
+template <typename CharT, typename C>
+inline std::size_t join_into(utils::span<CharT> const out, C const& c,
+                             tstringview<CharT> const separator)
+{
+    using value_type = std::remove_cv_t<
+        std::remove_reference_t<decltype(*std::cbegin(c))>>;
+    static_assert(detail::is_string_like_v<value_type, CharT> ||
+                      detail::is_chars_number_v<value_type>,
+                  "join_into(span): elements must be string-like or numeric");
+
+    std::size_t written = 0;
+    auto const put = [&](CharT const* const data, std::size_t const size) {
+        std::char_traits<CharT>::copy(out.data() + written, data, size);
+        written += size;
+    };
+    if constexpr (detail::is_string_like_v<value_type, CharT>) {
+        if (out.size() < detail::joined_size<CharT>(std::cbegin(c),
+                                                    std::cend(c),
+                                                    separator.size())) {
+            throw std::out_of_range("join_into: output buffer too small");
+        }
+        auto first = true;
+        for (auto const& element : c) {
+            if (!first) {
+                put(separator.data(), separator.size());
+            }
+            first = false;
+            tstringview<CharT> const view(element);
+            put(view.data(), view.size());
+        }
+    } else {
+        auto first = true;
+        for (auto const element : c) {
+            auto const number = format_number(element);
+            auto const needed = (first ? 0 : separator.size()) + number.size();
+            if (out.size() - written < needed) {
+                throw std::out_of_range("join_into: output buffer too small");
+            }
+            if (!first) {
+                put(separator.data(), separator.size());
+            }
+            first = false;
+            detail::widen_copy(out.data() + written, number.data(),
+                               number.size());
+            written += number.size();
+        }
+    }
+    return written;
+}
+
+// The overloads taking an allocator build the result with it.
+template <typename CharT, typename Iter, typename Allocator>
+[[nodiscard]] inline detail::string_for<CharT, Allocator>
+join(Iter begin, Iter end, CharT const* const separator,
+     Allocator const& alloc)
+{
+    detail::string_for<CharT, Allocator> out(
+        detail::rebind_alloc_t<Allocator, CharT>{alloc});
+    join_into(out, begin, end, tstringview<CharT>{separator});
+    return out;
+}
+
+template <typename CharT, typename Iter>
+[[nodiscard]] inline tstring<CharT> join(Iter begin, Iter end,
+                                         CharT const* const separator)
+{
+    return join(begin, end, separator, std::allocator<CharT>{});
+}
+
+template <typename CharT, typename C, typename Allocator>
+[[nodiscard]] inline detail::string_for<CharT, Allocator>
+join(C const& c, CharT const* const separator, Allocator const& alloc)
+{
+    return join(std::cbegin(c), std::cend(c), separator, alloc);
+}
+
+template <typename CharT, typename C>
+[[nodiscard]] inline tstring<CharT> join(C const& c,
+                                         CharT const* const separator)
+{
+    return join(std::cbegin(c), std::cend(c), separator);
+}
+
+// Single-character separator convenience overloads.
+template <typename CharT, typename C, typename Allocator>
+[[nodiscard]] inline detail::string_for<CharT, Allocator>
+join(C const& c, CharT const separator, Allocator const& alloc)
+{
+    detail::string_for<CharT, Allocator> out(
+        detail::rebind_alloc_t<Allocator, CharT>{alloc});
+    join_into(out, std::cbegin(c), std::cend(c),
+              tstringview<CharT>{&separator, 1});
+    return out;
+}
+
+template <typename CharT, typename C>
+[[nodiscard]] inline tstring<CharT> join(C const& c, CharT const separator)
+{
+    return join(c, separator, std::allocator<CharT>{});
+}
+
+// String separator convenience overload.
+template <typename CharT, typename C>
+[[nodiscard]] inline tstring<CharT> join(C const& c,
+                                         tstring<CharT> const& separator)
+{
+    tstring<CharT> out;
+    join_into(out, std::cbegin(c), std::cend(c),
+              tstringview<CharT>{separator});
+    return out;
+}
+
+namespace detail
+{
+// Locates the next delimiter from a character set. A single delimiter is kept
+// by value and found with traits::find (memchr for `char`). Larger sets use
+// find_first_of over the caller's `delimiters`, which must outlive the finder.
+template <typename CharT>
+class delimiter_set_finder
+{
+public:
+    explicit delimiter_set_finder(tstringview<CharT> const delimiters) noexcept
+        : delimiters_(delimiters)
+    {
+        if (delimiters.size() == 1) {
+            single_ = delimiters.front();
+            delimiters_ = {};
+        }
+    }
+
+    explicit delimiter_set_finder(CharT const delimiter) noexcept
+        : single_(delimiter)
+    {}
+
+    [[nodiscard]] std::size_t operator()(tstringview<CharT> const text,
+                                         std::size_t const pos) const noexcept
+    {
+        return single_ ? text.find(*single_, pos)
+                       : text.find_first_of(delimiters_, pos);
+    }
+
+    // Length of one delimiter match.
+    [[nodiscard]] static constexpr std::size_t size() noexcept { return 1; }
+
+private:
+    tstringview<CharT> delimiters_;
+    std::optional<CharT> single_;
+};
+
+// For `char`, larger sets are copied into a byte_set and go through the
+// vectorized scanner, so the finder never refers back to `delimiters`.
+template <>
+class delimiter_set_finder<char>
+{
+public:
+    explicit delimiter_set_finder(std::string_view const delimiters) noexcept
+        : set_(delimiters), count_(delimiters.size())
+    {
+        if (count_ == 1) {
+            single_ = delimiters.front();
+        }
+    }
+
+    explicit delimiter_set_finder(char const delimiter) noexcept
+        : count_(1), single_(delimiter)
+    {}
+
+    // Always scans with the class, whatever its size.
+    explicit delimiter_set_finder(simd::byte_set const& set) noexcept
+        : set_(set), count_(2)
+    {}
+
+    [[nodiscard]] std::size_t operator()(std::string_view const text,
+                                         std::size_t const pos) const noexcept
+    {
+        if (count_ < 2 || pos >= text.size()) {
+            return count_ == 0 ? std::string_view::npos
+                               : text.find(single_, pos);
+        }
+        auto const* const last = text.data() + text.size();
+        auto const* const hit =
+            simd::find_first_of(text.data() + pos, last, set_);
+        return hit == last ? std::string_view::npos
+                           : static_cast<std::size_t>(hit - text.data());
+    }
+
+    [[nodiscard]] static constexpr std::size_t size() noexcept { return 1; }
+
+private:
+    simd::byte_set set_;
+    std::size_t count_;
+    char single_{};
+};
+
+// Locates the next occurrence of a whole delimiter sequence. The caller's
+// `delimiter` must outlive the finder. An empty delimiter never matches.
+template <typename CharT>
+class delimiter_finder
+{
+public:
+    explicit delimiter_finder(tstringview<CharT> const delimiter) noexcept
+        : delimiter_(delimiter)
+    {}
+
+    [[nodiscard]] std::size_t operator()(tstringview<CharT> const text,
+                                         std::size_t const pos) const noexcept
+    {
+        if (delimiter_.empty()) {
+            return tstringview<CharT>::npos;
+        }
+        return find_substring(text, delimiter_, pos);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return delimiter_.size();
+    }
+
+private:
+    tstringview<CharT> delimiter_;
+};
+
+// delimiter_finder over a precompiled searcher, which must outlive it.
+template <typename CharT>
+class searcher_finder
+{
+public:
+    explicit searcher_finder(searcher<CharT> const& delimiter) noexcept
+        : delimiter_(&delimiter)
+    {}
+
+    [[nodiscard]] std::size_t operator()(tstringview<CharT> const text,
+                                         std::size_t const pos) const noexcept
+    {
+        return delimiter_->size() == 0 ? tstringview<CharT>::npos
+                                       : delimiter_->find(text, pos);
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return delimiter_->size();
+    }
+
+private:
+    searcher<CharT> const* delimiter_;
+};
+} // namespace detail
+
+// ----------
+// Splitting
+// ----------
+
+// Lazy forward range over the tokens of a split: each step finds the next
+// delimiter and yields a view into `text`, so nothing is allocated and
+// breaking out of the loop early skips the rest of the scan. Works in a plain
+// range-for and with anything taking begin()/end() (std algorithms,
+// utils::functional::foldl and the transducers built on it).
+//
+// The range refers to `text`, which must outlive it and its iterators. Create
+// one with split_lazy() or split_on_lazy().
+template <typename CharT, typename Finder>
+class split_range
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = tstringview<CharT>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type const*;
+        using reference = value_type const&;
+
+        iterator() = default;
+
+        [[nodiscard]] reference operator*() const noexcept { return token_; }
+        [[nodiscard]] pointer operator->() const noexcept { return &token_; }
+
+        iterator& operator++() noexcept
+        {
+            advance();
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            auto const previous = *this;
+            advance();
+            return previous;
+        }
+
+        [[nodiscard]] friend bool operator==(iterator const& lhs,
+                                             iterator const& rhs) noexcept
+        {
+            return lhs.next_ == rhs.next_;
+        }
+
+        [[nodiscard]] friend bool operator!=(iterator const& lhs,
+                                             iterator const& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        friend class split_range;
+
+        static constexpr std::size_t npos = tstringview<CharT>::npos;
+
+        explicit iterator(split_range const* range) noexcept
+            : range_(range), next_(0)
+        {
+            advance();
+        }
+
+        // next_ is where scanning resumes; text.size() + 1 once the tail token
+        // has been produced and npos at the end.
+        void advance() noexcept
+        {
+            auto const text = range_->text_;
+            while (next_ <= text.size()) {
+                auto const start = next_;
+                auto const pos = range_->finder_(text, start);
+                if (pos == npos) {
+                    next_ = text.size() + 1;
+                    if (start < text.size() || range_->keep_empty_) {
+                        token_ = text.substr(start);
+                        return;
+                    }
+                    break;
+                }
+
+                next_ = pos + range_->finder_.size();
+                if (pos > start || range_->keep_empty_) {
+                    token_ = text.substr(start, pos - start);
+                    return;
+                }
+            }
+            next_ = npos;
+        }
+
+        split_range const* range_{nullptr};
+        std::size_t next_{npos};
+        tstringview<CharT> token_;
+    };
+
+    split_range(tstringview<CharT> const text, Finder finder,
+                bool const keep_empty) noexcept
+        : text_(text), finder_(std::move(finder)), keep_empty_(keep_empty)
+    {}
+
+    [[nodiscard]] iterator begin() const noexcept { return iterator{this}; }
+    [[nodiscard]] iterator end() const noexcept { return iterator{}; }
+
+private:
+    tstringview<CharT> text_;
+    Finder finder_;
+    bool keep_empty_;
+};
+
+// Lazily split on a SET of single-character delimiters; same tokens, in the
+// same order, as split_view(). For non-`char` text with more than one
+// delimiter, `delimiters` must outlive the range too.
+template <typename CharT>
+[[nodiscard]] inline split_range<CharT, detail::delimiter_set_finder<CharT>>
+split_lazy(tstringview<CharT> const text, tstringview<CharT> const delimiters,
+           bool const keep_empty = false)
+{
+    return {text, detail::delimiter_set_finder<CharT>(delimiters), keep_empty};
+}
+
+// Single-character delimiter convenience overload.
+template <typename CharT>
+[[nodiscard]] inline split_range<CharT, detail::delimiter_set_finder<CharT>>
+split_lazy(tstringview<CharT> const text, CharT const delimiter,
+           bool const keep_empty = false)
+{
+    return {text, detail::delimiter_set_finder<CharT>(delimiter), keep_empty};
+}
+
+// Split on the characters of a precompiled class; the range keeps its own copy
+// of `delimiters`.
+[[nodiscard]] inline split_range<char, detail::delimiter_set_finder<char>>
+split_lazy(std::string_view const text, char_class const& delimiters,
+           bool const keep_empty = false)
+{
+    return {text, detail::delimiter_set_finder<char>(delimiters), keep_empty};
+}
+
+// Lazily split on a WHOLE delimiter; same tokens as split_on_view(). The
+// `delimiter` must outlive the range. An empty delimiter yields the whole
+// input as a single token.
+template <typename CharT>
+[[nodiscard]] inline split_range<CharT, detail::delimiter_finder<CharT>>
+split_on_lazy(tstringview<CharT> const text,
+              tstringview<CharT> const delimiter, bool const keep_empty = false)
+{
+    return {text, detail::delimiter_finder<CharT>(delimiter),
+            keep_empty || delimiter.empty()};
+}
+
+// split_on_lazy() with a precompiled delimiter (which may ignore case). The
+// searcher must outlive the range.
+template <typename CharT>
+[[nodiscard]] inline split_range<CharT, detail::searcher_finder<CharT>>
+split_on_lazy(tstringview<CharT> const text, searcher<CharT> const& delimiter,
+              bool const keep_empty = false)
+{
+    return {text, detail::searcher_finder<CharT>(delimiter),
+            keep_empty || delimiter.size() == 0};
+}
+
+namespace detail
+{
+// The tokens of a lazy split range, in a vector on `alloc`: as views, or as
+// strings that are allocated with it too.
+template <typename CharT, typename Range, typename Allocator>
+[[nodiscard]] inline views_for<CharT, Allocator>
+collect_views(Range const& range, Allocator const& alloc)
+{
+    views_for<CharT, Allocator> tokens(
+        rebind_alloc_t<Allocator, tstringview<CharT>>{alloc});
+    for (auto const token : range) {
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+template <typename CharT, typename Range, typename Allocator>
+[[nodiscard]] inline strings_for<CharT, Allocator>
+collect_strings(Range const& range, Allocator const& alloc)
+{
+    using string = string_for<CharT, Allocator>;
+    strings_for<CharT, Allocator> tokens(
+        rebind_alloc_t<Allocator, string>{alloc});
+    rebind_alloc_t<Allocator, CharT> const chars{alloc};
+    for (auto const token : range) {
+        tokens.push_back(string(token, chars));
+    }
+    return tokens;
+}
+} // namespace detail
+
+// Non-owning split on a SET of single-character delimiters: returns views into
+// `text`, which must outlive the result. Allocates only the token vector, not
+// the tokens themselves. With keep_empty == false (the default) empty tokens
+// between adjacent/leading/trailing delimiters are skipped; with keep_empty ==
+// true they are preserved (e.g. for CSV fields). The overloads taking an
+// allocator allocate the vector with it.
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline detail::views_for<CharT, Allocator>
+split_view(tstringview<CharT> const text, tstringview<CharT> const delimiters,
+           bool const keep_empty, Allocator const& alloc)
+{
+    return detail::collect_views<CharT>(
+        split_lazy<CharT>(text, delimiters, keep_empty), alloc);
+}
+
+template <typename CharT>
+[[nodiscard]] inline std::vector<tstringview<CharT>>
+split_view(tstringview<CharT> const text, tstringview<CharT> const delimiters,
+           bool const keep_empty = false)
+{
+    return split_view(text, delimiters, keep_empty, std::allocator<CharT>{});
+}
+
+// Single-character delimiter convenience overloads.
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline detail::views_for<CharT, Allocator>
+split_view(tstringview<CharT> const text, CharT const delimiter,
+           bool const keep_empty, Allocator const& alloc)
+{
+    return detail::collect_views<CharT>(
+        split_lazy<CharT>(text, delimiter, keep_empty), alloc);
+}
+
+template <typename CharT>
+[[nodiscard]] inline std::vector<tstringview<CharT>>
+split_view(tstringview<CharT> const text, CharT const delimiter,
+           bool const keep_empty = false)
+{
+    return split_view(text, delimiter, keep_empty, std::allocator<CharT>{});
+}
+
+// Split on the characters of a precompiled class.
+template <typename Allocator>
+[[nodiscard]] inline detail::views_for<char, Allocator>
+split_view(std::string_view const text, char_class const& delimiters,
+           bool const keep_empty, Allocator const& alloc)
+{
+    return detail::collect_views<char>(
+        split_lazy(text, delimiters, keep_empty), alloc);
+}
+
+[[nodiscard]] inline std::vector<std::string_view>
+split_view(std::string_view const text, char_class const& delimiters,
+           bool const keep_empty = false)
+{
+    return split_view(text, delimiters, keep_empty, std::allocator<char>{});
+}
+
+// Non-owning split on a WHOLE multi-character delimiter (the entire `delimiter`
+// sequence is matched), as opposed to split_view() which treats its argument as
+// a set of single-character delimiters. An empty delimiter yields the whole
+// input as a single token.
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline detail::views_for<CharT, Allocator>
+split_on_view(tstringview<CharT> const text, tstringview<CharT> const delimiter,
+              bool const keep_empty, Allocator const& alloc)
+{
+    return detail::collect_views<CharT>(
+        split_on_lazy<CharT>(text, delimiter, keep_empty), alloc);
+}
+
+template <typename CharT>
+[[nodiscard]] inline std::vector<tstringview<CharT>>
+split_on_view(tstringview<CharT> const text, tstringview<CharT> const delimiter,
+              bool const keep_empty = false)
+{
+    return split_on_view(text, delimiter, keep_empty,
+                         std::allocator<CharT>{});
+}
+
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline detail::views_for<CharT, Allocator>
+split_on_view(tstringview<CharT> const text, searcher<CharT> const& delimiter,
+              bool const keep_empty, Allocator const& alloc)
+{
+    return detail::collect_views<CharT>(
+        split_on_lazy<CharT>(text, delimiter, keep_empty), alloc);
+}
+
+template <typename CharT>
+[[nodiscard]] inline std::vector<tstringview<CharT>>
+split_on_view(tstringview<CharT> const text, searcher<CharT> const& delimiter,
+              bool const keep_empty = false)
+{
+    return split_on_view(text, delimiter, keep_empty,
+                         std::allocator<CharT>{});
+}
+
+// Owning splits: materialize the tokens of the lazy ranges into strings. With
+// an allocator, the vector and every token are allocated with it.
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline detail::strings_for<CharT, Allocator>
+split(tstringview<CharT> const text, CharT const delimiter,
+      bool const keep_empty, Allocator const& alloc)
+{
+    return detail::collect_strings<CharT>(
+        split_lazy<CharT>(text, delimiter, keep_empty), alloc);
+}
+
+template <typename CharT>
 [[nodiscard]] inline std::vector<tstring<CharT>>
 split(tstringview<CharT> const text, CharT const delimiter,
       bool const keep_empty = false)
 {
-    std::vector<tstring<CharT>> tokens;
-    for (auto const token : split_view<CharT>(text, delimiter, keep_empty)) {
-        tokens.emplace_back(token);
+    return split(text, delimiter, keep_empty, std::allocator<CharT>{});
+}
+
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline detail::strings_for<CharT, Allocator>
+split(tstringview<CharT> const text, tstringview<CharT> const delimiters,
+      bool const keep_empty, Allocator const& alloc)
+{
+    return detail::collect_strings<CharT>(
+        split_lazy<CharT>(text, delimiters, keep_empty), alloc);
+}
+
+template <typename CharT>
+[[nodiscard]] inline std::vector<tstring<CharT>>
+split(tstringview<CharT> const text, tstringview<CharT> const delimiters,
+      bool const keep_empty = false)
+{
+    return split(text, delimiters, keep_empty, std::allocator<CharT>{});
+}
+
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline detail::strings_for<CharT, Allocator>
+split_on(tstringview<CharT> const text, tstringview<CharT> const delimiter,
+         bool const keep_empty, Allocator const& alloc)
+{
+    return detail::collect_strings<CharT>(
+        split_on_lazy<CharT>(text, delimiter, keep_empty), alloc);
+}
+
+template <typename CharT>
+[[nodiscard]] inline std::vector<tstring<CharT>>
+split_on(tstringview<CharT> const text, tstringview<CharT> const delimiter,
+         bool const keep_empty = false)
+{
+    return split_on(text, delimiter, keep_empty, std::allocator<CharT>{});
+}
+
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline detail::strings_for<CharT, Allocator>
+split_on(tstringview<CharT> const text, searcher<CharT> const& delimiter,
+         bool const keep_empty, Allocator const& alloc)
+{
+    return detail::collect_strings<CharT>(
+        split_on_lazy<CharT>(text, delimiter, keep_empty), alloc);
+}
+
+template <typename CharT>
+[[nodiscard]] inline std::vector<tstring<CharT>>
+split_on(tstringview<CharT> const text, searcher<CharT> const& delimiter,
+         bool const keep_empty = false)
+{
+    return split_on(text, delimiter, keep_empty, std::allocator<CharT>{});
+}
+
+// ----------
+// Streaming splits
+// ----------
+
+// Splits input that arrives in successive chunks (e.g. 64 KiB socket or file
+// reads) and emits exactly the tokens split_view() / split_on_view() would
+// produce over the concatenated input.
+//
+// feed() calls `fn(token)` for every token completed by the chunk. Tokens that
+// lie inside the chunk are views into it; only a token (or whole delimiter)
+// straddling a chunk boundary is copied, into an internal carry buffer that is
+// reused across chunks. Views are valid only during the callback. finish()
+// emits the final token and resets the tokenizer for the next stream.
+//
+// Create one with make_stream_tokenizer() or make_stream_tokenizer_on().
+template <typename CharT, typename Finder>
+class stream_tokenizer
+{
+public:
+    stream_tokenizer(Finder finder, bool const keep_empty)
+        : finder_(std::move(finder)), keep_empty_(keep_empty)
+    {}
+
+    template <typename F>
+    void feed(tstringview<CharT> const chunk, F&& fn)
+    {
+        std::size_t start = 0;
+        if (!carry_.empty()) {
+            start = complete_carry(chunk, fn);
+            if (start == npos) {
+                return;
+            }
+        }
+
+        std::size_t pos = 0;
+        while ((pos = finder_(chunk, start)) != npos) {
+            emit(chunk.substr(start, pos - start), fn);
+            start = pos + finder_.size();
+        }
+        carry_.assign(chunk.data() + start, chunk.size() - start);
+    }
+
+    template <typename F>
+    void finish(F&& fn)
+    {
+        emit(tstringview<CharT>(carry_), fn);
+        carry_.clear();
+    }
+
+private:
+    static constexpr std::size_t npos = tstringview<CharT>::npos;
+
+    template <typename F>
+    void emit(tstringview<CharT> const token, F& fn)
+    {
+        if (!token.empty() || keep_empty_) {
+            fn(token);
+        }
+    }
+
+    // Finish the carried token with the head of `chunk`. Returns the offset in
+    // `chunk` where scanning resumes, or npos if the whole chunk was carried.
+    template <typename F>
+    std::size_t complete_carry(tstringview<CharT> const chunk, F& fn)
+    {
+        // The carry holds no whole delimiter, so only a delimiter starting in
+        // its last size() - 1 characters can end inside this chunk.
+        auto const reach = finder_.size() == 0 ? 0 : finder_.size() - 1;
+        auto const old_size = carry_.size();
+        carry_.append(chunk.data(), std::min(reach, chunk.size()));
+        auto const from = old_size - std::min(old_size, reach);
+        auto const straddle = finder_(tstringview<CharT>(carry_), from);
+        if (straddle != npos && straddle < old_size) {
+            carry_.resize(straddle);
+            emit(tstringview<CharT>(carry_), fn);
+            carry_.clear();
+            return straddle + finder_.size() - old_size;
+        }
+
+        carry_.resize(old_size);
+        auto const pos = finder_(chunk, 0);
+        if (pos == npos) {
+            carry_.append(chunk.data(), chunk.size());
+            return npos;
+        }
+        carry_.append(chunk.data(), pos);
+        emit(tstringview<CharT>(carry_), fn);
+        carry_.clear();
+        return pos + finder_.size();
+    }
+
+    Finder finder_;
+    bool keep_empty_;
+    tstring<CharT> carry_;
+};
+
+// Streaming split on a SET of single-character delimiters, matching
+// split_view(). For non-`char` text with more than one delimiter,
+// `delimiters` must outlive the tokenizer.
+template <typename CharT>
+[[nodiscard]] inline stream_tokenizer<CharT,
+                                      detail::delimiter_set_finder<CharT>>
+make_stream_tokenizer(tstringview<CharT> const delimiters,
+                      bool const keep_empty = false)
+{
+    return {detail::delimiter_set_finder<CharT>(delimiters), keep_empty};
+}
+
+// Single-character delimiter convenience overload.
+template <typename CharT>
+[[nodiscard]] inline stream_tokenizer<CharT,
+                                      detail::delimiter_set_finder<CharT>>
+make_stream_tokenizer(CharT const delimiter, bool const keep_empty = false)
+{
+    return {detail::delimiter_set_finder<CharT>(delimiter), keep_empty};
+}
+
+// Streaming split on a WHOLE delimiter, matching split_on_view(); delimiters
+// straddling a chunk boundary are recognized. `delimiter` must outlive the
+// tokenizer.
+template <typename CharT>
+[[nodiscard]] inline stream_tokenizer<CharT, detail::delimiter_finder<CharT>>
+make_stream_tokenizer_on(tstringview<CharT> const delimiter,
+                         bool const keep_empty = false)
+{
+    return {detail::delimiter_finder<CharT>(delimiter),
+            keep_empty || delimiter.empty()};
+}
+
+// ----------
+// Hex encoding
+// ----------
+
+namespace detail
+{
+inline constexpr char hex_digits_upper[] = "0123456789ABCDEF";
+inline constexpr char hex_digits_lower[] = "0123456789abcdef";
+
+// The two hex digits of every byte value, back to back (512 entries).
+[[nodiscard]] constexpr std::array<char, 512>
+make_hex_pairs(char const* const alphabet) noexcept
+{
+    std::array<char, 512> pairs{};
+    for (std::size_t b = 0; b < 256; ++b) {
+        pairs[2 * b] = alphabet[b >> 4U];
+        pairs[(2 * b) + 1] = alphabet[b & 0xFU];
+    }
+    return pairs;
+}
+
+inline constexpr auto hex_pairs_upper = make_hex_pairs(hex_digits_upper);
+inline constexpr auto hex_pairs_lower = make_hex_pairs(hex_digits_lower);
+
+// Encode `size` bytes into `out`, which has room for hex_size(size,
+// insert_spaces) characters. Plain `char` output without spaces goes through
+// the vector kernel first; the table handles the tail and everything else.
+template <typename CharT>
+inline void encode_hex(unsigned char const* const in, std::size_t const size,
+                       CharT* out, bool const use_uppercase,
+                       bool const insert_spaces) noexcept
+{
+    auto const* const pairs = use_uppercase ? hex_pairs_upper.data()
+                                            : hex_pairs_lower.data();
+    std::size_t i = 0;
+    if (insert_spaces) {
+        for (; i < size; ++i) {
+            if (i != 0) {
+                *out++ = CharT{' '};
+            }
+            *out++ = static_cast<CharT>(pairs[2 * in[i]]);
+            *out++ = static_cast<CharT>(pairs[(2 * in[i]) + 1]);
+        }
+        return;
+    }
+
+    if constexpr (std::is_same_v<CharT, char>) {
+        i = simd::encode_hex(in, size, out,
+                             use_uppercase ? hex_digits_upper
+                                           : hex_digits_lower);
+        out += 2 * i;
+    }
+    for (; i < size; ++i) {
+        *out++ = static_cast<CharT>(pairs[2 * in[i]]);
+        *out++ = static_cast<CharT>(pairs[(2 * in[i]) + 1]);
+    }
+}
+
+// Elements wider than a byte keep their full value, printed with at least two
+// digits, as the stream-based to_hex always did.
+template <typename CharT, typename Allocator>
+inline void append_wide_hex(tstring<CharT, Allocator>& out,
+                            unsigned long long value, bool const use_uppercase)
+{
+    auto const* const alphabet =
+        use_uppercase ? hex_digits_upper : hex_digits_lower;
+    CharT digits[2 * sizeof(value)];
+    std::size_t n = 0;
+    do {
+        digits[n++] = static_cast<CharT>(alphabet[value & 0xFU]);
+        value >>= 4U;
+    } while (value != 0);
+    if (n == 1) {
+        digits[n++] = CharT{'0'};
+    }
+    while (n != 0) {
+        out.push_back(digits[--n]);
+    }
+}
+
+// Contiguous containers of single-byte elements (strings, byte vectors,
+// arrays) can be encoded in bulk.
+template <typename C, typename = void>
+struct is_contiguous_bytes : std::false_type
+{};
+template <typename C>
+struct is_contiguous_bytes<
+    C, std::void_t<decltype(std::data(std::declval<C const&>())),
+                   decltype(std::size(std::declval<C const&>()))>>
+    : std::bool_constant<
+          sizeof(*std::data(std::declval<C const&>())) == 1 &&
+          (std::is_integral_v<std::remove_cv_t<std::remove_reference_t<
+               decltype(*std::data(std::declval<C const&>()))>>> ||
+           std::is_same_v<std::remove_cv_t<std::remove_reference_t<
+                              decltype(*std::data(std::declval<C const&>()))>>,
+                          std::byte>)>
+{};
+} // namespace detail
+
+// Number of characters the hex encoding of `size` bytes takes.
+[[nodiscard]] constexpr std::size_t
+hex_size(std::size_t const size, bool const insert_spaces = false) noexcept
+{
+    if (size == 0) {
+        return 0;
+    }
+    return insert_spaces ? (3 * size) - 1 : 2 * size;
+}
+
+// Hex-encode `bytes` into a caller-provided buffer, without allocating.
+// Returns the number of characters written. Throws std::out_of_range if `out`
+// is smaller than hex_size(bytes.size(), insert_spaces).
+template <typename CharT>
+inline std::size_t to_hex_into(utils::span<CharT> const out,
+                               utils::span<std::byte const> const bytes,
+                               bool const use_uppercase = true,
+                               bool const insert_spaces = false)
+{
+    auto const size = hex_size(bytes.size(), insert_spaces);
+    if (out.size() < size) {
+        throw std::out_of_range("to_hex_into: output buffer too small");
+    }
+    detail::encode_hex(reinterpret_cast<unsigned char const*>(bytes.data()),
+                       bytes.size(), out.data(), use_uppercase, insert_spaces);
+    return size;
+}
+
+// Replace the contents of `out` with the hex encoding of `bytes`. Reuses the
+// string's capacity, so a preallocated (or reused) string does not allocate.
+template <typename CharT, typename Allocator>
+inline void to_hex_into(tstring<CharT, Allocator>& out,
+                        utils::span<std::byte const> const bytes,
+                        bool const use_uppercase = true,
+                        bool const insert_spaces = false)
+{
+    out.resize(hex_size(bytes.size(), insert_spaces));
+    detail::encode_hex(reinterpret_cast<unsigned char const*>(bytes.data()),
+                       bytes.size(), out.data(), use_uppercase, insert_spaces);
+}
+
+// The overloads taking an allocator (after both options) build the result
+// with it.
+template <typename CharT, typename Iter, typename Allocator>
+[[nodiscard]] inline detail::string_for<CharT, Allocator>
+to_hex(Iter begin, Iter end, bool const use_uppercase,
+       bool const insert_spaces, Allocator const& alloc)
+{
+    using value_type = typename std::iterator_traits<Iter>::value_type;
+    detail::string_for<CharT, Allocator> out(
+        detail::rebind_alloc_t<Allocator, CharT>{alloc});
+    if constexpr (std::is_base_of_v<
+                      std::forward_iterator_tag,
+                      typename std::iterator_traits<Iter>::iterator_category>) {
+        out.reserve(hex_size(
+            static_cast<std::size_t>(std::distance(begin, end)),
+            insert_spaces));
+    }
+
+    auto const* const pairs = use_uppercase ? detail::hex_pairs_upper.data()
+                                            : detail::hex_pairs_lower.data();
+    for (auto current = begin; current != end; ++current) {
+        if (insert_spaces && current != begin) {
+            out.push_back(CharT{' '});
+        }
+        auto const value = detail::to_byte_value(*current);
+        if constexpr (sizeof(value_type) == 1) {
+            out.push_back(static_cast<CharT>(pairs[2 * value]));
+            out.push_back(static_cast<CharT>(pairs[(2 * value) + 1]));
+        } else {
+            detail::append_wide_hex(out, value, use_uppercase);
+        }
+    }
+    return out;
+}
+
+template <typename CharT, typename Iter>
+[[nodiscard]] inline tstring<CharT> to_hex(Iter begin, Iter end,
+                                           bool use_uppercase = true,
+                                           bool insert_spaces = false)
+{
+    return to_hex<CharT>(begin, end, use_uppercase, insert_spaces,
+                         std::allocator<CharT>{});
+}
+
+template <typename CharT, typename C, typename Allocator>
+[[nodiscard]] inline detail::string_for<CharT, Allocator>
+to_hex(C const& c, bool const use_uppercase, bool const insert_spaces,
+       Allocator const& alloc)
+{
+    if constexpr (detail::is_contiguous_bytes<C>::value) {
+        detail::string_for<CharT, Allocator> out(
+            detail::rebind_alloc_t<Allocator, CharT>{alloc});
+        auto const* const data =
+            reinterpret_cast<unsigned char const*>(std::data(c));
+        auto const size = static_cast<std::size_t>(std::size(c));
+        out.resize(hex_size(size, insert_spaces));
+        detail::encode_hex(data, size, out.data(), use_uppercase,
+                           insert_spaces);
+        return out;
+    } else {
+        return to_hex<CharT>(std::cbegin(c), std::cend(c), use_uppercase,
+                             insert_spaces, alloc);
+    }
+}
+
+template <typename CharT, typename C>
+[[nodiscard]] inline tstring<CharT>
+to_hex(C const& c, bool use_uppercase = true, bool insert_spaces = false)
+{
+    return to_hex<CharT>(c, use_uppercase, insert_spaces,
+                         std::allocator<CharT>{});
+}
+
+// ----------
+// Hex decoding
+// ----------
+
+enum class hex_status : std::uint8_t
+{
+    ok,
+    invalid_character,
+    buffer_too_small
+};
+
+struct hex_decode_result
+{
+    hex_status status{hex_status::ok};
+    // Bytes written to the output buffer.
+    std::size_t written{0};
+    // Index into the input of the first invalid character.
+    std::size_t error_offset{0};
+
+    [[nodiscard]] constexpr explicit operator bool() const noexcept
+    {
+        return status == hex_status::ok;
+    }
+};
+
+namespace detail
+{
+// Nibble value of every byte, 0xFF for characters that are not hex digits.
+[[nodiscard]] constexpr std::array<std::uint8_t, 256> make_hex_values() noexcept
+{
+    std::array<std::uint8_t, 256> values{};
+    for (auto& v : values) {
+        v = 0xFF;
+    }
+    for (std::uint8_t i = 0; i < 10; ++i) {
+        values['0' + i] = i;
+    }
+    for (std::uint8_t i = 0; i < 6; ++i) {
+        values['a' + i] = static_cast<std::uint8_t>(10 + i);
+        values['A' + i] = static_cast<std::uint8_t>(10 + i);
+    }
+    return values;
+}
+
+inline constexpr auto hex_values = make_hex_values();
+
+template <typename CharT>
+[[nodiscard]] constexpr std::uint8_t hex_value(CharT const ch) noexcept
+{
+    auto const code = static_cast<std::make_unsigned_t<CharT>>(ch);
+    return code < 256 ? hex_values[code] : std::uint8_t{0xFF};
+}
+} // namespace detail
+
+// Number of bytes a hex string of `size` characters decodes to.
+[[nodiscard]] constexpr std::size_t
+hex_decoded_size(std::size_t const size) noexcept
+{
+    return (size + 1) / 2;
+}
+
+// Decode a hexadecimal string into a caller-provided buffer, without throwing
+// or allocating. An odd-length input is read as if it had a leading '0'. On an
+// invalid character, reports its offset in `str`; `written` bytes before it
+// are already decoded. `out` must hold hex_decoded_size(str.size()) bytes,
+// otherwise nothing is written and buffer_too_small is returned.
+template <typename CharT>
+[[nodiscard]] inline hex_decode_result
+hex_to_bytes_into(utils::span<std::byte> const out,
+                  tstringview<CharT> const str) noexcept
+{
+    auto const size = str.size();
+    if (out.size() < hex_decoded_size(size)) {
+        return {hex_status::buffer_too_small, 0, 0};
+    }
+
+    auto* const dest = reinterpret_cast<unsigned char*>(out.data());
+    std::size_t i = 0;
+    std::size_t written = 0;
+    if (size % 2 != 0) {
+        auto const lo = detail::hex_value(str[0]);
+        if (lo > 0xF) {
+            return {hex_status::invalid_character, 0, 0};
+        }
+        dest[written++] = lo;
+        i = 1;
+    }
+
+    if constexpr (std::is_same_v<CharT, char>) {
+        auto const consumed =
+            simd::decode_hex(str.data() + i, size - i, dest + written);
+        i += consumed;
+        written += consumed / 2;
+    }
+
+    for (; i < size; i += 2) {
+        auto const hi = detail::hex_value(str[i]);
+        auto const lo = detail::hex_value(str[i + 1]);
+        if ((hi | lo) > 0xF) {
+            return {hex_status::invalid_character, written,
+                    hi > 0xF ? i : i + 1};
+        }
+        dest[written++] = static_cast<unsigned char>((hi << 4U) | lo);
+    }
+    return {hex_status::ok, written, 0};
+}
+
+// Converts a hexadecimal string to a byte vector. Throws std::invalid_argument
+// on a non-hex character; see hex_to_bytes_into() for the non-throwing form.
+template <typename CharT, typename Allocator>
+[[nodiscard]] detail::bytes_for<Allocator>
+hex_to_bytes(tstringview<CharT> const str, Allocator const& alloc)
+{
+    detail::bytes_for<Allocator> result(
+        hex_decoded_size(str.size()), std::byte{},
+        detail::rebind_alloc_t<Allocator, std::byte>{alloc});
+    if (!hex_to_bytes_into<CharT>({result.data(), result.size()}, str)) {
+        throw std::invalid_argument("Invalid hexadecimal character");
+    }
+    return result;
+}
+
+template <typename CharT>
+[[nodiscard]] std::vector<std::byte> hex_to_bytes(tstringview<CharT> const str)
+{
+    return hex_to_bytes<CharT>(str, std::allocator<std::byte>{});
+}
+
+// Kept for backwards compatibility.
+template <typename CharT>
+[[nodiscard]]
+std::vector<std::byte> to_bytes(tstringview<CharT> const str)
+{
+    return hex_to_bytes(str);
+}
+
+// ----------
+// Base64 / Base32
+// ----------
+
+// RFC 4648 Base64 (standard or URL-safe alphabet) and Base32. Encoding pads
+// the last group with '=' unless asked not to; decoding accepts padded and
+// unpadded input, rejects characters outside the alphabet (including
+// whitespace) and requires the unused bits of the last character to be zero,
+// so every byte string has exactly one encoding.
+
+enum class base64_alphabet : std::uint8_t
+{
+    standard, // A-Z a-z 0-9 + /
+    url       // A-Z a-z 0-9 - _
+};
+
+// Status of the Base64 and Base32 decoders.
+enum class codec_status : std::uint8_t
+{
+    ok,
+    invalid_character,
+    // The input ends in the middle of a byte, or its padding does not complete
+    // the last group.
+    invalid_length,
+    buffer_too_small
+};
+
+struct codec_result
+{
+    codec_status status{codec_status::ok};
+    // Bytes written to the output buffer.
+    std::size_t written{0};
+    // Index into the input of the first invalid character, or of the group or
+    // padding that makes the length invalid.
+    std::size_t error_offset{0};
+
+    [[nodiscard]] constexpr explicit operator bool() const noexcept
+    {
+        return status == codec_status::ok;
+    }
+};
+
+namespace detail
+{
+inline constexpr char base64_digits_standard[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+inline constexpr char base64_digits_url[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+inline constexpr char base32_digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ234567";
+
+// Value of every byte in `alphabet`, 0xFF for the others.
+template <std::size_t N>
+[[nodiscard]] constexpr std::array<std::uint8_t, 256>
+make_radix_values(char const (&alphabet)[N]) noexcept
+{
+    std::array<std::uint8_t, 256> values{};
+    for (auto& v : values) {
+        v = 0xFF;
+    }
+    for (std::size_t i = 0; i + 1 < N; ++i) {
+        values[static_cast<unsigned char>(alphabet[i])] =
+            static_cast<std::uint8_t>(i);
+    }
+    return values;
+}
+
+inline constexpr auto base64_values_standard =
+    make_radix_values(base64_digits_standard);
+inline constexpr auto base64_values_url = make_radix_values(base64_digits_url);
+inline constexpr auto base32_values = make_radix_values(base32_digits);
+
+[[nodiscard]] constexpr char const*
+base64_digits(base64_alphabet const alphabet) noexcept
+{
+    return alphabet == base64_alphabet::url ? base64_digits_url
+                                            : base64_digits_standard;
+}
+
+// Base64 (6 bits per character) and Base32 (5) share everything but their
+// group shape: `group_chars` characters encode `group_bytes` bytes.
+template <unsigned Bits>
+struct radix
+{
+    static_assert(Bits == 5 || Bits == 6);
+    static constexpr std::size_t group_chars = Bits == 6 ? 4 : 8;
+    static constexpr std::size_t group_bytes = Bits == 6 ? 3 : 5;
+    static constexpr std::uint64_t mask = (1U << Bits) - 1;
+};
+
+template <unsigned Bits>
+[[nodiscard]] constexpr std::size_t radix_size(std::size_t const size,
+                                               bool const padding) noexcept
+{
+    using r = radix<Bits>;
+    auto const groups = size / r::group_bytes;
+    auto const rest = size % r::group_bytes;
+    if (rest == 0) {
+        return groups * r::group_chars;
+    }
+    auto const tail = padding ? r::group_chars : ((rest * 8) + Bits - 1) / Bits;
+    return (groups * r::group_chars) + tail;
+}
+
+// The `sizeof...(K)` characters of `group`, most significant first, looked up
+// before any is stored: the stores may alias the alphabet.
+template <unsigned Bits, typename CharT, std::size_t... K>
+inline void put_radix_chars(CharT* const out, std::uint64_t const group,
+                            char const* const alphabet,
+                            std::index_sequence<K...> /*unused*/) noexcept
+{
+    constexpr auto n = sizeof...(K);
+    CharT const chars[] = {static_cast<CharT>(
+        alphabet[(group >> (Bits * (n - 1 - K))) & radix<Bits>::mask])...};
+    ((out[K] = chars[K]), ...);
+}
+
+// Encode `size` bytes into `out`, which has room for radix_size(). Plain
+// `char` output goes through the vector kernel first; whole groups are then
+// read with one big-endian load where 8 bytes are readable, and the last
+// partial group bit by bit.
+template <unsigned Bits, typename CharT, typename Kernels>
+inline void encode_radix(unsigned char const* const in, std::size_t const size,
+                         CharT* out, char const* const alphabet,
+                         bool const padding, Kernels const& kernels) noexcept
+{
+    using r = radix<Bits>;
+    std::size_t i = 0;
+    if constexpr (std::is_same_v<CharT, char>) {
+        i = kernels.encode(in, size, out);
+        out += i / r::group_bytes * r::group_chars;
+    }
+    for (; size - i >= r::group_bytes; i += r::group_bytes) {
+        std::uint64_t group = 0;
+        if (size - i >= 8) {
+            group = bytes::load_be<std::uint64_t>(
+                        reinterpret_cast<std::byte const*>(in + i)) >>
+                    (64 - (8 * r::group_bytes));
+        } else {
+            for (std::size_t k = 0; k < r::group_bytes; ++k) {
+                group = (group << 8U) | in[i + k];
+            }
+        }
+        put_radix_chars<Bits>(out, group, alphabet,
+                              std::make_index_sequence<r::group_chars>{});
+        out += r::group_chars;
+    }
+    if (i == size) {
+        return;
+    }
+    auto const rest = size - i;
+    std::uint64_t tail = 0;
+    for (std::size_t k = 0; k < rest; ++k) {
+        tail = (tail << 8U) | in[i + k];
+    }
+    auto const chars = ((rest * 8) + Bits - 1) / Bits;
+    tail <<= (chars * Bits) - (rest * 8);
+    for (std::size_t k = 0; k < chars; ++k) {
+        *out++ = static_cast<CharT>(
+            alphabet[(tail >> (Bits * (chars - 1 - k))) & r::mask]);
+    }
+    for (std::size_t k = chars; padding && k < r::group_chars; ++k) {
+        *out++ = CharT{'='};
+    }
+}
+
+template <typename CharT>
+[[nodiscard]] constexpr std::uint8_t
+radix_value(std::array<std::uint8_t, 256> const& values,
+            CharT const ch) noexcept
+{
+    auto const code = static_cast<std::make_unsigned_t<CharT>>(ch);
+    return code < 256 ? values[code] : std::uint8_t{0xFF};
+}
+
+// The values of the `sizeof...(K)` characters at `p` packed into one word,
+// first character most significant. `invalid` gets their OR, in which a bit
+// above the low `Bits` flags a character outside the alphabet.
+template <unsigned Bits, typename CharT, std::size_t... K>
+[[nodiscard]] inline std::uint64_t
+radix_group(CharT const* const p, std::array<std::uint8_t, 256> const& values,
+            unsigned& invalid, std::index_sequence<K...> /*unused*/) noexcept
+{
+    constexpr auto n = sizeof...(K);
+    std::uint8_t const v[] = {radix_value(values, p[K])...};
+    invalid = (v[K] | ...);
+    return ((std::uint64_t{v[K]} << (Bits * (n - 1 - K))) | ...);
+}
+
+// Decode `str` into `out` (see base64_to_bytes_into()). Plain `char` input
+// goes through the vector kernel first, which stops at the first block with
+// an invalid character; the scalar loops pin down its offset.
+template <unsigned Bits, typename CharT, typename Kernels>
+[[nodiscard]] inline codec_result
+decode_radix(utils::span<std::byte> const out, tstringview<CharT> const str,
+             std::array<std::uint8_t, 256> const& values,
+             Kernels const& kernels) noexcept
+{
+    using r = radix<Bits>;
+    // Up to group_chars - 2 '=' complete a group that holds at least one
+    // byte; when present, they must complete it exactly.
+    auto size = str.size();
+    std::size_t padding = 0;
+    while (padding < r::group_chars - 2 && padding < size &&
+           str[size - 1 - padding] == CharT{'='}) {
+        ++padding;
+    }
+    size -= padding;
+    auto const rest = size % r::group_chars;
+    if (padding != 0 && padding != r::group_chars - rest) {
+        return {codec_status::invalid_length, 0, size};
+    }
+    // A last group whose characters hold a whole unused character's worth of
+    // bits cannot come from any encoding.
+    if ((rest * Bits) % 8 >= Bits) {
+        return {codec_status::invalid_length, 0, size - rest};
+    }
+    auto const decoded =
+        (size / r::group_chars * r::group_bytes) + (rest * Bits / 8);
+    if (out.size() < decoded) {
+        return {codec_status::buffer_too_small, 0, 0};
+    }
+
+    auto* const dest = reinterpret_cast<unsigned char*>(out.data());
+    std::size_t i = 0;
+    std::size_t written = 0;
+    if constexpr (std::is_same_v<CharT, char>) {
+        i = kernels.decode(str.data(), size, dest);
+        written = i / r::group_chars * r::group_bytes;
+    }
+    for (; size - i >= r::group_chars; i += r::group_chars) {
+        unsigned invalid = 0;
+        auto const group =
+            radix_group<Bits>(str.data() + i, values, invalid,
+                              std::make_index_sequence<r::group_chars>{});
+        if ((invalid >> Bits) != 0) {
+            while ((radix_value(values, str[i]) >> Bits) == 0) {
+                ++i;
+            }
+            return {codec_status::invalid_character, written, i};
+        }
+        // One 8-byte store where the output has room past the group; the
+        // bytes beyond it are overwritten by the next one.
+        if (decoded - written >= 8) {
+            bytes::store_be(reinterpret_cast<std::byte*>(dest + written),
+                            group << (64 - (8 * r::group_bytes)));
+            written += r::group_bytes;
+        } else {
+            for (std::size_t k = 0; k < r::group_bytes; ++k) {
+                dest[written++] = static_cast<unsigned char>(
+                    group >> (8 * (r::group_bytes - 1 - k)));
+            }
+        }
+    }
+    std::uint64_t tail = 0;
+    unsigned bits = 0;
+    for (; i < size; ++i) {
+        auto const v = radix_value(values, str[i]);
+        if ((v >> Bits) != 0) {
+            return {codec_status::invalid_character, written, i};
+        }
+        tail = (tail << Bits) | v;
+        bits += Bits;
+        if (bits >= 8) {
+            bits -= 8;
+            dest[written++] = static_cast<unsigned char>(tail >> bits);
+        }
+    }
+    if ((tail & ((1U << bits) - 1)) != 0) {
+        return {codec_status::invalid_character, written, size - 1};
+    }
+    return {codec_status::ok, written, 0};
+}
+
+// The vector kernels of each codec, bound to its alphabet.
+struct base64_kernels
+{
+    char symbol62;
+    char symbol63;
+
+    explicit base64_kernels(base64_alphabet const alphabet) noexcept
+        : symbol62{base64_digits(alphabet)[62]},
+          symbol63{base64_digits(alphabet)[63]}
+    {
+    }
+
+    std::size_t encode(unsigned char const* const in, std::size_t const size,
+                       char* const out) const noexcept
+    {
+        return simd::encode_base64(in, size, out, symbol62, symbol63);
+    }
+
+    std::size_t decode(char const* const in, std::size_t const size,
+                       unsigned char* const out) const noexcept
+    {
+        return simd::decode_base64(in, size, out, symbol62, symbol63);
+    }
+};
+
+struct base32_kernels
+{
+    std::size_t encode(unsigned char const* const in, std::size_t const size,
+                       char* const out) const noexcept
+    {
+        return simd::encode_base32(in, size, out);
+    }
+
+    std::size_t decode(char const* const in, std::size_t const size,
+                       unsigned char* const out) const noexcept
+    {
+        return simd::decode_base32(in, size, out);
+    }
+};
+} // namespace detail
+
+// Number of characters the Base64 encoding of `size` bytes takes.
+[[nodiscard]] constexpr std::size_t
+base64_size(std::size_t const size, bool const padding = true) noexcept
+{
+    return detail::radix_size<6>(size, padding);
+}
+
+// Upper bound on the bytes a Base64 string of `size` characters decodes to
+// (exact for unpadded input).
+[[nodiscard]] constexpr std::size_t
+base64_decoded_size(std::size_t const size) noexcept
+{
+    return (size / 4 * 3) + (size % 4 * 3 / 4);
+}
+
+// Base64-encode `bytes` into a caller-provided buffer, without allocating.
+// Returns the number of characters written. Throws std::out_of_range if `out`
+// is smaller than base64_size(bytes.size(), padding).
+template <typename CharT>
+inline std::size_t
+to_base64_into(utils::span<CharT> const out,
+               utils::span<std::byte const> const bytes,
+               base64_alphabet const alphabet = base64_alphabet::standard,
+               bool const padding = true)
+{
+    auto const size = base64_size(bytes.size(), padding);
+    if (out.size() < size) {
+        throw std::out_of_range("to_base64_into: output buffer too small");
+    }
+    detail::encode_radix<6>(
+        reinterpret_cast<unsigned char const*>(bytes.data()), bytes.size(),
+        out.data(), detail::base64_digits(alphabet), padding,
+        detail::base64_kernels{alphabet});
+    return size;
+}
+
+// Replace the contents of `out` with the Base64 encoding of `bytes`, reusing
+// its capacity.
+template <typename CharT, typename Allocator>
+inline void
+to_base64_into(tstring<CharT, Allocator>& out,
+               utils::span<std::byte const> const bytes,
+               base64_alphabet const alphabet = base64_alphabet::standard,
+               bool const padding = true)
+{
+    out.resize(base64_size(bytes.size(), padding));
+    detail::encode_radix<6>(
+        reinterpret_cast<unsigned char const*>(bytes.data()), bytes.size(),
+        out.data(), detail::base64_digits(alphabet), padding,
+        detail::base64_kernels{alphabet});
+}
+
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline detail::string_for<CharT, Allocator>
+to_base64(utils::span<std::byte const> const bytes,
+          base64_alphabet const alphabet, bool const padding,
+          Allocator const& alloc)
+{
+    detail::string_for<CharT, Allocator> out(
+        detail::rebind_alloc_t<Allocator, CharT>{alloc});
+    to_base64_into(out, bytes, alphabet, padding);
+    return out;
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT>
+to_base64(utils::span<std::byte const> const bytes,
+          base64_alphabet const alphabet = base64_alphabet::standard,
+          bool const padding = true)
+{
+    return to_base64<CharT>(bytes, alphabet, padding, std::allocator<CharT>{});
+}
+
+// Decode a Base64 string into a caller-provided buffer, without throwing or
+// allocating. On an error, reports its offset in `str`; `written` bytes
+// before it are already decoded. `out` must hold the decoded bytes
+// (base64_decoded_size(str.size()) is always enough), otherwise nothing is
+// written and buffer_too_small is returned.
+template <typename CharT>
+[[nodiscard]] inline codec_result
+base64_to_bytes_into(utils::span<std::byte> const out,
+                     tstringview<CharT> const str,
+                     base64_alphabet const alphabet =
+                         base64_alphabet::standard) noexcept
+{
+    return detail::decode_radix<6>(out, str,
+                                   alphabet == base64_alphabet::url
+                                       ? detail::base64_values_url
+                                       : detail::base64_values_standard,
+                                   detail::base64_kernels{alphabet});
+}
+
+// Decode a Base64 string to a byte vector. Throws std::invalid_argument on
+// malformed input; see base64_to_bytes_into() for the non-throwing form.
+template <typename CharT, typename Allocator>
+[[nodiscard]] detail::bytes_for<Allocator>
+base64_to_bytes(tstringview<CharT> const str, base64_alphabet const alphabet,
+                Allocator const& alloc)
+{
+    detail::bytes_for<Allocator> result(
+        base64_decoded_size(str.size()), std::byte{},
+        detail::rebind_alloc_t<Allocator, std::byte>{alloc});
+    auto const decoded = base64_to_bytes_into<CharT>(
+        {result.data(), result.size()}, str, alphabet);
+    if (!decoded) {
+        throw std::invalid_argument("Invalid Base64 input");
+    }
+    result.resize(decoded.written);
+    return result;
+}
+
+template <typename CharT>
+[[nodiscard]] std::vector<std::byte>
+base64_to_bytes(tstringview<CharT> const str,
+                base64_alphabet const alphabet = base64_alphabet::standard)
+{
+    return base64_to_bytes<CharT>(str, alphabet, std::allocator<std::byte>{});
+}
+
+// Number of characters the Base32 encoding of `size` bytes takes.
+[[nodiscard]] constexpr std::size_t
+base32_size(std::size_t const size, bool const padding = true) noexcept
+{
+    return detail::radix_size<5>(size, padding);
+}
+
+// Upper bound on the bytes a Base32 string of `size` characters decodes to
+// (exact for unpadded input).
+[[nodiscard]] constexpr std::size_t
+base32_decoded_size(std::size_t const size) noexcept
+{
+    return (size / 8 * 5) + (size % 8 * 5 / 8);
+}
+
+// Base32 counterparts of the Base64 functions above, with the upper-case
+// RFC 4648 alphabet (A-Z 2-7).
+template <typename CharT>
+inline std::size_t to_base32_into(utils::span<CharT> const out,
+                                  utils::span<std::byte const> const bytes,
+                                  bool const padding = true)
+{
+    auto const size = base32_size(bytes.size(), padding);
+    if (out.size() < size) {
+        throw std::out_of_range("to_base32_into: output buffer too small");
+    }
+    detail::encode_radix<5>(
+        reinterpret_cast<unsigned char const*>(bytes.data()), bytes.size(),
+        out.data(), detail::base32_digits, padding, detail::base32_kernels{});
+    return size;
+}
+
+template <typename CharT, typename Allocator>
+inline void to_base32_into(tstring<CharT, Allocator>& out,
+                           utils::span<std::byte const> const bytes,
+                           bool const padding = true)
+{
+    out.resize(base32_size(bytes.size(), padding));
+    detail::encode_radix<5>(
+        reinterpret_cast<unsigned char const*>(bytes.data()), bytes.size(),
+        out.data(), detail::base32_digits, padding, detail::base32_kernels{});
+}
+
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline detail::string_for<CharT, Allocator>
+to_base32(utils::span<std::byte const> const bytes, bool const padding,
+          Allocator const& alloc)
+{
+    detail::string_for<CharT, Allocator> out(
+        detail::rebind_alloc_t<Allocator, CharT>{alloc});
+    to_base32_into(out, bytes, padding);
+    return out;
+}
+
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT>
+to_base32(utils::span<std::byte const> const bytes, bool const padding = true)
+{
+    return to_base32<CharT>(bytes, padding, std::allocator<CharT>{});
+}
+
+template <typename CharT>
+[[nodiscard]] inline codec_result
+base32_to_bytes_into(utils::span<std::byte> const out,
+                     tstringview<CharT> const str) noexcept
+{
+    return detail::decode_radix<5>(out, str, detail::base32_values,
+                                   detail::base32_kernels{});
+}
+
+template <typename CharT, typename Allocator>
+[[nodiscard]] detail::bytes_for<Allocator>
+base32_to_bytes(tstringview<CharT> const str, Allocator const& alloc)
+{
+    detail::bytes_for<Allocator> result(
+        base32_decoded_size(str.size()), std::byte{},
+        detail::rebind_alloc_t<Allocator, std::byte>{alloc});
+    auto const decoded =
+        base32_to_bytes_into<CharT>({result.data(), result.size()}, str);
+    if (!decoded) {
+        throw std::invalid_argument("Invalid Base32 input");
+    }
+    result.resize(decoded.written);
+    return result;
+}
+
+template <typename CharT>
+[[nodiscard]] std::vector<std::byte>
+base32_to_bytes(tstringview<CharT> const str)
+{
+    return base32_to_bytes<CharT>(str, std::allocator<std::byte>{});
+}
+
+// ----------
+// Unicode transcoding
+// ----------
+
+// Validation, counting and conversion between UTF-8 (char), UTF-16 (char16_t)
+// and UTF-32 (char32_t) text. The UTF-8 side is vectorized; the converters
+// write into caller-provided buffers, sized exactly with utf8_size(),
+// utf16_size() or utf32_size().
+
+enum class utf_status : std::uint8_t
+{
+    ok,
+    invalid_sequence,
+    buffer_too_small
+};
+
+struct utf_result
+{
+    utf_status status{utf_status::ok};
+    // Code units written to the output buffer.
+    std::size_t written{0};
+    // Index into the input of the first unit of the invalid sequence.
+    std::size_t error_offset{0};
+
+    [[nodiscard]] constexpr explicit operator bool() const noexcept
+    {
+        return status == utf_status::ok;
+    }
+};
+
+// Length of the longest well-formed prefix of `text` (its size when `text` is
+// valid). Overlong forms, surrogates, code points above U+10FFFF and truncated
+// sequences are malformed.
+[[nodiscard]] inline std::size_t
+utf8_valid_prefix(std::string_view const text) noexcept
+{
+    auto const* const first = text.data();
+    return static_cast<std::size_t>(
+        simd::validate_utf8(first, first + text.size()) - first);
+}
+
+// Unpaired surrogates are malformed.
+[[nodiscard]] inline std::size_t
+utf16_valid_prefix(std::u16string_view const text) noexcept
+{
+    auto const* const first = text.data();
+    return static_cast<std::size_t>(
+        simd::validate_utf16(first, first + text.size()) - first);
+}
+
+// Surrogates and values above U+10FFFF are malformed.
+[[nodiscard]] inline std::size_t
+utf32_valid_prefix(std::u32string_view const text) noexcept
+{
+    auto const* const first = text.data();
+    return static_cast<std::size_t>(
+        simd::validate_utf32(first, first + text.size()) - first);
+}
+
+[[nodiscard]] inline bool is_valid_utf8(std::string_view const text) noexcept
+{
+    return utf8_valid_prefix(text) == text.size();
+}
+
+[[nodiscard]] inline bool
+is_valid_utf16(std::u16string_view const text) noexcept
+{
+    return utf16_valid_prefix(text) == text.size();
+}
+
+[[nodiscard]] inline bool
+is_valid_utf32(std::u32string_view const text) noexcept
+{
+    return utf32_valid_prefix(text) == text.size();
+}
+
+// Number of code points in well-formed text. For malformed UTF-8 every byte
+// that is not a continuation byte counts as one.
+[[nodiscard]] inline std::size_t
+count_code_points(std::string_view const text) noexcept
+{
+    return simd::count_utf8(text.data(), text.data() + text.size());
+}
+
+[[nodiscard]] inline std::size_t
+count_code_points(std::u16string_view const text) noexcept
+{
+    std::size_t trailing = 0;
+    for (auto const unit : text) {
+        trailing += (unit & 0xFC00U) == 0xDC00U ? 1 : 0;
+    }
+    return text.size() - trailing;
+}
+
+// Exact converted sizes of well-formed text, in code units of the target.
+[[nodiscard]] inline std::size_t
+utf16_size(std::string_view const utf8) noexcept
+{
+    return simd::utf16_length(utf8.data(), utf8.data() + utf8.size());
+}
+
+[[nodiscard]] inline std::size_t
+utf32_size(std::string_view const utf8) noexcept
+{
+    return count_code_points(utf8);
+}
+
+// A surrogate pair takes four bytes, two for each of its units.
+[[nodiscard]] inline std::size_t
+utf8_size(std::u16string_view const utf16) noexcept
+{
+    // Bytes beyond the first, summed per block in 16 bits so that the
+    // vectorized sums stay in 16-bit lanes.
+    constexpr std::size_t block_size = 16;
+    auto const* const data = utf16.data();
+    auto const size = utf16.size();
+    std::size_t total = size;
+    std::size_t i = 0;
+    for (; size - i >= block_size; i += block_size) {
+        std::uint16_t block = 0;
+        for (std::size_t k = 0; k < block_size; ++k) {
+            std::uint16_t const unit = data[i + k];
+            block = static_cast<std::uint16_t>(
+                block + (unit >= 0x80U) + (unit >= 0x800U) -
+                ((unit & 0xF800U) == 0xD800U));
+        }
+        total += block;
+    }
+    for (; i < size; ++i) {
+        auto const unit = data[i];
+        total += (unit >= 0x80U ? 1 : 0) + (unit >= 0x800U ? 1 : 0);
+        total -= (unit & 0xF800U) == 0xD800U ? 1 : 0;
+    }
+    return total;
+}
+
+[[nodiscard]] inline std::size_t
+utf8_size(std::u32string_view const utf32) noexcept
+{
+    std::size_t size = 0;
+    for (auto const cp : utf32) {
+        size += cp < 0x80U ? 1 : cp < 0x800U ? 2 : cp < 0x10000U ? 3 : 4;
+    }
+    return size;
+}
+
+namespace detail
+{
+// Shared shape of the *_into converters: check that `out` can hold the
+// conversion (`max_ratio` units per input unit is always enough and avoids
+// the exact count), then convert up to the first malformed sequence.
+template <typename In, typename Out, typename Size, typename Convert>
+[[nodiscard]] inline utf_result
+transcode_into(utils::span<Out> const out, std::basic_string_view<In> const in,
+               std::size_t const max_ratio, Size size,
+               Convert convert) noexcept
+{
+    if (out.size() / max_ratio < in.size() && out.size() < size(in)) {
+        return {utf_status::buffer_too_small, 0, 0};
+    }
+    auto const converted = convert(in.data(), in.size(), out.data());
+    if (converted.read != in.size()) {
+        return {utf_status::invalid_sequence, converted.written,
+                converted.read};
+    }
+    return {utf_status::ok, converted.written, 0};
+}
+} // namespace detail
+
+// Convert `text` into a caller-provided buffer, without throwing or
+// allocating. `out` must hold utf16_size(text) (utf32_size(), utf8_size())
+// units, otherwise nothing is written and buffer_too_small is returned. On a
+// malformed sequence, reports its offset in `text`; the `written` units
+// before it are already converted.
+[[nodiscard]] inline utf_result
+utf8_to_utf16_into(utils::span<char16_t> const out,
+                   std::string_view const text) noexcept
+{
+    return detail::transcode_into(
+        out, text, 1,
+        [](std::string_view const in) { return utf16_size(in); },
+        simd::utf8_to_utf16);
+}
+
+[[nodiscard]] inline utf_result
+utf8_to_utf32_into(utils::span<char32_t> const out,
+                   std::string_view const text) noexcept
+{
+    return detail::transcode_into(
+        out, text, 1,
+        [](std::string_view const in) { return utf32_size(in); },
+        simd::utf8_to_utf32);
+}
+
+[[nodiscard]] inline utf_result
+utf16_to_utf8_into(utils::span<char> const out,
+                   std::u16string_view const text) noexcept
+{
+    return detail::transcode_into(
+        out, text, 3,
+        [](std::u16string_view const in) { return utf8_size(in); },
+        simd::utf16_to_utf8);
+}
+
+[[nodiscard]] inline utf_result
+utf32_to_utf8_into(utils::span<char> const out,
+                   std::u32string_view const text) noexcept
+{
+    return detail::transcode_into(
+        out, text, 4,
+        [](std::u32string_view const in) { return utf8_size(in); },
+        simd::utf32_to_utf8);
+}
+
+namespace detail
+{
+template <typename Out, typename In, typename Size, typename Into,
+          typename Allocator>
+[[nodiscard]] string_for<Out, Allocator>
+transcode(std::basic_string_view<In> in, Size size, Into into,
+          Allocator const& alloc)
+{
+    string_for<Out, Allocator> out(size(in), Out{},
+                                   rebind_alloc_t<Allocator, Out>{alloc});
+    auto const result = into(utils::span<Out>(out.data(), out.size()), in);
+    if (!result) {
+        throw std::invalid_argument("Invalid UTF sequence");
+    }
+    out.resize(result.written);
+    return out;
+}
+} // namespace detail
+
+// Allocating conversions. Throw std::invalid_argument on malformed input; see
+// the *_into() forms for the non-throwing versions.
+template <typename Allocator>
+[[nodiscard]] inline detail::string_for<char16_t, Allocator>
+utf8_to_utf16(std::string_view const text, Allocator const& alloc)
+{
+    return detail::transcode<char16_t>(
+        text, [](std::string_view const in) { return utf16_size(in); },
+        utf8_to_utf16_into, alloc);
+}
+
+[[nodiscard]] inline std::u16string utf8_to_utf16(std::string_view const text)
+{
+    return utf8_to_utf16(text, std::allocator<char16_t>{});
+}
+
+template <typename Allocator>
+[[nodiscard]] inline detail::string_for<char32_t, Allocator>
+utf8_to_utf32(std::string_view const text, Allocator const& alloc)
+{
+    return detail::transcode<char32_t>(
+        text, [](std::string_view const in) { return utf32_size(in); },
+        utf8_to_utf32_into, alloc);
+}
+
+[[nodiscard]] inline std::u32string utf8_to_utf32(std::string_view const text)
+{
+    return utf8_to_utf32(text, std::allocator<char32_t>{});
+}
+
+template <typename Allocator>
+[[nodiscard]] inline detail::string_for<char, Allocator>
+utf16_to_utf8(std::u16string_view const text, Allocator const& alloc)
+{
+    return detail::transcode<char>(
+        text, [](std::u16string_view const in) { return utf8_size(in); },
+        utf16_to_utf8_into, alloc);
+}
+
+[[nodiscard]] inline std::string utf16_to_utf8(std::u16string_view const text)
+{
+    return utf16_to_utf8(text, std::allocator<char>{});
+}
+
+template <typename Allocator>
+[[nodiscard]] inline detail::string_for<char, Allocator>
+utf32_to_utf8(std::u32string_view const text, Allocator const& alloc)
+{
+    return detail::transcode<char>(
+        text, [](std::u32string_view const in) { return utf8_size(in); },
+        utf32_to_utf8_into, alloc);
+}
+
+[[nodiscard]] inline std::string utf32_to_utf8(std::u32string_view const text)
+{
+    return utf32_to_utf8(text, std::allocator<char>{});
+}
+
+// ----------
+// Number parsing
+// ----------
+
+enum class parse_status : std::uint8_t
+{
+    ok,
+    // The field has no characters.
+    empty,
+    // Not a number, or a number followed by other characters.
+    invalid_character,
+    // A number that does not fit the target type.
+    out_of_range
+};
+
+// Outcome of parsing many fields: how many were produced, how many failed and
+// the index of the first failure.
+struct parse_batch_result
+{
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    std::size_t fields{0};
+    std::size_t errors{0};
+    std::size_t first_error{npos};
+
+    [[nodiscard]] constexpr explicit operator bool() const noexcept
+    {
+        return errors == 0;
+    }
+};
+
+namespace detail
+{
+template <typename T>
+inline constexpr bool is_parsable_integer_v =
+    std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+struct parse_decimal_result
+{
+    char const* ptr;
+    parse_status status;
+};
+
+[[nodiscard]] constexpr bool is_decimal_digit(char const ch) noexcept
+{
+    return static_cast<unsigned char>(ch - '0') < 10;
+}
+
+// Store a parsed magnitude as T, unless it does not fit.
+template <typename T>
+[[nodiscard]] inline bool store_magnitude(std::uint64_t const magnitude,
+                                          bool const negative,
+                                          T& value) noexcept
+{
+    auto const max = static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+    if (magnitude > (negative ? max + 1 : max)) {
+        return false;
     }
-    return tokens;
+    if (negative && magnitude != 0) {
+        // -(magnitude - 1) - 1 also covers the minimum, whose magnitude has
+        // no positive counterpart.
+        value =
+            static_cast<T>(-static_cast<std::int64_t>(magnitude - 1) - 1);
+    } else {
+        value = static_cast<T>(magnitude);
+    }
+    return true;
 }
 
-template <typename CharT>
-[[nodiscard]] inline std::vector<tstring<CharT>>
-split(tstringview<CharT> const text, tstringview<CharT> const delimiters,
-      bool const keep_empty = false)
+// Parse the base-10 integer at the start of [first, last) in the format
+// std::from_chars accepts ('-' only for signed types, no '+', no leading
+// whitespace), eight digits at a time. On success sets `value` and points past
+// the number; out_of_range points past the whole digit run; an input that
+// does not start with a number reports invalid_character (empty if there is
+// no input at all) and points at `first`. `value` is only written on success.
+template <typename T>
+[[nodiscard]] inline parse_decimal_result
+parse_decimal(char const* const first, char const* const last,
+              T& value) noexcept
 {
-    std::vector<tstring<CharT>> tokens;
-    for (auto const token : split_view<CharT>(text, delimiters, keep_empty)) {
-        tokens.emplace_back(token);
+    if (first == last) {
+        return {first, parse_status::empty};
     }
-    return tokens;
+
+    auto const* p = first;
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) {
+        if (*p == '-') {
+            negative = true;
+            ++p;
+        }
+    }
+
+    std::uint64_t magnitude = 0;
+    auto const* const digits = p;
+    p = simd::parse_digits(p, last, magnitude);
+    if (p == digits) {
+        return {first, parse_status::invalid_character};
+    }
+
+    // Longer runs (leading zeros, or plain overflow) finish one digit at a
+    // time, consuming every digit as from_chars does.
+    bool overflow = false;
+    for (; p != last && is_decimal_digit(*p); ++p) {
+        auto const digit = static_cast<std::uint64_t>(*p - '0');
+        if (overflow ||
+            magnitude > (std::numeric_limits<std::uint64_t>::max() - digit) /
+                            10) {
+            overflow = true;
+        } else {
+            magnitude = (magnitude * 10) + digit;
+        }
+    }
+
+    if (overflow || !store_magnitude(magnitude, negative, value)) {
+        return {p, parse_status::out_of_range};
+    }
+    return {p, parse_status::ok};
 }
 
-template <typename CharT>
-[[nodiscard]] inline std::vector<tstring<CharT>>
-split_on(tstringview<CharT> const text, tstringview<CharT> const delimiter,
-         bool const keep_empty = false)
+// Fast path for a whole field that is nothing but a base-10 integer: the
+// length is known, so the digits are parsed without looking for where they
+// end. Returns false, leaving `value` alone, for anything else (including
+// numbers that would need the slow path to tell why they fail).
+template <typename T>
+[[nodiscard]] inline bool parse_decimal_exact(char const* first,
+                                              char const* const last,
+                                              T& value) noexcept
 {
-    std::vector<tstring<CharT>> tokens;
-    for (auto const token : split_on_view<CharT>(text, delimiter, keep_empty)) {
-        tokens.emplace_back(token);
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) {
+        if (first != last && *first == '-') {
+            negative = true;
+            ++first;
+        }
     }
-    return tokens;
+    std::uint64_t magnitude = 0;
+    return simd::parse_digits_exact(
+               first, static_cast<std::size_t>(last - first), magnitude) &&
+           store_magnitude(magnitude, negative, value);
 }
 
-template <typename CharT, typename Iter>
-[[nodiscard]] inline tstring<CharT> to_hex(Iter begin, Iter end,
-                                           bool use_uppercase = true,
-                                           bool insert_spaces = false)
+// parse_decimal() over a whole field: trailing characters are an error.
+// Failed fields are stored as T{}.
+template <typename T>
+[[nodiscard]] inline parse_status parse_field(std::string_view const field,
+                                              T& value) noexcept
 {
-    tstringstream<CharT> oss;
-    if (use_uppercase) {
-        oss.setf(std::ios_base::uppercase);
+    auto const* const last = field.data() + field.size();
+    if (parse_decimal_exact(field.data(), last, value)) {
+        return parse_status::ok;
     }
 
-    for (auto current = begin; current != end; ++current) {
-        oss << std::hex << std::setw(2) << std::setfill('0')
-            << detail::to_byte_value(*current);
-        if (insert_spaces && std::next(current) != end) {
-            oss << ' ';
-        }
+    // Otherwise find out what is wrong with it.
+    auto const [ptr, status] = parse_decimal(field.data(), last, value);
+    if (status == parse_status::ok && ptr == last) {
+        return status;
     }
-
-    return oss.str();
+    value = T{};
+    return status == parse_status::ok ? parse_status::invalid_character
+                                      : status;
 }
 
-template <typename CharT, typename C>
-[[nodiscard]] inline tstring<CharT>
-to_hex(C const& c, bool use_uppercase = true, bool insert_spaces = false)
+template <typename T>
+[[nodiscard]] inline parse_batch_result
+parse_integers(utils::span<std::string_view const> const fields,
+               utils::span<T> const out, parse_status* const status)
 {
-    return to_hex<CharT>(std::cbegin(c), std::cend(c), use_uppercase,
-                         insert_spaces);
+    static_assert(is_parsable_integer_v<T>, "T must be an integral type");
+    if (out.size() < fields.size()) {
+        throw std::out_of_range("parse_integers: output buffer too small");
+    }
+    parse_batch_result result;
+    result.fields = fields.size();
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        auto const field_status = parse_field(fields[i], out[i]);
+        if (status != nullptr) {
+            status[i] = field_status;
+        }
+        if (field_status != parse_status::ok && result.errors++ == 0) {
+            result.first_error = i;
+        }
+    }
+    return result;
 }
 
-// Converts a hexadecimal string to a byte vector.
-template <typename CharT>
-[[nodiscard]] std::vector<std::byte> hex_to_bytes(tstringview<CharT> const str)
+// One pass over `text`: parse at the start of each field, then expect a
+// delimiter (or the end) right after the number. Only fields that fail go
+// back to the vectorized delimiter scan to find where they end.
+template <typename T>
+[[nodiscard]] inline parse_batch_result
+split_and_parse(std::string_view const text,
+                std::string_view const delimiters, std::vector<T>& out,
+                std::vector<parse_status>* const status, bool const keep_empty)
 {
-    auto const hexchar_to_int = [](CharT const ch) {
-        if (ch >= '0' && ch <= '9') {
-            return ch - '0';
+    static_assert(is_parsable_integer_v<T>, "T must be an integral type");
+    simd::byte_set const set(delimiters);
+    auto const* p = text.data();
+    auto const* const last = p + text.size();
+    parse_batch_result result;
+    for (;;) {
+        auto const* const start = p;
+        T value{};
+        auto [end, field_status] = parse_decimal(start, last, value);
+        if (end != last && !set.contains(static_cast<unsigned char>(*end))) {
+            end = simd::find_first_of(end, last, set);
+            if (field_status == parse_status::ok) {
+                field_status = parse_status::invalid_character;
+            }
         }
-        if (ch >= 'A' && ch <= 'F') {
-            return ch - 'A' + 10;
+        if (end == start) {
+            field_status = parse_status::empty;
         }
-        if (ch >= 'a' && ch <= 'f') {
-            return ch - 'a' + 10;
+
+        if (end != start || keep_empty) {
+            if (field_status != parse_status::ok) {
+                value = T{};
+                if (result.errors++ == 0) {
+                    result.first_error = result.fields;
+                }
+            }
+            out.push_back(value);
+            if (status != nullptr) {
+                status->push_back(field_status);
+            }
+            ++result.fields;
         }
 
-        throw std::invalid_argument("Invalid hexadecimal character");
-    };
+        if (end == last) {
+            return result;
+        }
+        p = end + 1;
+    }
+}
+} // namespace detail
 
-    std::vector<std::byte> result;
-    auto const size{str.size()};
+// Parse each of `fields` as a base-10 integer, in the format to_integral()
+// accepts, into the matching element of `out`. Never throws on bad input: a
+// field that fails is stored as T{} and counted in the result. Throws
+// std::out_of_range if `out` is shorter than `fields`.
+template <typename T>
+[[nodiscard]] inline parse_batch_result
+parse_integers(utils::span<std::string_view const> const fields,
+               utils::span<T> const out)
+{
+    return detail::parse_integers(fields, out, nullptr);
+}
 
-    std::size_t i{0};
-    if (size % 2 != 0) {
-        result.push_back(static_cast<std::byte>((hexchar_to_int('0') << 4) |
-                                                hexchar_to_int(str[i])));
-        ++i;
+// parse_integers() that also records each field's outcome in `status`, which
+// must be at least as long as `fields` (std::out_of_range otherwise).
+template <typename T>
+[[nodiscard]] inline parse_batch_result
+parse_integers(utils::span<std::string_view const> const fields,
+               utils::span<T> const out, utils::span<parse_status> const status)
+{
+    if (status.size() < fields.size()) {
+        throw std::out_of_range("parse_integers: status buffer too small");
     }
+    return detail::parse_integers(fields, out, status.data());
+}
 
-    for (; i < size; i += 2) {
-        result.push_back(static_cast<std::byte>((hexchar_to_int(str[i]) << 4) |
-                                                hexchar_to_int(str[i + 1])));
+// Split `text` on a SET of single-character delimiters and parse every field
+// as a base-10 integer in the same pass, appending the values to `out`. The
+// fields are exactly those split_view(text, delimiters, keep_empty) returns;
+// fields that fail (including empty ones kept with keep_empty) are appended
+// as T{} and counted in the result.
+template <typename T>
+[[nodiscard]] inline parse_batch_result
+split_and_parse(std::string_view const text,
+                std::string_view const delimiters, std::vector<T>& out,
+                bool const keep_empty = false)
+{
+    return detail::split_and_parse(text, delimiters, out, nullptr,
+                                   keep_empty);
+}
+
+// split_and_parse() that also appends each field's outcome to `status`.
+template <typename T>
+[[nodiscard]] inline parse_batch_result
+split_and_parse(std::string_view const text,
+                std::string_view const delimiters, std::vector<T>& out,
+                std::vector<parse_status>& status,
+                bool const keep_empty = false)
+{
+    return detail::split_and_parse(text, delimiters, out, &status,
+                                   keep_empty);
+}
+
+// Single-character delimiter convenience overloads.
+template <typename T>
+[[nodiscard]] inline parse_batch_result
+split_and_parse(std::string_view const text, char const delimiter,
+                std::vector<T>& out, bool const keep_empty = false)
+{
+    return detail::split_and_parse(text, std::string_view{&delimiter, 1}, out,
+                                   nullptr, keep_empty);
+}
+
+template <typename T>
+[[nodiscard]] inline parse_batch_result
+split_and_parse(std::string_view const text, char const delimiter,
+                std::vector<T>& out, std::vector<parse_status>& status,
+                bool const keep_empty = false)
+{
+    return detail::split_and_parse(text, std::string_view{&delimiter, 1}, out,
+                                   &status, keep_empty);
+}
+
+// Expected-like outcome of parsing one number: the value, or why there is none
+// and where parsing stopped.
+template <typename T>
+struct parse_result
+{
+    T value{};
+    parse_status status{parse_status::ok};
+    // Offset into the input where parsing stopped: one past the number on
+    // success (and for out_of_range); otherwise where a number was expected
+    // or the first character after it.
+    std::size_t offset{0};
+
+    [[nodiscard]] constexpr bool has_value() const noexcept
+    {
+        return status == parse_status::ok;
+    }
+
+    [[nodiscard]] constexpr explicit operator bool() const noexcept
+    {
+        return has_value();
+    }
+
+    [[nodiscard]] constexpr T const& operator*() const noexcept
+    {
+        return value;
+    }
+
+    [[nodiscard]] constexpr T value_or(T const fallback) const noexcept
+    {
+        return has_value() ? value : fallback;
+    }
+
+    [[nodiscard]] constexpr parse_status error() const noexcept
+    {
+        return status;
+    }
+};
+
+// How much of the input try_to_integral() / try_to_floating() may skip or
+// leave unconsumed. The defaults accept exactly one number and nothing else.
+struct parse_options
+{
+    // Skip leading whitespace before the number.
+    bool skip_whitespace{false};
+    // Accept a number followed by other characters; the result's offset says
+    // where it ended.
+    bool partial{false};
+};
+
+namespace detail
+{
+// Translate a std::from_chars outcome.
+[[nodiscard]] constexpr parse_status from_errc(std::errc const ec) noexcept
+{
+    if (ec == std::errc{}) {
+        return parse_status::ok;
+    }
+    return ec == std::errc::result_out_of_range
+               ? parse_status::out_of_range
+               : parse_status::invalid_character;
+}
+
+template <typename T, typename Parse>
+[[nodiscard]] inline parse_result<T> parse_number(std::string_view const text,
+                                                  parse_options const options,
+                                                  Parse parse) noexcept
+{
+    auto const* const first = text.data();
+    auto const* const last = first + text.size();
+    auto const* p = first;
+    if (options.skip_whitespace) {
+        while (p != last && is_whitespace(*p)) {
+            ++p;
+        }
     }
 
+    parse_result<T> result;
+    if (p == last) {
+        result.status = parse_status::empty;
+    } else {
+        auto const [stop, status] = parse(p, last, result.value);
+        result.status = status;
+        p = stop;
+        if (status == parse_status::ok && p != last && !options.partial) {
+            result.status = parse_status::invalid_character;
+        }
+    }
+    if (result.status != parse_status::ok) {
+        result.value = T{};
+    }
+    result.offset = static_cast<std::size_t>(p - first);
     return result;
 }
+} // namespace detail
 
-// Kept for backwards compatibility.
-template <typename CharT>
-[[nodiscard]]
-std::vector<std::byte> to_bytes(tstringview<CharT> const str)
+// Converts a string to an integral type without throwing on bad input. `base`
+// is 2..36 (std::invalid_argument otherwise); base 10 uses the SWAR parser.
+// The accepted syntax is std::from_chars': an optional '-' for signed types,
+// then digits, with no '+' or "0x" prefix.
+template <typename T, typename StringLike>
+[[nodiscard]] parse_result<T>
+try_to_integral(StringLike&& str, int const base = 10,
+                parse_options const options = {})
 {
-    return hex_to_bytes(str);
+    static_assert(detail::is_parsable_integer_v<T>,
+                  "T must be an integral type");
+    if (base < 2 || base > 36) {
+        throw std::invalid_argument("try_to_integral: base must be 2..36");
+    }
+    return detail::parse_number<T>(
+        std::string_view(str), options,
+        [base, partial = options.partial](char const* const first,
+                                          char const* const last, T& value) {
+            if (base != 10) {
+                auto const [ptr, ec] =
+                    std::from_chars(first, last, value, base);
+                return detail::parse_decimal_result{ptr,
+                                                    detail::from_errc(ec)};
+            }
+            if (!partial && detail::parse_decimal_exact(first, last, value)) {
+                return detail::parse_decimal_result{last, parse_status::ok};
+            }
+            return detail::parse_decimal(first, last, value);
+        });
 }
 
-// Converts a string to an integral type using std::from_chars.
-// Throws std::invalid_argument on failure.
+// Converts a string to an integral type. Throws std::invalid_argument on
+// failure; see try_to_integral() for the non-throwing form.
 template <typename T, typename StringLike>
 [[nodiscard]] T to_integral(StringLike&& str)
 {
-    static_assert(std::is_integral_v<T>, "T must be an integral type");
-    T value{};
-    auto const sv = std::string_view(str);
-    auto const [ptr, ec] =
-        std::from_chars(sv.data(), sv.data() + sv.size(), value);
-    // Reject both parse errors and trailing garbage ("123abc" must not yield
-    // 123): require that the whole input was consumed.
-    if (ec != std::errc{} || ptr != sv.data() + sv.size()) {
+    auto const result = try_to_integral<T>(std::forward<StringLike>(str));
+    if (!result) {
         throw std::invalid_argument("to_integral: conversion failed");
     }
-    return value;
+    return result.value;
 }
 
-// Converts a string to a floating-point type using std::from_chars.
-// Throws std::invalid_argument on failure. Only available when the standard
-// library provides floating-point from_chars (libstdc++ >= 11, recent libc++);
+// Floating-point parsing is only available when the standard library provides
+// floating-point from_chars (libstdc++ >= 11, recent libc++);
 // __cpp_lib_to_chars is defined exactly when that support is complete.
 #if defined(__cpp_lib_to_chars)
+// Converts a string to a floating-point type without throwing on bad input,
+// in std::from_chars' general format (no '+', "inf" and "nan" accepted).
 template <typename T, typename StringLike>
-[[nodiscard]] T to_floating(StringLike&& str)
+[[nodiscard]] parse_result<T> try_to_floating(StringLike&& str,
+                                              parse_options const options = {})
 {
     static_assert(std::is_floating_point_v<T>,
                   "T must be a floating-point type");
-    T value{};
-    auto const sv = std::string_view(str);
-    auto const [ptr, ec] =
-        std::from_chars(sv.data(), sv.data() + sv.size(), value);
-    if (ec != std::errc{} || ptr != sv.data() + sv.size()) {
+    return detail::parse_number<T>(
+        std::string_view(str), options,
+        [](char const* const first, char const* const last, T& value) {
+            auto const [ptr, ec] = std::from_chars(first, last, value);
+            return detail::parse_decimal_result{ptr, detail::from_errc(ec)};
+        });
+}
+
+// Converts a string to a floating-point type. Throws std::invalid_argument on
+// failure; see try_to_floating() for the non-throwing form.
+template <typename T, typename StringLike>
+[[nodiscard]] T to_floating(StringLike&& str)
+{
+    auto const result = try_to_floating<T>(std::forward<StringLike>(str));
+    if (!result) {
         throw std::invalid_argument("to_floating: conversion failed");
     }
-    return value;
+    return result.value;
 }
 #endif
 
@@ -609,43 +4742,88 @@ template <typename T, typename StringLike>
 
 // Left-pad `text` with `fill` up to `width`. Shorter-than-width only; longer
 // strings are returned unchanged.
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+pad_left(tstring<CharT, Allocator> text, std::size_t const width,
+         CharT const fill = CharT{' '})
+{
+    if (text.size() < width) {
+        text.insert(text.begin(), width - text.size(), fill);
+    }
+    return text;
+}
+
 template <typename CharT>
 [[nodiscard]] inline tstring<CharT> pad_left(tstring<CharT> text,
                                              std::size_t const width,
                                              CharT const fill = CharT{' '})
+{
+    return pad_left<CharT, std::allocator<CharT>>(std::move(text), width,
+                                                  fill);
+}
+
+// Right-pad `text` with `fill` up to `width`.
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+pad_right(tstring<CharT, Allocator> text, std::size_t const width,
+          CharT const fill = CharT{' '})
 {
     if (text.size() < width) {
-        text.insert(text.begin(), width - text.size(), fill);
+        text.append(width - text.size(), fill);
     }
     return text;
 }
 
-// Right-pad `text` with `fill` up to `width`.
 template <typename CharT>
 [[nodiscard]] inline tstring<CharT> pad_right(tstring<CharT> text,
                                               std::size_t const width,
                                               CharT const fill = CharT{' '})
+{
+    return pad_right<CharT, std::allocator<CharT>>(std::move(text), width,
+                                                   fill);
+}
+
+// Append `text` left-padded with `fill` up to `width` to `out`, without a
+// temporary: e.g. pad_left_into<char>(line, format_number(n), 8).
+template <typename CharT, typename Allocator>
+inline void pad_left_into(tstring<CharT, Allocator>& out,
+                          tstringview<CharT> const text,
+                          std::size_t const width,
+                          CharT const fill = CharT{' '})
 {
     if (text.size() < width) {
-        text.append(width - text.size(), fill);
+        out.append(width - text.size(), fill);
+    }
+    out.append(text.data(), text.size());
+}
+
+// Append `text` right-padded with `fill` up to `width` to `out`.
+template <typename CharT, typename Allocator>
+inline void pad_right_into(tstring<CharT, Allocator>& out,
+                           tstringview<CharT> const text,
+                           std::size_t const width,
+                           CharT const fill = CharT{' '})
+{
+    out.append(text.data(), text.size());
+    if (text.size() < width) {
+        out.append(width - text.size(), fill);
     }
-    return text;
 }
 
 // Center `text` within `width`, padding both sides with `fill`. When the
 // padding is odd, the extra character goes on the right.
-template <typename CharT>
-[[nodiscard]] inline tstring<CharT> center(tstring<CharT> const& text,
-                                           std::size_t const width,
-                                           CharT const fill = CharT{' '})
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline tstring<CharT, Allocator>
+center(tstring<CharT, Allocator> const& text, std::size_t const width,
+       CharT const fill = CharT{' '})
 {
     if (text.size() >= width) {
-        return text;
+        return tstring<CharT, Allocator>(text, text.get_allocator());
     }
     std::size_t const total = width - text.size();
     std::size_t const left = total / 2;
     std::size_t const right = total - left;
-    tstring<CharT> out;
+    tstring<CharT, Allocator> out(text.get_allocator());
     out.reserve(width);
     out.append(left, fill);
     out.append(text);
@@ -653,16 +4831,27 @@ template <typename CharT>
     return out;
 }
 
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT> center(tstring<CharT> const& text,
+                                           std::size_t const width,
+                                           CharT const fill = CharT{' '})
+{
+    return center<CharT, std::allocator<CharT>>(text, width, fill);
+}
+
 // ----------
 // Repetition
 // ----------
 
-// Repeat a multi-character unit `count` times.
-template <typename CharT>
-[[nodiscard]] inline tstring<CharT> repeat(tstringview<CharT> const unit,
-                                           std::size_t const count)
+// Repeat a multi-character unit `count` times; with an allocator, the result
+// is built with it.
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline detail::string_for<CharT, Allocator>
+repeat(tstringview<CharT> const unit, std::size_t const count,
+       Allocator const& alloc)
 {
-    tstring<CharT> out;
+    detail::string_for<CharT, Allocator> out(
+        detail::rebind_alloc_t<Allocator, CharT>{alloc});
     out.reserve(unit.size() * count);
     for (std::size_t i = 0; i < count; ++i) {
         out.append(unit.data(), unit.size());
@@ -670,11 +4859,193 @@ template <typename CharT>
     return out;
 }
 
+template <typename CharT>
+[[nodiscard]] inline tstring<CharT> repeat(tstringview<CharT> const unit,
+                                           std::size_t const count)
+{
+    return repeat(unit, count, std::allocator<CharT>{});
+}
+
 // Repeat a single character `count` times.
+template <typename CharT, typename Allocator>
+[[nodiscard]] inline detail::string_for<CharT, Allocator>
+repeat(CharT const ch, std::size_t const count, Allocator const& alloc)
+{
+    return detail::string_for<CharT, Allocator>(
+        count, ch, detail::rebind_alloc_t<Allocator, CharT>{alloc});
+}
+
 template <typename CharT>
 [[nodiscard]] inline tstring<CharT> repeat(CharT const ch,
                                            std::size_t const count)
 {
     return tstring<CharT>(count, ch);
 }
+
+// ----------
+// Inline strings
+// ----------
+
+// The mutating algorithms for inplace_string. Those that only shrink or
+// rewrite characters never fail; those that grow it throw std::out_of_range
+// past its capacity and leave it unchanged.
+
+namespace mutable_version
+{
+template <typename CharT, std::size_t N>
+inline void to_upper(inplace_string<N, CharT>& text) noexcept
+{
+    detail::to_upper_in_place(text);
+}
+
+template <typename CharT, std::size_t N>
+inline void to_lower(inplace_string<N, CharT>& text) noexcept
+{
+    detail::to_lower_in_place(text);
+}
+
+template <typename CharT, std::size_t N>
+inline void trim(inplace_string<N, CharT>& text) noexcept
+{
+    detail::trim_in_place(text);
+}
+
+template <typename CharT, std::size_t N>
+inline void trimleft(inplace_string<N, CharT>& text) noexcept
+{
+    detail::trimleft_in_place(text);
+}
+
+template <typename CharT, std::size_t N>
+inline void trimright(inplace_string<N, CharT>& text) noexcept
+{
+    detail::trimright_in_place(text);
+}
+
+template <typename CharT, std::size_t N>
+inline void replace_all(inplace_string<N, CharT>& text, CharT const from,
+                        CharT const to) noexcept
+{
+    std::replace(text.begin(), text.end(), from, to);
+}
+} // namespace mutable_version
+
+template <typename CharT, std::size_t N>
+[[nodiscard]] inline inplace_string<N, CharT>
+to_upper(inplace_string<N, CharT> text) noexcept
+{
+    mutable_version::to_upper(text);
+    return text;
+}
+
+template <typename CharT, std::size_t N>
+[[nodiscard]] inline inplace_string<N, CharT>
+to_lower(inplace_string<N, CharT> text) noexcept
+{
+    mutable_version::to_lower(text);
+    return text;
+}
+
+template <typename CharT, std::size_t N>
+[[nodiscard]] inline inplace_string<N, CharT>
+trim(inplace_string<N, CharT> text) noexcept
+{
+    mutable_version::trim(text);
+    return text;
+}
+
+template <typename CharT, std::size_t N>
+[[nodiscard]] inline inplace_string<N, CharT>
+trimleft(inplace_string<N, CharT> text) noexcept
+{
+    mutable_version::trimleft(text);
+    return text;
+}
+
+template <typename CharT, std::size_t N>
+[[nodiscard]] inline inplace_string<N, CharT>
+trimright(inplace_string<N, CharT> text) noexcept
+{
+    mutable_version::trimright(text);
+    return text;
+}
+
+template <typename CharT, std::size_t N>
+[[nodiscard]] inline inplace_string<N, CharT>
+replace_all(inplace_string<N, CharT> text, CharT const from,
+            CharT const to) noexcept
+{
+    mutable_version::replace_all(text, from, to);
+    return text;
+}
+
+// Left-pad `text` with `fill` up to `width` (at most N).
+template <typename CharT, std::size_t N>
+[[nodiscard]] inline inplace_string<N, CharT>
+pad_left(inplace_string<N, CharT> text, std::size_t const width,
+         CharT const fill = CharT{' '})
+{
+    if (text.size() < width) {
+        text.insert(0, width - text.size(), fill);
+    }
+    return text;
+}
+
+// Right-pad `text` with `fill` up to `width` (at most N).
+template <typename CharT, std::size_t N>
+[[nodiscard]] inline inplace_string<N, CharT>
+pad_right(inplace_string<N, CharT> text, std::size_t const width,
+          CharT const fill = CharT{' '})
+{
+    if (text.size() < width) {
+        text.append(width - text.size(), fill);
+    }
+    return text;
+}
+
+// Append `text` left-padded with `fill` up to `width` to `out`.
+template <typename CharT, std::size_t N>
+inline void pad_left_into(inplace_string<N, CharT>& out,
+                          tstringview<CharT> const text,
+                          std::size_t const width,
+                          CharT const fill = CharT{' '})
+{
+    auto const pad = text.size() < width ? width - text.size() : 0;
+    if (pad + text.size() > out.available()) {
+        throw std::out_of_range("pad_left_into: capacity exceeded");
+    }
+    out.append(pad, fill);
+    out.append(text.data(), text.size());
+}
+
+// Append `text` right-padded with `fill` up to `width` to `out`.
+template <typename CharT, std::size_t N>
+inline void pad_right_into(inplace_string<N, CharT>& out,
+                           tstringview<CharT> const text,
+                           std::size_t const width,
+                           CharT const fill = CharT{' '})
+{
+    auto const pad = text.size() < width ? width - text.size() : 0;
+    if (pad + text.size() > out.available()) {
+        throw std::out_of_range("pad_right_into: capacity exceeded");
+    }
+    out.append(text.data(), text.size());
+    out.append(pad, fill);
+}
+
+// Append `value` (see format_number) to `out`.
+template <typename CharT, typename T, std::size_t N>
+inline void append_number(inplace_string<N, CharT>& out, T const value)
+{
+    detail::append_number(out, value);
+}
+
+// Append an integer right-aligned in at least `width` characters to `out`.
+template <typename CharT, typename T, std::size_t N>
+inline void append_padded(inplace_string<N, CharT>& out, T const value,
+                          std::size_t const width,
+                          CharT const fill = CharT{'0'})
+{
+    detail::append_padded(out, value, width, fill);
+}
 } // namespace utils::strings
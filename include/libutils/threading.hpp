@@ -1,6 +1,8 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
+#include <exception>
 #include <iostream>
 #include <memory>
 #include <mutex>
@@ -8,6 +10,7 @@
 #include <thread>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace utils::threading
 {
@@ -57,6 +60,58 @@ void join_all(Collection& collection)
     join_all(std::begin(collection), std::end(collection));
 }
 
+// Inputs smaller than this per thread are not worth splitting.
+inline constexpr std::size_t parallel_min_chunk = std::size_t{1} << 16U;
+
+// How many chunks to cut `size` bytes into for up to `n_threads` threads:
+// at least one, and none smaller than parallel_min_chunk.
+[[nodiscard]] inline std::size_t parallel_chunks(std::size_t const size,
+                                                 std::size_t const n_threads)
+{
+    return std::max<std::size_t>(
+        1, std::min(n_threads, size / parallel_min_chunk));
+}
+
+// Run body(k) for every k < count, k = 0 on the calling thread and each of
+// the others on its own thread. When the system runs out of threads, the
+// chunks left without one run on the calling thread after chunk 0. The first
+// exception (by k) is rethrown once every thread has finished.
+template <typename Body>
+void run_chunks(std::size_t const count, Body const& body)
+{
+    std::vector<std::exception_ptr> errors(count);
+    auto const run = [&](std::size_t const k) {
+        try {
+            body(k);
+        } catch (...) {
+            errors[k] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    std::size_t spawned = 1;
+    try {
+        for (; spawned < count; ++spawned) {
+            threads.emplace_back(run, spawned);
+        }
+    } catch (...) {
+        // std::system_error (or std::bad_alloc) from std::thread: the
+        // threads started so far must still be joined before returning.
+    }
+    if (count != 0) {
+        run(0);
+    }
+    for (auto k = spawned; k < count; ++k) {
+        run(k);
+    }
+    join_all(threads);
+    for (auto const& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
 /**
  * The anti-lock unlocks a `mutex` at construction and locks it at destruction.
  * Requires a Guard type that exposes a mutex() method (e.g. std::unique_lock).
@@ -5,14 +5,22 @@
 #include <libutils/bytes.hpp>
 #include <libutils/chrono.hpp>
 #include <libutils/collections.hpp>
+#include <libutils/csv.hpp>
 #include <libutils/functional.hpp>
+#include <libutils/fuzzy.hpp>
 #include <libutils/hash.hpp>
+#include <libutils/inplace_string.hpp>
+#include <libutils/intern_pool.hpp>
 #include <libutils/iterators.hpp>
+#include <libutils/lines.hpp>
+#include <libutils/mapped_file.hpp>
 #include <libutils/math.hpp>
 #include <libutils/overloaded.hpp>
 #include <libutils/print.hpp>
 #include <libutils/scope_guard.hpp>
+#include <libutils/simd.hpp>
 #include <libutils/smart_pointers.hpp>
+#include <libutils/string_builder.hpp>
 #include <libutils/strings.hpp>
 #include <libutils/testing.hpp>
 #include <libutils/threading.hpp>
@@ -0,0 +1,284 @@
+#include <libutils/csv.hpp>
+#include <libutils/simd.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace csv = utils::strings::csv;
+
+namespace
+{
+using table = std::vector<std::vector<std::string>>;
+
+constexpr utils::simd::level all_levels[] = {utils::simd::level::scalar,
+                                             utils::simd::level::sse4_2,
+                                             utils::simd::level::avx2};
+
+struct level_guard
+{
+    ~level_guard() { utils::simd::set_max_level(utils::simd::level::avx2); }
+};
+
+table read_all(std::string_view const text, csv::dialect const d = {})
+{
+    table rows;
+    csv::for_each_row(
+        text,
+        [&](utils::span<std::string_view const> const row) {
+            rows.emplace_back(row.begin(), row.end());
+        },
+        d);
+    return rows;
+}
+
+// Byte-at-a-time statement of the documented rules, including the lenient
+// handling of malformed input.
+table reference(std::string_view const text, char const d = ',',
+                char const q = '"')
+{
+    table rows;
+    auto const n = text.size();
+    std::size_t pos = 0;
+    auto const strip_cr = [&](std::string& value, std::size_t const sep) {
+        if ((sep == n || text[sep] == '\n') && !value.empty() &&
+            value.back() == '\r') {
+            value.pop_back();
+        }
+    };
+    while (pos < n) {
+        std::vector<std::string> row;
+        for (;;) {
+            std::string value;
+            std::size_t i = pos;
+            if (pos < n && text[pos] == q) {
+                for (i = pos + 1; i < n;) {
+                    if (text[i] == q) {
+                        if (i + 1 < n && text[i + 1] == q) {
+                            value += q;
+                            i += 2;
+                            continue;
+                        }
+                        ++i;
+                        break;
+                    }
+                    value += text[i++];
+                }
+            }
+            std::string tail;
+            auto sep = i;
+            while (sep < n && text[sep] != d && text[sep] != '\n') {
+                tail += text[sep++];
+            }
+            strip_cr(tail, sep);
+            row.push_back(value + tail);
+            if (sep == n) {
+                pos = n;
+                break;
+            }
+            pos = sep + 1;
+            if (text[sep] == '\n') {
+                break;
+            }
+        }
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+// Well-formed CSV for `rows`, quoting only the fields that need it.
+std::string write(table const& rows)
+{
+    std::string out;
+    for (auto const& row : rows) {
+        for (std::size_t i = 0; i < row.size(); ++i) {
+            auto const& field = row[i];
+            if (field.find_first_of(",\"\r\n") == std::string::npos) {
+                out += field;
+            } else {
+                out += '"';
+                for (char const ch : field) {
+                    out += ch;
+                    if (ch == '"') {
+                        out += '"';
+                    }
+                }
+                out += '"';
+            }
+            out += i + 1 == row.size() ? "\r\n" : ",";
+        }
+    }
+    return out;
+}
+
+table random_table(std::size_t const rows, unsigned const seed)
+{
+    std::mt19937 gen{seed};
+    std::uniform_int_distribution<int> columns{1, 6};
+    std::uniform_int_distribution<int> length{0, 12};
+    std::string_view const alphabet = "abcdefgh ,\"\n\r";
+    std::uniform_int_distribution<std::size_t> pick{0, alphabet.size() - 1};
+    table out(rows);
+    for (auto& row : out) {
+        row.resize(static_cast<std::size_t>(columns(gen)));
+        for (auto& field : row) {
+            auto const n = length(gen);
+            for (int i = 0; i < n; ++i) {
+                field += alphabet[pick(gen)];
+            }
+        }
+    }
+    return out;
+}
+} // namespace
+
+TEST_CASE("Csv - fields, quoting and line endings")
+{
+    REQUIRE(read_all("").empty());
+    REQUIRE(read_all("a,b,c") == table{{"a", "b", "c"}});
+    REQUIRE(read_all("a,b\nc,d\n") == table{{"a", "b"}, {"c", "d"}});
+    REQUIRE(read_all("a,b\r\nc,d\r\n") == table{{"a", "b"}, {"c", "d"}});
+    REQUIRE(read_all("a,,c,\n") == table{{"a", "", "c", ""}});
+    REQUIRE(read_all("\n\n") == table{{""}, {""}});
+    REQUIRE(read_all(",") == table{{"", ""}});
+
+    REQUIRE(read_all(R"("a,b","c""d","")") == table{{"a,b", "c\"d", ""}});
+    REQUIRE(read_all("\"line\r\nbreak\",x\r\ny") ==
+            table{{"line\r\nbreak", "x"}, {"y"}});
+    REQUIRE(read_all(R"("""quoted""")") == table{{"\"quoted\""}});
+    // Quotes inside an unquoted field are literal.
+    REQUIRE(read_all(R"(a"b,c)") == table{{"a\"b", "c"}});
+
+    // Lenient: text after a closing quote is kept, an open quote runs to EOF.
+    REQUIRE(read_all(R"("ab"cd,e)") == table{{"abcd", "e"}});
+    REQUIRE(read_all("\"open,\nstill") == table{{"open,\nstill"}});
+}
+
+TEST_CASE("Csv - fields are views into the input unless unescaped")
+{
+    std::string const text = "plain,\"quoted\",\"esc\"\"aped\"\n";
+    csv::reader rows{text};
+    REQUIRE(rows.next());
+    auto const row = rows.row();
+    REQUIRE(row.size() == 3);
+    REQUIRE(row[0].data() == text.data());
+    REQUIRE(row[1].data() == text.data() + 7);
+    REQUIRE(row[2] == "esc\"aped");
+    REQUIRE((row[2].data() < text.data() ||
+             row[2].data() >= text.data() + text.size()));
+    REQUIRE(rows.rows() == 1);
+    REQUIRE(rows.offset() == text.size());
+    REQUIRE_FALSE(rows.next());
+}
+
+TEST_CASE("Csv - dialects")
+{
+    csv::dialect tsv;
+    tsv.delimiter = '\t';
+    tsv.quote = '\'';
+    REQUIRE(read_all("a\t'b\tc'\t'it''s'\n", tsv) ==
+            table{{"a", "b\tc", "it's"}});
+
+    csv::dialect bad;
+    bad.delimiter = '"';
+    REQUIRE_THROWS_AS(csv::reader("", bad), std::invalid_argument);
+    bad.delimiter = '\n';
+    REQUIRE_THROWS_AS(csv::reader("", bad), std::invalid_argument);
+}
+
+TEST_CASE("Csv - matches the reference on random input at every level")
+{
+    level_guard const guard;
+    std::mt19937 gen{5};
+    std::string_view const alphabet = "ab,,\"\"\n\r";
+    std::uniform_int_distribution<std::size_t> pick{0, alphabet.size() - 1};
+    std::uniform_int_distribution<int> length{0, 150};
+    for (int iteration = 0; iteration < 2000; ++iteration) {
+        std::string text;
+        auto const n = length(gen);
+        for (int i = 0; i < n; ++i) {
+            text += alphabet[pick(gen)];
+        }
+        auto const expected = reference(text);
+        for (auto const l : all_levels) {
+            utils::simd::set_max_level(l);
+            CAPTURE(text);
+            REQUIRE(read_all(text) == expected);
+        }
+    }
+}
+
+TEST_CASE("Csv - well-formed tables round-trip")
+{
+    auto const rows = random_table(500, 9);
+    REQUIRE(read_all(write(rows)) == rows);
+}
+
+TEST_CASE("Csv - split_rows cuts only at row boundaries")
+{
+    auto const rows = random_table(2000, 3);
+    auto const text = write(rows);
+    for (std::size_t parts = 1; parts <= 9; ++parts) {
+        auto const chunks = csv::split_rows(text, parts);
+        REQUIRE_FALSE(chunks.empty());
+        REQUIRE(chunks.size() <= parts);
+        table joined;
+        std::size_t offset = 0;
+        for (auto const chunk : chunks) {
+            REQUIRE(chunk.data() == text.data() + offset);
+            offset += chunk.size();
+            auto const part = read_all(chunk);
+            joined.insert(joined.end(), part.begin(), part.end());
+        }
+        REQUIRE(offset == text.size());
+        REQUIRE(joined == rows);
+    }
+    REQUIRE(csv::split_rows("", 4).empty());
+}
+
+TEST_CASE("Csv - parallel_for_each_row merges to the sequential result")
+{
+    auto const rows = random_table(40000, 11);
+    auto const text = write(rows);
+    REQUIRE(text.size() > 4 * utils::threading::parallel_min_chunk);
+
+    std::vector<table> per_chunk(4);
+    csv::parallel_for_each_row(
+        text, 4,
+        [&](std::size_t const chunk,
+            utils::span<std::string_view const> const row) {
+            per_chunk[chunk].emplace_back(row.begin(), row.end());
+        });
+    table joined;
+    std::size_t used = 0;
+    for (auto const& part : per_chunk) {
+        used += part.empty() ? 0 : 1;
+        joined.insert(joined.end(), part.begin(), part.end());
+    }
+    REQUIRE(used > 1);
+    REQUIRE(joined == rows);
+
+    // Small inputs stay on the calling thread.
+    std::size_t calls = 0;
+    csv::parallel_for_each_row(
+        "a\nb\n", 8,
+        [&](std::size_t const chunk, utils::span<std::string_view const>) {
+            REQUIRE(chunk == 0);
+            ++calls;
+        });
+    REQUIRE(calls == 2);
+
+    REQUIRE_THROWS_AS(csv::parallel_for_each_row(
+                          text, 4,
+                          [](std::size_t const chunk,
+                             utils::span<std::string_view const>) {
+                              if (chunk == 2) {
+                                  throw std::runtime_error("stop");
+                              }
+                          }),
+                      std::runtime_error);
+}
@@ -0,0 +1,142 @@
+#include <libutils/fuzzy.hpp>
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+// The textbook O(nm) dynamic program, as the reference.
+template <typename CharT>
+std::size_t naive_distance(std::basic_string_view<CharT> const a,
+                           std::basic_string_view<CharT> const b)
+{
+    std::vector<std::size_t> row(b.size() + 1);
+    for (std::size_t j = 0; j <= b.size(); ++j) {
+        row[j] = j;
+    }
+    for (std::size_t i = 1; i <= a.size(); ++i) {
+        auto diagonal = row[0];
+        row[0] = i;
+        for (std::size_t j = 1; j <= b.size(); ++j) {
+            auto const above = row[j];
+            row[j] = std::min({above + 1, row[j - 1] + 1,
+                               diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+std::string random_string(std::mt19937& gen, std::size_t const size,
+                          char const last)
+{
+    std::uniform_int_distribution<int> ch{'a', last};
+    std::string out(size, ' ');
+    for (auto& c : out) {
+        c = static_cast<char>(ch(gen));
+    }
+    return out;
+}
+} // namespace
+
+TEST_CASE("Fuzzy - edit_distance matches the dynamic program")
+{
+    using utils::strings::edit_distance;
+    REQUIRE(edit_distance("kitten", "sitting") == 3);
+    REQUIRE(edit_distance("", "abc") == 3);
+    REQUIRE(edit_distance("abc", "") == 3);
+    REQUIRE(edit_distance("", "") == 0);
+    REQUIRE(edit_distance("flaw", "lawn") == 2);
+    REQUIRE(edit_distance(std::string{"same"}, "same") == 0);
+    REQUIRE(edit_distance<wchar_t>(L"héllo", L"hello") == 1);
+
+    // Single-word and multi-block patterns, with small and large alphabets
+    // so that both close and distant pairs come up.
+    std::mt19937 gen{7};
+    std::uniform_int_distribution<std::size_t> size{0, 200};
+    for (int round = 0; round < 300; ++round) {
+        auto const last = round % 2 == 0 ? 'c' : 'z';
+        auto const a = random_string(gen, size(gen), last);
+        auto b = a;
+        // A third of the pairs are a few random edits apart.
+        if (round % 3 != 0) {
+            b = random_string(gen, size(gen), last);
+        } else {
+            for (int k = 0; k < 5 && !b.empty(); ++k) {
+                b[gen() % b.size()] = 'x';
+                b.insert(gen() % b.size(), 1, 'y');
+                b.erase(gen() % b.size(), 1);
+            }
+        }
+        auto const expected = naive_distance<char>(a, b);
+        REQUIRE(edit_distance(a, b) == expected);
+        REQUIRE(edit_distance(b, a) == expected);
+        // Bounded: exact up to the limit, limit + 1 past it.
+        for (std::size_t const limit : {std::size_t{0}, expected / 2,
+                                        expected, expected + 3}) {
+            REQUIRE(edit_distance(a, b, limit) ==
+                    std::min(expected, limit + 1));
+        }
+    }
+
+    // Wide characters outside the pattern's alphabet, past one block.
+    std::u32string wide(100, U'一');
+    std::u32string other = wide;
+    other[3] = U'丁';
+    other[90] = U'a';
+    other.push_back(U'b');
+    REQUIRE(edit_distance<char32_t>(wide, other) == 3);
+    REQUIRE(edit_distance<char32_t>(wide, other, 1) == 2);
+}
+
+TEST_CASE("Fuzzy - fuzzy_find_best picks the closest candidate")
+{
+    using utils::strings::fuzzy_find_best;
+    std::vector<std::string> const hosts{
+        "db-01.example.com", "db-02.example.com", "web-01.example.com",
+        "cache.example.org", "db-01.example.net"};
+
+    auto const match = fuzzy_find_best("db-01.exmaple.com", hosts);
+    REQUIRE(match);
+    REQUIRE(match.index == 0);
+    REQUIRE(match.distance == 2);
+
+    REQUIRE(fuzzy_find_best("web-01.example.com", hosts).distance == 0);
+    // Ties go to the earliest candidate.
+    REQUIRE(fuzzy_find_best("db-0.example.com", hosts).index == 0);
+    REQUIRE_FALSE(fuzzy_find_best("db-01.exmaple.com", hosts, 1));
+    REQUIRE_FALSE(fuzzy_find_best("x", std::vector<std::string>{}));
+    std::vector<std::string_view> const views(hosts.begin(), hosts.end());
+    REQUIRE(fuzzy_find_best("cache.example.com", views).index == 3);
+
+    // The filters never drop the best candidate.
+    std::mt19937 gen{11};
+    std::vector<std::string> candidates;
+    for (int i = 0; i < 500; ++i) {
+        candidates.push_back(random_string(gen, 5 + gen() % 30, 'h'));
+    }
+    auto const unbounded = utils::strings::fuzzy_match::npos;
+    for (int round = 0; round < 50; ++round) {
+        auto needle = candidates[gen() % candidates.size()];
+        needle[gen() % needle.size()] = 'z';
+        needle += round % 2 == 0 ? "q" : "";
+        for (std::size_t const limit :
+             {std::size_t{2}, std::size_t{6}, unbounded}) {
+            utils::strings::fuzzy_match expected;
+            for (std::size_t i = 0; i < candidates.size(); ++i) {
+                auto const d = naive_distance<char>(needle, candidates[i]);
+                if (d <= limit && d < expected.distance) {
+                    expected = {i, d};
+                }
+            }
+            auto const found = fuzzy_find_best(needle, candidates, limit);
+            REQUIRE(found.index == expected.index);
+            REQUIRE(found.distance == expected.distance);
+        }
+    }
+}
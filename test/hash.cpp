@@ -1,8 +1,12 @@
 #include <libutils/hash.hpp>
 
 #include <catch2/catch_test_macros.hpp>
+#include <array>
 #include <cstddef>
+#include <set>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 
 TEST_CASE("Hash - combine produces consistent results")
 {
@@ -40,3 +44,78 @@ TEST_CASE("Hash - different values produce different seeds")
 
     REQUIRE(s1 != s2);
 }
+
+TEST_CASE("Hash - hash_string is the same at compile time and run time")
+{
+    constexpr auto compile_time = utils::hash::hash_string("command");
+    static_assert(compile_time != utils::hash::hash_string("commanD"));
+    constexpr auto wide = utils::hash::hash_string(std::u16string_view{u"k"});
+
+    std::string const text{"command"};
+    REQUIRE(utils::hash::hash_string(text) == compile_time);
+    std::u16string const wide_text{u"k"};
+    REQUIRE(utils::hash::hash_string(std::u16string_view{wide_text}) == wide);
+
+    // Every length from 0 to 40 (full words, both kinds of partial word),
+    // and a change at any position, give distinct hashes.
+    std::string const base(40, 'a');
+    std::set<std::size_t> hashes;
+    for (std::size_t size = 0; size <= base.size(); ++size) {
+        auto const prefix = std::string_view{base}.substr(0, size);
+        REQUIRE(hashes.insert(utils::hash::hash_string(prefix)).second);
+        for (std::size_t i = 0; i < size; ++i) {
+            auto changed = std::string{prefix};
+            changed[i] = 'b';
+            REQUIRE(hashes.insert(utils::hash::hash_string(changed)).second);
+        }
+    }
+}
+
+TEST_CASE("Hash - string_switch dispatches on its cases")
+{
+    static constexpr auto commands = utils::hash::make_string_switch(
+        "get", "set", "del", "incr", "decr", "expire", "", "ping");
+    static_assert(commands.size() == 8);
+    static_assert(commands.find("expire") == 5);
+    static_assert(commands.find("expires") == commands.size());
+    static_assert(commands[1] == "set");
+
+    auto const dispatch = [](std::string const& name) {
+        switch (commands.find(name)) {
+        case commands.index("get"):
+            return 1;
+        case commands.index("set"):
+            return 2;
+        case commands.index(""):
+            return 3;
+        default:
+            return 0;
+        }
+    };
+    REQUIRE(dispatch("get") == 1);
+    REQUIRE(dispatch("set") == 2);
+    REQUIRE(dispatch("") == 3);
+    REQUIRE(dispatch("del") == 0);
+    REQUIRE(dispatch("gets") == 0);
+    REQUIRE(dispatch("GET") == 0);
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        REQUIRE(commands.find(commands[i]) == i);
+    }
+    REQUIRE_THROWS_AS(commands.index("nope"), std::invalid_argument);
+
+    // Large and wide switches too.
+    std::array<std::wstring, 300> names;
+    std::array<std::wstring_view, 300> views;
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        names[i] = L"name" + std::to_wstring(i);
+        views[i] = names[i];
+    }
+    utils::hash::string_switch<300, wchar_t> const wide(views);
+    for (std::size_t i = 0; i < views.size(); ++i) {
+        REQUIRE(wide.find(views[i]) == i);
+    }
+    REQUIRE(wide.find(L"name300") == 300);
+    views[7] = views[3];
+    REQUIRE_THROWS_AS((utils::hash::string_switch<300, wchar_t>(views)),
+                      std::invalid_argument);
+}
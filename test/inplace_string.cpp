@@ -0,0 +1,128 @@
+#include <libutils/inplace_string.hpp>
+#include <libutils/strings.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+using utils::strings::inplace_string;
+
+static_assert(std::is_trivially_copyable_v<inplace_string<16>>);
+static_assert(std::is_trivially_copyable_v<inplace_string<300, wchar_t>>);
+static_assert(sizeof(inplace_string<15>) == 17);
+static_assert(inplace_string<15>::capacity() == 15);
+
+TEST_CASE("InplaceString - checked and truncating modifiers")
+{
+    inplace_string<8> text;
+    REQUIRE(text.empty());
+    REQUIRE(text.c_str()[0] == '\0');
+
+    text.append("key").push_back(':');
+    text += "42";
+    REQUIRE(text == "key:42");
+    REQUIRE(text.size() == 6);
+    REQUIRE(text.available() == 2);
+    REQUIRE(std::string_view{text.c_str()} == "key:42");
+
+    // A checked operation that does not fit throws and changes nothing.
+    REQUIRE_THROWS_AS(text.append("abc"), std::out_of_range);
+    REQUIRE_THROWS_AS(text.append(3, 'x'), std::out_of_range);
+    REQUIRE_THROWS_AS(text.resize(9), std::out_of_range);
+    REQUIRE_THROWS_AS(text.insert(0, 3, ' '), std::out_of_range);
+    REQUIRE_THROWS_AS(inplace_string<2>("abc"), std::out_of_range);
+    REQUIRE(text == "key:42");
+
+    // The truncating forms keep what fits and report it.
+    REQUIRE_FALSE(text.append_truncated("abc"));
+    REQUIRE(text == "key:42ab");
+    REQUIRE(text.append_truncated(""));
+    REQUIRE_FALSE(text.append_truncated(1, 'x'));
+    REQUIRE(inplace_string<4>::truncated("abcdef") == "abcd");
+
+    text.erase(0, 4);
+    REQUIRE(text == "42ab");
+    text.insert(0, 2, '0');
+    REQUIRE(text == "0042ab");
+    text.erase(text.begin() + 4, text.end());
+    REQUIRE(text == "0042");
+    text.pop_back();
+    text.resize(5, '-');
+    REQUIRE(text == "004--");
+    REQUIRE(text.front() == '0');
+    REQUIRE(text.back() == '-');
+    REQUIRE(std::string{text.rbegin(), text.rend()} == "--400");
+
+    // Copies are independent values.
+    auto copy = text;
+    copy[0] = '1';
+    REQUIRE(copy == "104--");
+    REQUIRE(text == "004--");
+    REQUIRE(text < copy);
+    REQUIRE(text != copy);
+
+    std::ostringstream os;
+    os << copy;
+    REQUIRE(os.str() == "104--");
+
+    // Assigning from a view of itself, as std::string allows.
+    copy.assign(copy.view().substr(2));
+    REQUIRE(copy == "4--");
+    copy.assign(copy);
+    REQUIRE(copy == "4--");
+    text.clear();
+    REQUIRE(text.empty());
+    REQUIRE(text.c_str()[0] == '\0');
+}
+
+TEST_CASE("InplaceString - strings algorithms")
+{
+    namespace strings = utils::strings;
+
+    inplace_string<16> text("  Hello World ");
+    REQUIRE(strings::trim(text) == "Hello World");
+    REQUIRE(strings::trimleft(text) == "Hello World ");
+    REQUIRE(strings::trimright(text) == "  Hello World");
+    REQUIRE(strings::to_upper(text) == "  HELLO WORLD ");
+    REQUIRE(strings::to_lower(text) == "  hello world ");
+    REQUIRE(strings::replace_all(text, ' ', '_') == "__Hello_World_");
+
+    strings::mutable_version::trim<char>(text);
+    strings::mutable_version::to_upper(text);
+    strings::mutable_version::replace_all(text, 'O', '0');
+    REQUIRE(text == "HELL0 W0RLD");
+
+    inplace_string<8> const id("42");
+    REQUIRE(strings::pad_left(id, 5, '0') == "00042");
+    REQUIRE(strings::pad_right(id, 4) == "42  ");
+    REQUIRE(strings::pad_left(id, 1) == "42");
+    REQUIRE_THROWS_AS(strings::pad_left(id, 9), std::out_of_range);
+
+    inplace_string<12> key("u:");
+    strings::pad_left_into(key, std::string_view{"7"}, 3, '0');
+    strings::pad_right_into(key, std::string_view{"ab"}, 3, '.');
+    REQUIRE(key == "u:007ab.");
+    // Padded appends that do not fit leave the string unchanged.
+    REQUIRE_THROWS_AS(strings::pad_left_into(key, std::string_view{"1"}, 5),
+                      std::out_of_range);
+    REQUIRE(key == "u:007ab.");
+
+    strings::append_number(key, -12);
+    REQUIRE(key == "u:007ab.-12");
+    REQUIRE_THROWS_AS(strings::append_number(key, 100), std::out_of_range);
+    REQUIRE_THROWS_AS(strings::append_padded(key, 1, 2), std::out_of_range);
+    key.clear();
+    strings::append_padded(key, std::uint32_t{42}, 6);
+    REQUIRE(key == "000042");
+
+    // Wider characters take the generic paths.
+    inplace_string<8, wchar_t> wide(L" ab ");
+    strings::mutable_version::trim(wide);
+    strings::mutable_version::to_upper(wide);
+    strings::append_number(wide, 7);
+    REQUIRE(wide == L"AB7");
+}
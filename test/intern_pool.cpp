@@ -0,0 +1,124 @@
+#include <libutils/collections.hpp>
+#include <libutils/intern_pool.hpp>
+#include <libutils/threading.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+TEST_CASE("InternPool - ids are dense, stable and resolve to the string")
+{
+    utils::strings::intern_pool pool(64);
+    REQUIRE(pool.empty());
+    REQUIRE_FALSE(pool.find("host"));
+
+    auto const host = pool.intern("host");
+    auto const metric = pool.intern("metric");
+    auto const empty = pool.intern("");
+    REQUIRE(host == 0);
+    REQUIRE(metric == 1);
+    REQUIRE(empty == 2);
+    REQUIRE(pool.intern(std::string{"host"}) == host);
+    REQUIRE(pool.intern("") == empty);
+    REQUIRE(pool.size() == 3);
+    REQUIRE(pool.find("metric") == metric);
+    REQUIRE_FALSE(pool.find("metrics"));
+
+    REQUIRE(pool.view(host) == "host");
+    REQUIRE(pool.view(empty).empty());
+    REQUIRE(pool.at(metric) == "metric");
+    REQUIRE_THROWS_AS(pool.at(3), std::out_of_range);
+    REQUIRE(pool.string_bytes() == 10);
+
+    // Views survive arena chunks filling up, oversized strings and rehashes.
+    auto const first = pool.view(host);
+    std::string const big(200, 'x');
+    REQUIRE(pool.view(pool.intern(big)) == big);
+    std::unordered_map<std::string, std::uint32_t> ids;
+    for (int i = 0; i < 5000; ++i) {
+        auto const text = "tag." + std::to_string(i);
+        ids.emplace(text, pool.intern(text));
+    }
+    REQUIRE(first.data() == pool.view(host).data());
+    for (auto const& [text, id] : ids) {
+        REQUIRE(pool.view(id) == text);
+        REQUIRE(pool.intern(text) == id);
+    }
+    REQUIRE(pool.size() == 5004);
+
+    pool.clear();
+    REQUIRE(pool.empty());
+    REQUIRE_FALSE(pool.find("host"));
+    REQUIRE(pool.intern("metric") == 0);
+}
+
+TEST_CASE("InternPool - memory accounting follows areaof")
+{
+    utils::strings::intern_pool pool(1024);
+    REQUIRE(utils::collections::areaof(pool) == sizeof(pool));
+
+    pool.reserve(100);
+    auto const reserved = utils::collections::areaof(pool);
+    REQUIRE(reserved > sizeof(pool) + 100 * sizeof(std::string_view));
+
+    for (int i = 0; i < 100; ++i) {
+        pool.intern("key" + std::to_string(i));
+    }
+    // One arena chunk, no growth of the reserved vectors or index.
+    REQUIRE(utils::collections::areaof(pool) ==
+            reserved + 1024 + sizeof(std::unique_ptr<char[]>));
+    auto const utilization = utils::collections::memory_utilization(pool);
+    REQUIRE(utilization > 0.0);
+    REQUIRE(utilization < 1.0);
+    REQUIRE(utilization ==
+            static_cast<double>(pool.string_bytes()) /
+                static_cast<double>(utils::collections::areaof(pool)));
+}
+
+TEST_CASE("InternPool - sharded pool interns concurrently")
+{
+    utils::strings::sharded_intern_pool<8> pool;
+    constexpr int strings = 2000;
+    constexpr int threads = 4;
+
+    // Every thread interns every string, in a different order.
+    std::vector<std::vector<std::uint32_t>> ids(
+        threads, std::vector<std::uint32_t>(strings));
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int k = 0; k < strings; ++k) {
+                auto const i = (k * 7 + t * 13) % strings;
+                ids[static_cast<std::size_t>(t)][static_cast<std::size_t>(i)] =
+                    pool.intern("name." + std::to_string(i));
+            }
+        });
+    }
+    utils::threading::join_all(workers);
+
+    REQUIRE(pool.size() == strings);
+    std::set<std::uint32_t> distinct;
+    for (int i = 0; i < strings; ++i) {
+        auto const index = static_cast<std::size_t>(i);
+        auto const id = ids[0][index];
+        for (int t = 1; t < threads; ++t) {
+            REQUIRE(ids[static_cast<std::size_t>(t)][index] == id);
+        }
+        REQUIRE(pool.view(id) == "name." + std::to_string(i));
+        REQUIRE(pool.find("name." + std::to_string(i)) == id);
+        distinct.insert(id);
+    }
+    REQUIRE(distinct.size() == strings);
+    REQUIRE_FALSE(pool.find("other"));
+    REQUIRE(pool.area() > pool.string_bytes());
+
+    pool.clear();
+    REQUIRE(pool.empty());
+}
@@ -0,0 +1,202 @@
+#include <libutils/bytes.hpp>
+#include <libutils/lines.hpp>
+#include <libutils/polyfill.hpp>
+#include <libutils/simd.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+std::vector<std::string> collect(std::string_view const text)
+{
+    std::vector<std::string> out;
+    for (auto const line : utils::strings::lines(text)) {
+        out.emplace_back(line);
+    }
+    return out;
+}
+
+// std::getline, plus stripping the "\r" of "\r\n" (and of a final "\r").
+std::vector<std::string> reference(std::string const& text)
+{
+    std::vector<std::string> out;
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        out.push_back(line);
+    }
+    return out;
+}
+} // namespace
+
+TEST_CASE("Lines - line breaks and the final line")
+{
+    using lines = std::vector<std::string>;
+    REQUIRE(collect("").empty());
+    REQUIRE(collect("a") == lines{"a"});
+    REQUIRE(collect("a\n") == lines{"a"});
+    REQUIRE(collect("a\nb") == lines{"a", "b"});
+    REQUIRE(collect("a\r\nb\r\n") == lines{"a", "b"});
+    REQUIRE(collect("\n\n") == lines{"", ""});
+    REQUIRE(collect("a\n\nb\n") == lines{"a", "", "b"});
+    REQUIRE(collect("\r\n") == lines{""});
+    REQUIRE(collect("a\r") == lines{"a"});
+    // Only the "\r" right before the break is part of it.
+    REQUIRE(collect("a\rb\r\r\n") == lines{"a\rb\r"});
+}
+
+TEST_CASE("Lines - views point into the buffer")
+{
+    std::string const text = "first\r\nsecond\nthird";
+    auto const range = utils::strings::lines(text);
+    auto it = range.begin();
+    REQUIRE(it->data() == text.data());
+    REQUIRE(*it++ == "first");
+    REQUIRE(it->data() == text.data() + 7);
+    REQUIRE(*++it == "third");
+    REQUIRE(++it == range.end());
+
+    // Spans of characters and of raw bytes.
+    char const chars[] = {'x', '\n', 'y'};
+    std::vector<std::string> from_span;
+    for (auto const line :
+         utils::strings::lines(utils::span<char const>(chars, 3))) {
+        from_span.emplace_back(line);
+    }
+    REQUIRE(from_span == std::vector<std::string>{"x", "y"});
+    auto const bytes = utils::bytes::byte_view("p\r\nq");
+    REQUIRE(std::distance(utils::strings::lines(bytes).begin(),
+                          utils::strings::lines(bytes).end()) == 2);
+}
+
+TEST_CASE("Lines - match std::getline on random input at every level")
+{
+    std::mt19937 gen{3};
+    std::string_view const alphabet = "ab \r\n\n";
+    std::uniform_int_distribution<std::size_t> pick{0, alphabet.size() - 1};
+    std::uniform_int_distribution<int> length{0, 300};
+    for (int iteration = 0; iteration < 2000; ++iteration) {
+        std::string text;
+        for (auto n = length(gen); n > 0; --n) {
+            text += alphabet[pick(gen)];
+        }
+        // Now and then a line longer than a block.
+        if (iteration % 10 == 0) {
+            text.insert(text.size() / 2, std::string(150, 'x'));
+        }
+        auto const expected = reference(text);
+        for (auto const l :
+             {utils::simd::level::scalar, utils::simd::level::sse4_2,
+              utils::simd::level::avx2}) {
+            utils::simd::set_max_level(l);
+            CAPTURE(text);
+            REQUIRE(collect(text) == expected);
+        }
+    }
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+TEST_CASE("Lines - split_lines cuts only after line breaks")
+{
+    std::string text;
+    for (int i = 0; i < 5000; ++i) {
+        text += "line " + std::to_string(i) + (i % 3 == 0 ? "\r\n" : "\n");
+    }
+    text += "no break at the end";
+    auto const expected = collect(text);
+    for (std::size_t parts = 1; parts <= 9; ++parts) {
+        auto const chunks = utils::strings::split_lines(text, parts);
+        REQUIRE_FALSE(chunks.empty());
+        REQUIRE(chunks.size() <= parts);
+        std::vector<std::string> joined;
+        std::size_t offset = 0;
+        for (auto const chunk : chunks) {
+            REQUIRE(chunk.data() == text.data() + offset);
+            offset += chunk.size();
+            auto const part = collect(chunk);
+            joined.insert(joined.end(), part.begin(), part.end());
+        }
+        REQUIRE(offset == text.size());
+        REQUIRE(joined == expected);
+    }
+    REQUIRE(utils::strings::split_lines("", 4).empty());
+    REQUIRE(utils::strings::split_lines("one line", 4).size() == 1);
+}
+
+TEST_CASE("Lines - parallel_for_each_line merges to the sequential result")
+{
+    std::string text;
+    for (int i = 0; i < 60000; ++i) {
+        text += std::to_string(i) + ",field\n";
+    }
+    REQUIRE(text.size() > 4 * utils::threading::parallel_min_chunk);
+    auto const expected = collect(text);
+
+    std::vector<std::vector<std::string>> per_chunk(4);
+    utils::strings::parallel_for_each_line(
+        text, 4, [&](std::size_t const chunk, std::string_view const line) {
+            per_chunk[chunk].emplace_back(line);
+        });
+    std::vector<std::string> joined;
+    std::size_t used = 0;
+    for (auto const& part : per_chunk) {
+        used += part.empty() ? 0 : 1;
+        joined.insert(joined.end(), part.begin(), part.end());
+    }
+    REQUIRE(used > 1);
+    REQUIRE(joined == expected);
+
+    // Ordered merges concatenate in input order.
+    using lines = std::vector<std::string>;
+    auto const ordered = utils::strings::parallel_for_each_line(
+        text, 4, lines{},
+        [](lines& acc, std::string_view const line) {
+            acc.emplace_back(line);
+        },
+        [](lines& into, lines&& from) {
+            into.insert(into.end(), from.begin(), from.end());
+        });
+    REQUIRE(ordered == expected);
+
+    // Unordered merges suit commutative reductions.
+    auto const sum = utils::strings::parallel_for_each_line(
+        text, 4, std::size_t{0},
+        [](std::size_t& acc, std::string_view const line) {
+            acc += line.size();
+        },
+        [](std::size_t& into, std::size_t const from) { into += from; },
+        utils::strings::merge_order::unordered);
+    REQUIRE(sum == text.size() - expected.size());
+
+    // Empty input returns `init`; small inputs stay on the calling thread.
+    REQUIRE(utils::strings::parallel_for_each_line(
+                "", 4, 7, [](int&, std::string_view) {},
+                [](int& into, int const from) { into += from; }) == 7);
+    std::size_t calls = 0;
+    utils::strings::parallel_for_each_line(
+        "a\nb\n", 8, [&](std::size_t const chunk, std::string_view) {
+            REQUIRE(chunk == 0);
+            ++calls;
+        });
+    REQUIRE(calls == 2);
+
+    REQUIRE_THROWS_AS(utils::strings::parallel_for_each_line(
+                          text, 4,
+                          [](std::size_t const chunk, std::string_view) {
+                              if (chunk == 2) {
+                                  throw std::runtime_error("stop");
+                              }
+                          }),
+                      std::runtime_error);
+}
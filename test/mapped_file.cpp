@@ -0,0 +1,81 @@
+#include <libutils/lines.hpp>
+#include <libutils/mapped_file.hpp>
+#include <libutils/unused.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+
+namespace
+{
+// NOLINTNEXTLINE
+class MappedFileFixture
+{
+protected:
+    std::string const file = "mapped_file.txt";
+
+    void write(std::string const& contents) const
+    {
+        std::ofstream fs(file, std::ios::binary | std::ios::trunc);
+        fs << contents;
+    }
+
+public:
+    ~MappedFileFixture() { utils::unused(std::remove(file.c_str())); }
+};
+} // namespace
+
+TEST_CASE_METHOD(MappedFileFixture, "MappedFile - maps the whole file")
+{
+    std::string contents;
+    for (int i = 0; i < 10000; ++i) {
+        contents += "line " + std::to_string(i) + "\r\n";
+    }
+    write(contents);
+
+    utils::mapped_file const mapped(file);
+    REQUIRE(mapped.size() == contents.size());
+    REQUIRE(mapped.text() == contents);
+    REQUIRE(mapped.bytes().size() == contents.size());
+
+    std::size_t count = 0;
+    for (auto const line : utils::strings::lines(mapped.bytes())) {
+        REQUIRE(line == "line " + std::to_string(count));
+        ++count;
+    }
+    REQUIRE(count == 10000);
+}
+
+TEST_CASE_METHOD(MappedFileFixture, "MappedFile - empty files and moves")
+{
+    write("");
+    utils::mapped_file const empty(file);
+    REQUIRE(empty.empty());
+    REQUIRE(empty.text().empty());
+    REQUIRE(utils::strings::lines(empty.bytes()).begin() ==
+            utils::strings::lines(empty.bytes()).end());
+
+    write("abc");
+    utils::mapped_file first(file);
+    auto const* const data = first.data();
+    utils::mapped_file second(std::move(first));
+    REQUIRE(first.empty()); // NOLINT(bugprone-use-after-move)
+    REQUIRE(second.data() == data);
+    REQUIRE(second.text() == "abc");
+    first = std::move(second);
+    REQUIRE(first.text() == "abc");
+}
+
+TEST_CASE("MappedFile - missing files throw")
+{
+    REQUIRE_THROWS_AS(utils::mapped_file("NonExistentFile"), std::system_error);
+}
+
+#endif
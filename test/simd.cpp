@@ -0,0 +1,342 @@
+#include <libutils/simd.hpp>
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+constexpr utils::simd::level all_levels[] = {utils::simd::level::scalar,
+                                             utils::simd::level::sse4_2,
+                                             utils::simd::level::avx2};
+
+// Restores the default dispatch cap when a test leaves scope.
+struct level_guard
+{
+    ~level_guard() { utils::simd::set_max_level(utils::simd::level::avx2); }
+};
+
+std::string random_text(std::size_t const size, unsigned const seed)
+{
+    std::mt19937 gen{seed};
+    std::uniform_int_distribution<int> dist{0, 255};
+    std::string text(size, '\0');
+    for (auto& ch : text) {
+        ch = static_cast<char>(dist(gen));
+    }
+    return text;
+}
+} // namespace
+
+TEST_CASE("Simd - active level never exceeds the supported level")
+{
+    level_guard const guard;
+    utils::simd::set_max_level(utils::simd::level::scalar);
+    REQUIRE(utils::simd::active_level() == utils::simd::level::scalar);
+    utils::simd::set_max_level(utils::simd::level::avx2);
+    REQUIRE(utils::simd::active_level() == utils::simd::supported_level());
+}
+
+TEST_CASE("Simd - byte_set membership covers the whole byte range")
+{
+    constexpr utils::simd::byte_set set{std::string_view{",;\x7f\x80\xff"}};
+    static_assert(set.contains(','));
+    static_assert(!set.contains('a'));
+    REQUIRE(set.contains(0x7F));
+    REQUIRE(set.contains(0x80));
+    REQUIRE(set.contains(0xFF));
+    REQUIRE_FALSE(set.contains(0x00));
+    REQUIRE_FALSE(set.contains(0xFE));
+}
+
+TEST_CASE("Simd - find_first_of matches the scalar reference at every level")
+{
+    level_guard const guard;
+    // Delimiters spread over many high nibbles, including bytes >= 0x80.
+    std::string_view const delims{",\t \n|\x90\xe5\x01"};
+    utils::simd::byte_set const set{delims};
+
+    for (auto const l : all_levels) {
+        utils::simd::set_max_level(l);
+        for (unsigned seed = 0; seed < 20; ++seed) {
+            auto const text = random_text(1 + (seed * 37), seed);
+            std::string_view const view{text};
+            for (std::size_t pos = 0; pos < view.size(); pos += 7) {
+                auto const* const hit = utils::simd::find_first_of(
+                    view.data() + pos, view.data() + view.size(), set);
+                auto const expected = view.find_first_of(delims, pos);
+                auto const got =
+                    hit == view.data() + view.size()
+                        ? std::string_view::npos
+                        : static_cast<std::size_t>(hit - view.data());
+                REQUIRE(got == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("Simd - byte_set scans and remove match the std forms at every level")
+{
+    level_guard const guard;
+    std::string_view const members{" \t\r\n\x90\xe5"};
+    utils::simd::byte_set const set{members};
+
+    // Mostly members, so the not-of scans have long runs to skip.
+    std::mt19937 gen{13};
+    std::uniform_int_distribution<std::size_t> pick{0, members.size() - 1};
+    std::uniform_int_distribution<int> odds{0, 63};
+    std::string text(700, ' ');
+    for (auto& ch : text) {
+        ch = odds(gen) == 0 ? 'x' : members[pick(gen)];
+    }
+    auto const offset = [](char const* const hit, std::string_view const v) {
+        return hit == v.data() + v.size()
+                   ? std::string_view::npos
+                   : static_cast<std::size_t>(hit - v.data());
+    };
+
+    for (auto const l : all_levels) {
+        utils::simd::set_max_level(l);
+        for (std::size_t first = 0; first < 70; first += 3) {
+            for (std::size_t size = 0; first + size <= text.size();
+                 size += 1 + (size / 4)) {
+                auto const v = std::string_view{text}.substr(first, size);
+                auto const* const end = v.data() + v.size();
+                REQUIRE(offset(utils::simd::find_first_not_of(v.data(), end,
+                                                              set),
+                               v) == v.find_first_not_of(members));
+                REQUIRE(offset(utils::simd::find_last_not_of(v.data(), end,
+                                                             set),
+                               v) == v.find_last_not_of(members));
+                auto const expected = static_cast<std::size_t>(
+                    std::count_if(v.begin(), v.end(), [&](char const ch) {
+                        return members.find(ch) != std::string_view::npos;
+                    }));
+                REQUIRE(utils::simd::count(v.data(), end, set) == expected);
+
+                std::string kept{v};
+                kept.erase(std::remove_if(kept.begin(), kept.end(),
+                                          [&](char const ch) {
+                                              return members.find(ch) !=
+                                                     std::string_view::npos;
+                                          }),
+                           kept.end());
+                std::string removed{v};
+                auto* const out = utils::simd::remove(
+                    removed.data(), removed.data() + removed.size(), set);
+                removed.resize(static_cast<std::size_t>(out - removed.data()));
+                REQUIRE(removed == kept);
+            }
+        }
+        // Long enough to fold the byte counters more than once.
+        std::string const padding(20000, '\t');
+        REQUIRE(utils::simd::count(padding.data(),
+                                   padding.data() + padding.size(),
+                                   set) == padding.size());
+    }
+}
+
+TEST_CASE("Simd - find matches string_view::find at every level")
+{
+    level_guard const guard;
+    std::string text(200, 'a');
+    text += "needle";
+    text += std::string(50, 'b');
+    text += "nee";
+
+    for (auto const l : all_levels) {
+        utils::simd::set_max_level(l);
+        for (std::string_view const needle :
+             {"needle", "ab", "ba", "e", "bnee", "needles", "aaaaaaaaaaaaa"}) {
+            auto const* const hit = utils::simd::find(
+                text.data(), text.data() + text.size(), needle.data(),
+                needle.size());
+            auto const got = hit == text.data() + text.size()
+                                 ? std::string::npos
+                                 : static_cast<std::size_t>(hit - text.data());
+            REQUIRE(got == text.find(needle));
+        }
+    }
+}
+
+TEST_CASE("Simd - ASCII case conversion matches the scalar reference")
+{
+    level_guard const guard;
+    auto const text = random_text(300, 11);
+    auto expected_lower = text;
+    auto expected_upper = text;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        auto const c = static_cast<unsigned char>(text[i]);
+        if (c >= 'A' && c <= 'Z') {
+            expected_lower[i] = static_cast<char>(c + 32);
+        }
+        if (c >= 'a' && c <= 'z') {
+            expected_upper[i] = static_cast<char>(c - 32);
+        }
+    }
+
+    for (auto const l : all_levels) {
+        utils::simd::set_max_level(l);
+        for (std::size_t size : {0, 1, 15, 16, 17, 31, 32, 33, 100, 300}) {
+            auto lower = text.substr(0, size);
+            auto upper = text.substr(0, size);
+            utils::simd::to_lower_ascii(lower.data(), lower.size());
+            utils::simd::to_upper_ascii(upper.data(), upper.size());
+            REQUIRE(lower == expected_lower.substr(0, size));
+            REQUIRE(upper == expected_upper.substr(0, size));
+            REQUIRE(utils::simd::equal_icase(lower.data(), upper.data(), size));
+        }
+    }
+}
+
+TEST_CASE("Simd - equal_icase and find_icase only fold ASCII letters")
+{
+    level_guard const guard;
+    // '@' and '`', '[' and '{' differ only in the case bit but are not letters.
+    std::string const a = std::string(40, 'x') + "Hello@[World]\xC4";
+    std::string const b = std::string(40, 'X') + "hELLO@[wORLD]\xC4";
+    std::string const c = std::string(40, 'X') + "hELLO`{wORLD]\xE4";
+
+    for (auto const l : all_levels) {
+        utils::simd::set_max_level(l);
+        REQUIRE(utils::simd::equal_icase(a.data(), b.data(), a.size()));
+        for (std::size_t i = 40; i < a.size(); ++i) {
+            REQUIRE(utils::simd::equal_icase(a.data(), c.data(), i + 1) ==
+                    (i < 45));
+        }
+
+        auto const text =
+            std::string(70, '.') + "xNeEdLeX" + std::string(9, '.');
+        auto const find = [&](std::string_view const needle) {
+            auto const* const hit = utils::simd::find_icase(
+                text.data(), text.data() + text.size(), needle.data(),
+                needle.size());
+            return hit == text.data() + text.size()
+                       ? std::string::npos
+                       : static_cast<std::size_t>(hit - text.data());
+        };
+        REQUIRE(find("needle") == 71);
+        REQUIRE(find("XNEEDLEX") == 70);
+        REQUIRE(find("E") == 72);
+        REQUIRE(find("needle.x") == std::string::npos);
+        REQUIRE(find("") == 0);
+    }
+}
+
+TEST_CASE("Simd - SWAR digit parsing")
+{
+    REQUIRE(utils::simd::parse_eight_digits("00000000") == 0);
+    REQUIRE(utils::simd::parse_eight_digits("12345678") == 12345678);
+    REQUIRE(utils::simd::parse_eight_digits("99999999") == 99999999);
+    REQUIRE(utils::simd::parse_sixteen_digits("1234567890123456") ==
+            1234567890123456ULL);
+
+    auto const parse = [](std::string_view const text) {
+        std::uint64_t value = 0;
+        auto const* const stop = utils::simd::parse_digits(
+            text.data(), text.data() + text.size(), value);
+        return std::make_pair(value,
+                              static_cast<std::size_t>(stop - text.data()));
+    };
+    REQUIRE(parse("") == std::make_pair(std::uint64_t{0}, std::size_t{0}));
+    REQUIRE(parse("x1") == std::make_pair(std::uint64_t{0}, std::size_t{0}));
+    REQUIRE(parse("7") == std::make_pair(std::uint64_t{7}, std::size_t{1}));
+    REQUIRE(parse("/:09") == std::make_pair(std::uint64_t{0}, std::size_t{0}));
+    REQUIRE(parse("42,17") ==
+            std::make_pair(std::uint64_t{42}, std::size_t{2}));
+    // Stops after 19 digits; the caller handles the rest of the run.
+    REQUIRE(parse("9999999999999999999") ==
+            std::make_pair(std::uint64_t{9999999999999999999ULL},
+                           std::size_t{19}));
+    REQUIRE(parse("12345678901234567890") ==
+            std::make_pair(std::uint64_t{1234567890123456789ULL},
+                           std::size_t{19}));
+
+    // Every run length and every stop character, at every offset in a word.
+    std::string const digits = "3141592653589793238";
+    for (std::size_t n = 0; n <= digits.size(); ++n) {
+        for (int stop = 0; stop < 256; ++stop) {
+            if (stop >= '0' && stop <= '9') {
+                continue;
+            }
+            auto const text = digits.substr(0, n) + static_cast<char>(stop) +
+                              "123";
+            std::uint64_t expected = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                expected = (expected * 10) +
+                           static_cast<std::uint64_t>(digits[i] - '0');
+            }
+            REQUIRE(parse(text) == std::make_pair(expected, n));
+        }
+    }
+}
+
+TEST_CASE("Simd - parse_digits_exact checks every byte of the field")
+{
+    std::string const digits = "31415926535897932384";
+    for (std::size_t n = 0; n <= digits.size(); ++n) {
+        auto field = digits.substr(0, n);
+        std::uint64_t value = 7;
+        auto const ok =
+            utils::simd::parse_digits_exact(field.data(), n, value);
+        REQUIRE(ok == (n >= 1 && n <= 19));
+        if (ok) {
+            REQUIRE(value == std::stoull(field));
+        } else {
+            REQUIRE(value == 7);
+        }
+        for (std::size_t bad = 0; bad < n; ++bad) {
+            for (char const ch : {'/', ':', ' ', '\0', '\xB0'}) {
+                auto broken = field;
+                broken[bad] = ch;
+                REQUIRE_FALSE(
+                    utils::simd::parse_digits_exact(broken.data(), n, value));
+            }
+        }
+    }
+}
+
+TEST_CASE("Simd - match_block64 and count match the scalar reference")
+{
+    level_guard const guard;
+    auto text = random_text(1000, 21);
+    for (std::size_t i = 0; i < text.size(); i += 3) {
+        text[i] = ',';
+    }
+    for (auto const l : all_levels) {
+        utils::simd::set_max_level(l);
+        for (std::size_t offset = 0; offset + 64 <= text.size();
+             offset += 37) {
+            auto const masks = utils::simd::match_block64(text.data() + offset,
+                                                          ',', '"', '\n');
+            for (std::size_t i = 0; i < 64; ++i) {
+                auto const ch = text[offset + i];
+                REQUIRE(((masks.a >> i) & 1U) == (ch == ',' ? 1U : 0U));
+                REQUIRE(((masks.b >> i) & 1U) == (ch == '"' ? 1U : 0U));
+                REQUIRE(((masks.c >> i) & 1U) == (ch == '\n' ? 1U : 0U));
+            }
+        }
+        for (std::size_t size : {0, 1, 15, 16, 31, 32, 33, 100, 1000}) {
+            for (char const ch : {',', '"', '\xFF'}) {
+                auto const expected = static_cast<std::size_t>(
+                    std::count(text.begin(), text.begin() + size, ch));
+                REQUIRE(utils::simd::count(text.data(), text.data() + size,
+                                           ch) == expected);
+            }
+        }
+    }
+
+    // Long enough to fold the byte counters more than once.
+    std::string const commas(20000, ',');
+    for (auto const l : all_levels) {
+        utils::simd::set_max_level(l);
+        REQUIRE(utils::simd::count(commas.data(),
+                                   commas.data() + commas.size(),
+                                   ',') == commas.size());
+    }
+}
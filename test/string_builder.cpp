@@ -0,0 +1,103 @@
+#include <libutils/string_builder.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/uio.h>
+#endif
+
+TEST_CASE("StringBuilder - appends span chunks and read back in order")
+{
+    // Tiny chunks so every append crosses a boundary.
+    utils::strings::string_builder out(4);
+    REQUIRE(out.empty());
+    REQUIRE(out.to_string().empty());
+    REQUIRE(out.chunk_count() == 0);
+
+    out.append("hello").push_back(',');
+    out += ' ';
+    out.append(3, '-').append(std::string_view{});
+    out += "world";
+    utils::strings::append_number(out, -1234);
+    std::string const expected = "hello, ---world-1234";
+    REQUIRE(out.size() == expected.size());
+    REQUIRE(out.chunk_count() == 5);
+    REQUIRE(out.to_string() == expected);
+
+    // Every chunk but the last is full.
+    std::vector<std::string_view> chunks;
+    out.for_each_chunk([&chunks](std::string_view const chunk) {
+        chunks.push_back(chunk);
+    });
+    REQUIRE(chunks.size() == 5);
+    for (std::size_t i = 0; i + 1 < chunks.size(); ++i) {
+        REQUIRE(chunks[i].size() == 4);
+    }
+    REQUIRE(chunks.back() == "1234");
+
+    std::ostringstream os;
+    os << out;
+    REQUIRE(os.str() == expected);
+
+#if defined(__unix__) || defined(__APPLE__)
+    auto const iov = out.iovecs();
+    REQUIRE(iov.size() == 5);
+    std::string gathered;
+    for (auto const& v : iov) {
+        gathered.append(static_cast<char const*>(v.iov_base), v.iov_len);
+    }
+    REQUIRE(gathered == expected);
+#endif
+
+    // A large append spans several chunks at once.
+    std::string const big(37, 'x');
+    out.clear();
+    REQUIRE(out.empty());
+    REQUIRE(out.chunk_count() == 1);
+    out.append(big);
+    REQUIRE(out.to_string() == big);
+    REQUIRE(out.chunk_count() == 10);
+
+    auto moved = std::move(out);
+    REQUIRE(moved.to_string() == big);
+    REQUIRE(out.empty()); // NOLINT(bugprone-use-after-move)
+    out.append("again");
+    REQUIRE(out.to_string() == "again");
+}
+
+TEST_CASE("StringBuilder - formatting helpers and pooled chunks")
+{
+    utils::strings::chunk_pool pool(8, 2);
+    {
+        utils::strings::string_builder out(pool);
+        REQUIRE(out.chunk_size() == 8);
+        std::vector<std::string> const names{"a", "bb", "ccc"};
+        utils::strings::join_into(out, names, ", ");
+        out += '|';
+        std::vector<int> const numbers{1, -2, 30};
+        utils::strings::join_into(out, numbers, ",");
+        out += '|';
+        utils::strings::pad_left_into(out, "7", 3, '0');
+        utils::strings::pad_right_into(out, "ab", 4, '.');
+        utils::strings::pad_left_into(out, "long", 2);
+        REQUIRE(out.to_string() == "a, bb, ccc|1,-2,30|007ab..long");
+        REQUIRE(out.chunk_count() == 4);
+    }
+    // The chunks went back to the pool, up to its limit of two...
+    REQUIRE(pool.free_chunks() == 2);
+    {
+        // ...and the next builder takes them before allocating.
+        utils::strings::string_builder out(pool);
+        out.append(std::string(12, 'y'));
+        REQUIRE(pool.free_chunks() == 0);
+        out.clear();
+        REQUIRE(pool.free_chunks() == 1);
+    }
+    REQUIRE(pool.free_chunks() == 2);
+}
@@ -1,12 +1,29 @@
+#include <libutils/bytes.hpp>
+#include <libutils/functional.hpp>
+#include <libutils/simd.hpp>
 #include <libutils/strings.hpp>
 
+#include <algorithm>
+#include <array>
 #include <catch2/catch_test_macros.hpp>
+#include <charconv>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
+#include <locale>
+#include <memory>
+#include <ostream>
+#include <random>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <vector>
 
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
 TEST_CASE("Strings - to_string")
 {
     REQUIRE(utils::strings::to_string(42) == "42");
@@ -75,6 +92,71 @@ TEST_CASE("Strings - remove")
             "helloworld");
 }
 
+TEST_CASE("Strings - char_class scans, trims, splits and removes")
+{
+    namespace s = utils::strings;
+    constexpr s::char_class digits{"0123456789"};
+    static_assert(digits.contains('7') && !digits.contains('a'));
+
+    REQUIRE(s::find_first_in("ab12c3", digits) == 2);
+    REQUIRE(s::find_first_in("ab12c3", digits, 4) == 5);
+    REQUIRE(s::find_first_in("abc", digits) == std::string_view::npos);
+    REQUIRE(s::find_first_not_in("12a3", digits) == 2);
+    REQUIRE(s::find_first_not_in("123", digits, 1) == std::string_view::npos);
+    REQUIRE(s::find_last_not_in("a12", digits) == 0);
+    REQUIRE(s::find_last_not_in("", digits) == std::string_view::npos);
+    REQUIRE(s::count_in("a1b22c333", digits) == 6);
+
+    REQUIRE(s::trim_view("  token \t\n") == "token");
+    REQUIRE(s::trim_view("token") == "token");
+    REQUIRE(s::trim_view(" \r\n").empty());
+    REQUIRE(s::trimleft_view("007", s::char_class{"0"}) == "7");
+    REQUIRE(s::trimright_view("1.500", s::char_class{"0"}) == "1.5");
+
+    REQUIRE(s::split_view("a1b22c", digits) ==
+            std::vector<std::string_view>{"a", "b", "c"});
+    REQUIRE(s::split_view("1a22", digits, true) ==
+            std::vector<std::string_view>{"", "a", "", ""});
+    REQUIRE(s::remove(std::string{"a1b22c333"}, digits) == "abc");
+    REQUIRE(s::remove(std::string{"123"}, digits).empty());
+
+    // Long padding around short tokens, at every level: the trims must agree
+    // with the std::string_view formulation whatever the block alignment.
+    std::string_view const pad{" \t\n\r\v\f"};
+    std::mt19937 gen{17};
+    std::uniform_int_distribution<std::size_t> pick{0, pad.size() - 1};
+    std::uniform_int_distribution<std::size_t> length{0, 80};
+    for (int iteration = 0; iteration < 300; ++iteration) {
+        std::string text;
+        for (auto n = length(gen); n > 0; --n) {
+            text += pad[pick(gen)];
+        }
+        text += iteration % 5 == 0 ? "" : "to ken";
+        for (auto n = length(gen); n > 0; --n) {
+            text += pad[pick(gen)];
+        }
+        auto const first = text.find_first_not_of(pad);
+        auto const expected =
+            first == std::string::npos
+                ? std::string{}
+                : text.substr(first, text.find_last_not_of(pad) - first + 1);
+        for (auto const l :
+             {utils::simd::level::scalar, utils::simd::level::sse4_2,
+              utils::simd::level::avx2}) {
+            utils::simd::set_max_level(l);
+            CAPTURE(text);
+            REQUIRE(s::trim_view(text) == expected);
+            REQUIRE(s::trim<char>(text) == expected);
+            REQUIRE(s::trim<char>(text, std::string{pad}) == expected);
+            auto copy = text;
+            s::mutable_version::trim(copy);
+            REQUIRE(copy == expected);
+            REQUIRE(s::remove<char>(text, ' ').find(' ') == std::string::npos);
+        }
+    }
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
 TEST_CASE("Strings - join")
 {
     std::vector<std::string> v{"a", "b", "c"};
@@ -143,6 +225,122 @@ TEST_CASE("Strings - to_integral")
                       std::invalid_argument);
 }
 
+TEST_CASE("Strings - try_to_integral reports the error kind and offset")
+{
+    using utils::strings::parse_status;
+    using utils::strings::try_to_integral;
+
+    auto const ok = try_to_integral<int>("-42");
+    REQUIRE(ok);
+    REQUIRE(*ok == -42);
+    REQUIRE(ok.offset == 3);
+
+    auto const check = [](utils::strings::parse_result<int> const& r,
+                          parse_status const status,
+                          std::size_t const offset) {
+        REQUIRE(r.error() == status);
+        REQUIRE(r.offset == offset);
+        REQUIRE(r.value == 0);
+        REQUIRE(r.value_or(-1) == -1);
+    };
+    check(try_to_integral<int>(""), parse_status::empty, 0);
+    check(try_to_integral<int>("abc"), parse_status::invalid_character, 0);
+    check(try_to_integral<int>("-"), parse_status::invalid_character, 0);
+    check(try_to_integral<int>("+1"), parse_status::invalid_character, 0);
+    check(try_to_integral<int>(" 1"), parse_status::invalid_character, 0);
+    check(try_to_integral<int>("123abc"), parse_status::invalid_character, 3);
+    check(try_to_integral<int>("12 34"), parse_status::invalid_character, 2);
+    check(try_to_integral<int>("99999999999"), parse_status::out_of_range,
+          11);
+    check(try_to_integral<int>("99999999999x"), parse_status::out_of_range,
+          11);
+
+    auto const unsigned_minus = try_to_integral<unsigned>("-1");
+    REQUIRE(unsigned_minus.error() == parse_status::invalid_character);
+}
+
+TEST_CASE("Strings - try_to_integral bases, whitespace and partial input")
+{
+    using utils::strings::parse_options;
+    using utils::strings::parse_status;
+    using utils::strings::try_to_integral;
+
+    REQUIRE(*try_to_integral<int>("ff", 16) == 255);
+    REQUIRE(*try_to_integral<int>("-101", 2) == -5);
+    REQUIRE(*try_to_integral<std::uint8_t>("zz", 36) == 0);
+    REQUIRE(try_to_integral<std::uint8_t>("100", 16).error() ==
+            parse_status::out_of_range);
+    REQUIRE(try_to_integral<int>("0x1f", 16).error() ==
+            parse_status::invalid_character);
+    REQUIRE(try_to_integral<int>("12", 2).offset == 1);
+    REQUIRE_THROWS_AS(try_to_integral<int>("1", 1), std::invalid_argument);
+    REQUIRE_THROWS_AS(try_to_integral<int>("1", 37), std::invalid_argument);
+
+    parse_options skip;
+    skip.skip_whitespace = true;
+    REQUIRE(*try_to_integral<int>(" \t\n7", 10, skip) == 7);
+    REQUIRE(try_to_integral<int>("  ", 10, skip).error() ==
+            parse_status::empty);
+    REQUIRE(try_to_integral<int>("  ", 10, skip).offset == 2);
+    // Only leading whitespace is skipped.
+    REQUIRE(try_to_integral<int>(" 7 ", 10, skip).offset == 2);
+    REQUIRE_FALSE(try_to_integral<int>(" 7 ", 10, skip));
+
+    parse_options partial;
+    partial.partial = true;
+    auto const prefix = try_to_integral<int>("1234ms", 10, partial);
+    REQUIRE(prefix);
+    REQUIRE(*prefix == 1234);
+    REQUIRE(prefix.offset == 4);
+    REQUIRE(try_to_integral<int>("ms", 10, partial).error() ==
+            parse_status::invalid_character);
+
+    // Walk a list of numbers by offset.
+    std::string_view rest = "  10, 20,30";
+    std::vector<int> values;
+    parse_options walk;
+    walk.skip_whitespace = true;
+    walk.partial = true;
+    for (;;) {
+        auto const r = try_to_integral<int>(rest, 10, walk);
+        REQUIRE(r);
+        values.push_back(*r);
+        if (r.offset == rest.size()) {
+            break;
+        }
+        rest.remove_prefix(r.offset + 1);
+    }
+    REQUIRE(values == std::vector<int>{10, 20, 30});
+}
+
+#if defined(__cpp_lib_to_chars)
+TEST_CASE("Strings - try_to_floating")
+{
+    using utils::strings::parse_options;
+    using utils::strings::parse_status;
+    using utils::strings::try_to_floating;
+
+    REQUIRE(*try_to_floating<double>("2.5") == 2.5);
+    REQUIRE(try_to_floating<double>("").error() == parse_status::empty);
+    REQUIRE(try_to_floating<double>("2.5x").error() ==
+            parse_status::invalid_character);
+    REQUIRE(try_to_floating<double>("2.5x").offset == 3);
+    REQUIRE(try_to_floating<float>("1e999").error() ==
+            parse_status::out_of_range);
+
+    parse_options options;
+    options.skip_whitespace = true;
+    options.partial = true;
+    auto const r = try_to_floating<double>("\t-0.125 s", options);
+    REQUIRE(*r == -0.125);
+    REQUIRE(r.offset == 7);
+
+    REQUIRE(utils::strings::to_floating<double>("0.5") == 0.5);
+    REQUIRE_THROWS_AS(utils::strings::to_floating<double>("0.5 "),
+                      std::invalid_argument);
+}
+#endif
+
 TEST_CASE("Strings - split_view (non-owning)")
 {
     std::string const text = "a,b;c";
@@ -427,3 +625,1687 @@ TEST_CASE("Strings - generic over wchar_t (no locale paths)")
     std::vector<std::wstring> v{L"x", L"y", L"z"};
     REQUIRE(utils::strings::join<wchar_t>(v, L',') == L"x,y,z");
 }
+
+TEST_CASE("Strings - split_view vector and scalar paths agree")
+{
+    // Long enough to exercise the 16/32-byte kernels plus a ragged tail, with
+    // delimiters at block boundaries and runs of empty fields.
+    std::string text;
+    for (int i = 0; i < 40; ++i) {
+        text += "field" + std::to_string(i);
+        text += (i % 3 == 0) ? ",," : (i % 3 == 1) ? "\t" : " ";
+    }
+    text += "tail";
+
+    for (bool const keep_empty : {false, true}) {
+        utils::simd::set_max_level(utils::simd::level::scalar);
+        auto const scalar =
+            utils::strings::split_view<char>(text, " \t,", keep_empty);
+        auto const scalar_on =
+            utils::strings::split_on_view<char>(text, ",,", keep_empty);
+        utils::simd::set_max_level(utils::simd::level::avx2);
+        auto const vector =
+            utils::strings::split_view<char>(text, " \t,", keep_empty);
+        auto const vector_on =
+            utils::strings::split_on_view<char>(text, ",,", keep_empty);
+        REQUIRE(scalar == vector);
+        REQUIRE(scalar_on == vector_on);
+        REQUIRE(vector.back() == "tail");
+    }
+}
+
+TEST_CASE("Strings - split_lazy yields the same tokens as split_view")
+{
+    for (std::string_view const text :
+         {"", ",", "a", ",a,,b,", "a,b;c", ",,,", "no delimiters here"}) {
+        for (bool const keep_empty : {false, true}) {
+            std::vector<std::string_view> lazy;
+            for (auto const token :
+                 utils::strings::split_lazy<char>(text, ",;", keep_empty)) {
+                lazy.push_back(token);
+            }
+            REQUIRE(lazy ==
+                    utils::strings::split_view<char>(text, ",;", keep_empty));
+
+            std::vector<std::string_view> lazy_on;
+            for (auto const token : utils::strings::split_on_lazy<char>(
+                     text, std::string_view{",,"}, keep_empty)) {
+                lazy_on.push_back(token);
+            }
+            REQUIRE(lazy_on == utils::strings::split_on_view<char>(
+                                   text, std::string_view{",,"}, keep_empty));
+        }
+    }
+}
+
+TEST_CASE("Strings - split_lazy supports early exit and multi-pass")
+{
+    std::string const text = "alpha beta gamma delta";
+    auto const range = utils::strings::split_lazy<char>(text, ' ');
+
+    auto const it = std::find(range.begin(), range.end(), "gamma");
+    REQUIRE(it != range.end());
+    REQUIRE(it->data() == text.data() + 11);
+    REQUIRE(*std::next(it) == "delta");
+
+    // Iterators are independent copies: walking one leaves the other alone.
+    auto first = range.begin();
+    auto second = first;
+    ++first;
+    REQUIRE(*second == "alpha");
+    REQUIRE(*first == "beta");
+    REQUIRE(std::distance(range.begin(), range.end()) == 4);
+
+    // Generic (non-char) delimiter sets take the find_first_of path.
+    auto const wide = utils::strings::split_lazy<wchar_t>(
+        std::wstring_view{L"x;y,z"}, std::wstring_view{L",;"});
+    REQUIRE(std::distance(wide.begin(), wide.end()) == 3);
+    REQUIRE(*std::next(wide.begin(), 2) == L"z");
+}
+
+TEST_CASE("Strings - split_lazy composes with functional transducers")
+{
+    using namespace utils::functional;
+    auto const range =
+        utils::strings::split_lazy<char>(std::string_view{"a,bb,,ccc,dd"}, ',');
+
+    // Total length of tokens longer than one character.
+    auto const longer_than_one = [](std::string_view const t) {
+        return t.size() > 1;
+    };
+    auto const length = [](std::string_view const t) {
+        return t.size();
+    };
+    auto const sum = [](std::size_t const acc, std::size_t const n) {
+        return acc + n;
+    };
+    auto const total = foldl(concat(filter(longer_than_one), map(length))(sum),
+                             range, std::size_t{0});
+    REQUIRE(total == 7);
+}
+
+TEST_CASE("Strings - split_on_lazy with an empty delimiter")
+{
+    std::vector<std::string_view> tokens;
+    for (auto const token : utils::strings::split_on_lazy<char>(
+             std::string_view{""}, std::string_view{""})) {
+        tokens.push_back(token);
+    }
+    REQUIRE(tokens.size() == 1);
+    REQUIRE(tokens[0].empty());
+}
+
+namespace
+{
+// Feed `text` to `tokenizer` in chunks of `chunk_size` and collect the tokens.
+template <typename Tokenizer>
+std::vector<std::string> stream_tokens(Tokenizer tokenizer,
+                                       std::string_view const text,
+                                       std::size_t const chunk_size)
+{
+    std::vector<std::string> tokens;
+    auto const collect = [&](std::string_view const token) {
+        tokens.emplace_back(token);
+    };
+    for (std::size_t pos = 0; pos < text.size(); pos += chunk_size) {
+        tokenizer.feed(text.substr(pos, chunk_size), collect);
+    }
+    tokenizer.finish(collect);
+    return tokens;
+}
+} // namespace
+
+TEST_CASE("Strings - stream_tokenizer matches split across chunk sizes")
+{
+    for (std::string_view const text :
+         {"", ",", "a", "a,b,,c", ",lead,,trail,", "a->b-->c->->d-", "->",
+          "x->", "--->>->"}) {
+        for (bool const keep_empty : {false, true}) {
+            auto const by_set =
+                utils::strings::split<char>(text, ",>", keep_empty);
+            auto const by_seq = utils::strings::split_on<char>(
+                text, std::string_view{"->"}, keep_empty);
+            for (std::size_t chunk = 1; chunk <= text.size() + 1; ++chunk) {
+                REQUIRE(stream_tokens(
+                            utils::strings::make_stream_tokenizer<char>(
+                                ",>", keep_empty),
+                            text, chunk) == by_set);
+                REQUIRE(stream_tokens(
+                            utils::strings::make_stream_tokenizer_on<char>(
+                                std::string_view{"->"}, keep_empty),
+                            text, chunk) == by_seq);
+            }
+        }
+    }
+}
+
+TEST_CASE("Strings - stream_tokenizer emits views into the chunk")
+{
+    auto tokenizer = utils::strings::make_stream_tokenizer<char>('\n');
+    std::string const first = "one\ntwo\nthr";
+    std::string const second = "ee\nfour";
+    std::vector<std::string> tokens;
+    bool first_is_view = false;
+
+    tokenizer.feed(first, [&](std::string_view const token) {
+        if (tokens.empty()) {
+            first_is_view = token.data() == first.data();
+        }
+        tokens.emplace_back(token);
+    });
+    REQUIRE(first_is_view);
+    REQUIRE(tokens == std::vector<std::string>{"one", "two"});
+
+    // "thr" + "ee" straddles the boundary and comes from the carry buffer.
+    tokenizer.feed(second, [&](std::string_view const token) {
+        tokens.emplace_back(token);
+    });
+    tokenizer.finish([&](std::string_view const token) {
+        tokens.emplace_back(token);
+    });
+    REQUIRE(tokens ==
+            std::vector<std::string>{"one", "two", "three", "four"});
+}
+
+TEST_CASE("Strings - stream_tokenizer_on with an empty delimiter")
+{
+    auto const tokens = stream_tokens(
+        utils::strings::make_stream_tokenizer_on<char>(std::string_view{""}),
+        std::string_view{"abc"}, 2);
+    REQUIRE(tokens == std::vector<std::string>{"abc"});
+}
+
+TEST_CASE("Strings - to_hex vector and table paths agree")
+{
+    std::string bytes;
+    for (int i = 0; i < 300; ++i) {
+        bytes += static_cast<char>((i * 37) & 0xFF);
+    }
+
+    for (std::size_t size : {0, 1, 15, 16, 17, 31, 32, 33, 64, 100, 300}) {
+        auto const input = std::string_view{bytes}.substr(0, size);
+        utils::simd::set_max_level(utils::simd::level::scalar);
+        auto const upper = utils::strings::to_hex<char>(input);
+        auto const lower = utils::strings::to_hex<char>(input, false);
+        utils::simd::set_max_level(utils::simd::level::avx2);
+        REQUIRE(utils::strings::to_hex<char>(input) == upper);
+        REQUIRE(utils::strings::to_hex<char>(input, false) == lower);
+        REQUIRE(upper.size() == utils::strings::hex_size(size));
+        // The iterator overload takes the generic table path.
+        REQUIRE(utils::strings::to_hex<char>(input.begin(), input.end()) ==
+                upper);
+    }
+}
+
+TEST_CASE("Strings - to_hex_into writes into caller buffers")
+{
+    std::string_view const text{"\x01\xAB\xff"};
+    auto const bytes = utils::bytes::byte_view(text);
+
+    char buffer[16];
+    auto const written = utils::strings::to_hex_into<char>(
+        utils::span<char>(buffer, sizeof(buffer)), bytes, false, true);
+    REQUIRE(std::string_view(buffer, written) == "01 ab ff");
+
+    std::string out;
+    out.reserve(64);
+    auto const* const storage = out.data();
+    utils::strings::to_hex_into<char>(out, bytes);
+    REQUIRE(out == "01ABFF");
+    REQUIRE(out.data() == storage);
+
+    std::wstring wide;
+    utils::strings::to_hex_into<wchar_t>(wide, bytes, true, true);
+    REQUIRE(wide == L"01 AB FF");
+
+    char small[5];
+    REQUIRE_THROWS_AS(utils::strings::to_hex_into<char>(
+                          utils::span<char>(small, sizeof(small)), bytes),
+                      std::out_of_range);
+}
+
+TEST_CASE("Strings - to_hex keeps wide element values")
+{
+    std::vector<int> const values{0x1, 0xAB, 0x1234};
+    REQUIRE(utils::strings::to_hex<char>(values) == "01AB1234");
+    REQUIRE(utils::strings::to_hex<char>(values, false, true) == "01 ab 1234");
+}
+
+TEST_CASE("Strings - hex_to_bytes_into decodes without throwing")
+{
+    std::vector<std::byte> out(4);
+    auto const ok =
+        utils::strings::hex_to_bytes_into<char>(out, std::string_view{"aBc"});
+    REQUIRE(ok);
+    REQUIRE(ok.written == 2);
+    REQUIRE(out[0] == std::byte{0x0A});
+    REQUIRE(out[1] == std::byte{0xBC});
+
+    auto const bad =
+        utils::strings::hex_to_bytes_into<char>(out, std::string_view{"12x4"});
+    REQUIRE(bad.status == utils::strings::hex_status::invalid_character);
+    REQUIRE(bad.error_offset == 2);
+    REQUIRE(bad.written == 1);
+
+    auto const small = utils::strings::hex_to_bytes_into<char>(
+        out, std::string_view{"0011223344"});
+    REQUIRE(small.status == utils::strings::hex_status::buffer_too_small);
+
+    std::vector<std::byte> wide_out(1);
+    REQUIRE(utils::strings::hex_to_bytes_into<wchar_t>(
+        wide_out, std::wstring_view{L"7f"}));
+    REQUIRE(wide_out[0] == std::byte{0x7F});
+    REQUIRE_FALSE(utils::strings::hex_to_bytes_into<wchar_t>(
+        wide_out, std::wstring_view{L"\u0130f"}));
+}
+
+TEST_CASE("Strings - hex_to_bytes_into vector and scalar paths agree")
+{
+    std::string bytes;
+    for (int i = 0; i < 200; ++i) {
+        bytes += static_cast<char>((i * 91) & 0xFF);
+    }
+    auto const hex = utils::strings::to_hex<char>(bytes, false);
+
+    for (auto const l :
+         {utils::simd::level::scalar, utils::simd::level::avx2}) {
+        utils::simd::set_max_level(l);
+        for (std::size_t size : {0, 1, 15, 16, 31, 32, 33, 64, 65, 399, 400}) {
+            auto const input = std::string_view{hex}.substr(0, size);
+            std::vector<std::byte> out(utils::strings::hex_decoded_size(size));
+            auto const result =
+                utils::strings::hex_to_bytes_into<char>(out, input);
+            REQUIRE(result);
+            REQUIRE(result.written == out.size());
+            REQUIRE(utils::strings::to_hex<char>(out, false) ==
+                    (size % 2 == 0 ? std::string{input}
+                                   : "0" + std::string{input}));
+        }
+
+        // An invalid character inside a vector block is found at its offset.
+        for (std::size_t bad_at : {0, 5, 17, 40, 63, 100}) {
+            auto corrupt = hex;
+            corrupt[bad_at] = 'g';
+            std::vector<std::byte> out(hex.size() / 2);
+            auto const result = utils::strings::hex_to_bytes_into<char>(
+                out, std::string_view{corrupt});
+            REQUIRE(result.status ==
+                    utils::strings::hex_status::invalid_character);
+            REQUIRE(result.error_offset == bad_at);
+            REQUIRE(result.written == bad_at / 2);
+        }
+    }
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+TEST_CASE("Strings - Base64 / Base32 match the RFC 4648 test vectors")
+{
+    namespace s = utils::strings;
+    std::string_view const inputs[] = {"",      "f",      "fo",    "foo",
+                                       "foob",  "fooba",  "foobar"};
+    std::string_view const base64[] = {"",         "Zg==",     "Zm8=",
+                                       "Zm9v",     "Zm9vYg==", "Zm9vYmE=",
+                                       "Zm9vYmFy"};
+    std::string_view const base32[] = {
+        "",         "MY======",         "MZXQ====",        "MZXW6===",
+        "MZXW6YQ=", "MZXW6YTB",         "MZXW6YTBOI======"};
+    for (std::size_t i = 0; i < std::size(inputs); ++i) {
+        auto const bytes = utils::bytes::byte_view(inputs[i]);
+        REQUIRE(s::to_base64<char>(bytes) == base64[i]);
+        REQUIRE(s::to_base32<char>(bytes) == base32[i]);
+        auto const unpadded64 = base64[i].substr(0, base64[i].find('='));
+        auto const unpadded32 = base32[i].substr(0, base32[i].find('='));
+        REQUIRE(s::to_base64<char>(bytes, s::base64_alphabet::standard,
+                                   false) == unpadded64);
+        REQUIRE(s::to_base32<char>(bytes, false) == unpadded32);
+        REQUIRE(s::base64_size(inputs[i].size()) == base64[i].size());
+        REQUIRE(s::base32_size(inputs[i].size(), false) == unpadded32.size());
+
+        for (auto const text : {base64[i], unpadded64}) {
+            auto const decoded = s::base64_to_bytes<char>(text);
+            REQUIRE(utils::bytes::to_string_view(decoded) == inputs[i]);
+        }
+        for (auto const text : {base32[i], unpadded32}) {
+            auto const decoded = s::base32_to_bytes<char>(text);
+            REQUIRE(utils::bytes::to_string_view(decoded) == inputs[i]);
+        }
+    }
+
+    // The alphabets differ in their last two characters.
+    auto const bytes = utils::bytes::byte_view("\xFB\xFF");
+    REQUIRE(s::to_base64<char>(bytes) == "+/8=");
+    REQUIRE(s::to_base64<char>(bytes, s::base64_alphabet::url, false) ==
+            "-_8");
+    REQUIRE(s::to_base64<wchar_t>(bytes) == L"+/8=");
+    REQUIRE(utils::bytes::to_string_view(s::base64_to_bytes<char>(
+                "-_8", s::base64_alphabet::url)) == "\xFB\xFF");
+    REQUIRE_THROWS_AS(s::base64_to_bytes<char>("-_8"), std::invalid_argument);
+}
+
+TEST_CASE("Strings - Base64 / Base32 round-trip at every level")
+{
+    namespace s = utils::strings;
+    std::mt19937 gen{16};
+    std::uniform_int_distribution<int> byte{0, 255};
+    std::string bytes(1000, '\0');
+    for (auto& ch : bytes) {
+        ch = static_cast<char>(byte(gen));
+    }
+
+    for (std::size_t size = 0; size < 200; size += 1 + size / 16) {
+        auto const input =
+            utils::bytes::byte_view(std::string_view{bytes}.substr(0, size));
+        for (bool const padding : {true, false}) {
+            utils::simd::set_max_level(utils::simd::level::scalar);
+            auto const b64 =
+                s::to_base64<char>(input, s::base64_alphabet::url, padding);
+            auto const b32 = s::to_base32<char>(input, padding);
+            for (auto const l :
+                 {utils::simd::level::scalar, utils::simd::level::sse4_2,
+                  utils::simd::level::avx2}) {
+                utils::simd::set_max_level(l);
+                // Exactly sized buffers: the kernels must not write past them.
+                std::vector<char> chars(b64.size());
+                REQUIRE(s::to_base64_into<char>(chars, input,
+                                                s::base64_alphabet::url,
+                                                padding) == b64.size());
+                REQUIRE(std::string_view(chars.data(), chars.size()) == b64);
+                chars.resize(b32.size());
+                REQUIRE(s::to_base32_into<char>(chars, input, padding) ==
+                        b32.size());
+                REQUIRE(std::string_view(chars.data(), chars.size()) == b32);
+
+                std::vector<std::byte> out(size);
+                auto const r64 = s::base64_to_bytes_into<char>(
+                    out, b64, s::base64_alphabet::url);
+                REQUIRE(r64);
+                REQUIRE(r64.written == size);
+                REQUIRE(std::equal(out.begin(), out.end(), input.begin()));
+                std::fill(out.begin(), out.end(), std::byte{0});
+                auto const r32 = s::base32_to_bytes_into<char>(out, b32);
+                REQUIRE(r32);
+                REQUIRE(r32.written == size);
+                REQUIRE(std::equal(out.begin(), out.end(), input.begin()));
+            }
+        }
+    }
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+TEST_CASE("Strings - Base64 / Base32 decoding reports malformed input")
+{
+    namespace s = utils::strings;
+    std::vector<std::byte> out(600);
+    auto const b64 = [&](std::string_view const text) {
+        return s::base64_to_bytes_into<char>(out, text);
+    };
+    auto const b32 = [&](std::string_view const text) {
+        return s::base32_to_bytes_into<char>(out, text);
+    };
+
+    // Padding must complete the last group exactly.
+    REQUIRE(b64("Zg==").written == 1);
+    REQUIRE(b64("Zg=").status == s::codec_status::invalid_length);
+    REQUIRE(b64("Zm8==").status == s::codec_status::invalid_length);
+    REQUIRE(b64("Zg===").status == s::codec_status::invalid_length);
+    REQUIRE(b64("Z").status == s::codec_status::invalid_length);
+    REQUIRE(b64("Zm9vY").error_offset == 4);
+    REQUIRE(b32("MY=====").status == s::codec_status::invalid_length);
+    REQUIRE(b32("MZX").status == s::codec_status::invalid_length);
+    REQUIRE(b32("MZXW6Y").status == s::codec_status::invalid_length);
+
+    // Non-zero unused bits would give a second encoding of the same bytes.
+    REQUIRE(b64("Zh==").status == s::codec_status::invalid_character);
+    REQUIRE(b64("Zh==").error_offset == 1);
+    REQUIRE(b32("MZ======").status == s::codec_status::invalid_character);
+
+    // Whitespace and the other alphabet's symbols are rejected.
+    auto const space = b64("Zm9v Yg=");
+    REQUIRE(space.status == s::codec_status::invalid_character);
+    REQUIRE(space.error_offset == 4);
+    REQUIRE(space.written == 3);
+    REQUIRE_FALSE(b64("Zm-v"));
+    REQUIRE(b32("mzxw6ytb").error_offset == 0);
+    REQUIRE(b32("MZXW6YT1").error_offset == 7);
+
+    std::vector<std::byte> small(2);
+    REQUIRE(s::base64_to_bytes_into<char>(small, std::string_view{"Zm9v"})
+                .status == s::codec_status::buffer_too_small);
+    REQUIRE(s::base64_to_bytes_into<char>(small, std::string_view{"Zm8="}));
+
+    std::vector<std::byte> wide_out(2);
+    REQUIRE(
+        s::base64_to_bytes_into<wchar_t>(wide_out, std::wstring_view{L"Zm8"}));
+    REQUIRE_FALSE(
+        s::base64_to_bytes_into<wchar_t>(wide_out, std::wstring_view{L"Zİ"}));
+
+    // An invalid character inside a vector block is found at its offset.
+    std::string bytes(300, '\0');
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<char>((i * 131) & 0xFF);
+    }
+    auto const encoded64 = s::to_base64<char>(utils::bytes::byte_view(bytes));
+    auto const encoded32 = s::to_base32<char>(utils::bytes::byte_view(bytes));
+    for (auto const l : {utils::simd::level::scalar, utils::simd::level::sse4_2,
+                         utils::simd::level::avx2}) {
+        utils::simd::set_max_level(l);
+        for (std::size_t bad_at : {0, 5, 17, 40, 63, 100, 250}) {
+            auto corrupt = encoded64;
+            corrupt[bad_at] = '*';
+            auto const r64 = b64(corrupt);
+            REQUIRE(r64.status == s::codec_status::invalid_character);
+            REQUIRE(r64.error_offset == bad_at);
+            REQUIRE(r64.written == bad_at / 4 * 3);
+            corrupt = encoded32;
+            corrupt[bad_at] = '0';
+            auto const r32 = b32(corrupt);
+            REQUIRE(r32.status == s::codec_status::invalid_character);
+            REQUIRE(r32.error_offset == bad_at);
+            REQUIRE(r32.written == bad_at / 8 * 5);
+        }
+    }
+    utils::simd::set_max_level(utils::simd::level::avx2);
+
+    REQUIRE_THROWS_AS(s::base32_to_bytes<char>("MZXW6YT1"),
+                      std::invalid_argument);
+    char short_buffer[3];
+    REQUIRE_THROWS_AS(
+        s::to_base64_into<char>(utils::span<char>(short_buffer, 3),
+                                utils::bytes::byte_view("a")),
+        std::out_of_range);
+}
+
+namespace
+{
+constexpr utils::simd::level all_levels[] = {utils::simd::level::scalar,
+                                             utils::simd::level::sse4_2,
+                                             utils::simd::level::avx2};
+
+// Code points in runs of one script at a time (ASCII, Cyrillic, CJK, private
+// use, emoji), so the vector fast paths and the single-character steps
+// between them all get exercised.
+std::u32string random_code_points(std::size_t const size, unsigned const seed)
+{
+    struct script
+    {
+        char32_t first;
+        char32_t last;
+    };
+    constexpr script scripts[] = {{0x20, 0x7E},
+                                  {0x400, 0x4FF},
+                                  {0x4E00, 0x9FFF},
+                                  {0xE000, 0xFFFD},
+                                  {0x1F300, 0x1F64F}};
+    std::mt19937 gen{seed};
+    std::uniform_int_distribution<std::size_t> pick_script{0, 4};
+    std::uniform_int_distribution<std::size_t> run{1, 64};
+    std::u32string out;
+    while (out.size() < size) {
+        auto const s = scripts[pick_script(gen)];
+        std::uniform_int_distribution<std::uint32_t> pick{s.first, s.last};
+        for (auto n = run(gen); n != 0 && out.size() < size; --n) {
+            out += static_cast<char32_t>(pick(gen));
+        }
+    }
+    return out;
+}
+
+std::string reference_utf8(std::u32string_view const text)
+{
+    std::string out;
+    for (auto const cp : text) {
+        utils::strings::detail::append_utf8(out, cp);
+    }
+    return out;
+}
+
+std::u16string reference_utf16(std::u32string_view const text)
+{
+    std::u16string out;
+    for (auto const cp : text) {
+        if (cp < 0x10000) {
+            out += static_cast<char16_t>(cp);
+        } else {
+            out += static_cast<char16_t>(0xD800 + ((cp - 0x10000) >> 10U));
+            out += static_cast<char16_t>(0xDC00 + ((cp - 0x10000) & 0x3FFU));
+        }
+    }
+    return out;
+}
+
+// Offset of the first malformed sequence, one sequence at a time through the
+// case-folding decoder.
+std::size_t reference_valid_prefix(std::string_view const text)
+{
+    std::size_t i = 0;
+    while (i < text.size()) {
+        auto const unit =
+            utils::strings::detail::decode_utf8_unit(text.substr(i));
+        if ((unit.value & utils::strings::detail::raw_byte) != 0) {
+            break;
+        }
+        i += unit.size;
+    }
+    return i;
+}
+} // namespace
+
+TEST_CASE("Strings - UTF-8 validation rejects every malformed form")
+{
+    struct sample
+    {
+        std::string_view text;
+        std::size_t valid;
+    };
+    sample const samples[] = {
+        {"", 0},
+        {"ascii", 5},
+        {"\xC3\xA9\xE4\xB8\x96\xF0\x9F\x98\x80", 9},
+        {"\xC0\x80", 0},              // overlong two-byte
+        {"a\xC1\xBF", 1},             // overlong two-byte
+        {"\xE0\x9F\xBF", 0},          // overlong three-byte
+        {"\xED\xA0\x80", 0},          // surrogate
+        {"\xF0\x8F\xBF\xBF", 0},      // overlong four-byte
+        {"\xF4\x90\x80\x80", 0},      // above U+10FFFF
+        {"\xF5\x80\x80\x80", 0},      // invalid lead
+        {"\xFF", 0},                  // invalid lead
+        {"ab\x80", 2},                // stray continuation
+        {"ab\xE4\xB8", 2},            // truncated
+        {"\xE4\xB8\xAD\xAD", 3},      // one continuation too many
+        {"\xE4\xB8" "a", 0},          // continuation missing
+        {"\xF0\x9F\x98" "abc", 0},    // continuation missing
+    };
+    std::string const ascii(70, 'x');
+    std::string cjk; // 世 repeated
+    for (int i = 0; i < 30; ++i) {
+        cjk += "\xE4\xB8\x96";
+    }
+    std::string const tail = ascii + cjk;
+
+    for (auto const l : all_levels) {
+        utils::simd::set_max_level(l);
+        for (auto const& s : samples) {
+            REQUIRE(utils::strings::utf8_valid_prefix(s.text) == s.valid);
+            REQUIRE(utils::strings::is_valid_utf8(s.text) ==
+                    (s.valid == s.text.size()));
+            // The same bytes at every position of a vector block.
+            for (std::size_t pad = 0; pad <= 66; ++pad) {
+                for (auto const is_cjk : {false, true}) {
+                    auto const prefix = is_cjk ? cjk.substr(0, (pad / 3) * 3)
+                                               : ascii.substr(0, pad);
+                    auto const text = prefix + std::string{s.text} + tail;
+                    auto const expected = s.valid == s.text.size()
+                                              ? text.size()
+                                              : prefix.size() + s.valid;
+                    CAPTURE(pad);
+                    REQUIRE(utils::strings::utf8_valid_prefix(text) ==
+                            expected);
+                }
+            }
+        }
+    }
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+TEST_CASE("Strings - UTF-8 validation agrees with the scalar decoder")
+{
+    std::string_view const pieces[] = {
+        "a",    "z",    "\xC3\xA9", "\xE4\xB8\x96", "\xF0\x9F\x98\x80",
+        "\x80", "\xBF", "\xC0",     "\xE4",         "\xF0\x9F",
+        "\xED\xA0\x80", "\xF4\x90\x80\x80"};
+    std::mt19937 gen{17};
+    std::uniform_int_distribution<std::size_t> pick{0, std::size(pieces) - 1};
+    std::uniform_int_distribution<std::size_t> bad{0, 60};
+    std::uniform_int_distribution<int> length{0, 120};
+    for (int iteration = 0; iteration < 3000; ++iteration) {
+        std::string text;
+        for (auto n = length(gen); n != 0; --n) {
+            // Mostly well-formed pieces, so errors land deep in the input.
+            auto const index = pick(gen);
+            text += bad(gen) == 0 || index < 5 ? pieces[index] : pieces[0];
+        }
+        auto const expected = reference_valid_prefix(text);
+        for (auto const l : all_levels) {
+            utils::simd::set_max_level(l);
+            CAPTURE(text);
+            REQUIRE(utils::strings::utf8_valid_prefix(text) == expected);
+        }
+    }
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+TEST_CASE("Strings - UTF counts and converted sizes are exact")
+{
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        auto const utf32 = random_code_points(seed * 97, seed);
+        auto const utf8 = reference_utf8(utf32);
+        auto const utf16 = reference_utf16(utf32);
+        REQUIRE(utils::strings::utf8_size(utf16) == utf8.size());
+        REQUIRE(utils::strings::utf8_size(utf32) == utf8.size());
+        REQUIRE(utils::strings::count_code_points(utf16) == utf32.size());
+        for (auto const l : all_levels) {
+            utils::simd::set_max_level(l);
+            REQUIRE(utils::strings::count_code_points(utf8) == utf32.size());
+            REQUIRE(utils::strings::utf32_size(utf8) == utf32.size());
+            REQUIRE(utils::strings::utf16_size(utf8) == utf16.size());
+        }
+    }
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+TEST_CASE("Strings - UTF transcoding round-trips at every level")
+{
+    for (std::size_t const size :
+         {0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 100, 1000, 5000}) {
+        for (unsigned seed = 0; seed < 4; ++seed) {
+            auto const utf32 = random_code_points(size, seed);
+            auto const utf8 = reference_utf8(utf32);
+            auto const utf16 = reference_utf16(utf32);
+            for (auto const l : all_levels) {
+                utils::simd::set_max_level(l);
+                REQUIRE(utils::strings::utf8_to_utf16(utf8) == utf16);
+                REQUIRE(utils::strings::utf8_to_utf32(utf8) == utf32);
+                REQUIRE(utils::strings::utf16_to_utf8(utf16) == utf8);
+                REQUIRE(utils::strings::utf32_to_utf8(utf32) == utf8);
+            }
+        }
+    }
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+TEST_CASE("Strings - UTF *_into report malformed input and short buffers")
+{
+    char16_t utf16[8];
+    auto result = utils::strings::utf8_to_utf16_into(
+        utils::span<char16_t>(utf16, 8), "ab\xFF" "cd");
+    REQUIRE(result.status == utils::strings::utf_status::invalid_sequence);
+    REQUIRE(result.error_offset == 2);
+    REQUIRE(result.written == 2);
+    REQUIRE(std::u16string_view(utf16, 2) == u"ab");
+
+    // 世界 takes 6 bytes, 2 UTF-16 units and 2 code points.
+    std::string_view const cjk = "\xE4\xB8\x96\xE7\x95\x8C";
+    result = utils::strings::utf8_to_utf16_into(
+        utils::span<char16_t>(utf16, 1), cjk);
+    REQUIRE(result.status == utils::strings::utf_status::buffer_too_small);
+    REQUIRE(result.written == 0);
+    result = utils::strings::utf8_to_utf16_into(
+        utils::span<char16_t>(utf16, 2), cjk);
+    REQUIRE(result);
+    REQUIRE(std::u16string_view(utf16, 2) == u"\u4e16\u754c");
+
+    char32_t utf32[2];
+    REQUIRE(utils::strings::utf8_to_utf32_into(
+                utils::span<char32_t>(utf32, 2), cjk)
+                .written == 2);
+    REQUIRE(std::u32string_view(utf32, 2) == U"\u4e16\u754c");
+
+    char utf8[8];
+    REQUIRE(utils::strings::utf16_to_utf8_into(utils::span<char>(utf8, 5),
+                                               u"\u4e16\u754c")
+                .status == utils::strings::utf_status::buffer_too_small);
+    REQUIRE(utils::strings::utf32_to_utf8_into(utils::span<char>(utf8, 5),
+                                               U"\u4e16\u754c")
+                .status == utils::strings::utf_status::buffer_too_small);
+    REQUIRE(utils::strings::utf16_to_utf8_into(utils::span<char>(utf8, 6),
+                                               u"\u4e16\u754c"));
+    REQUIRE(std::string_view(utf8, 6) == cjk);
+
+    // Unpaired and reversed surrogates; surrogates and values above
+    // U+10FFFF in UTF-32.
+    std::u16string const lone{u'a', char16_t{0xD800}, u'b'};
+    std::u16string const reversed{char16_t{0xDC00}, char16_t{0xD800}};
+    std::u16string const pair{char16_t{0xD83D}, char16_t{0xDE00}};
+    REQUIRE(utils::strings::utf16_valid_prefix(lone) == 1);
+    REQUIRE(utils::strings::utf16_valid_prefix(reversed) == 0);
+    REQUIRE(utils::strings::is_valid_utf16(pair));
+    REQUIRE(utils::strings::utf16_to_utf8(pair) == "\xF0\x9F\x98\x80");
+    result = utils::strings::utf16_to_utf8_into(utils::span<char>(utf8, 8),
+                                                lone);
+    REQUIRE(result.status == utils::strings::utf_status::invalid_sequence);
+    REQUIRE(result.error_offset == 1);
+    REQUIRE(result.written == 1);
+
+    std::u32string const too_large{U'a', char32_t{0x110000}};
+    std::u32string const surrogate{char32_t{0xDFFF}};
+    REQUIRE(utils::strings::utf32_valid_prefix(too_large) == 1);
+    REQUIRE_FALSE(utils::strings::is_valid_utf32(surrogate));
+
+    REQUIRE_THROWS_AS(utils::strings::utf8_to_utf16("\xC0\x80"),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(utils::strings::utf8_to_utf32("\xE4\xB8"),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(utils::strings::utf16_to_utf8(lone),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(utils::strings::utf32_to_utf8(too_large),
+                      std::invalid_argument);
+}
+
+TEST_CASE("Strings - my_tolower / my_toupper are locale-free for ASCII")
+{
+    REQUIRE(utils::strings::my_tolower('A') == 'a');
+    REQUIRE(utils::strings::my_toupper('z') == 'Z');
+    REQUIRE(utils::strings::my_tolower('[') == '[');
+    REQUIRE(utils::strings::my_tolower('\xC4') == '\xC4');
+    REQUIRE(utils::strings::my_tolower(U'Q') == U'q');
+    REQUIRE(utils::strings::my_tolower('Q', std::locale::classic()) == 'q');
+}
+
+TEST_CASE("Strings - ignore_case overloads agree on vector and scalar paths")
+{
+    std::string lower(70, 'k');
+    lower += "content-type: text/html";
+    auto upper = utils::strings::to_upper<char>(lower);
+
+    for (auto const l :
+         {utils::simd::level::scalar, utils::simd::level::avx2}) {
+        utils::simd::set_max_level(l);
+        REQUIRE(upper == std::string(70, 'K') + "CONTENT-TYPE: TEXT/HTML");
+        REQUIRE(utils::strings::to_lower<char>(upper) == lower);
+        REQUIRE(utils::strings::equal<char>(lower, upper, true));
+        REQUIRE_FALSE(utils::strings::equal<char>(lower, upper));
+        REQUIRE(utils::strings::starts_with<char>(upper, lower.substr(0, 72),
+                                                  true));
+        REQUIRE(utils::strings::ends_with<char>(upper, "Text/Html", true));
+        REQUIRE(utils::strings::contains<char>(upper, "type: text", true));
+        REQUIRE_FALSE(utils::strings::contains<char>(upper, "type: text"));
+        REQUIRE_FALSE(
+            utils::strings::contains<char>(upper, "type: texts", true));
+    }
+    utils::simd::set_max_level(utils::simd::level::avx2);
+}
+
+TEST_CASE("Strings - fold_case applies Unicode simple case folding")
+{
+    using utils::strings::fold_case;
+    REQUIRE(fold_case(U'A') == U'a');
+    REQUIRE(fold_case(U'\u00C4') == U'\u00E4'); // Ä
+    REQUIRE(fold_case(U'\u0178') == U'\u00FF'); // Ÿ
+    REQUIRE(fold_case(U'\u0100') == U'\u0101'); // Ā
+    REQUIRE(fold_case(U'\u0101') == U'\u0101');
+    REQUIRE(fold_case(U'\u03A3') == U'\u03C3'); // Σ
+    REQUIRE(fold_case(U'\u03C2') == U'\u03C3'); // final sigma
+    REQUIRE(fold_case(U'\u0416') == U'\u0436'); // Ж
+    REQUIRE(fold_case(U'\u212A') == U'k');       // Kelvin sign
+    REQUIRE(fold_case(U'\U00010400') == U'\U00010428');
+    REQUIRE(fold_case(U'\u4E2D') == U'\u4E2D'); // 中
+    REQUIRE(fold_case(U'\u00DF') == U'\u00DF'); // ß has no simple folding
+
+    REQUIRE(utils::strings::fold_case_utf8("\xC3\x84PFEL \xCE\xA3") ==
+            "\xC3\xA4pfel \xCF\x83");
+    // Malformed bytes pass through untouched.
+    REQUIRE(utils::strings::fold_case_utf8("A\xC3(\xFF") == "a\xC3(\xFF");
+}
+
+TEST_CASE("Strings - case_folding::unicode compares UTF-8 text")
+{
+    using utils::strings::case_folding;
+    // "ÄPFEL" / "äpfel", and the Kelvin sign (3 bytes) against 'k' (1 byte).
+    std::string_view const upper = "\xC3\x84PFEL \xE2\x84\xAA";
+    std::string_view const lower = "\xC3\xA4pfel k";
+
+    REQUIRE(utils::strings::equal<char>(upper, lower, case_folding::unicode));
+    REQUIRE_FALSE(
+        utils::strings::equal<char>(upper, lower, case_folding::ascii));
+    REQUIRE_FALSE(utils::strings::equal<char>(upper, "\xC3\xA4pfel",
+                                              case_folding::unicode));
+    REQUIRE(utils::strings::starts_with<char>(upper, "\xC3\xA4p",
+                                              case_folding::unicode));
+    REQUIRE_FALSE(utils::strings::starts_with<char>(
+        "\xC3\xA4p", upper, case_folding::unicode));
+    REQUIRE(
+        utils::strings::ends_with<char>(upper, "L K", case_folding::unicode));
+    REQUIRE(
+        utils::strings::contains<char>(upper, "FEL k", case_folding::unicode));
+    REQUIRE_FALSE(
+        utils::strings::contains<char>(upper, "x", case_folding::unicode));
+
+    REQUIRE(utils::strings::equal<char32_t>(U"\u0416\u03A3", U"\u0436\u03C2",
+                                            case_folding::unicode));
+    REQUIRE(utils::strings::equal<char>("Hello", "hello", case_folding::ascii));
+    REQUIRE_FALSE(
+        utils::strings::equal<char>("Hello", "hello", case_folding::none));
+}
+
+TEST_CASE("Strings - searcher agrees with find for short and long needles")
+{
+    // Random text over a tiny alphabet so partial matches are frequent.
+    std::string text;
+    std::uint32_t seed = 1;
+    for (int i = 0; i < 3000; ++i) {
+        seed = seed * 1103515245U + 12345U;
+        text += "abAB"[(seed >> 16U) % 4];
+    }
+
+    for (auto const l :
+         {utils::simd::level::scalar, utils::simd::level::avx2}) {
+        utils::simd::set_max_level(l);
+        for (std::size_t const size : {1, 2, 7, 32, 33, 48, 90}) {
+            for (std::size_t const at : {0, 1000, 2999 - 90}) {
+                auto const needle = text.substr(at, size);
+                utils::strings::searcher<char> const exact{needle};
+                REQUIRE(exact.find(text) == text.find(needle));
+                REQUIRE(exact.find(text, at + 1) == text.find(needle, at + 1));
+
+                auto const lower = utils::strings::to_lower<char>(text);
+                auto const folded = utils::strings::to_lower<char>(needle);
+                utils::strings::searcher<char> const icase{
+                    utils::strings::to_upper<char>(needle), true};
+                REQUIRE(icase.needle() == folded);
+                REQUIRE(icase.find(text) == lower.find(folded));
+                REQUIRE(icase.find(text, at + 1) == lower.find(folded, at + 1));
+            }
+        }
+    }
+    utils::simd::set_max_level(utils::simd::level::avx2);
+
+    utils::strings::searcher<char> const empty{""};
+    REQUIRE(empty.find("abc", 2) == 2);
+    REQUIRE(empty.find("abc", 4) == utils::strings::searcher<char>::npos);
+}
+
+TEST_CASE("Strings - searcher overloads of contains / replace / split_on")
+{
+    std::string const long_key(40, '-');
+    utils::strings::searcher<char> const key{"Key"};
+    utils::strings::searcher<char> const key_icase{"Key", true};
+    utils::strings::searcher<char> const rule{long_key};
+
+    REQUIRE(utils::strings::contains<char>("a Key here", key));
+    REQUIRE_FALSE(utils::strings::contains<char>("a KEY here", key));
+    REQUIRE(utils::strings::contains<char>("a KEY here", key_icase));
+    REQUIRE(utils::strings::contains<char>("x" + long_key + "x", rule));
+    REQUIRE_FALSE(
+        utils::strings::contains<char>(std::string(39, '-') + "x", rule));
+
+    REQUIRE(utils::strings::replace_all<char>("key KEY Key", key_icase, "v") ==
+            "v v v");
+    REQUIRE(utils::strings::replace_all<char>("key KEY Key", key, "v") ==
+            "key KEY v");
+    REQUIRE(utils::strings::replace_first<char>("kEy KEY", key_icase, "v") ==
+            "v KEY");
+
+    auto const text = "a" + long_key + "b" + long_key + long_key + "c";
+    REQUIRE(utils::strings::split_on_view<char>(text, rule) ==
+            std::vector<std::string_view>{"a", "b", "c"});
+    REQUIRE(utils::strings::split_on<char>(text, rule, true) ==
+            std::vector<std::string>{"a", "b", "", "c"});
+    REQUIRE(utils::strings::split_on_view<char>(
+                "1AND2and3", utils::strings::searcher<char>{"and", true}) ==
+            std::vector<std::string_view>{"1", "2", "3"});
+    REQUIRE(utils::strings::split_on_view<char>(
+                "a,b", utils::strings::searcher<char>{""}) ==
+            std::vector<std::string_view>{"a,b"});
+}
+
+TEST_CASE("Strings - searcher over wchar_t")
+{
+    std::wstring const text = L"one TWO three two";
+    utils::strings::searcher<wchar_t> const exact{L"two"};
+    utils::strings::searcher<wchar_t> const icase{L"two", true};
+    utils::strings::searcher<wchar_t> const long_icase{
+        std::wstring(40, L'X'), true};
+
+    REQUIRE(exact.find(text) == 14);
+    REQUIRE(icase.find(text) == 4);
+    REQUIRE(icase.find(text, 5) == 14);
+    REQUIRE(long_icase.find(L"y" + std::wstring(40, L'x')) == 1);
+    REQUIRE(utils::strings::split_on_view<wchar_t>(L"aTWOb", icase) ==
+            std::vector<std::wstring_view>{L"a", L"b"});
+}
+
+TEST_CASE("Strings - multi_searcher finds every occurrence of every pattern")
+{
+    // The classic example: overlapping patterns sharing suffixes.
+    utils::strings::multi_searcher<char> const patterns{"he", "she", "his",
+                                                        "hers"};
+    auto const matches = patterns.find_all("ushers");
+    std::vector<std::pair<std::size_t, std::size_t>> got;
+    for (auto const& m : matches) {
+        got.emplace_back(m.pattern, m.offset);
+    }
+    REQUIRE(got == std::vector<std::pair<std::size_t, std::size_t>>{
+                       {1, 1}, {0, 2}, {3, 2}});
+
+    REQUIRE(utils::strings::contains_any<char>("this", patterns));
+    REQUIRE_FALSE(utils::strings::contains_any<char>("thus", patterns));
+    REQUIRE_FALSE(utils::strings::contains_any<char>("", patterns));
+    REQUIRE(patterns.pattern_count() == 4);
+    REQUIRE(patterns.pattern_size(3) == 4);
+}
+
+TEST_CASE("Strings - multi_searcher agrees with per-pattern find")
+{
+    // Enough patterns to push states past the dense rows, over a small
+    // alphabet so that failure links are exercised constantly.
+    std::vector<std::string> pattern_list;
+    std::string text;
+    std::uint32_t seed = 5;
+    auto const next = [&] {
+        seed = seed * 1103515245U + 12345U;
+        return (seed >> 16U) % 3;
+    };
+    for (int i = 0; i < 40; ++i) {
+        std::string pattern;
+        auto const size = 1 + next() + next() + next();
+        for (std::size_t j = 0; j < size; ++j) {
+            pattern += "abc"[next()];
+        }
+        pattern_list.push_back(pattern);
+    }
+    for (int i = 0; i < 500; ++i) {
+        text += "abc"[next()];
+    }
+
+    utils::strings::multi_searcher<char> const patterns{pattern_list};
+    std::vector<std::pair<std::size_t, std::size_t>> got;
+    patterns.for_each_match(text, [&](auto const m) {
+        got.emplace_back(m.offset, m.pattern);
+    });
+    std::vector<std::pair<std::size_t, std::size_t>> expected;
+    for (std::size_t id = 0; id < pattern_list.size(); ++id) {
+        // Duplicates report the lowest id only.
+        if (std::find(pattern_list.begin(), pattern_list.begin() + id,
+                      pattern_list[id]) != pattern_list.begin() + id) {
+            continue;
+        }
+        for (auto pos = text.find(pattern_list[id]); pos != std::string::npos;
+             pos = text.find(pattern_list[id], pos + 1)) {
+            expected.emplace_back(pos, id);
+        }
+    }
+    std::sort(got.begin(), got.end());
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(got == expected);
+}
+
+TEST_CASE("Strings - multi_searcher replace_all is leftmost-longest")
+{
+    utils::strings::multi_searcher<char> const patterns{"ab", "abcd", "cd",
+                                                        "bc", ""};
+    REQUIRE(utils::strings::replace_all<char>(
+                "xabcdx abx bcd", patterns,
+                std::vector<std::string_view>{"1", "2", "3", "4", "5"}) ==
+            "x2x 1x 4d");
+    REQUIRE(utils::strings::replace_all<char>("abcd-cd", patterns,
+                                              std::string_view{"*"}) ==
+            "*-*");
+    REQUIRE_THROWS_AS(utils::strings::replace_all<char>(
+                          "ab", patterns, std::vector<std::string_view>{"1"}),
+                      std::invalid_argument);
+
+    // "ab" has to wait for "abcde" to fail before it is chosen, while "cd",
+    // seen in the meantime, must still be picked up after it.
+    utils::strings::multi_searcher<char> const pending{"ab", "cd", "abcde"};
+    REQUIRE(utils::strings::replace_all<char>("abcdX abcde", pending,
+                                              std::string_view{"_"}) ==
+            "__X _");
+}
+
+TEST_CASE("Strings - multi_searcher leftmost-longest with nested patterns")
+{
+    // "a", "aa", ... 32 "a"s: every position starts 32 overlapping matches,
+    // of which the leftmost-longest choice keeps one per 32 characters.
+    std::vector<std::string> nested;
+    for (std::size_t size = 1; size <= 32; ++size) {
+        nested.emplace_back(size, 'a');
+    }
+    utils::strings::multi_searcher<char> const patterns{nested};
+    std::string const text(1000, 'a');
+    auto const matches = patterns.find_non_overlapping(text);
+    REQUIRE(matches.size() == 32);
+    for (std::size_t i = 0; i < 31; ++i) {
+        REQUIRE(matches[i].pattern == 31);
+        REQUIRE(matches[i].offset == 32 * i);
+    }
+    REQUIRE(matches.back().pattern == 7);
+    REQUIRE(matches.back().offset == 992);
+    auto const tail = text + "b" + text.substr(0, 40);
+    REQUIRE(utils::strings::replace_all<char>(tail, patterns,
+                                              std::string_view{"x"}) ==
+            std::string(32, 'x') + "bxx");
+
+    // Against the greedy choice over every match, sorted.
+    std::vector<std::string> const mixed{"a", "ab", "aba", "b", "bab", "abab"};
+    utils::strings::multi_searcher<char> const small{mixed};
+    std::string random_text;
+    std::uint32_t seed = 11;
+    for (int i = 0; i < 2000; ++i) {
+        seed = seed * 1103515245U + 12345U;
+        random_text += "abc"[(seed >> 16U) % 3];
+    }
+    auto all = small.find_all(random_text);
+    std::sort(all.begin(), all.end(), [&](auto const& a, auto const& b) {
+        return a.offset != b.offset ? a.offset < b.offset
+                                    : mixed[a.pattern].size() >
+                                          mixed[b.pattern].size();
+    });
+    std::vector<std::pair<std::size_t, std::size_t>> expected;
+    std::size_t covered = 0;
+    for (auto const& m : all) {
+        if (m.offset >= covered) {
+            expected.emplace_back(m.offset, m.pattern);
+            covered = m.offset + mixed[m.pattern].size();
+        }
+    }
+    std::vector<std::pair<std::size_t, std::size_t>> got;
+    small.for_each_non_overlapping(random_text, [&](auto const m) {
+        got.emplace_back(m.offset, m.pattern);
+    });
+    REQUIRE(got == expected);
+}
+
+TEST_CASE("Strings - multi_searcher with ignore_case and wide characters")
+{
+    utils::strings::multi_searcher<char> const secrets{
+        std::vector<std::string>{"password=", "Token:"}, true};
+    REQUIRE(utils::strings::replace_all<char>(
+                "user PASSWORD=x token:y", secrets, std::string_view{"#"}) ==
+            "user #x #y");
+
+    utils::strings::multi_searcher<wchar_t> const wide{L"中文", L"AB"};
+    auto const matches = wide.find_all(L"x中文AB中");
+    REQUIRE(matches.size() == 2);
+    REQUIRE(matches[0].pattern == 0);
+    REQUIRE(matches[0].offset == 1);
+    REQUIRE(matches[1].pattern == 1);
+    REQUIRE(matches[1].offset == 3);
+    // A byte-level match straddling two characters must not be reported.
+    utils::strings::multi_searcher<char16_t> const straddle{u"䄀"};
+    REQUIRE_FALSE(straddle.contains_any(u"AA"));
+}
+
+TEST_CASE("Strings - replace_all shrinking, equal and growing lengths")
+{
+    // Every length relation, with matches at both ends and back to back.
+    std::string const text = "--a--b----c--";
+    for (auto const l :
+         {utils::simd::level::scalar, utils::simd::level::avx2}) {
+        utils::simd::set_max_level(l);
+        REQUIRE(utils::strings::replace_all<char>(text, "--", "") == "abc");
+        REQUIRE(utils::strings::replace_all<char>(text, "--", "+") ==
+                "+a+b++c+");
+        REQUIRE(utils::strings::replace_all<char>(text, "--", "==") ==
+                "==a==b====c==");
+        REQUIRE(utils::strings::replace_all<char>(text, "--", "<-->") ==
+                "<-->a<-->b<--><-->c<-->");
+    }
+    utils::simd::set_max_level(utils::simd::level::avx2);
+
+    REQUIRE(utils::strings::replace_all<wchar_t>(std::wstring{L"a--b"}, L"--",
+                                                 L"") == L"ab");
+}
+
+TEST_CASE("Strings - mutable_version::replace_all reuses the buffer")
+{
+    std::string text(100, 'x');
+    text += "abcabc";
+    auto const* const data = text.data();
+    auto const capacity = text.capacity();
+
+    utils::strings::mutable_version::replace_all<char>(text, "abc", "XYZ");
+    REQUIRE(text == std::string(100, 'x') + "XYZXYZ");
+    utils::strings::mutable_version::replace_all<char>(text, "XYZ", "-");
+    REQUIRE(text == std::string(100, 'x') + "--");
+    REQUIRE(text.data() == data);
+    REQUIRE(text.capacity() == capacity);
+
+    utils::strings::mutable_version::replace_all<char>(text, "-", "[-]");
+    REQUIRE(text == std::string(100, 'x') + "[-][-]");
+
+    utils::strings::searcher<char> const key{"X", true};
+    utils::strings::mutable_version::replace_all<char>(text, key, "y");
+    REQUIRE(text == std::string(100, 'y') + "[-][-]");
+}
+
+TEST_CASE("Strings - append_replaced appends to the caller's buffer")
+{
+    std::string out = "head:";
+    utils::strings::append_replaced<char>(out, "a,b,c", ",", ", ");
+    REQUIRE(out == "head:a, b, c");
+    utils::strings::append_replaced<char>(out, "|x", "", "?");
+    REQUIRE(out == "head:a, b, c|x");
+    utils::strings::append_replaced<char>(
+        out, "|A.a", utils::strings::searcher<char>{"a", true}, "_");
+    REQUIRE(out == "head:a, b, c|x|_._");
+}
+
+TEST_CASE("Strings - join string-like elements without streams")
+{
+    std::vector<std::string_view> const views{"GET", "/index.html",
+                                              "HTTP/1.1"};
+    REQUIRE(utils::strings::join<char>(views, " ") ==
+            "GET /index.html HTTP/1.1");
+    REQUIRE(utils::strings::join<char>(std::vector<char const*>{"a", "b"},
+                                       ',') == "a,b");
+    REQUIRE(
+        utils::strings::join<char>(std::vector<std::string>{}, ",").empty());
+    REQUIRE(utils::strings::join<char>(std::vector<std::string>{"x"}, ",") ==
+            "x");
+    REQUIRE(utils::strings::join<wchar_t>(std::vector<std::wstring>{L"a", L"b"},
+                                          L"::") == L"a::b");
+    REQUIRE(utils::strings::joined_size<char>(views.begin(), views.end(), 1) ==
+            24);
+}
+
+TEST_CASE("Strings - join numbers through to_chars")
+{
+    REQUIRE(utils::strings::join<char>(std::vector<int>{1, -20, 300}, ",") ==
+            "1,-20,300");
+    REQUIRE(utils::strings::join<char>(
+                std::vector<std::uint64_t>{18446744073709551615ULL, 0}, "|") ==
+            "18446744073709551615|0");
+    REQUIRE(utils::strings::join<wchar_t>(std::vector<long>{7, 8}, L", ") ==
+            L"7, 8");
+#if defined(__cpp_lib_to_chars)
+    REQUIRE(utils::strings::join<char>(std::vector<double>{0.1, 2.5, 1e21},
+                                       ",") == "0.1,2.5,1e+21");
+#endif
+    // Characters and bool keep their stream formatting.
+    REQUIRE(utils::strings::join<char>(std::vector<char>{'a', 'b'}, "-") ==
+            "a-b");
+    REQUIRE(utils::strings::join<char>(std::vector<bool>{true, false}, ",") ==
+            "1,0");
+}
+
+TEST_CASE("Strings - join_into appends to a string or fills a span")
+{
+    std::string out = "[";
+    utils::strings::join_into<char>(out, std::vector<std::string>{"a", "b"},
+                                    ", ");
+    utils::strings::join_into<char>(out, std::vector<int>{1, 2}, ";");
+    REQUIRE(out == "[a, b1;2");
+
+    std::vector<char> buffer(8, '#');
+    REQUIRE(utils::strings::join_into<char>(
+                utils::span<char>{buffer},
+                std::vector<std::string_view>{"ab", "cd"}, "--") == 6);
+    REQUIRE(std::string(buffer.begin(), buffer.end()) == "ab--cd##");
+    REQUIRE(utils::strings::join_into<char>(utils::span<char>{buffer},
+                                            std::vector<int>{10, 20, 30},
+                                            ",") == 8);
+    REQUIRE(std::string(buffer.begin(), buffer.end()) == "10,20,30");
+
+    REQUIRE_THROWS_AS(utils::strings::join_into<char>(
+                          utils::span<char>{buffer},
+                          std::vector<std::string_view>{"abcd", "efgh"}, ","),
+                      std::out_of_range);
+    REQUIRE_THROWS_AS(utils::strings::join_into<char>(
+                          utils::span<char>{buffer},
+                          std::vector<int>{100, 200, 300}, ","),
+                      std::out_of_range);
+}
+
+namespace
+{
+struct point
+{
+    int x;
+    int y;
+};
+
+std::ostream& operator<<(std::ostream& os, point const& p)
+{
+    return os << '(' << p.x << ' ' << p.y << ')';
+}
+} // namespace
+
+TEST_CASE("Strings - join keeps the ostream path for other types")
+{
+    std::vector<point> const points{{1, 2}, {3, 4}};
+    REQUIRE(utils::strings::join<char>(points, ", ") == "(1 2), (3 4)");
+}
+
+TEST_CASE("Strings - format_number / format_to use to_chars")
+{
+    REQUIRE(utils::strings::format_number(0).view() == "0");
+    REQUIRE(utils::strings::format_number(-123456789LL).view() ==
+            "-123456789");
+    REQUIRE(utils::strings::format_number(std::uint64_t{18446744073709551615U})
+                .view() == "18446744073709551615");
+
+    char buffer[8];
+    REQUIRE(utils::strings::format_to<char>(utils::span<char>{buffer}, 4096) ==
+            4);
+    REQUIRE(std::string_view(buffer, 4) == "4096");
+    REQUIRE_THROWS_AS(
+        utils::strings::format_to<char>(utils::span<char>{buffer}, 123456789),
+        std::out_of_range);
+
+    wchar_t wide[4];
+    REQUIRE(utils::strings::format_to<wchar_t>(utils::span<wchar_t>{wide},
+                                               -12) == 3);
+    REQUIRE(std::wstring_view(wide, 3) == L"-12");
+
+    std::string out = "n=";
+    utils::strings::append_number(out, 42U);
+    REQUIRE(out == "n=42");
+}
+
+#if defined(__cpp_lib_to_chars)
+TEST_CASE("Strings - floating-point formatting")
+{
+    // Shortest round-trip form: no "0.100000" and no lost digits.
+    REQUIRE(utils::strings::format_number(0.1).view() == "0.1");
+    REQUIRE(utils::strings::format_number(1.0 / 3).view() ==
+            "0.3333333333333333");
+    REQUIRE(utils::strings::format_number(1e300).view() == "1e+300");
+    REQUIRE(utils::strings::format_number(2.5F).view() == "2.5");
+
+    REQUIRE(utils::strings::format_fixed(3.14159, 2).view() == "3.14");
+    REQUIRE(utils::strings::format_fixed(-0.5, 0).view() == "-0");
+    REQUIRE_THROWS_AS((void)utils::strings::format_fixed(1e300, 2),
+                      std::out_of_range);
+
+    std::vector<char> big(400);
+    REQUIRE(utils::strings::format_fixed_to<char>(utils::span<char>{big}, 1e300,
+                                                  2) == 304);
+
+    std::string out;
+    utils::strings::append_fixed(out, 2.0 / 3, 3);
+    out += ' ';
+    utils::strings::append_number(out, 1e-7);
+    REQUIRE(out == "0.667 1e-07");
+}
+#endif
+
+TEST_CASE("Strings - padded numbers compose without allocating")
+{
+    std::string out;
+    utils::strings::append_padded(out, 42, 5);
+    out += '|';
+    utils::strings::append_padded(out, -42, 5);
+    out += '|';
+    utils::strings::append_padded(out, -42, 5, ' ');
+    out += '|';
+    utils::strings::append_padded(out, 123456, 3);
+    REQUIRE(out == "00042|-0042|  -42|123456");
+
+    char buffer[6];
+    REQUIRE(utils::strings::format_padded_to<char>(utils::span<char>{buffer},
+                                                   7, 6, '.') == 6);
+    REQUIRE(std::string_view(buffer, 6) == ".....7");
+    REQUIRE_THROWS_AS(utils::strings::format_padded_to<char>(
+                          utils::span<char>{buffer}, 7, 7),
+                      std::out_of_range);
+
+    std::string line;
+    utils::strings::pad_left_into<char>(line, utils::strings::format_number(7),
+                                        4);
+    utils::strings::pad_right_into<char>(line, "ms", 4, '.');
+    REQUIRE(line == "   7ms..");
+}
+
+namespace
+{
+// Fields parse_integers() must agree with std::from_chars on: numbers around
+// every type's limits, leading zeros, signs and trailing garbage.
+std::vector<std::string> integer_fields()
+{
+    std::vector<std::string> fields = {
+        "", "0", "-0", "00000000000000000000000042", "-", "+1", " 1", "1 ",
+        "12x", "x12", "127", "128", "-128", "-129", "255", "256", "65535",
+        "2147483647", "2147483648", "-2147483648", "-2147483649",
+        "4294967295", "4294967296", "9223372036854775807",
+        "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+        "18446744073709551615", "18446744073709551616",
+        "99999999999999999999999", "1234567890123456789x"};
+    std::mt19937_64 gen{7};
+    for (int i = 0; i < 500; ++i) {
+        auto const value = gen();
+        auto const width = static_cast<int>(gen() % 20);
+        std::string field = std::to_string(value).substr(
+            0, static_cast<std::size_t>(width) + 1);
+        if (gen() % 3 == 0) {
+            field.insert(field.begin(), '-');
+        }
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+template <typename T>
+void check_parse_integers()
+{
+    auto const storage = integer_fields();
+    std::vector<std::string_view> const fields(storage.begin(), storage.end());
+    std::vector<T> values(fields.size());
+    std::vector<utils::strings::parse_status> status(fields.size());
+    auto const result =
+        utils::strings::parse_integers<T>(fields, values, status);
+    REQUIRE(result.fields == fields.size());
+
+    std::size_t errors = 0;
+    for (std::size_t i = 0; i < fields.size(); ++i) {
+        T expected{};
+        auto const* const last = fields[i].data() + fields[i].size();
+        auto const [ptr, ec] =
+            std::from_chars(fields[i].data(), last, expected);
+        auto const ok = ec == std::errc{} && ptr == last;
+        CAPTURE(fields[i]);
+        REQUIRE((status[i] == utils::strings::parse_status::ok) == ok);
+        REQUIRE(values[i] == (ok ? expected : T{}));
+        if (ec == std::errc::result_out_of_range) {
+            REQUIRE(status[i] == utils::strings::parse_status::out_of_range);
+        }
+        errors += ok ? 0 : 1;
+    }
+    REQUIRE(result.errors == errors);
+    REQUIRE(result.first_error == 0); // the empty field
+}
+} // namespace
+
+TEST_CASE("Strings - parse_integers agrees with from_chars")
+{
+    check_parse_integers<std::int8_t>();
+    check_parse_integers<std::uint8_t>();
+    check_parse_integers<std::int16_t>();
+    check_parse_integers<std::int32_t>();
+    check_parse_integers<std::uint32_t>();
+    check_parse_integers<std::int64_t>();
+    check_parse_integers<std::uint64_t>();
+}
+
+TEST_CASE("Strings - parse_integers reports per-field errors")
+{
+    std::vector<std::string_view> const fields = {"10", "", "x", "300", "-4"};
+    std::vector<std::uint8_t> values(fields.size(), 99);
+    std::vector<utils::strings::parse_status> status(fields.size());
+    auto const result =
+        utils::strings::parse_integers<std::uint8_t>(fields, values, status);
+    REQUIRE_FALSE(result);
+    REQUIRE(result.errors == 4);
+    REQUIRE(result.first_error == 1);
+    REQUIRE(values == std::vector<std::uint8_t>{10, 0, 0, 0, 0});
+    using utils::strings::parse_status;
+    REQUIRE(status ==
+            std::vector<parse_status>{parse_status::ok, parse_status::empty,
+                                      parse_status::invalid_character,
+                                      parse_status::out_of_range,
+                                      parse_status::invalid_character});
+
+    std::vector<int> ints(fields.size());
+    REQUIRE(utils::strings::parse_integers<int>(
+                std::vector<std::string_view>{"1", "2"}, ints)
+                .errors == 0);
+    REQUIRE(ints[0] == 1);
+    REQUIRE(ints[1] == 2);
+
+    std::vector<int> too_small(2);
+    REQUIRE_THROWS_AS(utils::strings::parse_integers<int>(fields, too_small),
+                      std::out_of_range);
+}
+
+TEST_CASE("Strings - split_and_parse matches split_view then parse")
+{
+    using utils::strings::parse_status;
+    for (std::string_view const text :
+         {"", ",", "1", "1,2,3", ",1,,2,", "12,x3,4x,-5,99999999999999999999",
+          "  7 \t8\n9  ", "-2147483648,2147483647,2147483648"}) {
+        for (std::string_view const delims : {",", " \t\n", ",\n"}) {
+            for (bool const keep_empty : {false, true}) {
+                auto const tokens =
+                    utils::strings::split_view<char>(text, delims, keep_empty);
+                std::vector<int> expected(tokens.size());
+                std::vector<parse_status> expected_status(tokens.size());
+                auto const expected_result =
+                    utils::strings::parse_integers<int>(tokens, expected,
+                                                        expected_status);
+
+                std::vector<int> values{-1};
+                std::vector<parse_status> status;
+                auto const result = utils::strings::split_and_parse(
+                    text, delims, values, status, keep_empty);
+                CAPTURE(text, delims, keep_empty);
+                REQUIRE(values.front() == -1); // appended, not replaced
+                values.erase(values.begin());
+                REQUIRE(values == expected);
+                REQUIRE(status == expected_status);
+                REQUIRE(result.fields == tokens.size());
+                REQUIRE(result.errors == expected_result.errors);
+                REQUIRE(result.first_error == expected_result.first_error);
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> column;
+    REQUIRE(utils::strings::split_and_parse(
+        "17|4294967295|0000000000000000000000000001", '|', column));
+    REQUIRE(column == std::vector<std::uint32_t>{17, 4294967295U, 1});
+}
+
+namespace
+{
+// A stateful allocator that counts the allocations made through it and its
+// rebound copies. It has no default constructor, so any string or vector that
+// does not get it passed down fails to compile.
+template <typename T>
+struct counting_allocator
+{
+    using value_type = T;
+
+    std::size_t* count;
+
+    explicit counting_allocator(std::size_t* const counter) noexcept
+        : count(counter)
+    {}
+
+    template <typename U>
+    counting_allocator(counting_allocator<U> const& other) noexcept
+        : count(other.count)
+    {}
+
+    T* allocate(std::size_t const n)
+    {
+        ++*count;
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* const p, std::size_t const n) noexcept
+    {
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <typename U>
+    friend bool operator==(counting_allocator const& lhs,
+                           counting_allocator<U> const& rhs) noexcept
+    {
+        return lhs.count == rhs.count;
+    }
+
+    template <typename U>
+    friend bool operator!=(counting_allocator const& lhs,
+                           counting_allocator<U> const& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+};
+
+using counted_string = utils::strings::tstring<char, counting_allocator<char>>;
+
+// Strings with different allocators only compare through views.
+template <typename String>
+std::string_view view(String const& text)
+{
+    return {text.data(), text.size()};
+}
+} // namespace
+
+TEST_CASE("Strings - allocator overloads build with the given allocator")
+{
+    namespace s = utils::strings;
+    std::size_t count = 0;
+    counting_allocator<char> const alloc{&count};
+
+    // Tokens longer than the small-string buffer, so each one allocates.
+    std::string const text =
+        "first-long-token-value,second-long-token-value,,third-long-token";
+    auto const tokens = s::split<char>(text, ',', false, alloc);
+    REQUIRE(tokens.size() == 3);
+    REQUIRE(count >= 4); // the vector and every token
+    for (std::size_t i = 0; i < tokens.size(); ++i) {
+        REQUIRE(view(tokens[i]) == s::split<char>(text, ',')[i]);
+        REQUIRE(tokens[i].get_allocator() == alloc);
+    }
+    REQUIRE(tokens.get_allocator() == alloc);
+
+    auto const views = s::split_view<char>(text, ",", true, alloc);
+    REQUIRE(std::vector<std::string_view>(views.begin(), views.end()) ==
+            s::split_view<char>(text, ",", true));
+    REQUIRE(s::split_on<char>(text, ",,", false, alloc).size() == 2);
+    REQUIRE(s::split_on_view<char>(text, "-", false, alloc).size() == 9);
+
+    auto before = count;
+    auto const joined = s::join(tokens, "; ", alloc);
+    REQUIRE(view(joined) == s::join(s::split<char>(text, ','), "; "));
+    REQUIRE(count == before + 1); // sized once
+    REQUIRE(s::join(tokens, '|', alloc) ==
+            "first-long-token-value|second-long-token-value|third-long-token");
+
+    std::vector<std::byte> const bytes(32, std::byte{0xAB});
+    before = count;
+    auto const hex = s::to_hex<char>(bytes, false, true, alloc);
+    REQUIRE(view(hex) == s::to_hex<char>(bytes, false, true));
+    REQUIRE(count == before + 1);
+    REQUIRE(view(s::to_hex<char>(bytes.begin(), bytes.end(), true, false,
+                                 alloc)) == s::to_hex<char>(bytes));
+    REQUIRE(view(s::to_base64<char>(bytes, s::base64_alphabet::url, false,
+                                    alloc)) ==
+            s::to_base64<char>(bytes, s::base64_alphabet::url, false));
+    REQUIRE(view(s::to_base32<char>(bytes, true, alloc)) ==
+            s::to_base32<char>(bytes));
+    REQUIRE(view(s::repeat<char>("ab", 20, alloc)) ==
+            s::repeat<char>("ab", 20));
+    REQUIRE(view(s::repeat('x', 40, alloc)) == std::string(40, 'x'));
+}
+
+TEST_CASE("Strings - transforms keep the string's allocator")
+{
+    namespace s = utils::strings;
+    std::size_t count = 0;
+    counting_allocator<char> const alloc{&count};
+    counted_string const text("  a long enough line to leave the buffer  ",
+                              alloc);
+
+    auto const upper = s::to_upper(counted_string(text, alloc));
+    REQUIRE(upper == "  A LONG ENOUGH LINE TO LEAVE THE BUFFER  ");
+    REQUIRE(upper.get_allocator() == alloc);
+    REQUIRE(s::trim(text) == "a long enough line to leave the buffer");
+    REQUIRE(s::trim(text).get_allocator() == alloc);
+    REQUIRE(s::trimleft(text).get_allocator() == alloc);
+    REQUIRE(s::trimright(text).get_allocator() == alloc);
+    REQUIRE(s::pad_left(counted_string("7", alloc), 40, '0').size() == 40);
+    REQUIRE(s::center(counted_string("mid", alloc), 40).get_allocator() ==
+            alloc);
+    REQUIRE(s::remove(counted_string(text, alloc), ' ') ==
+            "alongenoughlinetoleavethebuffer");
+
+    // Growing replacements build a new buffer, with the same allocator.
+    auto before = count;
+    auto grown = s::replace_all<char>(counted_string(text, alloc), " ", "__");
+    REQUIRE(grown.get_allocator() == alloc);
+    REQUIRE(view(grown) == s::replace_all<char>(std::string(text), " ", "__"));
+    REQUIRE(count > before);
+    REQUIRE(s::replace_first<char>(counted_string(text, alloc), "long", "short")
+                .get_allocator() == alloc);
+
+    // Appending into a reserved string does not allocate again.
+    counted_string out(alloc);
+    out.reserve(256);
+    before = count;
+    s::join_into<char>(out, std::vector<int>{1, 2, 3}, ",");
+    s::append_number(out, 42);
+    s::pad_left_into<char>(out, "x", 4);
+    s::append_replaced<char>(out, "a.b", ".", "::");
+    s::mutable_version::to_upper(out);
+    REQUIRE(out == "1,2,342   XA::B");
+    std::array<std::byte, 2> const two{std::byte{0xAB}, std::byte{0x01}};
+    s::to_hex_into(out, utils::span<std::byte const>(two.data(), two.size()));
+    REQUIRE(out == "AB01");
+    REQUIRE(count == before);
+}
+
+#if defined(__cpp_lib_memory_resource)
+TEST_CASE("Strings - pmr pipeline stays on its arena")
+{
+    namespace s = utils::strings;
+
+    // Anything that falls back to the default resource would throw.
+    struct default_resource_guard
+    {
+        std::pmr::memory_resource* previous = std::pmr::set_default_resource(
+            std::pmr::null_memory_resource());
+        ~default_resource_guard() { std::pmr::set_default_resource(previous); }
+    } const guard;
+
+    std::array<std::byte, 16384> buffer{};
+    std::pmr::monotonic_buffer_resource arena(
+        buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+    std::pmr::polymorphic_allocator<char> const alloc(&arena);
+
+    std::string_view const request =
+        "user=someone.with.a.long.name&session=0123456789abcdef&path=/a/b";
+    auto const fields = s::split<char>(request, '&', false, alloc);
+    REQUIRE(fields.size() == 3);
+    auto const joined = s::join(fields, ',', alloc);
+    auto hex = s::to_hex<char>(joined, false, false, alloc);
+    s::mutable_version::to_upper(hex);
+    auto const width = hex.size() + 8;
+    auto padded = s::pad_left(std::move(hex), width, '0');
+    static_assert(std::is_same_v<decltype(padded), s::pmr::string>);
+    REQUIRE(padded.get_allocator().resource() == &arena);
+    REQUIRE(padded.substr(0, 8) == "00000000");
+    REQUIRE(padded.size() == 8 + (2 * request.size()));
+    REQUIRE(s::to_hex<char>(std::string_view{request}, true, false, alloc)
+                .find("26") != s::pmr::string::npos);
+
+    // The charset trims, for char and wide strings alike.
+    s::pmr::string const path("//a/b//", alloc);
+    auto const trimmed = s::trim(path, std::string{"/"});
+    static_assert(std::is_same_v<decltype(trimmed), s::pmr::string const>);
+    REQUIRE(trimmed == "a/b");
+    REQUIRE(trimmed.get_allocator().resource() == &arena);
+    REQUIRE(s::trimleft(path, std::string{"/"}) == "a/b//");
+    REQUIRE(s::trimright(path, std::string{"/"}).get_allocator().resource() ==
+            &arena);
+    s::pmr::tstring<wchar_t> const wide(L"--x--", &arena);
+    REQUIRE(s::trim(wide, std::wstring{L"-"}) == L"x");
+    REQUIRE(s::trimleft(wide, std::wstring{L"-"}).get_allocator().resource() ==
+            &arena);
+    REQUIRE(s::trimright(wide, std::wstring{L"-x"}).empty());
+
+    // Multi-pattern replacement, transcoding and decoding, too.
+    s::multi_searcher<char> const keys{"user", "session"};
+    auto const masked =
+        s::replace_all<char>(request, keys, std::string_view{"*"}, alloc);
+    static_assert(std::is_same_v<decltype(masked), s::pmr::string const>);
+    REQUIRE(masked.substr(0, 2) == "*=");
+    REQUIRE(masked.get_allocator().resource() == &arena);
+    REQUIRE(s::replace_all<char>(request, keys,
+                                 std::array<std::string_view, 2>{"u", "s"},
+                                 alloc)
+                .get_allocator()
+                .resource() == &arena);
+
+    std::string_view const apples = "\xC3\x84pfel";
+    auto const utf16 = s::utf8_to_utf16(apples, alloc);
+    REQUIRE(utf16 == u"\u00C4pfel");
+    REQUIRE(utf16.get_allocator().resource() == &arena);
+    REQUIRE(s::utf16_to_utf8(utf16, alloc).get_allocator().resource() ==
+            &arena);
+    REQUIRE(s::utf32_to_utf8(s::utf8_to_utf32(apples, alloc), alloc) ==
+            apples);
+    auto const folded = s::fold_case_utf8(apples, alloc);
+    REQUIRE(folded == "\xC3\xA4pfel");
+    REQUIRE(folded.get_allocator().resource() == &arena);
+
+    auto const bytes = s::hex_to_bytes<char>("c3a4", alloc);
+    static_assert(
+        std::is_same_v<decltype(bytes), std::pmr::vector<std::byte> const>);
+    REQUIRE(bytes.size() == 2);
+    REQUIRE(bytes.get_allocator().resource() == &arena);
+    REQUIRE(s::base64_to_bytes<char>("w6Q=", s::base64_alphabet::standard,
+                                     alloc) == bytes);
+    REQUIRE(s::base32_to_bytes<char>("YOSA====", alloc) == bytes);
+}
+#endif
@@ -1,13 +1,24 @@
 #include <libutils/threading.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <exception>
+#include <fstream>
 #include <iostream>
 #include <mutex>
 #include <sstream>
+#include <stdexcept>
+#include <string>
 #include <thread>
 #include <vector>
 
+#if defined(__linux__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
 TEST_CASE("threading - join_all joins every joinable thread")
 {
     std::atomic<int> counter{0};
@@ -27,6 +38,78 @@ TEST_CASE("threading - join_all joins every joinable thread")
     }
 }
 
+TEST_CASE("threading - run_chunks runs every chunk, rethrows the first error")
+{
+    std::vector<int> done(4);
+    auto const caller = std::this_thread::get_id();
+    std::thread::id first;
+    utils::threading::run_chunks(done.size(), [&](std::size_t const k) {
+        done[k] = 1;
+        if (k == 0) {
+            first = std::this_thread::get_id();
+        }
+    });
+    REQUIRE(done == std::vector<int>{1, 1, 1, 1});
+    REQUIRE(first == caller);
+
+    // Every chunk still runs; the error of the lowest failing chunk wins.
+    std::atomic<int> ran{0};
+    std::string error;
+    try {
+        utils::threading::run_chunks(3, [&](std::size_t const k) {
+            ++ran;
+            if (k != 0) {
+                throw std::runtime_error(std::to_string(k));
+            }
+        });
+    } catch (std::runtime_error const& e) {
+        error = e.what();
+    }
+    REQUIRE(error == "1");
+    REQUIRE(ran.load() == 3);
+    utils::threading::run_chunks(0, [](std::size_t) {
+        FAIL("no chunks to run");
+    });
+
+    REQUIRE(utils::threading::parallel_chunks(0, 8) == 1);
+    REQUIRE(utils::threading::parallel_chunks(
+                3 * utils::threading::parallel_min_chunk, 8) == 3);
+    REQUIRE(utils::threading::parallel_chunks(
+                3 * utils::threading::parallel_min_chunk, 2) == 2);
+}
+
+// Address-space limits do not mix with sanitizers' shadow memory.
+#if defined(__linux__) && !defined(__SANITIZE_ADDRESS__) &&                    \
+    !defined(__SANITIZE_THREAD__)
+TEST_CASE("threading - run_chunks runs chunks without a thread on the caller")
+{
+    // Cap the address space a little above what is in use, so that thread
+    // stacks run out after a few dozen threads.
+    std::size_t pages = 0;
+    std::ifstream{"/proc/self/statm"} >> pages;
+    auto const in_use =
+        static_cast<rlim_t>(pages) * static_cast<rlim_t>(sysconf(_SC_PAGESIZE));
+    rlimit previous{};
+    REQUIRE(getrlimit(RLIMIT_AS, &previous) == 0);
+    rlimit capped = previous;
+    capped.rlim_cur = in_use + (rlim_t{256} << 20U);
+    REQUIRE(setrlimit(RLIMIT_AS, &capped) == 0);
+
+    std::vector<int> done(5000);
+    std::string error;
+    try {
+        utils::threading::run_chunks(done.size(), [&](std::size_t const k) {
+            done[k] = 1;
+        });
+    } catch (std::exception const& e) {
+        error = e.what();
+    }
+    REQUIRE(setrlimit(RLIMIT_AS, &previous) == 0);
+    REQUIRE(error.empty());
+    REQUIRE(std::count(done.begin(), done.end(), 1) == 5000);
+}
+#endif
+
 TEST_CASE(
     "threading - anti_lock unlocks on construction, relocks on destruction")
 {